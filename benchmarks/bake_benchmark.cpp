@@ -0,0 +1,188 @@
+#include "benchmark.hpp"
+
+#include <sumire/core/models/animation_sampler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* BakedAnimation check and benchmark.
+*
+* Check: at every baked frame time, the baked tracks must match the authored channels up to the
+*  snorm16 rotation quantization.
+*
+* Benchmark: one evaluation visits every animated value of a clip at the playback time, as
+*  Animation::visitValues does for Animation::sample and Animation::blend, from the authored samplers
+*  (keyframe cursor lookup and linear or cubic spline interpolation) and from the baked tracks.
+*  The visitor only accumulates the values, as node writes are the same for both paths.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    constexpr float KEY_RATE        = 30.0f;
+    constexpr float CLIP_DURATION   = 10.0f;
+    constexpr float UPDATE_INTERVAL = 1.0f / 60.0f;
+
+    struct Clip {
+        std::vector<AnimationChannel> channels;
+        std::vector<AnimationSampler> samplers;
+        float start = 0.0f;
+        float end = CLIP_DURATION;
+    };
+
+    glm::vec4 randomRotation(std::mt19937& rng) {
+        std::normal_distribution<float> dist{ 0.0f, 1.0f };
+        glm::quat q = glm::normalize(glm::quat{ dist(rng), dist(rng), dist(rng), dist(rng) });
+        return glm::vec4{ q.x, q.y, q.z, q.w };
+    }
+
+    glm::vec4 randomValue(std::mt19937& rng, AnimationChannel::PathType path) {
+        std::uniform_real_distribution<float> translationDist{ -1.0f, 1.0f };
+        std::uniform_real_distribution<float> scaleDist{ 0.5f, 1.5f };
+        switch (path) {
+            case AnimationChannel::PathType::ROTATION: return randomRotation(rng);
+            case AnimationChannel::PathType::SCALE:
+                return glm::vec4{ scaleDist(rng), scaleDist(rng), scaleDist(rng), 0.0f };
+            default:
+                return glm::vec4{ translationDist(rng), translationDist(rng), translationDist(rng), 0.0f };
+        }
+    }
+
+    // A rig of numNodes nodes, each with translation, rotation and scale channels keyed at KEY_RATE.
+    Clip createClip(std::mt19937& rng, uint32_t numNodes, util::GLTFinterpolationType interpolation) {
+        std::uniform_real_distribution<float> tangentDist{ -0.1f, 0.1f };
+        const uint32_t numKeys = static_cast<uint32_t>(CLIP_DURATION * KEY_RATE) + 1u;
+
+        Clip clip;
+        clip.channels.resize(numNodes * 3u);
+        clip.samplers.resize(numNodes * 3u);
+
+        for (uint32_t c = 0; c < clip.channels.size(); c++) {
+            AnimationChannel& channel = clip.channels[c];
+            channel.path = static_cast<AnimationChannel::PathType>(c % 3u);
+            channel.node = nullptr;
+            channel.nodeIdx = c / 3u;
+            channel.samplerIdx = c;
+
+            AnimationSampler& sampler = clip.samplers[c];
+            sampler.interpolation = interpolation;
+            sampler.inputs.resize(numKeys);
+            for (uint32_t k = 0; k < numKeys; k++) {
+                sampler.inputs[k] = std::min(static_cast<float>(k) / KEY_RATE, CLIP_DURATION);
+
+                // Cubic spline keys are (in tangent, value, out tangent) triplets.
+                const glm::vec4 value = randomValue(rng, channel.path);
+                if (interpolation == util::INTERP_CUBIC_SPLINE) {
+                    sampler.outputs.push_back(glm::vec4{ tangentDist(rng), tangentDist(rng), tangentDist(rng), tangentDist(rng) });
+                    sampler.outputs.push_back(value);
+                    sampler.outputs.push_back(glm::vec4{ tangentDist(rng), tangentDist(rng), tangentDist(rng), tangentDist(rng) });
+                } else {
+                    sampler.outputs.push_back(value);
+                }
+            }
+        }
+
+        return clip;
+    }
+
+    // Authored path of Animation::visitValues
+    template <typename Visitor>
+    void sampleAuthored(const Clip& clip, float time, std::vector<uint32_t>& cursors, Visitor&& visit) {
+        for (size_t i = 0; i < clip.channels.size(); i++) {
+            const AnimationChannel& channel = clip.channels[i];
+            glm::vec4 value;
+            if (!clip.samplers[channel.samplerIdx].sample(time, channel.path, cursors[i], value)) continue;
+            visit(channel.nodeIdx, channel.path, value);
+        }
+    }
+
+    bool valuesMatch(AnimationChannel::PathType path, const glm::vec4& a, const glm::vec4& b) {
+        if (path == AnimationChannel::PathType::ROTATION) {
+            // Either hemisphere is the same rotation
+            const glm::quat qa = glm::normalize(glm::quat{ a.w, a.x, a.y, a.z });
+            const glm::quat qb = glm::normalize(glm::quat{ b.w, b.x, b.y, b.z });
+            return std::abs(glm::dot(qa, qb)) > 1.0f - 1e-5f;
+        }
+        return std::abs(a.x - b.x) < 1e-4f && std::abs(a.y - b.y) < 1e-4f && std::abs(a.z - b.z) < 1e-4f;
+    }
+
+    bool runCheck(const Clip& clip, const BakedAnimation& baked) {
+        const uint32_t numNodes = static_cast<uint32_t>(clip.channels.size() / 3u);
+        std::vector<uint32_t> cursors(clip.channels.size(), 0u);
+        // Authored values of the current frame, indexed by node * 3 + path.
+        std::vector<glm::vec4> expected(numNodes * 3u);
+        uint32_t mismatches = 0u;
+
+        for (uint32_t f = 0; f < baked.frameCount; f++) {
+            const float time = clip.start + static_cast<float>(f) / baked.sampleRate;
+            sampleAuthored(clip, time, cursors, [&](uint32_t nodeIdx, AnimationChannel::PathType path, const glm::vec4& value) {
+                expected[nodeIdx * 3u + path] = value;
+            });
+            baked.sample(time, clip.start, [&](uint32_t nodeIdx, AnimationChannel::PathType path, const glm::vec4& value) {
+                if (!valuesMatch(path, expected[nodeIdx * 3u + path], value)) mismatches++;
+            });
+        }
+
+        return mismatches == 0u;
+    }
+
+    // Keeps the sampled values from being optimized away.
+    volatile float valueSink = 0.0f;
+
+    void runBenchmark(const Clip& clip, const BakedAnimation& baked, const char* interpolation) {
+        constexpr uint32_t NUM_EVALUATIONS = 100000u;
+
+        glm::vec4 sink{ 0.0f };
+        auto accumulate = [&](uint32_t, AnimationChannel::PathType, const glm::vec4& value) {
+            sink += value;
+        };
+        auto playbackTime = [&](uint32_t n) {
+            return clip.start + std::fmod(static_cast<float>(n) * UPDATE_INTERVAL, clip.end - clip.start);
+        };
+
+        std::vector<uint32_t> cursors(clip.channels.size(), 0u);
+        uint32_t n = 0u;
+        const double authoredUs = benchmark::meanMicroseconds(NUM_EVALUATIONS, [&]() {
+            sampleAuthored(clip, playbackTime(n++), cursors, accumulate);
+        });
+
+        n = 0u;
+        const double bakedUs = benchmark::meanMicroseconds(NUM_EVALUATIONS, [&]() {
+            baked.sample(playbackTime(n++), clip.start, accumulate);
+        });
+
+        valueSink = sink.x + sink.y + sink.z + sink.w;
+
+        std::cout << clip.channels.size() / 3u << " | " << interpolation << " | " << authoredUs << " | "
+            << bakedUs << " | " << authoredUs / bakedUs << "x" << std::endl;
+    }
+
+}
+
+int main() {
+    std::mt19937 rng{ 5u };
+
+    std::cout << "nodes (T/R/S each) | interpolation | authored (us per evaluation)"
+        << " | baked at " << BakedAnimation::DEFAULT_SAMPLE_RATE << " fps (us per evaluation) | speedup" << std::endl;
+
+    for (uint32_t numNodes : { 20u, 100u }) {
+        for (util::GLTFinterpolationType interpolation : { util::INTERP_LINEAR, util::INTERP_CUBIC_SPLINE }) {
+            const Clip clip = createClip(rng, numNodes, interpolation);
+            const BakedAnimation baked = BakedAnimation::bake(
+                clip.samplers, clip.channels, clip.start, clip.end, BakedAnimation::DEFAULT_SAMPLE_RATE
+            );
+
+            if (!benchmark::check(runCheck(clip, baked), "baked frames differ from the authored channels")) {
+                return EXIT_FAILURE;
+            }
+            runBenchmark(clip, baked, interpolation == util::INTERP_LINEAR ? "linear" : "cubic spline");
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
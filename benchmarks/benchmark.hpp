@@ -0,0 +1,33 @@
+#pragma once
+
+/*
+* Shared helpers for the standalone CPU benchmarks (see SUMIRE_BUILD_BENCHMARKS in CMakeLists.txt).
+*
+* Each benchmark checks its results against a reference implementation before timing anything, and
+*  returns EXIT_FAILURE if they differ.
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace sumire::benchmark {
+
+    // Mean wall time of fn() in microseconds, after one untimed warm up call.
+    template <typename Fn>
+    double meanMicroseconds(uint32_t iterations, Fn&& fn) {
+        fn();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) fn();
+        const auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+    }
+
+    inline bool check(bool passed, const char* what) {
+        if (!passed) std::cerr << "[Sumire::Benchmark] FAILED: " << what << std::endl;
+        return passed;
+    }
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+/*
+* A large skinned glTF model built in memory, for the glTF decode and mesh cache benchmarks: 2M vertices
+*  in 32 primitives of a 256 x 256 vertex grid, with float positions, normals, tangents, UVs & weights,
+*  uint16 joints and uint32 indices, one buffer view per attribute as exporters write them.
+*/
+
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+#include <sumire/loaders/gltf_primitive_decoder.hpp>
+
+#include <tiny_gltf.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace sumire::benchmark {
+
+    constexpr uint32_t NUM_PRIMITIVES = 32u;
+    constexpr uint32_t GRID_SIZE      = 256u;
+    constexpr uint32_t GRID_VERTICES  = GRID_SIZE * GRID_SIZE;
+    constexpr uint32_t GRID_INDICES   = (GRID_SIZE - 1u) * (GRID_SIZE - 1u) * 6u;
+
+    template <typename T>
+    inline int addAccessor(tinygltf::Model &model, const std::vector<T> &elements, int componentType, int type, size_t count) {
+        tinygltf::Buffer &buffer = model.buffers[0];
+
+        tinygltf::BufferView view{};
+        view.buffer = 0;
+        view.byteOffset = buffer.data.size();
+        view.byteLength = elements.size() * sizeof(T);
+        buffer.data.resize(buffer.data.size() + view.byteLength);
+        std::memcpy(&buffer.data[view.byteOffset], elements.data(), view.byteLength);
+        model.bufferViews.push_back(view);
+
+        tinygltf::Accessor accessor{};
+        accessor.bufferView = static_cast<int>(model.bufferViews.size()) - 1;
+        accessor.byteOffset = 0;
+        accessor.componentType = componentType;
+        accessor.type = type;
+        accessor.count = count;
+        model.accessors.push_back(accessor);
+        return static_cast<int>(model.accessors.size()) - 1;
+    }
+
+    // All primitives' data is in one buffer, as in a .glb.
+    inline tinygltf::Model createModel() {
+        std::mt19937 rng{ 19u };
+        std::uniform_real_distribution<float> unitDist{ -1.0f, 1.0f };
+        std::uniform_int_distribution<uint32_t> jointDist{ 0u, 63u };
+
+        tinygltf::Model model;
+        model.buffers.resize(1);
+        model.meshes.resize(1);
+
+        for (uint32_t p = 0; p < NUM_PRIMITIVES; p++) {
+            std::vector<float> positions, normals, tangents, uvs, weights;
+            std::vector<uint16_t> joints;
+            for (uint32_t y = 0; y < GRID_SIZE; y++) {
+                for (uint32_t x = 0; x < GRID_SIZE; x++) {
+                    positions.insert(positions.end(), { static_cast<float>(x), static_cast<float>(p), static_cast<float>(y) });
+                    // Exported normals are only near unit length
+                    normals.insert(normals.end(), { 0.1f * unitDist(rng), 1.0f + 0.01f * unitDist(rng), 0.1f * unitDist(rng) });
+                    tangents.insert(tangents.end(), { 1.0f, 0.1f * unitDist(rng), 0.1f * unitDist(rng), x % 2u ? 1.0f : -1.0f });
+                    uvs.insert(uvs.end(), { static_cast<float>(x) / GRID_SIZE, static_cast<float>(y) / GRID_SIZE });
+
+                    const float w0 = 0.5f + 0.5f * std::abs(unitDist(rng));
+                    weights.insert(weights.end(), { w0, 1.0f - w0, 0.0f, 0.0f });
+                    for (int j = 0; j < 4; j++) joints.push_back(static_cast<uint16_t>(jointDist(rng)));
+                }
+            }
+
+            std::vector<uint32_t> indices;
+            for (uint32_t y = 0; y + 1u < GRID_SIZE; y++) {
+                for (uint32_t x = 0; x + 1u < GRID_SIZE; x++) {
+                    const uint32_t v0 = y * GRID_SIZE + x;
+                    indices.insert(indices.end(), { v0, v0 + GRID_SIZE, v0 + 1u, v0 + 1u, v0 + GRID_SIZE, v0 + GRID_SIZE + 1u });
+                }
+            }
+
+            tinygltf::Primitive primitive{};
+            primitive.mode = TINYGLTF_MODE_TRIANGLES;
+            primitive.attributes["POSITION"]   = addAccessor(model, positions, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, GRID_VERTICES);
+            primitive.attributes["NORMAL"]     = addAccessor(model, normals, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, GRID_VERTICES);
+            primitive.attributes["TANGENT"]    = addAccessor(model, tangents, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4, GRID_VERTICES);
+            primitive.attributes["TEXCOORD_0"] = addAccessor(model, uvs, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2, GRID_VERTICES);
+            primitive.attributes["JOINTS_0"]   = addAccessor(model, joints, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC4, GRID_VERTICES);
+            primitive.attributes["WEIGHTS_0"]  = addAccessor(model, weights, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4, GRID_VERTICES);
+            primitive.indices = addAccessor(model, indices, TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, TINYGLTF_TYPE_SCALAR, GRID_INDICES);
+            model.meshes[0].primitives.push_back(primitive);
+        }
+
+        return model;
+    }
+
+    // GLTFloader::loadGLTF's second phase: arrays sized once, then each primitive decoded into its slice.
+    inline void decodeSlices(
+        const tinygltf::Model &model, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+        SumiThreadPool *threadPool
+    ) {
+        vertices.resize(NUM_PRIMITIVES * GRID_VERTICES);
+        indices.resize(NUM_PRIMITIVES * GRID_INDICES);
+
+        auto decodeRange = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t p = begin; p < end; p++) {
+                loaders::GLTFprimitiveDecoder::decode(
+                    model, model.meshes[0].primitives[p], true,
+                    &vertices[p * GRID_VERTICES], p * GRID_VERTICES, GRID_VERTICES,
+                    &indices[p * GRID_INDICES], GRID_INDICES
+                );
+            }
+        };
+        if (threadPool) {
+            threadPool->parallelFor(NUM_PRIMITIVES, decodeRange);
+        } else {
+            decodeRange(0u, NUM_PRIMITIVES);
+        }
+    }
+
+}
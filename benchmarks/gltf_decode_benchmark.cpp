@@ -0,0 +1,138 @@
+#include "benchmark.hpp"
+#include "gltf_benchmark_model.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/*
+* GLTFprimitiveDecoder check and benchmark.
+*
+* The 2M vertex skinned model of gltf_benchmark_model.hpp is built in memory, so that only vertex and
+*  index decoding is timed: not file parsing, textures, tangent generation or upload.
+*
+* Decoding is timed with the original per vertex push_back loop of GLTFloader::loadGLTFnode, and
+*  with GLTFprimitiveDecoder into presized arrays, on the calling thread and across primitives on a
+*  SumiThreadPool as GLTFloader does.
+*
+* Check: both decodes must give the same vertices and indices, except that tangents are now
+*  normalized over xyz with their handedness kept, where the original normalized all four components.
+*/
+
+using namespace sumire;
+using namespace sumire::benchmark;
+
+namespace {
+
+    template <typename T>
+    const T *accessorData(const tinygltf::Model &model, int accessorIdx, int &stride) {
+        const tinygltf::Accessor &accessor = model.accessors[accessorIdx];
+        const tinygltf::BufferView &view = model.bufferViews[accessor.bufferView];
+        stride = accessor.ByteStride(view) / static_cast<int>(sizeof(T));
+        return reinterpret_cast<const T *>(&model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]);
+    }
+
+    // The original GLTFloader::loadGLTFnode decode for the attributes above: one push_back per vertex
+    //  and index, with the joint type switch and both normalizations inside the vertex loop.
+    void decodeLegacy(const tinygltf::Model &model, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+        for (const tinygltf::Primitive &primitive : model.meshes[0].primitives) {
+            const uint32_t vertexStart = static_cast<uint32_t>(vertices.size());
+            const uint32_t vertexCount = static_cast<uint32_t>(model.accessors[primitive.attributes.at("POSITION")].count);
+
+            int stridePos, strideNorm, strideTangent, strideTexCoord0, strideJoints0, strideWeights0;
+            const float *bufferPos = accessorData<float>(model, primitive.attributes.at("POSITION"), stridePos);
+            const float *bufferNorm = accessorData<float>(model, primitive.attributes.at("NORMAL"), strideNorm);
+            const float *bufferTangent = accessorData<float>(model, primitive.attributes.at("TANGENT"), strideTangent);
+            const float *bufferTexCoord0 = accessorData<float>(model, primitive.attributes.at("TEXCOORD_0"), strideTexCoord0);
+            const uint16_t *bufferJoints0 = accessorData<uint16_t>(model, primitive.attributes.at("JOINTS_0"), strideJoints0);
+            const float *bufferWeights0 = accessorData<float>(model, primitive.attributes.at("WEIGHTS_0"), strideWeights0);
+            const int jointsComponentType = model.accessors[primitive.attributes.at("JOINTS_0")].componentType;
+
+            for (uint32_t vIdx = 0; vIdx < vertexCount; vIdx++) {
+                Vertex v{};
+                v.position = glm::make_vec3(&bufferPos[vIdx * stridePos]);
+                v.normal = glm::normalize(glm::make_vec3(&bufferNorm[vIdx * strideNorm]));
+                v.tangent = glm::normalize(glm::make_vec4(&bufferTangent[vIdx * strideTangent]));
+                v.uv0 = glm::make_vec2(&bufferTexCoord0[vIdx * strideTexCoord0]);
+                v.uv1 = glm::vec2{ 0.0f };
+                v.color = glm::vec3{ 1.0f };
+
+                switch (jointsComponentType) {
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                        v.joint = glm::make_vec4(&bufferJoints0[vIdx * strideJoints0]);
+                        break;
+                    }
+                    default: break;
+                }
+
+                v.weight = glm::make_vec4(&bufferWeights0[vIdx * strideWeights0]);
+                if (glm::length(v.weight) == 0.0f) v.weight = glm::vec4{ 1.0f, 0.0f, 0.0f, 0.0f };
+
+                vertices.push_back(v);
+            }
+
+            int strideIdx;
+            const uint32_t *castData = accessorData<uint32_t>(model, primitive.indices, strideIdx);
+            const uint32_t indexCount = static_cast<uint32_t>(model.accessors[primitive.indices].count);
+            for (uint32_t idx = 0; idx < indexCount; idx++) {
+                indices.push_back(castData[idx] + vertexStart);
+            }
+        }
+    }
+
+    bool verticesMatch(const Vertex &legacy, const Vertex &decoded) {
+        const glm::vec3 legacyTangent = glm::normalize(glm::vec3{ legacy.tangent });
+        const glm::vec3 tangent{ decoded.tangent };
+        return legacy.position == decoded.position && legacy.normal == decoded.normal &&
+            legacy.uv0 == decoded.uv0 && legacy.uv1 == decoded.uv1 && legacy.color == decoded.color &&
+            legacy.joint == decoded.joint && legacy.weight == decoded.weight &&
+            glm::length(legacyTangent - tangent) < 1e-5f && (legacy.tangent.w < 0.0f) == (decoded.tangent.w < 0.0f);
+    }
+
+}
+
+int main() {
+    const tinygltf::Model model = createModel();
+    SumiThreadPool threadPool;
+
+    std::vector<Vertex> legacyVertices;
+    std::vector<uint32_t> legacyIndices;
+    decodeLegacy(model, legacyVertices, legacyIndices);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    decodeSlices(model, vertices, indices, &threadPool);
+
+    bool passed = vertices.size() == legacyVertices.size() && indices == legacyIndices;
+    for (size_t i = 0; passed && i < vertices.size(); i++) passed = verticesMatch(legacyVertices[i], vertices[i]);
+    if (!benchmark::check(passed, "decoded slices differ from the original decode")) return EXIT_FAILURE;
+    std::cout << "Check: " << vertices.size() << " vertices and " << indices.size()
+        << " indices matched the original decode" << std::endl;
+
+    // Each run decodes into new arrays, as each load does.
+    constexpr uint32_t ITERATIONS = 5u;
+    const double legacyMs = benchmark::meanMicroseconds(ITERATIONS, [&]() {
+        std::vector<Vertex> v;
+        std::vector<uint32_t> i;
+        decodeLegacy(model, v, i);
+    }) / 1000.0;
+    const double slicesMs = benchmark::meanMicroseconds(ITERATIONS, [&]() {
+        std::vector<Vertex> v;
+        std::vector<uint32_t> i;
+        decodeSlices(model, v, i, nullptr);
+    }) / 1000.0;
+    const double parallelMs = benchmark::meanMicroseconds(ITERATIONS, [&]() {
+        std::vector<Vertex> v;
+        std::vector<uint32_t> i;
+        decodeSlices(model, v, i, &threadPool);
+    }) / 1000.0;
+
+    std::cout << "decode of " << vertices.size() << " vertices | ms" << std::endl;
+    std::cout << "original push_back loop | " << legacyMs << std::endl;
+    std::cout << "presized slices, calling thread | " << slicesMs << std::endl;
+    std::cout << "presized slices, " << threadPool.getThreadCount() << " pool threads + caller | " << parallelMs << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+#include "benchmark.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+* Joint upload bytes check and benchmark.
+*
+* Node and Mesh need a Vulkan device, so this replays the joint write scheme of SumiModel::writeNodes
+*  on a parent index skeleton: NodeHierarchy::propagate stamps every node whose world transform changed
+*  with the new node generation, and Node::update writes only joints stamped after the generation the
+*  frame in flight's joint buffer was last written at. World transforms are stood in for by one float
+*  per joint, the parent's value plus the local one.
+*
+* Check: after every write, each frame in flight's joint buffer must hold every joint's current world
+*  value, i.e. no skipped joint may be stale.
+*
+* Benchmark: joint bytes written per frame for a 65 joint humanoid under several animations, writing
+*  the whole palette (as before) and only the dirty joints.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    constexpr int MAX_FRAMES_IN_FLIGHT = 2;       // SumiSwapChain::MAX_FRAMES_IN_FLIGHT
+    constexpr uint64_t JOINT_SIZE = 128u;         // sizeof(Mesh::JointData)
+    constexpr uint64_t COMPACT_JOINT_SIZE = 32u;  // sizeof(Mesh::CompactJointData)
+    constexpr uint32_t NUM_FRAMES = 600u;
+    constexpr int32_t NO_PARENT = -1;
+
+    // Parents always precede children, as in NodeHierarchy.
+    struct Skeleton {
+        std::vector<int32_t> parents;
+        std::vector<std::string> names;
+
+        uint32_t add(const std::string &name, int32_t parent) {
+            parents.push_back(parent);
+            names.push_back(name);
+            return static_cast<uint32_t>(parents.size() - 1u);
+        }
+
+        uint32_t find(const std::string &name) const {
+            for (uint32_t i = 0; i < names.size(); i++) {
+                if (names[i] == name) return i;
+            }
+            return static_cast<uint32_t>(names.size());
+        }
+
+        bool isDescendant(uint32_t joint, uint32_t ancestor) const {
+            for (int32_t i = static_cast<int32_t>(joint); i != NO_PARENT; i = parents[i]) {
+                if (static_cast<uint32_t>(i) == ancestor) return true;
+            }
+            return false;
+        }
+    };
+
+    // A Mixamo style humanoid: spine & head, arms with five fingers of three bones and an end joint, and legs.
+    Skeleton createHumanoid() {
+        Skeleton skeleton;
+        const int32_t hips = skeleton.add("Hips", NO_PARENT);
+        const int32_t spine = skeleton.add("Spine", hips);
+        const int32_t spine1 = skeleton.add("Spine1", spine);
+        const int32_t spine2 = skeleton.add("Spine2", spine1);
+        const int32_t neck = skeleton.add("Neck", spine2);
+        const int32_t head = skeleton.add("Head", neck);
+        skeleton.add("HeadTop_End", head);
+
+        for (const std::string side : { "Left", "Right" }) {
+            const int32_t shoulder = skeleton.add(side + "Shoulder", spine2);
+            const int32_t arm = skeleton.add(side + "Arm", shoulder);
+            const int32_t foreArm = skeleton.add(side + "ForeArm", arm);
+            const int32_t hand = skeleton.add(side + "Hand", foreArm);
+            for (const std::string finger : { "Thumb", "Index", "Middle", "Ring", "Pinky" }) {
+                int32_t parent = hand;
+                for (int bone = 1; bone <= 4; bone++) {
+                    parent = skeleton.add(side + "Hand" + finger + std::to_string(bone), parent);
+                }
+            }
+        }
+
+        for (const std::string side : { "Left", "Right" }) {
+            const int32_t upLeg = skeleton.add(side + "UpLeg", hips);
+            const int32_t leg = skeleton.add(side + "Leg", upLeg);
+            const int32_t foot = skeleton.add(side + "Foot", leg);
+            const int32_t toe = skeleton.add(side + "ToeBase", foot);
+            skeleton.add(side + "Toe_End", toe);
+        }
+
+        return skeleton;
+    }
+
+    struct Scenario {
+        const char *name;
+        // Whether joint's local transform is animated in frame
+        std::function<bool(uint32_t joint, uint32_t frame)> animates;
+    };
+
+    // Joints written over all frames
+    struct JointWrites {
+        uint64_t wholePalette = 0u;
+        uint64_t dirtyJoints = 0u;
+        uint32_t staleJoints = 0u;
+    };
+
+    JointWrites runScenario(const Skeleton &skeleton, const Scenario &scenario) {
+        const uint32_t nJoints = static_cast<uint32_t>(skeleton.parents.size());
+        std::mt19937 rng{ 13u };
+        std::uniform_real_distribution<float> motionDist{ -1.0f, 1.0f };
+
+        std::vector<float> locals(nJoints, 0.0f);
+        std::vector<float> worlds(nJoints, 0.0f);
+        std::vector<uint64_t> worldGenerations(nJoints, 0u);
+        std::vector<uint8_t> worldChanged(nJoints, 0u);
+        std::vector<std::vector<float>> jointBuffers(MAX_FRAMES_IN_FLIGHT, std::vector<float>(nJoints, 0.0f));
+        std::vector<uint64_t> frameNodeGenerations(MAX_FRAMES_IN_FLIGHT, 0u);
+        uint64_t nodeGeneration = 0u;
+        bool fullUpdate = true;
+
+        JointWrites writes;
+        for (uint32_t frame = 0; frame < NUM_FRAMES; frame++) {
+            const int frameIdx = static_cast<int>(frame % MAX_FRAMES_IN_FLIGHT);
+
+            // Animation::sample
+            std::vector<uint8_t> localChanged(nJoints, fullUpdate ? 1u : 0u);
+            for (uint32_t j = 0; j < nJoints; j++) {
+                if (!scenario.animates(j, frame)) continue;
+                locals[j] = motionDist(rng);
+                localChanged[j] = 1u;
+            }
+
+            // NodeHierarchy::propagate
+            bool anyChanged = false;
+            for (uint32_t j = 0; j < nJoints; j++) {
+                const int32_t parent = skeleton.parents[j];
+                const bool changed = localChanged[j] || (parent != NO_PARENT && worldChanged[parent]);
+                worldChanged[j] = changed ? 1u : 0u;
+                if (!changed) continue;
+
+                worlds[j] = (parent != NO_PARENT ? worlds[parent] : 0.0f) + locals[j];
+                worldGenerations[j] = nodeGeneration + 1u;
+                anyChanged = true;
+            }
+            fullUpdate = false;
+            if (anyChanged) nodeGeneration++;
+
+            // SumiModel::commitAnimatedNodes, then Node::update for the skinned mesh. The mesh node is not
+            //  under the skeleton, so it never moves.
+            const uint64_t sinceGeneration = frameNodeGenerations[frameIdx];
+            if (sinceGeneration == nodeGeneration) continue;
+
+            std::vector<float> &jointBuffer = jointBuffers[frameIdx];
+            uint32_t nDirty = 0u;
+            for (uint32_t j = 0; j < nJoints; j++) {
+                if (sinceGeneration != 0u && worldGenerations[j] <= sinceGeneration) continue;
+                jointBuffer[j] = worlds[j];
+                nDirty++;
+            }
+            frameNodeGenerations[frameIdx] = nodeGeneration;
+
+            writes.wholePalette += nJoints;
+            writes.dirtyJoints += nDirty;
+            for (uint32_t j = 0; j < nJoints; j++) {
+                if (jointBuffer[j] != worlds[j]) writes.staleJoints++;
+            }
+        }
+
+        return writes;
+    }
+
+}
+
+int main() {
+    const Skeleton skeleton = createHumanoid();
+    const uint32_t nJoints = static_cast<uint32_t>(skeleton.parents.size());
+
+    const uint32_t spine2 = skeleton.find("Spine2");
+    const uint32_t leftHand = skeleton.find("LeftHand");
+    const uint32_t rightHand = skeleton.find("RightHand");
+    const uint32_t rightShoulder = skeleton.find("RightShoulder");
+    const uint32_t head = skeleton.find("Head");
+    const uint32_t headTop = skeleton.find("HeadTop_End");
+
+    const std::vector<Scenario> scenarios{
+        { "walk cycle, every joint keyed", [&](uint32_t, uint32_t) {
+            return true;
+        } },
+        { "waving right arm, rest of the body held", [&](uint32_t joint, uint32_t) {
+            return skeleton.isDescendant(joint, rightShoulder);
+        } },
+        { "finger poses only", [&](uint32_t joint, uint32_t) {
+            return joint != leftHand && joint != rightHand &&
+                (skeleton.isDescendant(joint, leftHand) || skeleton.isDescendant(joint, rightHand));
+        } },
+        { "head look-at only", [&](uint32_t joint, uint32_t) {
+            return joint == head || joint == headTop;
+        } },
+        { "idle breathing on Spine2", [&](uint32_t joint, uint32_t) {
+            return joint == spine2;
+        } },
+        { "gesture for 1s in every 5s", [&](uint32_t joint, uint32_t frame) {
+            return frame % 300u < 60u && skeleton.isDescendant(joint, rightShoulder);
+        } },
+    };
+
+    std::vector<JointWrites> results;
+    for (const Scenario &scenario : scenarios) {
+        results.push_back(runScenario(skeleton, scenario));
+        if (!benchmark::check(results.back().staleJoints == 0u, "a joint buffer kept a stale joint")) {
+            return EXIT_FAILURE;
+        }
+    }
+    std::cout << "Check: every frame in flight's joints were current after each write" << std::endl;
+
+    std::cout << nJoints << " joints, " << NUM_FRAMES << " frames, " << MAX_FRAMES_IN_FLIGHT
+        << " frames in flight" << std::endl;
+    std::cout << "animation | whole palette (bytes/frame, full | compact) | dirty joints (bytes/frame, full | compact)"
+        << std::endl;
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        const double wholePalette = static_cast<double>(results[i].wholePalette) / NUM_FRAMES;
+        const double dirtyJoints = static_cast<double>(results[i].dirtyJoints) / NUM_FRAMES;
+        std::cout << scenarios[i].name << " | "
+            << wholePalette * JOINT_SIZE << " | " << wholePalette * COMPACT_JOINT_SIZE << " | "
+            << dirtyJoints * JOINT_SIZE << " | " << dirtyJoints * COMPACT_JOINT_SIZE << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
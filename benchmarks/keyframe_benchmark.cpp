@@ -0,0 +1,188 @@
+#include "benchmark.hpp"
+
+#include <sumire/core/models/animation_sampler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* AnimationSampler keyframe lookup check and benchmark.
+*
+* A model update samples every channel of a clip at the playback time, as SumiModel::updateAnimation
+*  does before writing the nodes. Clips of 100, 10k and 100k keys per channel are played forward at
+*  60 updates per second, looping at the end, with the cached cursor lookup and with the original
+*  linear scan over every keyframe pair.
+*
+* Check: the cursor must find the same keyframe interval as the linear scan on every channel of every
+*  update, including at exact keyframe times and across loops.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    constexpr uint32_t NUM_NODES    = 20u;
+    constexpr uint32_t NUM_CHANNELS = NUM_NODES * 3u; // Translation, rotation & scale per node
+    constexpr float KEY_INTERVAL    = 1.0f / 120.0f;  // Mocap rate
+    constexpr float UPDATE_INTERVAL = 1.0f / 60.0f;
+
+    struct Clip {
+        std::vector<AnimationChannel> channels;
+        std::vector<AnimationSampler> samplers;
+        float start = 0.0f;
+        float end = 0.0f;
+    };
+
+    Clip createClip(std::mt19937& rng, uint32_t numKeys) {
+        std::uniform_real_distribution<float> valueDist{ -1.0f, 1.0f };
+        std::uniform_real_distribution<float> jitterDist{ 0.0f, 0.5f * KEY_INTERVAL };
+
+        Clip clip;
+        clip.channels.resize(NUM_CHANNELS);
+        clip.samplers.resize(NUM_CHANNELS);
+
+        for (uint32_t c = 0; c < NUM_CHANNELS; c++) {
+            AnimationChannel& channel = clip.channels[c];
+            channel.path = static_cast<AnimationChannel::PathType>(c % 3u);
+            channel.node = nullptr;
+            channel.nodeIdx = c / 3u;
+            channel.samplerIdx = c;
+
+            // Keys are jittered so channels do not share keyframe times.
+            AnimationSampler& sampler = clip.samplers[c];
+            sampler.interpolation = util::INTERP_LINEAR;
+            sampler.inputs.resize(numKeys);
+            sampler.outputs.resize(numKeys);
+            for (uint32_t k = 0; k < numKeys; k++) {
+                sampler.inputs[k] = static_cast<float>(k) * KEY_INTERVAL + (k > 0u ? jitterDist(rng) : 0.0f);
+                sampler.outputs[k] = glm::vec4{ valueDist(rng), valueDist(rng), valueDist(rng), valueDist(rng) };
+            }
+            // Every channel spans the whole clip, so looping exercises every cursor.
+            sampler.inputs.back() = static_cast<float>(numKeys - 1u) * KEY_INTERVAL;
+        }
+
+        clip.end = static_cast<float>(numKeys - 1u) * KEY_INTERVAL;
+        return clip;
+    }
+
+    // The original lookup: every keyframe pair is tested, and the last one containing time is used.
+    bool findKeyframeLinear(const AnimationSampler& sampler, float time, uint32_t& keyframe) {
+        bool found = false;
+        for (size_t i = 0; i < sampler.inputs.size() - 1; i++) {
+            if (time < sampler.inputs[i] || time > sampler.inputs[i + 1]) continue;
+            keyframe = static_cast<uint32_t>(i);
+            found = true;
+        }
+        return found;
+    }
+
+    // The original interpolation for linear keyframes, as AnimationSampler::sample() for a found keyframe.
+    glm::vec4 sampleLinear(const AnimationSampler& sampler, AnimationChannel::PathType path, uint32_t i, float time) {
+        const float u = std::max(0.0f, time - sampler.inputs[i]) / (sampler.inputs[i + 1] - sampler.inputs[i]);
+        const glm::vec4& output0 = sampler.outputs[i];
+        const glm::vec4& output1 = sampler.outputs[i + 1];
+
+        if (path == AnimationChannel::PathType::ROTATION) {
+            glm::quat q0{ output0.w, output0.x, output0.y, output0.z };
+            glm::quat q1{ output1.w, output1.x, output1.y, output1.z };
+            glm::quat q = util::interpQuat(q0, q0, q1, q1, u, sampler.interpolation);
+            return glm::vec4{ q.x, q.y, q.z, q.w };
+        }
+        return util::interpVec4(output0, output0, output1, output1, u, sampler.interpolation);
+    }
+
+    // Playback time after update n, looped over the clip.
+    float playbackTime(const Clip& clip, uint32_t n) {
+        const float duration = clip.end - clip.start;
+        return clip.start + std::fmod(static_cast<float>(n) * UPDATE_INTERVAL, duration);
+    }
+
+    bool runCheck(const Clip& clip, uint32_t numUpdates) {
+        std::vector<uint32_t> cursors(NUM_CHANNELS, 0u);
+        uint32_t mismatches = 0u;
+
+        auto checkAt = [&](float time) {
+            for (uint32_t c = 0; c < NUM_CHANNELS; c++) {
+                const AnimationSampler& sampler = clip.samplers[c];
+                uint32_t expected = 0u;
+                uint32_t found = 0u;
+                const bool expectedFound = findKeyframeLinear(sampler, time, expected);
+                const bool cursorFound = sampler.findKeyframe(time, cursors[c], found);
+                if (expectedFound != cursorFound || (expectedFound && expected != found)) mismatches++;
+            }
+        };
+
+        for (uint32_t n = 0; n < numUpdates; n++) checkAt(playbackTime(clip, n));
+        // Exact keyframe times pick the later interval, as the linear scan did.
+        const std::vector<float>& keyTimes = clip.samplers[0].inputs;
+        const size_t keyStride = std::max<size_t>(1u, keyTimes.size() / 64u);
+        for (size_t k = 0; k < keyTimes.size(); k += keyStride) checkAt(keyTimes[k]);
+        checkAt(keyTimes.back());
+
+        return mismatches == 0u;
+    }
+
+    // Keeps the sampled values from being optimized away.
+    volatile float valueSink = 0.0f;
+
+    void runBenchmark(uint32_t numKeys, const Clip& clip) {
+        // The linear scan is given a similar total number of keyframe tests at every key count.
+        const uint32_t cursorUpdates = 20000u;
+        const uint32_t linearUpdates = std::max(10u, 20000000u / (NUM_CHANNELS * numKeys));
+
+        std::vector<uint32_t> cursors(NUM_CHANNELS, 0u);
+        glm::vec4 sink{ 0.0f };
+
+        uint32_t n = 0u;
+        const double cursorUs = benchmark::meanMicroseconds(cursorUpdates, [&]() {
+            const float time = playbackTime(clip, n++);
+            for (uint32_t c = 0; c < NUM_CHANNELS; c++) {
+                const AnimationChannel& channel = clip.channels[c];
+                glm::vec4 value;
+                if (clip.samplers[channel.samplerIdx].sample(time, channel.path, cursors[c], value)) sink += value;
+            }
+        });
+
+        n = 0u;
+        const double linearUs = benchmark::meanMicroseconds(linearUpdates, [&]() {
+            const float time = playbackTime(clip, n++);
+            for (uint32_t c = 0; c < NUM_CHANNELS; c++) {
+                const AnimationChannel& channel = clip.channels[c];
+                const AnimationSampler& sampler = clip.samplers[channel.samplerIdx];
+                uint32_t keyframe;
+                if (findKeyframeLinear(sampler, time, keyframe)) sink += sampleLinear(sampler, channel.path, keyframe, time);
+            }
+        });
+
+        valueSink = sink.x + sink.y + sink.z + sink.w;
+
+        std::cout << numKeys << " | " << linearUs << " | " << cursorUs << " | " << linearUs / cursorUs << "x" << std::endl;
+    }
+
+}
+
+int main() {
+    std::mt19937 rng{ 3u };
+
+    std::vector<uint32_t> keyCounts{ 100u, 10000u, 100000u };
+    std::vector<Clip> clips;
+    for (uint32_t numKeys : keyCounts) clips.push_back(createClip(rng, numKeys));
+
+    for (size_t i = 0; i < clips.size(); i++) {
+        // The 100 key clip lasts 0.8s, so 2000 updates loop it many times.
+        const uint32_t numUpdates = keyCounts[i] >= 100000u ? 200u : 2000u;
+        if (!benchmark::check(runCheck(clips[i], numUpdates), "cursor keyframes differ from the linear scan")) {
+            return EXIT_FAILURE;
+        }
+    }
+    std::cout << "Check: cursor lookup matched the linear scan on every channel and update" << std::endl;
+
+    std::cout << "keys per channel (" << NUM_CHANNELS << " channels) | linear scan (us per update)"
+        << " | cursor (us per update) | speedup" << std::endl;
+    for (size_t i = 0; i < clips.size(); i++) runBenchmark(keyCounts[i], clips[i]);
+
+    return EXIT_SUCCESS;
+}
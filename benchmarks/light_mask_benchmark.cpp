@@ -0,0 +1,237 @@
+#include "benchmark.hpp"
+
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_mask_builder.hpp>
+#include <sumire/core/rendering/general/sumi_camera.hpp>
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+#include <sumire/math/coord_space_converters.hpp>
+#include <sumire/math/frustum_culling.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* LightMaskBuilder check and benchmark.
+*
+* Lights are scattered in and around the view frustum of the default 50 degree perspective camera, and
+*  sorted by min depth as LightSorter does.
+*
+* Check: every tile of each built mask must hold exactly the lights of the original scalar cull in
+*  HighQualityShadowMapper::generateLightMask(), i.e. FrustumPlane::intersectSphere against tile planes
+*  built per tile from the projection, plus the near and far tests. Builds are repeated with new lights
+*  and the same camera (cached tile planes), after a projection change and after a resize, on the
+*  calling thread and on a SumiThreadPool, so that stale tile planes would be caught.
+*
+* Benchmark: the original scalar cull against the builder with its tile planes rebuilt every frame,
+*  with them cached across frames, and with them cached and tile rows on a SumiThreadPool, for several
+*  light counts and screen sizes.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    constexpr float TILE_SIZE = LightMaskBuilder::TILE_SIZE;
+
+    std::vector<structs::viewSpaceLight> randomLights(std::mt19937& rng, uint32_t count, const SumiCamera& camera) {
+        // Somewhat wider and deeper than the frustum, so that tiles' edges and the near and far tests are hit.
+        const float halfHeight = glm::tan(camera.getFovy() * 0.5f) * 1.2f;
+        const float halfWidth  = halfHeight * camera.getAspect();
+        std::uniform_real_distribution<float> depthDist{ -5.0f, camera.getFar() * 0.1f };
+        std::uniform_real_distribution<float> offsetDist{ -1.0f, 1.0f };
+        std::uniform_real_distribution<float> rangeDist{ 0.5f, 10.0f };
+
+        std::vector<structs::viewSpaceLight> lights(count);
+        for (uint32_t i = 0; i < count; i++) {
+            structs::viewSpaceLight& light = lights[i];
+            const float depth = depthDist(rng);
+            const float extent = glm::max(depth, 1.0f);
+
+            light.slot = i;
+            light.range = rangeDist(rng);
+            light.viewSpacePosition = glm::vec3{
+                offsetDist(rng) * halfWidth * extent, offsetDist(rng) * halfHeight * extent, -depth };
+            light.viewSpaceDepth = depth;
+            light.minDepth = depth - light.range;
+            light.maxDepth = depth + light.range;
+        }
+
+        std::sort(lights.begin(), lights.end(), [](const auto& a, const auto& b) {
+            return a.minDepth < b.minDepth;
+        });
+        return lights;
+    }
+
+    // The original generateLightMask() cull, into a dense light bitset per tile.
+    void cullReference(
+        std::span<const structs::viewSpaceLight> lights,
+        const SumiCamera& camera,
+        glm::uvec2 screenDim,
+        const structs::lightMask& lightMask,
+        std::vector<uint32_t>& tileBits
+    ) {
+        const uint32_t wordsPerTile = (static_cast<uint32_t>(lights.size()) + 31u) / 32u;
+        tileBits.assign(static_cast<size_t>(lightMask.numTiles()) * wordsPerTile, 0u);
+
+        constexpr glm::vec3 origin = glm::vec3(0.0f);
+        const float near = camera.getNear();
+        const float far  = camera.getFar();
+        const glm::vec2 screenDimF{ screenDim };
+        const glm::mat4 invProjection = glm::inverse(camera.getProjectionMatrix());
+
+        for (uint32_t frustumX = 0; frustumX < lightMask.numTilesX; frustumX++) {
+            for (uint32_t frustumY = 0; frustumY < lightMask.numTilesY; frustumY++) {
+                uint32_t* bits = &tileBits[static_cast<size_t>(lightMask.tileIdx(frustumX, frustumY)) * wordsPerTile];
+
+                const glm::vec4 screenTopL = { TILE_SIZE * glm::vec2{  frustumX  , frustumY  }, -1.0f, 1.0f };
+                const glm::vec4 screenTopR = { TILE_SIZE * glm::vec2{  frustumX+1, frustumY  }, -1.0f, 1.0f };
+                const glm::vec4 screenBotL = { TILE_SIZE * glm::vec2{  frustumX  , frustumY+1}, -1.0f, 1.0f };
+                const glm::vec4 screenBotR = { TILE_SIZE * glm::vec2{  frustumX+1, frustumY+1}, -1.0f, 1.0f };
+
+                const glm::vec3 viewTopL = glm::vec3(screenToView(screenTopL, screenDimF, invProjection));
+                const glm::vec3 viewTopR = glm::vec3(screenToView(screenTopR, screenDimF, invProjection));
+                const glm::vec3 viewBotL = glm::vec3(screenToView(screenBotL, screenDimF, invProjection));
+                const glm::vec3 viewBotR = glm::vec3(screenToView(screenBotR, screenDimF, invProjection));
+
+                const FrustumPlane tileFrustumT = computeFrustumPlane(origin, viewTopR, viewTopL);
+                const FrustumPlane tileFrustumB = computeFrustumPlane(origin, viewBotL, viewBotR);
+                const FrustumPlane tileFrustumR = computeFrustumPlane(origin, viewBotR, viewTopR);
+                const FrustumPlane tileFrustumL = computeFrustumPlane(origin, viewTopL, viewBotL);
+
+                for (uint32_t i = 0; i < lights.size(); i++) {
+                    const float r = lights[i].range;
+                    const glm::vec3 p = lights[i].viewSpacePosition;
+
+                    const bool intersects = (
+                        tileFrustumT.intersectSphere(p, r) &&
+                        tileFrustumB.intersectSphere(p, r) &&
+                        tileFrustumL.intersectSphere(p, r) &&
+                        tileFrustumR.intersectSphere(p, r) &&
+                        lights[i].viewSpaceDepth + r > near &&
+                        lights[i].viewSpaceDepth - r < far
+                    );
+
+                    if (intersects) bits[i / 32u] |= 1u << (i % 32u);
+                }
+            }
+        }
+    }
+
+    // Number of tiles whose lights differ from the reference, or all tiles if the mask is malformed.
+    uint32_t countMismatchedTiles(
+        const structs::lightMask& lightMask, std::span<const uint32_t> tileBits, uint32_t numLights
+    ) {
+        if (lightMask.words.empty() || lightMask.words[0] != lightMask.words.size()) return lightMask.numTiles();
+
+        const uint32_t wordsPerTile = (numLights + 31u) / 32u;
+        std::vector<uint32_t> bits(wordsPerTile);
+        uint32_t mismatched = 0u;
+
+        for (uint32_t tileIdx = 0; tileIdx < lightMask.numTiles(); tileIdx++) {
+            std::fill(bits.begin(), bits.end(), 0u);
+            bool inRange = true;
+            lightMask.forEachGroup(tileIdx, [&](uint32_t group, uint32_t lightBits) {
+                if (group < wordsPerTile) bits[group] = lightBits;
+                else inRange = false;
+            });
+
+            const uint32_t* expected = &tileBits[static_cast<size_t>(tileIdx) * wordsPerTile];
+            if (!inRange || !std::equal(bits.begin(), bits.end(), expected)) mismatched++;
+        }
+        return mismatched;
+    }
+
+    bool runCheck(SumiThreadPool& threadPool) {
+        constexpr uint32_t FRAMES_PER_VIEW = 4u;
+
+        std::mt19937 rng{ 5u };
+        uint32_t numBuilds = 0u;
+        uint32_t failedBuilds = 0u;
+
+        for (SumiThreadPool* pool : { static_cast<SumiThreadPool*>(nullptr), &threadPool }) {
+            for (uint32_t numLights : { 0u, 1u, 31u, 33u, 1000u, 4099u }) {
+                LightMaskBuilder builder;
+                SumiCamera camera{ glm::radians(50.0f), 16.0f / 9.0f };
+
+                // Frames at one size and projection, then after a projection change, then after a resize
+                //  to the same aspect, without invalidateTilePlanes() so that the builder must notice it.
+                struct View { glm::uvec2 screenDim; float fovy; };
+                for (const View view : {
+                    View{ { 1280u, 720u }, 50.0f }, View{ { 1280u, 720u }, 70.0f }, View{ { 1024u, 576u }, 70.0f } }
+                ) {
+                    camera.setFovy(glm::radians(view.fovy));
+                    camera.setAspect(static_cast<float>(view.screenDim.x) / static_cast<float>(view.screenDim.y));
+                    camera.calculateProjectionMatrix();
+
+                    structs::lightMask lightMask{ view.screenDim.x, view.screenDim.y };
+                    std::vector<uint32_t> tileBits;
+                    for (uint32_t frame = 0; frame < FRAMES_PER_VIEW; frame++) {
+                        const std::vector<structs::viewSpaceLight> lights = randomLights(rng, numLights, camera);
+                        builder.build(lights, camera, view.screenDim, lightMask, pool);
+                        cullReference(lights, camera, view.screenDim, lightMask, tileBits);
+
+                        numBuilds++;
+                        if (countMismatchedTiles(lightMask, tileBits, numLights) != 0u) failedBuilds++;
+                    }
+                }
+            }
+        }
+
+        std::cout << "Check: " << numBuilds << " builds against FrustumPlane::intersectSphere, "
+            << failedBuilds << " failed" << std::endl;
+        return benchmark::check(failedBuilds == 0u, "light masks differ from the scalar reference cull");
+    }
+
+    void runBenchmark(SumiThreadPool& threadPool) {
+        // Roughly the same number of light-tile tests per configuration.
+        constexpr double TESTS_PER_CONFIGURATION = 2e9;
+
+        std::mt19937 rng{ 13u };
+
+        const char* cullPath = LightMaskBuilder::usesSimd() ? "SSE" : "scalar fallback";
+        std::cout << "lights | screen | original (us) | " << cullPath << ", planes rebuilt (us) | "
+            << cullPath << ", planes cached (us) | cached, " << threadPool.getThreadCount()
+            << " pool threads + caller (us)" << std::endl;
+
+        for (const glm::uvec2 screenDim : { glm::uvec2{ 1280u, 720u }, glm::uvec2{ 1920u, 1080u }, glm::uvec2{ 3840u, 2160u } }) {
+            SumiCamera camera{ glm::radians(50.0f), static_cast<float>(screenDim.x) / static_cast<float>(screenDim.y) };
+            structs::lightMask lightMask{ screenDim.x, screenDim.y };
+
+            for (uint32_t numLights : { 256u, 1024u, 4096u, 16384u }) {
+                const std::vector<structs::viewSpaceLight> lights = randomLights(rng, numLights, camera);
+                const double tests = static_cast<double>(numLights) * lightMask.numTiles();
+                const uint32_t iterations = static_cast<uint32_t>(glm::clamp(TESTS_PER_CONFIGURATION / tests / 100.0, 1.0, 200.0));
+
+                std::vector<uint32_t> tileBits;
+                const double referenceUs = benchmark::meanMicroseconds(iterations, [&]() {
+                    cullReference(lights, camera, screenDim, lightMask, tileBits);
+                });
+
+                LightMaskBuilder builder;
+                const double rebuiltUs = benchmark::meanMicroseconds(iterations, [&]() {
+                    builder.invalidateTilePlanes();
+                    builder.build(lights, camera, screenDim, lightMask, nullptr);
+                });
+                const double cachedUs = benchmark::meanMicroseconds(iterations, [&]() {
+                    builder.build(lights, camera, screenDim, lightMask, nullptr);
+                });
+                const double pooledUs = benchmark::meanMicroseconds(iterations, [&]() {
+                    builder.build(lights, camera, screenDim, lightMask, &threadPool);
+                });
+
+                std::cout << numLights << " | " << screenDim.x << "x" << screenDim.y << " | " << referenceUs << " | "
+                    << rebuiltUs << " | " << cachedUs << " | " << pooledUs << std::endl;
+            }
+        }
+    }
+
+}
+
+int main() {
+    SumiThreadPool threadPool;
+
+    if (!runCheck(threadPool)) return EXIT_FAILURE;
+    runBenchmark(threadPool);
+    return EXIT_SUCCESS;
+}
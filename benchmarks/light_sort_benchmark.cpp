@@ -0,0 +1,213 @@
+#include "benchmark.hpp"
+
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_sorter.hpp>
+#include <sumire/core/rendering/general/sumi_camera.hpp>
+#include <sumire/core/rendering/lighting/sumi_light_store.hpp>
+#include <sumire/math/view_space_depth.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* LightSorter check and benchmark.
+*
+* Point lights are scattered in a box around a camera at the origin, which either turns a little each
+*  frame (coherent frames, as when looking around) or faces a random direction each frame.
+*
+* Check: every sort must give the same lights in the same order as the original
+*  HighQualityShadowMapper::sortLightsByViewSpaceDepth(), i.e. calculateOrthogonalViewSpaceDepth() per
+*  light and a std::sort by min depth. Lights with equal min depths may be in either order. Frames are
+*  sorted coherently, after lights are added and removed, and from random directions.
+*
+* Benchmark: the original std::sort path against LightSorter over coherent and random frames, for 256,
+*  1024 and 16k lights.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    constexpr float SCENE_EXTENT = 200.0f;
+    // Camera turn per coherent frame, in radians
+    constexpr float COHERENT_TURN = 0.01f;
+
+    void addRandomLights(std::mt19937& rng, SumiLightStore& store, uint32_t count) {
+        std::uniform_real_distribution<float> posDist{ -SCENE_EXTENT, SCENE_EXTENT };
+        std::uniform_real_distribution<float> rangeDist{ 0.5f, 10.0f };
+
+        for (uint32_t i = 0; i < count; i++) {
+            SumiLight light = SumiLight::createPointLight(glm::vec3{ posDist(rng), posDist(rng), posDist(rng) });
+            light.range = rangeDist(rng);
+            store.add(light);
+        }
+    }
+
+    glm::mat4 viewMatrix(glm::vec3 rotation) {
+        SumiCamera camera{ glm::radians(50.0f), 16.0f / 9.0f };
+        camera.setViewYXZ(glm::vec3{ 0.0f }, rotation);
+        return camera.getViewMatrix();
+    }
+
+    // The original sortLightsByViewSpaceDepth(), with lights read from the store.
+    std::vector<structs::viewSpaceLight> sortLegacy(const SumiLightStore& store, const glm::mat4& view) {
+        auto lights = std::vector<structs::viewSpaceLight>();
+        for (uint32_t slot = 0; slot < store.size(); slot++) {
+            structs::viewSpaceLight viewSpaceLight{};
+            viewSpaceLight.slot = slot;
+            viewSpaceLight.range = store.getRange(slot);
+
+            viewSpaceLight.viewSpaceDepth = calculateOrthogonalViewSpaceDepth(
+                store.getPosition(slot),
+                view,
+                &viewSpaceLight.viewSpacePosition
+            );
+            viewSpaceLight.minDepth = viewSpaceLight.viewSpaceDepth - viewSpaceLight.range;
+            viewSpaceLight.maxDepth = viewSpaceLight.viewSpaceDepth + viewSpaceLight.range;
+
+            lights.push_back(viewSpaceLight);
+        }
+
+        std::sort(lights.begin(), lights.end(),
+            [](const structs::viewSpaceLight& a, const structs::viewSpaceLight& b) {
+                return a.minDepth < b.minDepth;
+            }
+        );
+
+        return lights;
+    }
+
+    // Same lights in the same order, except within runs of equal min depth, which std::sort leaves in any order.
+    bool ordersMatch(std::span<const structs::viewSpaceLight> legacy, std::span<const structs::viewSpaceLight> sorted) {
+        if (legacy.size() != sorted.size()) return false;
+
+        auto bySlot = [](const structs::viewSpaceLight& a, const structs::viewSpaceLight& b) { return a.slot < b.slot; };
+        std::vector<structs::viewSpaceLight> legacyRun;
+        std::vector<structs::viewSpaceLight> sortedRun;
+
+        for (size_t first = 0; first < legacy.size();) {
+            size_t last = first + 1;
+            while (last < legacy.size() && legacy[last].minDepth == legacy[first].minDepth) last++;
+
+            legacyRun.assign(legacy.begin() + first, legacy.begin() + last);
+            sortedRun.assign(sorted.begin() + first, sorted.begin() + last);
+            std::sort(legacyRun.begin(), legacyRun.end(), bySlot);
+            std::sort(sortedRun.begin(), sortedRun.end(), bySlot);
+
+            for (size_t i = 0; i < legacyRun.size(); i++) {
+                const structs::viewSpaceLight& a = legacyRun[i];
+                const structs::viewSpaceLight& b = sortedRun[i];
+                if (
+                    a.slot              != b.slot              ||
+                    a.range             != b.range             ||
+                    a.viewSpacePosition != b.viewSpacePosition ||
+                    a.viewSpaceDepth    != b.viewSpaceDepth    ||
+                    a.minDepth          != b.minDepth          ||
+                    a.maxDepth          != b.maxDepth
+                ) return false;
+            }
+            first = last;
+        }
+        return true;
+    }
+
+    bool runCheck() {
+        constexpr uint32_t FRAMES_PER_PHASE = 8u;
+
+        std::mt19937 rng{ 3u };
+        std::uniform_real_distribution<float> angleDist{ -glm::pi<float>(), glm::pi<float>() };
+        uint32_t numSorts = 0u;
+        uint32_t failedSorts = 0u;
+
+        for (uint32_t numLights : { 0u, 1u, 31u, 33u, 256u, 1024u, 16384u }) {
+            SumiLightStore store;
+            addRandomLights(rng, store, numLights);
+
+            LightSorter sorter;
+            glm::vec3 rotation{ 0.0f };
+
+            auto checkFrame = [&]() {
+                const glm::mat4 view = viewMatrix(rotation);
+                numSorts++;
+                if (!ordersMatch(sortLegacy(store, view), sorter.sort(store, view))) failedSorts++;
+            };
+
+            // Coherent frames, reusing the previous order
+            for (uint32_t frame = 0; frame < FRAMES_PER_PHASE; frame++) {
+                rotation.y += COHERENT_TURN;
+                checkFrame();
+            }
+
+            // Lights added and removed, which moves slots and so invalidates the previous order
+            for (uint32_t frame = 0; frame < FRAMES_PER_PHASE && numLights > 0u; frame++) {
+                store.remove(store.idAt(rng() % store.size()));
+                addRandomLights(rng, store, 1u);
+                checkFrame();
+            }
+
+            // Random directions, so that repairing the previous order gives up
+            for (uint32_t frame = 0; frame < FRAMES_PER_PHASE; frame++) {
+                rotation = glm::vec3{ angleDist(rng) * 0.5f, angleDist(rng), 0.0f };
+                checkFrame();
+            }
+        }
+
+        std::cout << "Check: " << numSorts << " sorts against std::sort, " << failedSorts << " failed" << std::endl;
+        return benchmark::check(failedSorts == 0u, "LightSorter orders differ from the std::sort path");
+    }
+
+    void runBenchmark() {
+        constexpr uint32_t NUM_VIEWS = 64u;
+
+        std::mt19937 rng{ 17u };
+        std::uniform_real_distribution<float> angleDist{ -glm::pi<float>(), glm::pi<float>() };
+
+        // Views are built ahead of time so that only the sorts are timed. Coherent views turn one way
+        //  and then back, so that they stay coherent when wrapping around.
+        std::vector<glm::mat4> coherentViews(NUM_VIEWS);
+        std::vector<glm::mat4> randomViews(NUM_VIEWS);
+        for (uint32_t i = 0; i < NUM_VIEWS; i++) {
+            coherentViews[i] = viewMatrix(glm::vec3{ 0.0f, COHERENT_TURN * glm::min(i, NUM_VIEWS - i), 0.0f });
+            randomViews[i] = viewMatrix(glm::vec3{ angleDist(rng) * 0.5f, angleDist(rng), 0.0f });
+        }
+
+        std::cout << "lights | std::sort, coherent (us) | LightSorter, coherent (us) | "
+            << "std::sort, random (us) | LightSorter, random (us)" << std::endl;
+
+        for (uint32_t numLights : { 256u, 1024u, 16384u }) {
+            SumiLightStore store;
+            addRandomLights(rng, store, numLights);
+            const uint32_t iterations = glm::max(10000000u / numLights, NUM_VIEWS);
+
+            auto timeLegacy = [&](const std::vector<glm::mat4>& views) {
+                uint32_t frame = 0u;
+                return benchmark::meanMicroseconds(iterations, [&]() {
+                    const std::vector<structs::viewSpaceLight> lights = sortLegacy(store, views[frame++ % NUM_VIEWS]);
+                });
+            };
+            auto timeSorter = [&](const std::vector<glm::mat4>& views) {
+                LightSorter sorter;
+                uint32_t frame = 0u;
+                return benchmark::meanMicroseconds(iterations, [&]() {
+                    sorter.sort(store, views[frame++ % NUM_VIEWS]);
+                });
+            };
+
+            const double legacyCoherentUs = timeLegacy(coherentViews);
+            const double sorterCoherentUs = timeSorter(coherentViews);
+            const double legacyRandomUs = timeLegacy(randomViews);
+            const double sorterRandomUs = timeSorter(randomViews);
+
+            std::cout << numLights << " | " << legacyCoherentUs << " | " << sorterCoherentUs << " | "
+                << legacyRandomUs << " | " << sorterRandomUs << std::endl;
+        }
+    }
+
+}
+
+int main() {
+    if (!runCheck()) return EXIT_FAILURE;
+    runBenchmark();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,314 @@
+#include "benchmark.hpp"
+
+#include <sumire/util/mesh_optimizer.hpp>
+#include <sumire/util/sumire_engine_path.hpp>
+
+#include <glm/gtc/constants.hpp>
+#include <tiny_gltf.h>
+#include <tiny_obj_loader.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*
+* util::optimizeMesh check and ACMR / ATVR report for the bundled assets.
+*
+* Meshes are read as the loaders read them: OBJ vertices in first seen order and faces in file order,
+*  glTF primitives with their authored vertex and index order. Each triangle list primitive is then
+*  optimized as at load time, and its post-transform cache efficiency simulated before and after with
+*  util::simulateVertexCache. Every mesh is also run with its triangles shuffled, as a stand-in for
+*  poorly ordered exports.
+*
+* Check: optimizing must keep every primitive's triangles (as vertex attributes, with their winding)
+*  and its vertex count, and the reported after stats must match a fresh simulation.
+*
+* Usage: mesh_optimizer_benchmark [model.obj | model.glb ...], defaulting to assets/models/primitives.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    struct Primitive {
+        uint32_t vertexStart;
+        uint32_t vertexCount;
+        uint32_t indexStart;
+        uint32_t indexCount;
+    };
+
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<Primitive> primitives;
+    };
+
+    // As OBJloader::loadOBJ, one primitive with vertices deduplicated in first seen order. Vertices are
+    //  keyed by their attribute indices rather than their values, which is the same for exported files.
+    MeshData readObj(const std::string &path) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str())) {
+            throw std::runtime_error("[Sumire::Benchmark] " + warn + err);
+        }
+
+        MeshData mesh;
+        std::map<std::tuple<int, int, int>, uint32_t> uniqueVertices;
+        for (const auto &shape : shapes) {
+            for (const auto &index : shape.mesh.indices) {
+                const auto key = std::make_tuple(index.vertex_index, index.normal_index, index.texcoord_index);
+                auto [it, inserted] = uniqueVertices.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+                if (inserted) {
+                    Vertex vertex{};
+                    if (index.vertex_index >= 0) {
+                        vertex.position = {
+                            attrib.vertices[3 * index.vertex_index + 0],
+                            attrib.vertices[3 * index.vertex_index + 1],
+                            attrib.vertices[3 * index.vertex_index + 2]
+                        };
+                    }
+                    if (index.normal_index >= 0) {
+                        vertex.normal = {
+                            attrib.normals[3 * index.normal_index + 0],
+                            attrib.normals[3 * index.normal_index + 1],
+                            attrib.normals[3 * index.normal_index + 2]
+                        };
+                    }
+                    if (index.texcoord_index >= 0) {
+                        vertex.uv0 = {
+                            attrib.texcoords[2 * index.texcoord_index + 0],
+                            attrib.texcoords[2 * index.texcoord_index + 1]
+                        };
+                    }
+                    mesh.vertices.push_back(vertex);
+                }
+                mesh.indices.push_back(it->second);
+            }
+        }
+
+        mesh.primitives.push_back(Primitive{
+            0u, static_cast<uint32_t>(mesh.vertices.size()), 0u, static_cast<uint32_t>(mesh.indices.size())
+        });
+        return mesh;
+    }
+
+    // Reads element i of a float accessor of N components.
+    template <int N>
+    glm::vec<N, float> readFloats(const tinygltf::Model &model, const tinygltf::Accessor &accessor, size_t i) {
+        const tinygltf::BufferView &view = model.bufferViews[accessor.bufferView];
+        const size_t stride = accessor.ByteStride(view);
+        const float *src = reinterpret_cast<const float*>(
+            &model.buffers[view.buffer].data[view.byteOffset + accessor.byteOffset + i * stride]);
+
+        glm::vec<N, float> value;
+        for (int c = 0; c < N; c++) value[c] = src[c];
+        return value;
+    }
+
+    // As GLTFloader, every triangle list primitive of every mesh with its authored order. Only the
+    //  attributes the optimizer reads or the check compares are decoded.
+    MeshData readGlb(const std::string &path) {
+        tinygltf::Model model;
+        tinygltf::TinyGLTF loader;
+        std::string warn, err;
+        if (!loader.LoadBinaryFromFile(&model, &err, &warn, path)) {
+            throw std::runtime_error("[Sumire::Benchmark] " + warn + err);
+        }
+
+        MeshData mesh;
+        for (const tinygltf::Mesh &gltfMesh : model.meshes) {
+            for (const tinygltf::Primitive &gltfPrimitive : gltfMesh.primitives) {
+                const auto position = gltfPrimitive.attributes.find("POSITION");
+                if (gltfPrimitive.mode != TINYGLTF_MODE_TRIANGLES || gltfPrimitive.indices < 0 ||
+                    position == gltfPrimitive.attributes.end()) continue;
+
+                Primitive primitive{};
+                primitive.vertexStart = static_cast<uint32_t>(mesh.vertices.size());
+                primitive.indexStart = static_cast<uint32_t>(mesh.indices.size());
+
+                const tinygltf::Accessor &positions = model.accessors[position->second];
+                const auto normal = gltfPrimitive.attributes.find("NORMAL");
+                const auto uv0 = gltfPrimitive.attributes.find("TEXCOORD_0");
+                for (size_t v = 0; v < positions.count; v++) {
+                    Vertex vertex{};
+                    vertex.position = readFloats<3>(model, positions, v);
+                    if (normal != gltfPrimitive.attributes.end()) {
+                        vertex.normal = readFloats<3>(model, model.accessors[normal->second], v);
+                    }
+                    if (uv0 != gltfPrimitive.attributes.end()) {
+                        vertex.uv0 = readFloats<2>(model, model.accessors[uv0->second], v);
+                    }
+                    mesh.vertices.push_back(vertex);
+                }
+
+                const tinygltf::Accessor &indices = model.accessors[gltfPrimitive.indices];
+                const tinygltf::BufferView &view = model.bufferViews[indices.bufferView];
+                const size_t stride = indices.ByteStride(view);
+                const unsigned char *src = &model.buffers[view.buffer].data[view.byteOffset + indices.byteOffset];
+                for (size_t i = 0; i < indices.count; i++) {
+                    uint32_t index = 0u;
+                    switch (indices.componentType) {
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:  index = src[i * stride]; break;
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: index = *reinterpret_cast<const uint16_t*>(src + i * stride); break;
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:   index = *reinterpret_cast<const uint32_t*>(src + i * stride); break;
+                        default: break;
+                    }
+                    mesh.indices.push_back(primitive.vertexStart + index);
+                }
+
+                primitive.vertexCount = static_cast<uint32_t>(mesh.vertices.size()) - primitive.vertexStart;
+                primitive.indexCount = static_cast<uint32_t>(mesh.indices.size()) - primitive.indexStart;
+                mesh.primitives.push_back(primitive);
+            }
+        }
+
+        return mesh;
+    }
+
+    // A smooth UV sphere with shared vertices, in ring order as exporters write them. The bundled
+    //  primitives are flat shaded or already transform each vertex once, so this shows vertex reuse.
+    MeshData generateSphere(uint32_t rings, uint32_t segments) {
+        MeshData mesh;
+        for (uint32_t r = 0; r <= rings; r++) {
+            const float phi = glm::pi<float>() * static_cast<float>(r) / rings;
+            for (uint32_t s = 0; s <= segments; s++) {
+                const float theta = 2.0f * glm::pi<float>() * static_cast<float>(s) / segments;
+                Vertex vertex{};
+                vertex.position = { std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta) };
+                vertex.normal = vertex.position;
+                vertex.uv0 = { static_cast<float>(s) / segments, static_cast<float>(r) / rings };
+                mesh.vertices.push_back(vertex);
+            }
+        }
+
+        for (uint32_t r = 0; r < rings; r++) {
+            for (uint32_t s = 0; s < segments; s++) {
+                const uint32_t v0 = r * (segments + 1u) + s;
+                const uint32_t v1 = v0 + segments + 1u;
+                mesh.indices.insert(mesh.indices.end(), { v0, v1, v0 + 1u, v0 + 1u, v1, v1 + 1u });
+            }
+        }
+
+        mesh.primitives.push_back(Primitive{
+            0u, static_cast<uint32_t>(mesh.vertices.size()), 0u, static_cast<uint32_t>(mesh.indices.size())
+        });
+        return mesh;
+    }
+
+    void shuffleTriangles(MeshData &mesh, std::mt19937 &rng) {
+        for (const Primitive &primitive : mesh.primitives) {
+            std::vector<std::array<uint32_t, 3>> triangles(primitive.indexCount / 3u);
+            for (size_t t = 0; t < triangles.size(); t++) {
+                for (uint32_t c = 0; c < 3u; c++) triangles[t][c] = mesh.indices[primitive.indexStart + 3u * t + c];
+            }
+            std::shuffle(triangles.begin(), triangles.end(), rng);
+            for (size_t t = 0; t < triangles.size(); t++) {
+                for (uint32_t c = 0; c < 3u; c++) mesh.indices[primitive.indexStart + 3u * t + c] = triangles[t][c];
+            }
+        }
+    }
+
+    using VertexKey = std::array<float, 8>;
+    using TriangleKey = std::array<VertexKey, 3>;
+
+    // A primitive's triangles by vertex attributes, each rotated to start at its least vertex so that
+    //  only the winding is compared.
+    std::vector<TriangleKey> triangleKeys(const MeshData &mesh, const Primitive &primitive) {
+        auto vertexKey = [&](uint32_t idx) {
+            const Vertex &v = mesh.vertices[idx];
+            return VertexKey{
+                v.position.x, v.position.y, v.position.z, v.normal.x, v.normal.y, v.normal.z, v.uv0.x, v.uv0.y
+            };
+        };
+
+        std::vector<TriangleKey> keys;
+        for (uint32_t i = primitive.indexStart; i + 2u < primitive.indexStart + primitive.indexCount; i += 3u) {
+            TriangleKey key{ vertexKey(mesh.indices[i]), vertexKey(mesh.indices[i + 1]), vertexKey(mesh.indices[i + 2]) };
+            std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+            keys.push_back(key);
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    bool optimizeAndReport(const std::string &name, MeshData &mesh) {
+        util::VertexCacheStats before;
+        util::VertexCacheStats after;
+        bool passed = true;
+
+        for (const Primitive &primitive : mesh.primitives) {
+            const std::vector<TriangleKey> trianglesBefore = triangleKeys(mesh, primitive);
+            const size_t vertexCount = mesh.vertices.size();
+
+            util::MeshOptimizeData optimizeData{
+                mesh.vertices,
+                mesh.indices,
+                primitive.vertexStart,
+                primitive.vertexCount,
+                primitive.indexStart,
+                primitive.indexCount
+            };
+            if (!util::optimizeMesh(&optimizeData)) continue;
+
+            const util::VertexCacheStats simulated = util::simulateVertexCache(
+                &mesh.indices[primitive.indexStart], primitive.indexCount, primitive.vertexStart, primitive.vertexCount
+            );
+            passed = passed &&
+                mesh.vertices.size() == vertexCount &&
+                triangleKeys(mesh, primitive) == trianglesBefore &&
+                simulated.misses == optimizeData.outStatsAfter.misses;
+
+            before += optimizeData.outStatsBefore;
+            after += optimizeData.outStatsAfter;
+        }
+
+        std::cout << name << " | " << before.triangles << " | " << before.vertices << " | "
+            << before.acmr() << " -> " << after.acmr() << " | "
+            << before.atvr() << " -> " << after.atvr() << std::endl;
+        return benchmark::check(passed, "optimizeMesh changed a primitive's triangles or misreported its stats");
+    }
+
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) paths.push_back(argv[i]);
+    if (paths.empty()) {
+        paths = {
+            SUMIRE_ENGINE_PATH("assets/models/primitives/quad.obj"),
+            SUMIRE_ENGINE_PATH("assets/models/primitives/sphere.obj"),
+            SUMIRE_ENGINE_PATH("assets/models/primitives/sphere.glb")
+        };
+    }
+
+    std::vector<std::pair<std::string, MeshData>> meshes;
+    for (const std::string &path : paths) {
+        const bool isObj = path.size() >= 4 && path.compare(path.size() - 4, 4, ".obj") == 0;
+        meshes.emplace_back(path, isObj ? readObj(path) : readGlb(path));
+    }
+    meshes.emplace_back("generated smooth sphere, 128 x 256", generateSphere(128u, 256u));
+
+    std::mt19937 rng{ 17u };
+
+    std::cout << "mesh | triangles | vertices | ACMR (" << util::VERTEX_CACHE_SIZE << " entry FIFO) | ATVR" << std::endl;
+    for (const auto &[name, mesh] : meshes) {
+        MeshData authored = mesh;
+        if (!optimizeAndReport(name, authored)) return EXIT_FAILURE;
+
+        MeshData shuffled = mesh;
+        shuffleTriangles(shuffled, rng);
+        if (!optimizeAndReport(name + " (shuffled)", shuffled)) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
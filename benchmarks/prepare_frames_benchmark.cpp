@@ -0,0 +1,321 @@
+#include "benchmark.hpp"
+
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_mask_builder.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/prepare_frame_tracker.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/zbin_builder.hpp>
+#include <sumire/core/rendering/general/sumi_camera.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* Frames in flight check and benchmark for the CPU prepare path of HighQualityShadowMapper.
+*
+* Each frame in flight's zBin and light mask buffers are stood in for by host arrays, written with the
+*  protocol of prepare() and prepareFrame(): prepare() builds the zBin and light mask with ZbinBuilder
+*  and LightMaskBuilder and reserves light mask capacity, prepareFrame() grows the frame's light mask
+*  buffer to it and writes both buffers if PrepareFrameTracker says they are out of date. Frames are
+*  run as Sumire::run does, with prepare() only when lights changed. Buffers are copied at submit.
+*
+* Check: while a frame is in flight, preparing the other frames must leave its buffers as they were at
+*  its submit. Each frame must be submitted with buffers holding the latest prepare(), and must not be
+*  written again from a prepare() it already holds. Lights are static, moved every frame, moved every
+*  other frame, and added until the light mask buffers grow, for 2 and 3 frames in flight.
+*
+* Benchmark: frame time with lights moved every frame against static lights, whose uploads are skipped.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    constexpr uint32_t NUM_SLICES = 1024u; // HighQualityShadowMapper::NUM_SLICES
+    constexpr uint32_t INITIAL_LIGHT_MASK_WORDS_PER_TILE = 8u; // HighQualityShadowMapper::INITIAL_LIGHT_MASK_WORDS_PER_TILE
+    constexpr uint32_t LIGHT_MASK_HEADROOM_DIVISOR = 4u; // HighQualityShadowMapper::LIGHT_MASK_HEADROOM_DIVISOR
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2u; // SumiSwapChain::MAX_FRAMES_IN_FLIGHT
+
+    constexpr uint32_t FRAMES_PER_SCENARIO = 48u;
+
+    // Fills newly allocated buffers, which hold nothing yet.
+    constexpr uint32_t UNWRITTEN_WORD = 0xCDCDCDCDu;
+
+    std::vector<structs::viewSpaceLight> randomLights(std::mt19937& rng, uint32_t count, const SumiCamera& camera) {
+        const float halfHeight = glm::tan(camera.getFovy() * 0.5f);
+        const float halfWidth  = halfHeight * camera.getAspect();
+        std::uniform_real_distribution<float> depthDist{ -5.0f, camera.getFar() * 0.1f };
+        std::uniform_real_distribution<float> offsetDist{ -1.0f, 1.0f };
+        std::uniform_real_distribution<float> rangeDist{ 0.5f, 10.0f };
+
+        std::vector<structs::viewSpaceLight> lights(count);
+        for (uint32_t i = 0; i < count; i++) {
+            structs::viewSpaceLight& light = lights[i];
+            const float depth = depthDist(rng);
+            const float extent = glm::max(depth, 1.0f);
+
+            light.slot = i;
+            light.range = rangeDist(rng);
+            light.viewSpacePosition = glm::vec3{
+                offsetDist(rng) * halfWidth * extent, offsetDist(rng) * halfHeight * extent, -depth };
+            light.viewSpaceDepth = depth;
+            light.minDepth = depth - light.range;
+            light.maxDepth = depth + light.range;
+        }
+
+        std::sort(lights.begin(), lights.end(), [](const auto& a, const auto& b) {
+            return a.minDepth < b.minDepth;
+        });
+        return lights;
+    }
+
+    // A frame in flight's zBin and light mask buffers.
+    struct FrameBuffers {
+        std::vector<structs::zBinData> zBin;
+        std::vector<uint32_t> lightMask;
+        // The prepare() the buffers were last written from, 0 if never written.
+        uint64_t writtenFrom = 0u;
+    };
+
+    bool zBinDataEqual(const structs::zBinData& a, const structs::zBinData& b) {
+        return a.minLightIdx == b.minLightIdx && a.maxLightIdx == b.maxLightIdx &&
+            a.rangedMinLightIdx == b.rangedMinLightIdx && a.rangedMaxLightIdx == b.rangedMaxLightIdx;
+    }
+
+    bool buffersEqual(const FrameBuffers& a, const FrameBuffers& b) {
+        return std::equal(a.zBin.begin(), a.zBin.end(), b.zBin.begin(), b.zBin.end(), zBinDataEqual)
+            && a.lightMask == b.lightMask;
+    }
+
+    // The CPU prepare path of HighQualityShadowMapper, writing host arrays in place of its buffers.
+    class PrepareFrames {
+    public:
+        PrepareFrames(uint32_t numFrames, glm::uvec2 screenDim) :
+            screenDim{ screenDim },
+            zBin{ NUM_SLICES },
+            lightMask{ screenDim.x, screenDim.y },
+            frameTracker{ numFrames },
+            frames(numFrames)
+        {
+            lightMaskCapacity = structs::lightMask::HEADER_WORDS
+                + lightMask.numTiles() * (1u + INITIAL_LIGHT_MASK_WORDS_PER_TILE);
+            for (FrameBuffers& frame : frames) {
+                frame.zBin.assign(NUM_SLICES, structs::zBinData{});
+                frame.lightMask.assign(lightMaskCapacity, UNWRITTEN_WORD);
+            }
+        }
+
+        void prepare(std::span<const structs::viewSpaceLight> lights, const SumiCamera& camera) {
+            frameTracker.advance();
+            numPrepares++;
+
+            zBinBuilder.build(lights, camera.getNear(), camera.getFar(), zBin);
+            lightMaskBuilder.build(lights, camera, screenDim, lightMask, nullptr);
+            reserveLightMaskWords(static_cast<uint32_t>(lightMask.words.size()));
+        }
+
+        void prepareFrame(uint32_t frameIdx) {
+            FrameBuffers& frame = frames[frameIdx];
+
+            if (frame.lightMask.size() < lightMaskCapacity) {
+                frame.lightMask.assign(lightMaskCapacity, UNWRITTEN_WORD);
+                frameTracker.invalidate(frameIdx);
+                numGrowths++;
+            }
+
+            if (!frameTracker.acquire(frameIdx)) {
+                numSkipped++;
+                return;
+            }
+
+            if (frame.writtenFrom == numPrepares && !isUnwritten(frame)) numRedundantUploads++;
+            frame.writtenFrom = numPrepares;
+            numUploads++;
+
+            std::copy(zBin.data.begin(), zBin.data.end(), frame.zBin.begin());
+            std::copy(lightMask.words.begin(), lightMask.words.end(), frame.lightMask.begin());
+        }
+
+        // Whether the frame's buffers hold the latest prepare().
+        bool isUpToDate(uint32_t frameIdx) const {
+            const FrameBuffers& frame = frames[frameIdx];
+            return std::equal(zBin.data.begin(), zBin.data.end(), frame.zBin.begin(), frame.zBin.end(), zBinDataEqual)
+                && lightMask.words.size() <= frame.lightMask.size()
+                && std::equal(lightMask.words.begin(), lightMask.words.end(), frame.lightMask.begin());
+        }
+
+        const FrameBuffers& getFrame(uint32_t frameIdx) const { return frames[frameIdx]; }
+
+        uint32_t numUploads = 0u;
+        uint32_t numSkipped = 0u;
+        uint32_t numGrowths = 0u;
+        uint32_t numRedundantUploads = 0u;
+
+    private:
+        void reserveLightMaskWords(uint32_t numWords) {
+            if (numWords <= lightMaskCapacity) return;
+            lightMaskCapacity = std::max(
+                numWords + numWords / LIGHT_MASK_HEADROOM_DIVISOR,
+                lightMaskCapacity + lightMaskCapacity / 2u
+            );
+        }
+
+        static bool isUnwritten(const FrameBuffers& frame) {
+            return !frame.lightMask.empty() && frame.lightMask[0] == UNWRITTEN_WORD;
+        }
+
+        const glm::uvec2 screenDim;
+
+        ZbinBuilder zBinBuilder;
+        LightMaskBuilder lightMaskBuilder;
+        structs::zBin zBin;
+        structs::lightMask lightMask;
+        uint32_t lightMaskCapacity = 0u;
+
+        PrepareFrameTracker frameTracker;
+        std::vector<FrameBuffers> frames;
+        uint64_t numPrepares = 0u;
+    };
+
+    enum class LightMotion { Static, EveryFrame, EveryOtherFrame, Growing };
+
+    struct CheckResult {
+        uint32_t frames = 0u;
+        uint32_t overwrittenInFlight = 0u;
+        uint32_t staleSubmits = 0u;
+        uint32_t redundantUploads = 0u;
+        uint32_t skipped = 0u;
+        uint32_t growths = 0u;
+    };
+
+    void runScenario(uint32_t numFrames, LightMotion motion, std::mt19937& rng, CheckResult& result) {
+        constexpr uint32_t INITIAL_LIGHTS = 256u;
+        constexpr uint32_t MAX_LIGHTS = 8192u;
+        const glm::uvec2 screenDim{ 1280u, 720u };
+
+        SumiCamera camera{ glm::radians(50.0f), static_cast<float>(screenDim.x) / static_cast<float>(screenDim.y) };
+        PrepareFrames prepareFrames{ numFrames, screenDim };
+
+        // Buffers of each frame as submitted, which the GPU may read until the frame's fence signals.
+        std::vector<FrameBuffers> submitted(numFrames);
+        std::vector<bool> inFlight(numFrames, false);
+
+        uint32_t numLights = INITIAL_LIGHTS;
+        for (uint32_t frame = 0; frame < FRAMES_PER_SCENARIO; frame++) {
+            const uint32_t frameIdx = frame % numFrames;
+            // The frame's fence has signalled, so the GPU is done with its buffers.
+            inFlight[frameIdx] = false;
+
+            bool lightsChanged = frame == 0u;
+            switch (motion) {
+                case LightMotion::Static:          break;
+                case LightMotion::EveryFrame:      lightsChanged = true; break;
+                case LightMotion::EveryOtherFrame: lightsChanged = lightsChanged || frame % 2u == 0u; break;
+                case LightMotion::Growing:
+                    lightsChanged = lightsChanged || frame % 3u == 0u;
+                    if (frame > 0u && lightsChanged) numLights = glm::min(numLights * 2u, MAX_LIGHTS);
+                    break;
+            }
+
+            if (lightsChanged) prepareFrames.prepare(randomLights(rng, numLights, camera), camera);
+            prepareFrames.prepareFrame(frameIdx);
+
+            for (uint32_t other = 0; other < numFrames; other++) {
+                if (inFlight[other] && !buffersEqual(prepareFrames.getFrame(other), submitted[other])) {
+                    result.overwrittenInFlight++;
+                }
+            }
+            if (!prepareFrames.isUpToDate(frameIdx)) result.staleSubmits++;
+
+            submitted[frameIdx] = prepareFrames.getFrame(frameIdx);
+            inFlight[frameIdx] = true;
+            result.frames++;
+        }
+
+        result.redundantUploads += prepareFrames.numRedundantUploads;
+        result.skipped += prepareFrames.numSkipped;
+        result.growths += prepareFrames.numGrowths;
+    }
+
+    bool runCheck() {
+        std::mt19937 rng{ 7u };
+        CheckResult result{};
+        CheckResult staticResult{};
+        uint32_t expectedStaticSkips = 0u;
+
+        for (uint32_t numFrames : { MAX_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT + 1u }) {
+            // Only the first prepare() of a static scene is uploaded, once per frame in flight.
+            runScenario(numFrames, LightMotion::Static, rng, staticResult);
+            expectedStaticSkips += FRAMES_PER_SCENARIO - numFrames;
+            runScenario(numFrames, LightMotion::EveryFrame, rng, result);
+            runScenario(numFrames, LightMotion::EveryOtherFrame, rng, result);
+            runScenario(numFrames, LightMotion::Growing, rng, result);
+        }
+
+        std::cout << "Check: " << result.frames + staticResult.frames << " frames, "
+            << result.overwrittenInFlight + staticResult.overwrittenInFlight << " wrote a frame in flight, "
+            << result.staleSubmits + staticResult.staleSubmits << " submitted stale buffers, "
+            << result.redundantUploads + staticResult.redundantUploads << " rewrote current buffers, "
+            << result.skipped + staticResult.skipped << " skipped uploads, "
+            << result.growths << " light mask growths" << std::endl;
+
+        bool passed = benchmark::check(
+            result.overwrittenInFlight + staticResult.overwrittenInFlight == 0u,
+            "preparing a frame wrote buffers of another frame in flight"
+        );
+        passed = benchmark::check(
+            result.staleSubmits + staticResult.staleSubmits == 0u,
+            "a frame was submitted with buffers older than the latest prepare"
+        ) && passed;
+        passed = benchmark::check(
+            result.redundantUploads + staticResult.redundantUploads == 0u,
+            "a frame's buffers were written again from the prepare they already held"
+        ) && passed;
+        passed = benchmark::check(
+            staticResult.skipped == expectedStaticSkips,
+            "uploads of static frames were not skipped"
+        ) && passed;
+        passed = benchmark::check(result.growths > 0u, "light mask buffers were never grown") && passed;
+        return passed;
+    }
+
+    void runBenchmark() {
+        constexpr uint32_t NUM_LIGHTS = 1024u;
+        constexpr uint32_t NUM_LIGHT_SETS = 8u;
+        constexpr uint32_t ITERATIONS = 200u;
+        const glm::uvec2 screenDim{ 1920u, 1080u };
+
+        std::mt19937 rng{ 11u };
+        SumiCamera camera{ glm::radians(50.0f), static_cast<float>(screenDim.x) / static_cast<float>(screenDim.y) };
+
+        // Light sets are built ahead of time so that only prepare() and prepareFrame() are timed.
+        std::vector<std::vector<structs::viewSpaceLight>> lightSets;
+        for (uint32_t i = 0; i < NUM_LIGHT_SETS; i++) lightSets.push_back(randomLights(rng, NUM_LIGHTS, camera));
+
+        auto timeFrames = [&](bool lightsMove) {
+            PrepareFrames prepareFrames{ MAX_FRAMES_IN_FLIGHT, screenDim };
+            prepareFrames.prepare(lightSets[0], camera);
+            uint32_t frame = 0u;
+            return benchmark::meanMicroseconds(ITERATIONS, [&]() {
+                if (lightsMove) prepareFrames.prepare(lightSets[frame % NUM_LIGHT_SETS], camera);
+                prepareFrames.prepareFrame(frame % MAX_FRAMES_IN_FLIGHT);
+                frame++;
+            });
+        };
+
+        const double movingUs = timeFrames(true);
+        const double staticUs = timeFrames(false);
+
+        std::cout << "frame of " << NUM_LIGHTS << " lights at " << screenDim.x << "x" << screenDim.y
+            << ", " << MAX_FRAMES_IN_FLIGHT << " frames in flight | us" << std::endl;
+        std::cout << "lights moved, prepare and upload | " << movingUs << std::endl;
+        std::cout << "lights static, upload skipped | " << staticUs << std::endl;
+    }
+
+}
+
+int main() {
+    if (!runCheck()) return EXIT_FAILURE;
+    runBenchmark();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,236 @@
+#include "benchmark.hpp"
+#include "gltf_benchmark_model.hpp"
+
+#include <sumire/loaders/sumimesh_file.hpp>
+#include <sumire/util/mapped_file.hpp>
+#include <sumire/util/rw_file_binary.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+* SumimeshFile check and benchmark.
+*
+* The 2M vertex skinned model of gltf_benchmark_model.hpp stands in for a large .glb: its buffer is
+*  written to a source file, and its decoded vertices & indices to a .sumimesh cache with SumimeshFile,
+*  as SumimeshCache::write does. The cache holds only the geometry, which is what a model of this size
+*  spends its load on. Textures, materials and nodes are created on device either way.
+*
+* Each load ends with the vertices and indices copied to staging memory, as their upload does:
+*  - glTF: reads the source file, as tinygltf does, and decodes it with GLTFprimitiveDecoder on a
+*    SumiThreadPool, as GLTFloader does. JSON parsing and tangent generation are not included.
+*  - cache: hashes the source for its key, maps and validates the cache, and copies the geometry
+*    out of the mapping, as GLTFloader::createModelFromFile, SumimeshCache::read and SumiModel do.
+*  Cold loads first drop both files from the OS page cache (Linux only), warm loads read them from it.
+*
+* Check: the cache's geometry must match the decoded arrays, and caches must be rejected for a
+*  changed source or options, or if truncated.
+*/
+
+using namespace sumire;
+using namespace sumire::benchmark;
+
+namespace {
+
+    using loaders::SumimeshFile;
+
+    constexpr uint32_t CACHE_FLAGS = SumimeshFile::FLAG_GEN_TANGENTS;
+
+    // Drops path from the OS page cache, so that it is next read from disk.
+    bool evictFromPageCache(const std::string &path) {
+#ifdef _WIN32
+        return false;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        const bool evicted = ::fdatasync(fd) == 0 && ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        ::close(fd);
+        return evicted;
+#endif
+    }
+
+    // Mean wall time of fn() in milliseconds, with files dropped from the page cache before each call.
+    template <typename Fn>
+    double meanColdMilliseconds(uint32_t iterations, const std::vector<std::string> &files, Fn&& fn) {
+        double total = 0.0;
+        for (uint32_t i = 0; i < iterations; i++) {
+            for (const std::string &file : files) evictFromPageCache(file);
+
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        return total / iterations;
+    }
+
+    // Stands in for the vertex and index staging buffers.
+    struct Staging {
+        std::vector<unsigned char> vertices;
+        std::vector<unsigned char> indices;
+
+        void write(std::span<const Vertex> srcVertices, std::span<const uint32_t> srcIndices) {
+            std::memcpy(vertices.data(), srcVertices.data(), srcVertices.size_bytes());
+            std::memcpy(indices.data(), srcIndices.data(), srcIndices.size_bytes());
+        }
+    };
+
+    void loadGLTF(
+        const std::string &sourcePath, tinygltf::Model &model, SumiThreadPool &threadPool, Staging &staging
+    ) {
+        std::vector<char> source;
+        if (!util::readFileBinary(sourcePath, source)) return;
+        model.buffers[0].data.assign(source.begin(), source.end());
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        decodeSlices(model, vertices, indices, &threadPool);
+        staging.write(vertices, indices);
+    }
+
+    bool loadCache(const std::string &sourcePath, const std::string &cachePath, Staging &staging) {
+        SumimeshFile::Key key{};
+        util::MappedFile cacheFile;
+        SumimeshFile::Geometry geometry{};
+        if (!SumimeshFile::makeKey(sourcePath, CACHE_FLAGS, key)
+            || !SumimeshFile::open(cachePath, key, cacheFile)
+            || !SumimeshFile::readGeometry(cacheFile, geometry)
+        ) {
+            return false;
+        }
+        staging.write(geometry.vertices, geometry.indices);
+        return true;
+    }
+
+    bool writeCache(
+        const std::string &cachePath, const SumimeshFile::Key &key,
+        const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices
+    ) {
+        loaders::sumimesh::CacheWriter writer;
+        SumimeshFile::writeHeader(writer, key);
+        SumimeshFile::writeGeometry(writer, SumimeshFile::Geometry{ {}, {}, vertices, indices });
+        return util::writeFileBinary(cachePath, writer.buffer);
+    }
+
+    // A cache that must not be read is rejected by open() or readGeometry().
+    bool rejects(const std::string &cachePath, const SumimeshFile::Key &key) {
+        util::MappedFile cacheFile;
+        SumimeshFile::Geometry geometry{};
+        return !SumimeshFile::open(cachePath, key, cacheFile) || !SumimeshFile::readGeometry(cacheFile, geometry);
+    }
+
+    bool runCheck(
+        const std::string &sourcePath, const std::string &cachePath,
+        const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices
+    ) {
+        SumimeshFile::Key key{};
+        util::MappedFile cacheFile;
+        SumimeshFile::Geometry geometry{};
+        if (!SumimeshFile::makeKey(sourcePath, CACHE_FLAGS, key)
+            || !SumimeshFile::open(cachePath, key, cacheFile)
+            || !SumimeshFile::readGeometry(cacheFile, geometry)
+        ) {
+            return false;
+        }
+        const bool matches = geometry.morphDeltas.empty() && geometry.morphVertices.empty()
+            && geometry.vertices.size() == vertices.size() && geometry.indices.size() == indices.size()
+            && std::memcmp(geometry.vertices.data(), vertices.data(), geometry.vertices.size_bytes()) == 0
+            && std::memcmp(geometry.indices.data(), indices.data(), geometry.indices.size_bytes()) == 0;
+
+        SumimeshFile::Key changedSource = key;
+        changedSource.sourceHash ^= 1u;
+        SumimeshFile::Key changedOptions = key;
+        changedOptions.flags |= SumimeshFile::FLAG_OPTIMIZE_MESHES;
+
+        const std::string truncatedPath = cachePath + ".truncated";
+        const bool rejected = rejects(cachePath, changedSource) && rejects(cachePath, changedOptions)
+            && util::writeFileBinary(truncatedPath, reinterpret_cast<const char*>(cacheFile.data()), cacheFile.size() / 2u)
+            && rejects(truncatedPath, key);
+        std::filesystem::remove(truncatedPath);
+
+        return matches && rejected;
+    }
+
+}
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string sourcePath = (dir / "sumimesh_cache_benchmark.bin").string();
+    const std::string cachePath = SumimeshFile::getCachePath(sourcePath);
+
+    tinygltf::Model model = createModel();
+    SumiThreadPool threadPool;
+
+    if (!util::writeFileBinary(
+        sourcePath, reinterpret_cast<const char*>(model.buffers[0].data.data()), model.buffers[0].data.size())
+    ) {
+        std::cerr << "Failed to write <" << sourcePath << ">" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    decodeSlices(model, vertices, indices, &threadPool);
+
+    SumimeshFile::Key key{};
+    if (!SumimeshFile::makeKey(sourcePath, CACHE_FLAGS, key) || !writeCache(cachePath, key, vertices, indices)) {
+        std::cerr << "Failed to write <" << cachePath << ">" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const bool passed = runCheck(sourcePath, cachePath, vertices, indices);
+    if (!benchmark::check(passed, "cache geometry differs from the decoded model, or a bad cache was read")) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "Check: " << vertices.size() << " vertices and " << indices.size()
+        << " indices read back from the cache, changed and truncated caches rejected" << std::endl;
+
+    const size_t vertexCount = vertices.size();
+    Staging staging{
+        std::vector<unsigned char>(vertices.size() * sizeof(Vertex)),
+        std::vector<unsigned char>(indices.size() * sizeof(uint32_t))
+    };
+    vertices = {};
+    indices = {};
+    model.buffers[0].data = {};
+
+    const uint64_t sourceBytes = std::filesystem::file_size(sourcePath);
+    const uint64_t cacheBytes = std::filesystem::file_size(cachePath);
+    const std::vector<std::string> files{ sourcePath, cachePath };
+    const bool canEvict = evictFromPageCache(sourcePath) && evictFromPageCache(cachePath);
+
+    constexpr uint32_t ITERATIONS = 5u;
+    bool loaded = true;
+    auto glTFload = [&]() { loadGLTF(sourcePath, model, threadPool, staging); };
+    auto cacheLoad = [&]() { loaded = loadCache(sourcePath, cachePath, staging) && loaded; };
+
+    const double glTFwarmMs = benchmark::meanMicroseconds(ITERATIONS, glTFload) / 1000.0;
+    const double cacheWarmMs = benchmark::meanMicroseconds(ITERATIONS, cacheLoad) / 1000.0;
+    const double glTFcoldMs = canEvict ? meanColdMilliseconds(ITERATIONS, files, glTFload) : 0.0;
+    const double cacheColdMs = canEvict ? meanColdMilliseconds(ITERATIONS, files, cacheLoad) : 0.0;
+    if (!benchmark::check(loaded, "the cache was not loaded")) return EXIT_FAILURE;
+
+    std::cout << "load of " << vertexCount << " vertices (source " << sourceBytes / (1024.0 * 1024.0)
+        << "MB, cache " << cacheBytes / (1024.0 * 1024.0) << "MB, " << threadPool.getThreadCount()
+        << " pool threads) | cold (ms) | warm (ms)" << std::endl;
+    if (canEvict) {
+        std::cout << "glTF read & decode | " << glTFcoldMs << " | " << glTFwarmMs << std::endl;
+        std::cout << ".sumimesh cache | " << cacheColdMs << " | " << cacheWarmMs << std::endl;
+    } else {
+        std::cout << "glTF read & decode | n/a | " << glTFwarmMs << std::endl;
+        std::cout << ".sumimesh cache | n/a | " << cacheWarmMs << std::endl;
+        std::cout << "Cold loads need the files dropped from the page cache, which is not supported here." << std::endl;
+    }
+
+    std::filesystem::remove(sourcePath);
+    std::filesystem::remove(cachePath);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+#include "benchmark.hpp"
+
+#include <sumire/core/render_systems/high_quality_shadow_mapping/zbin_builder.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* ZbinBuilder property check and benchmark.
+*
+* Property check: randomized scenes are built over several frames, with lights changing range and
+*  near / far changing between frames, in both full and incremental modes. Every build must match
+*  the original two pass fill over slice ranges looked up independently in the boundary table.
+*
+* Benchmark: full and incremental builds against the original generateZbin() (per light log2 and
+*  the two pass fill) for 1k - 64k lights.
+*/
+
+using namespace sumire;
+
+namespace {
+
+    constexpr uint32_t NUM_SLICES = 1024u; // HighQualityShadowMapper::NUM_SLICES
+
+    std::vector<structs::viewSpaceLight> randomLights(std::mt19937& rng, uint32_t count, float far) {
+        std::uniform_real_distribution<float> depthDist{ -20.0f, far * 1.1f };
+        std::uniform_real_distribution<float> rangeDist{ 0.5f, 15.0f };
+
+        std::vector<structs::viewSpaceLight> lights(count);
+        for (structs::viewSpaceLight& light : lights) {
+            light.viewSpaceDepth = depthDist(rng);
+            light.range = rangeDist(rng);
+            light.minDepth = light.viewSpaceDepth - light.range;
+            light.maxDepth = light.viewSpaceDepth + light.range;
+        }
+
+        std::sort(lights.begin(), lights.end(), [](const auto& a, const auto& b) {
+            return a.minDepth < b.minDepth;
+        });
+        return lights;
+    }
+
+    // Resizes some lights' ranges about their min depth, so the min depth sort order is kept.
+    void changeLightRanges(std::mt19937& rng, std::vector<structs::viewSpaceLight>& lights, uint32_t count) {
+        if (lights.empty()) return;
+
+        std::uniform_int_distribution<size_t> lightDist{ 0, lights.size() - 1 };
+        std::uniform_real_distribution<float> rangeDist{ 0.5f, 15.0f };
+        for (uint32_t i = 0; i < count; i++) {
+            structs::viewSpaceLight& light = lights[lightDist(rng)];
+            light.range = rangeDist(rng);
+            light.maxDepth = light.minDepth + 2.0f * light.range;
+        }
+    }
+
+    // Slice of a depth by binary search of the boundary table: -1 in front of near, NUM_SLICES beyond far.
+    int32_t tableSlice(std::span<const float> sliceBoundaries, float depth) {
+        return static_cast<int32_t>(
+            std::upper_bound(sliceBoundaries.begin(), sliceBoundaries.end(), depth) - sliceBoundaries.begin()) - 1;
+    }
+
+    bool zBinsEqual(const structs::zBin& a, const structs::zBin& b) {
+        if (
+            a.minLight     != b.minLight     ||
+            a.maxLight     != b.maxLight     ||
+            a.firstFullIdx != b.firstFullIdx ||
+            a.lastFullIdx  != b.lastFullIdx
+        ) return false;
+
+        return std::equal(a.data.begin(), a.data.end(), b.data.begin(), [](const auto& x, const auto& y) {
+            return (
+                x.minLightIdx       == y.minLightIdx       &&
+                x.maxLightIdx       == y.maxLightIdx       &&
+                x.rangedMinLightIdx == y.rangedMinLightIdx &&
+                x.rangedMaxLightIdx == y.rangedMaxLightIdx
+            );
+        });
+    }
+
+    bool runPropertyCheck() {
+        constexpr uint32_t NUM_SCENES       = 400u;
+        constexpr uint32_t FRAMES_PER_SCENE = 20u;
+
+        std::mt19937 rng{ 7u };
+        uint32_t failedBuilds = 0u;
+
+        for (uint32_t scene = 0; scene < NUM_SCENES; scene++) {
+            ZbinBuilder builder;
+            builder.setIncremental(scene % 2 == 0);
+            structs::zBin zBin{ NUM_SLICES };
+
+            const uint32_t numLights = scene % 10 == 0 ? rng() % 4000u : rng() % 100u;
+            float near = 0.1f;
+            float far = scene % 3 == 0 ? 50.0f : 1000.0f;
+            std::vector<structs::viewSpaceLight> lights = randomLights(rng, numLights, far);
+
+            for (uint32_t frame = 0; frame < FRAMES_PER_SCENE; frame++) {
+                if (frame > 0) changeLightRanges(rng, lights, rng() % 4u);
+                if (frame == FRAMES_PER_SCENE / 2) far *= 0.5f;
+                if (frame == FRAMES_PER_SCENE / 2 + 1 && !lights.empty()) lights.pop_back();
+
+                builder.build(lights, near, far, zBin);
+
+                std::span<const float> sliceBoundaries = builder.getSliceBoundaries();
+                std::vector<int32_t> sliceMin(lights.size());
+                std::vector<int32_t> sliceMax(lights.size());
+                for (size_t i = 0; i < lights.size(); i++) {
+                    sliceMin[i] = tableSlice(sliceBoundaries, lights[i].minDepth);
+                    sliceMax[i] = tableSlice(sliceBoundaries, lights[i].maxDepth);
+                }
+
+                structs::zBin reference{ NUM_SLICES };
+                ZbinBuilder::buildReference(sliceMin, sliceMax, static_cast<uint32_t>(lights.size()), reference);
+
+                const bool passed = builder.validate(zBin) == 0u && zBinsEqual(zBin, reference);
+                if (!passed) failedBuilds++;
+            }
+        }
+
+        std::cout << "Property check: " << NUM_SCENES * FRAMES_PER_SCENE << " builds, "
+            << failedBuilds << " failed" << std::endl;
+        return benchmark::check(failedBuilds == 0u, "zBin builds differ from the reference fill");
+    }
+
+    // The original generateZbin(): a log per light end, then the two pass fill.
+    void buildLegacy(
+        std::span<const structs::viewSpaceLight> lights,
+        float near, float far,
+        std::vector<int32_t>& sliceMin,
+        std::vector<int32_t>& sliceMax,
+        structs::zBin& zBin
+    ) {
+        const float logFarNear = std::log(far / near);
+        const float sliceFrac1 = static_cast<float>(NUM_SLICES) / logFarNear;
+        const float sliceFrac2 = static_cast<float>(NUM_SLICES) * std::log(near) / logFarNear;
+
+        auto depthToSlice = [&](float depth) {
+            if (depth <= 0.0f) return -1;
+            const int slice = static_cast<int>(std::floor(std::log(depth) * sliceFrac1 - sliceFrac2));
+            return std::clamp(slice, -1, static_cast<int>(NUM_SLICES));
+        };
+
+        for (size_t i = 0; i < lights.size(); i++) {
+            sliceMin[i] = depthToSlice(lights[i].minDepth);
+            sliceMax[i] = depthToSlice(lights[i].maxDepth);
+        }
+        ZbinBuilder::buildReference(sliceMin, sliceMax, static_cast<uint32_t>(lights.size()), zBin);
+    }
+
+    void runBenchmark() {
+        constexpr float NEAR = 0.1f;
+        constexpr float FAR  = 1000.0f;
+        // Lights changing range per incremental build
+        constexpr uint32_t CHANGED_LIGHTS = 8u;
+
+        std::mt19937 rng{ 11u };
+
+        std::cout << "lights | legacy (us) | full build (us) | incremental, "
+            << CHANGED_LIGHTS << " changed (us)" << std::endl;
+
+        for (uint32_t numLights : { 1024u, 4096u, 16384u, 65536u }) {
+            std::vector<structs::viewSpaceLight> lights = randomLights(rng, numLights, FAR);
+            const uint32_t iterations = 2000000u / numLights;
+
+            structs::zBin zBin{ NUM_SLICES };
+            std::vector<int32_t> sliceMin(numLights);
+            std::vector<int32_t> sliceMax(numLights);
+            const double legacyUs = benchmark::meanMicroseconds(iterations, [&]() {
+                buildLegacy(lights, NEAR, FAR, sliceMin, sliceMax, zBin);
+            });
+
+            ZbinBuilder builder;
+            const double fullUs = benchmark::meanMicroseconds(iterations, [&]() {
+                builder.invalidate();
+                builder.build(lights, NEAR, FAR, zBin);
+            });
+
+            // Range changes are drawn ahead of time so only the builds are timed.
+            std::vector<std::vector<structs::viewSpaceLight>> frames(16u, lights);
+            for (auto& frame : frames) changeLightRanges(rng, frame, CHANGED_LIGHTS);
+
+            builder.setIncremental(true);
+            uint32_t frameIdx = 0u;
+            const double incrementalUs = benchmark::meanMicroseconds(iterations, [&]() {
+                builder.build(frames[frameIdx++ % frames.size()], NEAR, FAR, zBin);
+            });
+
+            std::cout << numLights << " | " << legacyUs << " | " << fullUs << " | " << incrementalUs << std::endl;
+        }
+    }
+
+}
+
+int main() {
+    if (!runPropertyCheck()) return EXIT_FAILURE;
+    runBenchmark();
+    return EXIT_SUCCESS;
+}
@@ -25,13 +25,20 @@ layout(set = 2, binding = 0) uniform MeshNode {
     mat4 matrix;
     mat4 normalMatrix;
     int nJoints;
+    int jointFormat;
 } meshNode;
 
 #include "../includes/inc_joint.glsl"
 
+// The joint SSBO holds one of two formats, selected by meshNode.jointFormat.
 layout(set = 2, binding = 1) buffer jointSSBO {
     Joint jointMatrices[];
 };
+layout(set = 2, binding = 1) buffer compactJointSSBO {
+    CompactJoint compactJoints[];
+};
+
+#include "../includes/inc_joint_palette.glsl"
 
 layout(push_constant) uniform Model {
     mat4 modelMatrix;
@@ -46,10 +53,10 @@ void main() {
     if (meshNode.nJoints > 0) {
         // Calculated as per glTF 2.0 reference guide
         mat4 skinMat = 
-            weight.x * jointMatrices[int(joint.x)].matrix +
-            weight.y * jointMatrices[int(joint.y)].matrix +
-            weight.z * jointMatrices[int(joint.z)].matrix +
-            weight.w * jointMatrices[int(joint.w)].matrix;
+            weight.x * paletteJointMatrix(int(joint.x), meshNode.jointFormat) +
+            weight.y * paletteJointMatrix(int(joint.y), meshNode.jointFormat) +
+            weight.z * paletteJointMatrix(int(joint.z), meshNode.jointFormat) +
+            weight.w * paletteJointMatrix(int(joint.w), meshNode.jointFormat);
 
         combinedTransform = modelMatrix * meshNode.matrix * skinMat;
     } else {
@@ -0,0 +1,53 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// sumire::CompactVertex & QuantizedVertex. Joints and weights are not vertex inputs, as compact models are
+//  always compute skinned, and so drawn with meshNode.nJoints = 0.
+layout(location = 3) in vec3 position;
+layout(location = 4) in vec3 col;
+layout(location = 5) in uvec2 normalTangent;
+layout(location = 6) in vec2 uv0;
+layout(location = 7) in vec2 uv1;
+
+layout(location = 0) out vec3 outColor;
+layout(location = 1) out vec2 outUv0;
+layout(location = 2) out vec2 outUv1;
+
+layout(set = 0, binding = 1) uniform Camera {
+    mat4 projectionMatrix;
+    mat4 viewMatrix;
+    mat4 projectionViewMatrix;
+    vec3 cameraPosition;
+};
+
+layout(set = 2, binding = 0) uniform MeshNode {
+    mat4 matrix;
+    mat4 normalMatrix;
+    int nJoints;
+    int jointFormat;
+    // Quantized positions are relative to the mesh bounds. Identity for unquantized positions.
+    vec4 positionScale;
+    vec4 positionOffset;
+} meshNode;
+
+#include "../includes/inc_compact_vertex.glsl"
+
+layout(push_constant) uniform Model {
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+};
+
+void main() {
+    mat4 combinedTransform = modelMatrix * meshNode.matrix;
+
+    vec3 meshPos = meshNode.positionOffset.xyz + meshNode.positionScale.xyz * position;
+    vec4 localPos = combinedTransform * vec4(meshPos, 1.0);
+    localPos /= localPos.w;
+    // Standard Camera Projection
+    gl_Position = projectionViewMatrix * localPos;
+
+    // Pass remaining vertex attributes to frag shader
+    outColor = col;
+    outUv0 = uv0;
+    outUv1 = uv1;
+}
@@ -18,11 +18,11 @@ layout(push_constant) uniform Push {
 #include "../includes/inc_light_mask.glsl"
 
 layout(set = 0, binding = 0) restrict readonly buffer lightMaskBuffer {
-    lightMask lightMasks[];
+    uint lightMaskWords[];
 };
 
 layout(set = 0, binding = 1) restrict readonly buffer tileGroupLightMaskBuffer {
-    lightMask tileGroupLightMasks[];
+    uint tileGroupLightMaskWords[];
 };
 
 layout(set = 0, binding = 2) restrict readonly buffer tileLightCountEarly {
@@ -66,32 +66,28 @@ void main() {
     uint finalCount     = finalTileLightCount[tileIdx];
 
     // ---- Light Mask Count Gather -----------------------------------------------------
-    uint tileLightMask = lightMasks[tileLightMaskIdx].bits[0];
+    uint tileOffset     = lightMaskWords[lightMaskTileOffsetIdx(tileLightMaskIdx)];
+    uint superGroupMask = lightMaskWords[tileOffset];
 
-    while (tileLightMask != 0) {
-        uint lightGroupBit = findLSB(tileLightMask);
-        uint lightMask     = lightMasks[tileLightMaskIdx].bits[lightGroupBit + 1];
-        tileLightMask     ^= (1 << lightGroupBit); // remove processed group
+    for (uint i = 0; i < uint(bitCount(superGroupMask)); i++) {
+        uint numGroups    = uint(bitCount(lightMaskWords[tileOffset + 1 + 2 * i]));
+        uint lightWordIdx = tileOffset + lightMaskWords[tileOffset + 2 + 2 * i];
 
-        while (lightMask != 0) {
-            uint lightBit   = findLSB(lightMask);
-            lightMask      ^= (1 << lightBit);
-            lightMaskCount++;
+        for (uint g = 0; g < numGroups; g++) {
+            lightMaskCount += uint(bitCount(lightMaskWords[lightWordIdx + g]));
         }
     }
 
     // ---- Approx Count Gather ---------------------------------------------------------
-    uint lightGroupMask = tileGroupLightMasks[tileGroupIdx].bits[0];
+    uint tileGroupOffset = tileGroupLightMaskWords[lightMaskTileOffsetIdx(tileGroupIdx)];
+    superGroupMask       = tileGroupLightMaskWords[tileGroupOffset];
 
-    while (lightGroupMask != 0) {
-        uint lightGroupBit = findLSB(lightGroupMask);
-        uint lightMask     = tileGroupLightMasks[tileGroupIdx].bits[lightGroupBit + 1];
-        lightGroupMask     ^= (1 << lightGroupBit); // remove processed group
+    for (uint i = 0; i < uint(bitCount(superGroupMask)); i++) {
+        uint numGroups    = uint(bitCount(tileGroupLightMaskWords[tileGroupOffset + 1 + 2 * i]));
+        uint lightWordIdx = tileGroupOffset + tileGroupLightMaskWords[tileGroupOffset + 2 + 2 * i];
 
-        while (lightMask != 0) {
-            uint lightBit   = findLSB(lightMask);
-            lightMask      ^= (1 << lightBit);
-            approxCount++;
+        for (uint g = 0; g < numGroups; g++) {
+            approxCount += uint(bitCount(tileGroupLightMaskWords[lightWordIdx + g]));
         }
     }
     // ----------------------------------------------------------------------------------
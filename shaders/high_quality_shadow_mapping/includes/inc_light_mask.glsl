@@ -1,3 +1,55 @@
-struct lightMask {
-    uint bits[33];
-};
\ No newline at end of file
+/*
+ * Sparse hierarchical light mask. Mirrors structs::lightMask (light_mask.hpp) on the CPU.
+ *
+ * Light masks are flat uint buffers:
+ *   [0]                    Number of words in use (allocation counter for GPU writers)
+ *   [1, 1 + numTiles)      Word index of each tile's block
+ *
+ * Each tile block is a two-level group hierarchy over the view-depth sorted light list:
+ *   [0]                    Super group mask. Bit s is set if any light in [1024s, 1024s + 1024) is set.
+ *   [1 + 2i]               Group mask of the i-th set super group (one bit per group of 32 lights).
+ *   [2 + 2i]               Index of the first light word of the i-th set super group (block relative).
+ *   ...                    One light word per set group bit, in ascending light order.
+ *
+ * Set bits are always visited in ascending order, so super group entries and light words can be
+ *   walked with running indices instead of bit counts.
+*/
+
+const uint LIGHT_MASK_HEADER_WORDS       = 1;
+const uint LIGHTS_PER_GROUP              = 32;
+const uint GROUPS_PER_SUPER_GROUP        = 32;
+const uint LIGHTS_PER_SUPER_GROUP        = LIGHTS_PER_GROUP * GROUPS_PER_SUPER_GROUP;
+const uint MAX_SUPER_GROUPS              = 32;
+const uint LIGHT_MASK_MAX_LIGHTS         = LIGHTS_PER_SUPER_GROUP * MAX_SUPER_GROUPS;
+const uint LIGHT_MASK_MAX_GROUPS         = LIGHT_MASK_MAX_LIGHTS / LIGHTS_PER_GROUP;
+const uint LIGHT_MASK_TILE_GROUP_DIM     = 2; // Light mask tiles per (64x64 pixel) tile group side
+
+// Light lists store 2 16-bit light indices per uint.
+const uint LIGHT_LIST_INDICES_PER_WORD   = 2;
+const uint LIGHT_LIST_INDEX_BITS         = 16;
+
+uint lightMaskTileOffsetIdx(in uint tileIdx) {
+    return LIGHT_MASK_HEADER_WORDS + tileIdx;
+}
+
+// Number of set bits in mask below bit.
+uint bitCountBelow(in uint mask, in uint bit) {
+    return uint(bitCount(mask & ((1u << bit) - 1u)));
+}
+
+// Unsets bits of a light mask word that only cover lights outside of lightRange.
+//   Bit b of the word covers lights [firstLightIdx + b * lightsPerBit, firstLightIdx + (b + 1) * lightsPerBit).
+uint intersectLightRange(in uint bits, in uint firstLightIdx, in uint lightsPerBit, in ivec2 lightRange) {
+    if ( any(lessThan(lightRange, ivec2(0))) ) return 0u;
+
+    const uvec2 range    = uvec2(lightRange);
+    const uint lastLight = firstLightIdx + 32 * lightsPerBit - 1;
+    if (range.x > lastLight || range.y < firstLightIdx) return 0u;
+
+    const uint minBit = range.x > firstLightIdx ? (range.x - firstLightIdx) / lightsPerBit : 0u;
+    const uint maxBit = min(31u, (range.y - firstLightIdx) / lightsPerBit);
+
+    const uint minMask = ~((1u << minBit) - 1u);
+    const uint maxMask = maxBit == 31 ? 0xFFFFFFFFu : (1u << (maxBit + 1)) - 1u;
+    return bits & minMask & maxMask;
+}
@@ -0,0 +1,5 @@
+// View space light data uploaded (pre-sorted by min depth) for GPU prepare.
+struct preparedLight {
+    vec4 viewSpacePositionRange; // xyz: view space position, w: range
+    vec4 viewSpaceDepths;        // x: view space depth, y: min depth, z: max depth
+};
@@ -0,0 +1,35 @@
+// Normal & tangent packing of sumire::CompactVertex and QuantizedVertex (see vertex.hpp).
+//  Both are octahedral encoded into two snorm16, with the tangent's handedness in bit 0 of its encoding.
+
+vec3 octDecode(vec2 e) {
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+    return normalize(v);
+}
+
+vec2 octEncode(vec3 v) {
+    float l1 = abs(v.x) + abs(v.y) + abs(v.z);
+    if (l1 <= 0.0) return vec2(0.0);
+
+    vec3 n = v / l1;
+    if (n.z >= 0.0) return n.xy;
+    return (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec3 decodeCompactNormal(uint encoded) {
+    return octDecode(unpackSnorm2x16(encoded));
+}
+
+vec4 decodeCompactTangent(uint encoded) {
+    return vec4(octDecode(unpackSnorm2x16(encoded & ~1u)), (encoded & 1u) != 0u ? -1.0 : 1.0);
+}
+
+uint encodeCompactNormal(vec3 normal) {
+    return packSnorm2x16(octEncode(normal));
+}
+
+// Keeps the handedness bit of the tangent's current encoding.
+uint encodeCompactTangent(vec3 tangent, uint encoded) {
+    return (packSnorm2x16(octEncode(tangent)) & ~1u) | (encoded & 1u);
+}
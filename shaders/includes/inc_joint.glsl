@@ -1,4 +1,48 @@
+// Joint palette formats (see Mesh::JointFormat)
+const int JOINT_FORMAT_MATRIX  = 0;
+const int JOINT_FORMAT_COMPACT = 1;
+
 struct Joint {
     mat4 matrix;
     mat4 normalMatrix;
-};
\ No newline at end of file
+};
+
+// Rotation quaternion (x, y, z, w), and translation (xyz) with uniform scale (w).
+struct CompactJoint {
+    vec4 rotation;
+    vec4 translationScale;
+};
+
+mat3 quatToMat3(vec4 q) {
+    vec3 q2 = q.xyz * 2.0;
+    float xx = q.x * q2.x;
+    float yy = q.y * q2.y;
+    float zz = q.z * q2.z;
+    float xy = q.x * q2.y;
+    float xz = q.x * q2.z;
+    float yz = q.y * q2.z;
+    float wx = q.w * q2.x;
+    float wy = q.w * q2.y;
+    float wz = q.w * q2.z;
+
+    return mat3(
+        1.0 - (yy + zz), xy + wz,         xz - wy,
+        xy - wz,         1.0 - (xx + zz), yz + wx,
+        xz + wy,         yz - wx,         1.0 - (xx + yy)
+    );
+}
+
+mat4 compactJointMatrix(CompactJoint joint) {
+    mat3 rotationScale = quatToMat3(joint.rotation) * joint.translationScale.w;
+    return mat4(
+        vec4(rotationScale[0], 0.0),
+        vec4(rotationScale[1], 0.0),
+        vec4(rotationScale[2], 0.0),
+        vec4(joint.translationScale.xyz, 1.0)
+    );
+}
+
+// Inverse transpose of a rotation and uniform scale, so no inverse is needed.
+mat4 compactJointNormalMatrix(CompactJoint joint) {
+    return mat4(quatToMat3(joint.rotation) / joint.translationScale.w);
+}
@@ -0,0 +1,12 @@
+// Joint palette lookups for either joint format.
+//  Requires inc_joint.glsl, and jointMatrices[] and compactJoints[] declared over the same joint SSBO.
+
+mat4 paletteJointMatrix(int idx, int jointFormat) {
+    return jointFormat == JOINT_FORMAT_COMPACT ?
+        compactJointMatrix(compactJoints[idx]) : jointMatrices[idx].matrix;
+}
+
+mat4 paletteJointNormalMatrix(int idx, int jointFormat) {
+    return jointFormat == JOINT_FORMAT_COMPACT ?
+        compactJointNormalMatrix(compactJoints[idx]) : jointMatrices[idx].normalMatrix;
+}
@@ -25,7 +25,23 @@ namespace sumire {
     // ---- Engine Graphics Settings ---------------------------------------------------------------
 
     struct InternalGraphicsSettings {
+        // At most 32768 (structs::lightMask::MAX_LIGHTS) with HQSM.
         uint32_t MAX_N_LIGHTS = 1024u;
+        // HQSM phase 1 (zBin & light mask generation) on the GPU instead of the CPU.
+        bool GPU_HQSM_PREPARE = false;
+        // Diff GPU prepare results against the CPU reference every frame (slow, debug only).
+        bool VALIDATE_GPU_HQSM_PREPARE = false;
+        // Skin loaded models in pre-draw compute rather than in the vertex shader (toggleable per model).
+        bool COMPUTE_SKINNING = true;
+        // Resample loaded animations into uniform baked tracks, rather than sampling authored keyframes.
+        bool BAKE_ANIMATIONS = true;
+        // Write a .sumimesh cache next to each loaded glTF model, and load from it while the source is unchanged.
+        bool CACHE_MODELS = true;
+        // Store loaded models' vertices in compact, quantized formats where possible (see VertexFormat).
+        //  Compact skinned models are always compute skinned.
+        bool COMPACT_VERTICES = false;
+        // Reorder loaded models' triangles & vertices for the vertex cache, overdraw and vertex fetch.
+        bool OPTIMIZE_MESHES = true;
     };
 
     // ---- All ------------------------------------------------------------------------------------
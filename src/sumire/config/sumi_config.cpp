@@ -105,6 +105,20 @@ namespace sumire {
                 // .MAX_N_LIGHTS
                 auto& localConfigObj = data.graphics.internal;
                 parseUint(v_internalGraphicsSettings, "max_n_lights", objNameStack + ".max_n_lights", &localConfigObj.MAX_N_LIGHTS);
+                // .GPU_HQSM_PREPARE
+                parseBool(v_internalGraphicsSettings, "gpu_hqsm_prepare", objNameStack + ".gpu_hqsm_prepare", &localConfigObj.GPU_HQSM_PREPARE);
+                // .VALIDATE_GPU_HQSM_PREPARE
+                parseBool(v_internalGraphicsSettings, "validate_gpu_hqsm_prepare", objNameStack + ".validate_gpu_hqsm_prepare", &localConfigObj.VALIDATE_GPU_HQSM_PREPARE);
+                // .COMPUTE_SKINNING
+                parseBool(v_internalGraphicsSettings, "compute_skinning", objNameStack + ".compute_skinning", &localConfigObj.COMPUTE_SKINNING);
+                // .BAKE_ANIMATIONS
+                parseBool(v_internalGraphicsSettings, "bake_animations", objNameStack + ".bake_animations", &localConfigObj.BAKE_ANIMATIONS);
+                // .CACHE_MODELS
+                parseBool(v_internalGraphicsSettings, "cache_models", objNameStack + ".cache_models", &localConfigObj.CACHE_MODELS);
+                // .COMPACT_VERTICES
+                parseBool(v_internalGraphicsSettings, "compact_vertices", objNameStack + ".compact_vertices", &localConfigObj.COMPACT_VERTICES);
+                // .OPTIMIZE_MESHES
+                parseBool(v_internalGraphicsSettings, "optimize_meshes", objNameStack + ".optimize_meshes", &localConfigObj.OPTIMIZE_MESHES);
 
             }
             strStackPop(objNameStack, "::internal");
@@ -209,6 +223,20 @@ namespace sumire {
             writer.StartObject();
                 writer.Key("max_n_lights");
                 writer.Uint(data.graphics.internal.MAX_N_LIGHTS);
+                writer.Key("gpu_hqsm_prepare");
+                writer.Bool(data.graphics.internal.GPU_HQSM_PREPARE);
+                writer.Key("validate_gpu_hqsm_prepare");
+                writer.Bool(data.graphics.internal.VALIDATE_GPU_HQSM_PREPARE);
+                writer.Key("compute_skinning");
+                writer.Bool(data.graphics.internal.COMPUTE_SKINNING);
+                writer.Key("bake_animations");
+                writer.Bool(data.graphics.internal.BAKE_ANIMATIONS);
+                writer.Key("cache_models");
+                writer.Bool(data.graphics.internal.CACHE_MODELS);
+                writer.Key("compact_vertices");
+                writer.Bool(data.graphics.internal.COMPACT_VERTICES);
+                writer.Key("optimize_meshes");
+                writer.Bool(data.graphics.internal.OPTIMIZE_MESHES);
             writer.EndObject();
         writer.EndObject();
 
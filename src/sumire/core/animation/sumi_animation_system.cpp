@@ -0,0 +1,89 @@
+#include <sumire/core/animation/sumi_animation_system.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace sumire {
+
+    SumiAnimationSystem::SumiAnimationSystem(SumiThreadPool* threadPool) : threadPool{ threadPool } {}
+
+    SumiAnimationSystem::~SumiAnimationSystem() {
+        // Jobs reference this system, so they must not outlive it.
+        waitForUpdate();
+    }
+
+    void SumiAnimationSystem::beginUpdate(SumiObject::Map& objects, float time, int frameIdx) {
+        assert(pendingJobs.load() == 0u && "Previous animation update was not waited on");
+
+        gatherAnimatedModels(objects);
+        updateTime = time;
+        updateFrameIdx = frameIdx;
+
+        const uint32_t nModels = static_cast<uint32_t>(animatedModels.size());
+        if (nModels == 0u) return;
+
+        if (!threadPool) {
+            updateModels(0u, nModels);
+            return;
+        }
+
+        // One job per model, up to a few jobs per worker so the queue stays short with hundreds of models.
+        //  The last batches may be smaller, which leaves room to balance uneven skeleton sizes.
+        const uint32_t maxJobs = 4u * threadPool->getThreadCount();
+        const uint32_t batchSize = (nModels + maxJobs - 1u) / maxJobs;
+        const uint32_t nJobs = (nModels + batchSize - 1u) / batchSize;
+
+        pendingJobs.store(nJobs);
+        for (uint32_t i = 0; i < nJobs; i++) {
+            const uint32_t begin = i * batchSize;
+            const uint32_t end = std::min(nModels, begin + batchSize);
+            threadPool->submit([this, begin, end]() {
+                updateModels(begin, end);
+
+                // Decrement under the lock so that waitForUpdate() cannot return while we are still signalling.
+                std::unique_lock<std::mutex> lock{ doneMutex };
+                if (pendingJobs.fetch_sub(1u) == 1u) doneCondition.notify_one();
+            });
+        }
+    }
+
+    void SumiAnimationSystem::waitForUpdate() {
+        if (threadPool) {
+            // Help drain the queue rather than sleeping while our jobs are pending.
+            while (pendingJobs.load() > 0u && threadPool->tryRunPendingJob()) {}
+
+            std::unique_lock<std::mutex> lock{ doneMutex };
+            doneCondition.wait(lock, [this]() { return pendingJobs.load() == 0u; });
+        }
+
+        // Jobs are done with the models, so their stats can be read.
+        jointUploadBytes = 0u;
+        for (SumiModel* model : animatedModels) {
+            jointUploadBytes += model->takeJointUploadBytes();
+        }
+    }
+
+    void SumiAnimationSystem::gatherAnimatedModels(SumiObject::Map& objects) {
+        animatedModels.clear();
+        for (auto& kv : objects) {
+            SumiModel* model = kv.second.model.get();
+            if (model && model->isAnimated()) animatedModels.push_back(model);
+        }
+
+        // Objects can share a model, which must only be updated by one job.
+        std::sort(animatedModels.begin(), animatedModels.end());
+        animatedModels.erase(std::unique(animatedModels.begin(), animatedModels.end()), animatedModels.end());
+    }
+
+    void SumiAnimationSystem::updateModels(uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            SumiModel* model = animatedModels[i];
+            if (model->hasAnimationLayers()) {
+                model->updateAnimationLayers(updateTime, updateFrameIdx);
+            } else {
+                model->updateAllAnimations(updateTime, updateFrameIdx);
+            }
+        }
+    }
+
+}
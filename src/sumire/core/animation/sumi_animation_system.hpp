@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sumire/core/models/sumi_model.hpp>
+#include <sumire/core/rendering/general/sumi_object.hpp>
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace sumire {
+
+    // Advances the animations of every animated model in the scene on the worker pool, ahead of
+    //  command recording. Each model is updated by a single job and only writes its own node state
+    //  and its frame in flight's mesh buffers, so models need no synchronisation between each other.
+    //
+    //  Usage per frame, once the frame in flight's fence has been waited on:
+    //    beginUpdate() -> (other main thread work) -> waitForUpdate() -> record draws.
+    class SumiAnimationSystem {
+    public:
+        // If threadPool is null, all models are updated on the calling thread in beginUpdate().
+        explicit SumiAnimationSystem(SumiThreadPool* threadPool = nullptr);
+        ~SumiAnimationSystem();
+
+        SumiAnimationSystem(const SumiAnimationSystem&) = delete;
+        SumiAnimationSystem& operator=(const SumiAnimationSystem&) = delete;
+
+        // Kick off animation jobs for frameIdx. Models shared between objects are only updated once.
+        // Models with animation layers (see SumiModel::addAnimationLayer) blend them, and other models play
+        //  all of their animations, looped.
+        void beginUpdate(SumiObject::Map& objects, float time, int frameIdx);
+        // Block until every job from the last beginUpdate() has finished, helping with pending jobs.
+        void waitForUpdate();
+
+        uint32_t getAnimatedModelCount() const { return static_cast<uint32_t>(animatedModels.size()); }
+        // Joint bytes written by the last update, across all frames in flight it wrote to.
+        uint64_t getJointUploadBytes() const { return jointUploadBytes; }
+
+    private:
+        void gatherAnimatedModels(SumiObject::Map& objects);
+        void updateModels(uint32_t begin, uint32_t end);
+
+        SumiThreadPool* threadPool = nullptr;
+
+        // Reused between frames so that steady state updates do not allocate.
+        std::vector<SumiModel*> animatedModels;
+        float updateTime = 0.0f;
+        int updateFrameIdx = -1;
+        uint64_t jointUploadBytes = 0u;
+
+        std::atomic<uint32_t> pendingJobs{ 0u };
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+    };
+
+}
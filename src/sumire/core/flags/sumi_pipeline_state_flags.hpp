@@ -8,7 +8,11 @@ namespace sumire {
         SUMI_PIPELINE_STATE_DEFAULT = 0x00000000,
         SUMI_PIPELINE_STATE_UNLIT_BIT = 0x00000001,
         SUMI_PIPELINE_STATE_DOUBLE_SIDED_BIT = 0x00000002,
-        SUMI_PIPELINE_STATE_HIGHEST = SUMI_PIPELINE_STATE_DOUBLE_SIDED_BIT,
+        // Vertex input formats, set by the model rather than the material (see VertexFormat).
+        SUMI_PIPELINE_STATE_COMPACT_VERTEX_BIT = 0x00000004,
+        // Only valid with SUMI_PIPELINE_STATE_COMPACT_VERTEX_BIT.
+        SUMI_PIPELINE_STATE_QUANTIZED_POSITION_BIT = 0x00000008,
+        SUMI_PIPELINE_STATE_HIGHEST = SUMI_PIPELINE_STATE_QUANTIZED_POSITION_BIT,
     } SumiPipelineStateFlagBits;
 
     typedef SumiFlags SumiPipelineStateFlags;
@@ -28,7 +28,8 @@ namespace sumire {
         uint32_t instanceCount,
         VkBufferUsageFlags usageFlags,
         VkMemoryPropertyFlags memoryPropertyFlags,
-        VkDeviceSize minOffsetAlignment)
+        VkDeviceSize minOffsetAlignment,
+        VkSharingMode sharingMode)
         : sumiDevice{device},
             instanceSize{instanceSize},
             instanceCount{instanceCount},
@@ -36,7 +37,7 @@ namespace sumire {
             memoryPropertyFlags{memoryPropertyFlags} {
         alignmentSize = getAlignment(instanceSize, minOffsetAlignment);
         bufferSize = alignmentSize * instanceCount;
-        device.createBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory);
+        device.createBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory, sharingMode);
     }
     
     SumiBuffer::~SumiBuffer() {
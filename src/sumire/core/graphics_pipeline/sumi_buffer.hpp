@@ -13,7 +13,8 @@ namespace sumire {
                 uint32_t instanceCount,
                 VkBufferUsageFlags usageFlags,	
                 VkMemoryPropertyFlags memoryPropertyFlags,
-                VkDeviceSize minOffsetAlignment = 1);
+                VkDeviceSize minOffsetAlignment = 1,
+                VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE);
             ~SumiBuffer();
 
             SumiBuffer(const SumiBuffer&) = delete;
@@ -33,6 +34,7 @@ namespace sumire {
             VkResult invalidateIndex(int index);
 
             VkBuffer getBuffer() const { return buffer; }
+            VkDeviceMemory getMemory() const { return memory; }
             void* getMappedMemory() const { return mapped; }
             uint32_t getInstanceCount() const { return instanceCount; }
             VkDeviceSize getInstanceSize() const { return instanceSize; }
@@ -1,4 +1,5 @@
 #include <sumire/core/graphics_pipeline/sumi_device.hpp>
+#include <sumire/core/graphics_pipeline/sumi_upload_batch.hpp>
 
 #include <sumire/util/vk_check_success.hpp>
 
@@ -704,7 +705,8 @@ namespace sumire {
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkBuffer& buffer,
-        VkDeviceMemory& bufferMemory
+        VkDeviceMemory& bufferMemory,
+        VkSharingMode sharingMode
     ) {
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -712,6 +714,13 @@ namespace sumire {
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+        const uint32_t sharedQueueFamilies[] = { queueFamilyIndices.graphicsFamily, queueFamilyIndices.computeFamily };
+        if (sharingMode == VK_SHARING_MODE_CONCURRENT && sharedQueueFamilies[0] != sharedQueueFamilies[1]) {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = 2;
+            bufferInfo.pQueueFamilyIndices = sharedQueueFamilies;
+        }
+
         VK_CHECK_SUCCESS(
             vkCreateBuffer(device_, &bufferInfo, nullptr, &buffer),
             "[Sumire::SumiDevice] Failed to create requested buffer."
@@ -734,6 +743,8 @@ namespace sumire {
     }
 
     VkCommandBuffer SumiDevice::beginSingleTimeCommands() {
+        if (SumiUploadBatch *batch = SumiUploadBatch::current()) return batch->getCommandBuffer();
+
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -752,6 +763,12 @@ namespace sumire {
     }
 
     void SumiDevice::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
+        SumiUploadBatch *batch = SumiUploadBatch::current();
+        if (batch && commandBuffer == batch->getCommandBuffer()) {
+            batch->recordBarrier();
+            return;
+        }
+
         vkEndCommandBuffer(commandBuffer);
 
         VkSubmitInfo submitInfo{};
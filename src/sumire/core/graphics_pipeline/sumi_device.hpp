@@ -96,6 +96,8 @@ namespace sumire {
         VkCommandPool getPresentCommandPool() const { return presentCommandPool; }
         VkCommandPool getComputeCommandPool() const {
             return computeCommandPool == VK_NULL_HANDLE ? graphicsCommandPool : computeCommandPool; }
+        // Submits and waits on the graphics queue, so only for the main thread, unless the calling thread
+        //  has an upload batch, which the commands are recorded into instead (see SumiUploadBatch).
         VkCommandBuffer beginSingleTimeCommands();
         void endSingleTimeCommands(VkCommandBuffer commandBuffer);
 
@@ -105,12 +107,16 @@ namespace sumire {
             const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
         // Buffer Helper Functions
+        // Concurrent buffers are shared between the graphics and compute queue families, so that buffers
+        //  written on one queue and read on the other need no ownership transfers. Falls back to exclusive
+        //  if both queues are of the same family.
         void createBuffer(
             VkDeviceSize size,
             VkBufferUsageFlags usage,
             VkMemoryPropertyFlags properties,
             VkBuffer& buffer,
-            VkDeviceMemory& bufferMemory
+            VkDeviceMemory& bufferMemory,
+            VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE
         );
         void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
         void copyBufferToImage(
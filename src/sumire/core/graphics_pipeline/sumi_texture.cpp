@@ -1,4 +1,5 @@
 #include <sumire/core/graphics_pipeline/sumi_texture.hpp>
+#include <sumire/core/graphics_pipeline/sumi_upload_batch.hpp>
 
 #include <sumire/util/vk_check_success.hpp>
 
@@ -59,28 +60,30 @@ namespace sumire {
         imageInfo.extent.height = textureHeight;
 
         // Upload to GPU memory
-        SumiBuffer stagingBuffer{
+        auto stagingBuffer = std::make_unique<SumiBuffer>(
             device,
             imageSize,
             1,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
+        );
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)imageData);
+        stagingBuffer->map();
+        stagingBuffer->writeToBuffer((void *)imageData);
 
         // Cleanup image in system memory from load
         stbi_image_free(imageData);
 
-        return std::make_unique<SumiTexture>(
+        auto texture = std::make_unique<SumiTexture>(
             device,
             memoryPropertyFlags, 
             imageInfo, 
             generateMips,
             samplerInfo,
-            stagingBuffer
+            *stagingBuffer
         );
+        SumiUploadBatch::releaseStaging(std::move(stagingBuffer));
+        return texture;
     }
 
     // Creates a RGBA texture from RGBA data.
@@ -95,25 +98,27 @@ namespace sumire {
         imageInfo.extent.height = height;
 
         // Upload to GPU memory
-        SumiBuffer stagingBuffer{
+        auto stagingBuffer = std::make_unique<SumiBuffer>(
             device,
             imageSize,
             1,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
+        );
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)data);
+        stagingBuffer->map();
+        stagingBuffer->writeToBuffer((void *)data);
 
-        return std::make_unique<SumiTexture>(
+        auto texture = std::make_unique<SumiTexture>(
             device,
             memoryPropertyFlags, 
             imageInfo, 
             generateMips,
             samplerInfo, 
-            stagingBuffer
+            *stagingBuffer
         );
+        SumiUploadBatch::releaseStaging(std::move(stagingBuffer));
+        return texture;
     }
 
     // Creates a RGBA texture from RGB data.
@@ -141,26 +146,28 @@ namespace sumire {
         }
 
         // Upload to GPU memory
-        SumiBuffer stagingBuffer{
+        auto stagingBuffer = std::make_unique<SumiBuffer>(
             device,
             imageSize,
             1,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
+        );
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)convertedData);
+        stagingBuffer->map();
+        stagingBuffer->writeToBuffer((void *)convertedData);
         delete[] convertedData;
 
-        return std::make_unique<SumiTexture>(
+        auto texture = std::make_unique<SumiTexture>(
             device, 
             memoryPropertyFlags, 
             imageInfo, 
             generateMips,
             samplerInfo, 
-            stagingBuffer
+            *stagingBuffer
         );
+        SumiUploadBatch::releaseStaging(std::move(stagingBuffer));
+        return texture;
     }
 
     // Image create info for a linear RGBA (UNORM) image.
@@ -0,0 +1,107 @@
+#include <sumire/core/graphics_pipeline/sumi_upload_batch.hpp>
+
+#include <sumire/util/vk_check_success.hpp>
+
+#include <cassert>
+
+namespace sumire {
+
+    namespace {
+        thread_local SumiUploadBatch *currentBatch = nullptr;
+    }
+
+    SumiUploadBatch::SumiUploadBatch(SumiDevice &device) : sumiDevice{ device } {
+        // Graphics family, as uploads include layout transitions and mip generation blits (see SumiTexture).
+        //  Each batch has its own pool, as command pools cannot be shared between recording threads.
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = sumiDevice.graphicsQueueFamilyIndex();
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        VK_CHECK_SUCCESS(
+            vkCreateCommandPool(sumiDevice.device(), &poolInfo, nullptr, &commandPool),
+            "[Sumire::SumiUploadBatch] Failed to create upload command pool."
+        );
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        VK_CHECK_SUCCESS(
+            vkAllocateCommandBuffers(sumiDevice.device(), &allocInfo, &commandBuffer),
+            "[Sumire::SumiUploadBatch] Failed to allocate upload command buffer."
+        );
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VK_CHECK_SUCCESS(
+            vkBeginCommandBuffer(commandBuffer, &beginInfo),
+            "[Sumire::SumiUploadBatch] Failed to begin upload command buffer."
+        );
+    }
+
+    SumiUploadBatch::~SumiUploadBatch() {
+        assert(currentBatch != this && "Upload batch destroyed while still the current batch of its thread");
+
+        // Frees the command buffer with it.
+        vkDestroyCommandPool(sumiDevice.device(), commandPool, nullptr);
+        stagingBuffers.clear();
+    }
+
+    SumiUploadBatch::Scope::Scope(SumiUploadBatch &batch) : previous{ currentBatch } {
+        assert(!batch.ended && "Cannot record into an upload batch that has ended");
+        currentBatch = &batch;
+    }
+
+    SumiUploadBatch::Scope::~Scope() {
+        currentBatch = previous;
+    }
+
+    SumiUploadBatch* SumiUploadBatch::current() {
+        return currentBatch;
+    }
+
+    void SumiUploadBatch::releaseStaging(std::unique_ptr<SumiBuffer> stagingBuffer) {
+        if (!currentBatch) return;
+
+        currentBatch->stagingBytes += stagingBuffer->getBufferSize();
+        currentBatch->stagingBuffers.push_back(std::move(stagingBuffer));
+    }
+
+    void SumiUploadBatch::recordBarrier() {
+        assert(!ended && "Cannot record into an upload batch that has ended");
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr
+        );
+
+        commandCount++;
+    }
+
+    void SumiUploadBatch::end() {
+        assert(!ended && "Upload batch already ended");
+        assert(currentBatch != this && "Upload batch ended while still the current batch of its thread");
+
+        VK_CHECK_SUCCESS(
+            vkEndCommandBuffer(commandBuffer),
+            "[Sumire::SumiUploadBatch] Failed to end upload command buffer."
+        );
+        ended = true;
+    }
+
+}
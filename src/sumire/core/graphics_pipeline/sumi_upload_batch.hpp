@@ -0,0 +1,74 @@
+#pragma once
+
+#include <sumire/core/graphics_pipeline/sumi_device.hpp>
+#include <sumire/core/graphics_pipeline/sumi_buffer.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sumire {
+
+    // Records the single time commands (see SumiDevice::beginSingleTimeCommands) issued by one thread into
+    //  one command buffer of its own pool, instead of submitting each and idling the graphics queue.
+    //  Lets GPU resources be created off the main thread, with the batch submitted later by the main
+    //  thread and its completion tracked by a fence (see loaders::AsyncModelLoader).
+    //
+    //  Usage on the recording thread:
+    //    { SumiUploadBatch::Scope scope{ batch }; (create resources) } -> batch.end()
+    //  then submit getCommandBuffer() on the graphics queue, and only destroy the batch, or use the
+    //  resources it uploads to, once that submission has completed.
+    class SumiUploadBatch {
+        public:
+            explicit SumiUploadBatch(SumiDevice &device);
+            ~SumiUploadBatch();
+
+            SumiUploadBatch(const SumiUploadBatch&) = delete;
+            SumiUploadBatch& operator=(const SumiUploadBatch&) = delete;
+
+            // Makes batch the calling thread's upload batch for the scope's lifetime. Scopes nest, so a
+            //  thread may record another batch while helping other jobs (see SumiThreadPool::parallelFor).
+            class Scope {
+                public:
+                    explicit Scope(SumiUploadBatch &batch);
+                    ~Scope();
+
+                    Scope(const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+
+                private:
+                    SumiUploadBatch *previous;
+            };
+
+            // The calling thread's upload batch, or null if it has none.
+            static SumiUploadBatch* current();
+
+            // Destroys a staging buffer once the commands reading it have completed. That is when the
+            //  calling thread's batch completes, or right away without a batch, as single time commands
+            //  have already completed by the time they return.
+            static void releaseStaging(std::unique_ptr<SumiBuffer> stagingBuffer);
+
+            // Orders the commands recorded so far before any recorded after, as if each single time
+            //  command had completed before the next began.
+            void recordBarrier();
+            // Ends recording, ready for submission.
+            void end();
+
+            VkCommandBuffer getCommandBuffer() const { return commandBuffer; }
+            bool hasEnded() const { return ended; }
+            uint32_t getCommandCount() const { return commandCount; }
+            VkDeviceSize getStagingBytes() const { return stagingBytes; }
+
+        private:
+            SumiDevice &sumiDevice;
+
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            bool ended = false;
+            uint32_t commandCount = 0u;
+
+            std::vector<std::unique_ptr<SumiBuffer>> stagingBuffers;
+            VkDeviceSize stagingBytes = 0u;
+    };
+
+}
@@ -0,0 +1,178 @@
+#include <sumire/core/graphics_pipeline/sumi_upload_ring.hpp>
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace sumire {
+
+    SumiUploadRing::SumiUploadRing(
+        SumiDevice& device,
+        VkDeviceSize frameSize,
+        uint32_t numFrames,
+        VkBufferUsageFlags usageFlags
+    ) : sumiDevice{ device }, numFrames{ numFrames } {
+        assert(numFrames > 0 && "Upload ring needs at least one frame region");
+
+        offsetAlignment = getOffsetAlignment(device, usageFlags);
+        atomSize = std::max<VkDeviceSize>(device.properties.limits.nonCoherentAtomSize, 1);
+
+        // Frame regions start on both an offset and a flush atom boundary.
+        this->frameSize = alignUp(frameSize, std::max(offsetAlignment, atomSize));
+
+        buffer = std::make_unique<SumiBuffer>(
+            sumiDevice,
+            this->frameSize,
+            numFrames,
+            usageFlags,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        );
+        buffer->map();
+    }
+
+    /**
+     * Returns the frame size required to bump-allocate each of the given sizes once, in order.
+     *
+     * @param device Device whose alignment limits the ring will be created with
+     * @param usageFlags Buffer usage of the ring
+     * @param allocationSizes Sizes of the allocations made each frame
+     */
+    VkDeviceSize SumiUploadRing::frameSizeFor(
+        SumiDevice& device,
+        VkBufferUsageFlags usageFlags,
+        std::initializer_list<VkDeviceSize> allocationSizes
+    ) {
+        const VkDeviceSize alignment = getOffsetAlignment(device, usageFlags);
+
+        VkDeviceSize size = 0;
+        for (VkDeviceSize allocationSize : allocationSizes) {
+            size = alignUp(size, alignment) + allocationSize;
+        }
+        return size;
+    }
+
+    /**
+     * Starts allocating from a frame's region, discarding its previous allocations.
+     *
+     * @note The frame's previous submission must have completed (e.g. its in flight fence waited on).
+     *
+     * @param frameIdx Frame in flight index
+     */
+    void SumiUploadRing::beginFrame(uint32_t frameIdx) {
+        assert(frameIdx < numFrames && "Upload ring frame index out of range");
+        assert(pendingFlushes.empty() && "Previous upload ring frame was not flushed");
+
+        this->frameIdx = frameIdx;
+        head = frameIdx * frameSize;
+    }
+
+    /**
+     * Bump-allocates a sub-range of the current frame's region.
+     *
+     * @param size Size of the allocation in bytes
+     *
+     * @return Allocation with a pointer into the mapped buffer and its offset for descriptors
+     */
+    SumiUploadRing::Allocation SumiUploadRing::allocate(VkDeviceSize size) {
+        const VkDeviceSize offset = alignUp(head, offsetAlignment);
+        if (offset + size > (frameIdx + 1) * frameSize) {
+            throw std::runtime_error("[Sumire::SumiUploadRing] Frame region out of space.");
+        }
+        head = offset + size;
+
+        Allocation allocation{};
+        allocation.data   = static_cast<char*>(buffer->getMappedMemory()) + offset;
+        allocation.offset = offset;
+        allocation.size   = size;
+        return allocation;
+    }
+
+    /**
+     * Copies data into an allocation and queues the written range for flushing.
+     *
+     * @param allocation Allocation of the current frame
+     * @param data Pointer to the data to copy
+     * @param size Size of the data to copy
+     * @param offset (Optional) Byte offset from the beginning of the allocation
+     */
+    void SumiUploadRing::write(
+        const Allocation& allocation, const void* data, VkDeviceSize size, VkDeviceSize offset
+    ) {
+        assert(offset + size <= allocation.size && "Write out of allocation bounds");
+        memcpy(static_cast<char*>(allocation.data) + offset, data, size);
+        markWritten(allocation, size, offset);
+    }
+
+    /**
+     * Queues a range of an allocation that was written through its mapped pointer for flushing.
+     *
+     * @param allocation Allocation of the current frame
+     * @param size (Optional) Size of the written range. Pass VK_WHOLE_SIZE for the rest of the allocation.
+     * @param offset (Optional) Byte offset from the beginning of the allocation
+     */
+    void SumiUploadRing::markWritten(const Allocation& allocation, VkDeviceSize size, VkDeviceSize offset) {
+        if (size == VK_WHOLE_SIZE) size = allocation.size - offset;
+        if (size == 0) return;
+
+        // Flush ranges must be multiples of nonCoherentAtomSize, frame regions are atom aligned.
+        const VkDeviceSize begin = (allocation.offset + offset) / atomSize * atomSize;
+        const VkDeviceSize end   = std::min(
+            alignUp(allocation.offset + offset + size, atomSize), (frameIdx + 1) * frameSize);
+
+        if (!pendingFlushes.empty()) {
+            VkMappedMemoryRange& last = pendingFlushes.back();
+            if (begin <= last.offset + last.size && end >= last.offset) {
+                const VkDeviceSize mergedBegin = std::min(begin, last.offset);
+                last.size   = std::max(end, last.offset + last.size) - mergedBegin;
+                last.offset = mergedBegin;
+                return;
+            }
+        }
+
+        VkMappedMemoryRange range{};
+        range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = buffer->getMemory();
+        range.offset = begin;
+        range.size   = end - begin;
+        pendingFlushes.push_back(range);
+    }
+
+    /**
+     * Flushes every range written this frame with a single call.
+     *
+     * @return VkResult of the flush call
+     */
+    VkResult SumiUploadRing::flushFrame() {
+        if (pendingFlushes.empty()) return VK_SUCCESS;
+
+        const VkResult result = vkFlushMappedMemoryRanges(
+            sumiDevice.device(), static_cast<uint32_t>(pendingFlushes.size()), pendingFlushes.data());
+        pendingFlushes.clear();
+        return result;
+    }
+
+    /**
+     * Create a buffer info descriptor for an allocation
+     */
+    VkDescriptorBufferInfo SumiUploadRing::descriptorInfo(const Allocation& allocation) const {
+        return buffer->descriptorInfo(allocation.size, allocation.offset);
+    }
+
+    VkDeviceSize SumiUploadRing::getOffsetAlignment(SumiDevice& device, VkBufferUsageFlags usageFlags) {
+        const VkPhysicalDeviceLimits& limits = device.properties.limits;
+
+        VkDeviceSize alignment = 16;
+        if (usageFlags & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+            alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+        if (usageFlags & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+            alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+        return alignment;
+    }
+
+    VkDeviceSize SumiUploadRing::alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+}
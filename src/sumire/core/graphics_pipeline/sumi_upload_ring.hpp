@@ -0,0 +1,72 @@
+#pragma once
+
+#include <sumire/core/graphics_pipeline/sumi_device.hpp>
+#include <sumire/core/graphics_pipeline/sumi_buffer.hpp>
+
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace sumire {
+
+    // A single persistently mapped host visible buffer, split into one region per frame in flight.
+    //  Each frame bump-allocates aligned sub-ranges from its own region, and written ranges are
+    //  flushed together with one call at the end of the frame's uploads.
+    class SumiUploadRing {
+        public:
+            struct Allocation {
+                void* data          = nullptr;
+                VkDeviceSize offset = 0;
+                VkDeviceSize size   = 0;
+            };
+
+            SumiUploadRing(
+                SumiDevice& device,
+                VkDeviceSize frameSize,
+                uint32_t numFrames,
+                VkBufferUsageFlags usageFlags
+            );
+
+            SumiUploadRing(const SumiUploadRing&) = delete;
+            SumiUploadRing& operator=(const SumiUploadRing&) = delete;
+
+            // Smallest frame size fitting one allocation of each size, in order.
+            static VkDeviceSize frameSizeFor(
+                SumiDevice& device,
+                VkBufferUsageFlags usageFlags,
+                std::initializer_list<VkDeviceSize> allocationSizes
+            );
+
+            void beginFrame(uint32_t frameIdx);
+            Allocation allocate(VkDeviceSize size);
+
+            void write(const Allocation& allocation, const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+            void markWritten(const Allocation& allocation, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
+            VkResult flushFrame();
+
+            VkDescriptorBufferInfo descriptorInfo(const Allocation& allocation) const;
+
+            SumiBuffer* getBuffer() const { return buffer.get(); }
+            VkDeviceSize getFrameSize() const { return frameSize; }
+            VkDeviceSize getFrameBytesUsed() const { return head - frameIdx * frameSize; }
+
+        private:
+            static VkDeviceSize getOffsetAlignment(SumiDevice& device, VkBufferUsageFlags usageFlags);
+            static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment);
+
+            SumiDevice& sumiDevice;
+            std::unique_ptr<SumiBuffer> buffer;
+
+            VkDeviceSize offsetAlignment;
+            VkDeviceSize atomSize;
+            VkDeviceSize frameSize;
+            uint32_t numFrames;
+
+            uint32_t frameIdx = 0;
+            VkDeviceSize head = 0;
+
+            // Written ranges of the current frame, atom aligned and merged when adjacent.
+            std::vector<VkMappedMemoryRange> pendingFlushes;
+    };
+
+}
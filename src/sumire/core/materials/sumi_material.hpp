@@ -9,6 +9,7 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -90,7 +91,8 @@ namespace sumire {
             const id_t getId() { return id; }
 
             static std::unique_ptr<SumiMaterial> createMaterial(SumiDevice &device, MaterialTextureData &data) {
-                static id_t currentId = 0;
+                // Atomic, as materials are created by loader worker threads (see loaders::AsyncModelLoader).
+                static std::atomic<id_t> currentId = 0;
                 return std::make_unique<SumiMaterial>(currentId++, device, data);
             }
 
@@ -104,6 +106,7 @@ namespace sumire {
 
             MaterialShaderData getMaterialShaderData();
             VkDescriptorSet getDescriptorSet() { return matDescriptorSet; }
+            const MaterialTextureData& getTextureData() const { return texData; }
 
         private:
             id_t id;
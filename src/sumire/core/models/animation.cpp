@@ -0,0 +1,206 @@
+#include <sumire/core/models/animation.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace sumire {
+
+    void AnimationPose::resize(uint32_t nodeCount) {
+        translations.resize(nodeCount);
+        rotations.resize(nodeCount);
+        scales.resize(nodeCount);
+        touched.resize(nodeCount);
+    }
+
+    float Animation::loopTime(float time) const {
+        // TODO: I'm not sure this works if time < start
+        //		 it would be better to use math::fmod here
+        if (time > end) {
+            float duration = end - start;
+            float exceeds = time - start - duration;
+            float n_times_exceeds = std::floor(exceeds/duration);
+            time = start + (exceeds - n_times_exceeds * duration);
+        }
+        return time;
+    }
+
+    void Animation::resolveNodes() {
+        for (auto& channel : channels) {
+            assert(channel.node != nullptr && "Animation channel has no target node to resolve");
+            channel.nodeIdx = channel.node->hierarchyIdx;
+            channel.node = nullptr;
+        }
+    }
+
+    template <typename Visitor>
+    bool Animation::visitValues(float time, std::vector<uint32_t> &keyframeCursors, Visitor &&visit) const {
+        if (!baked.empty()) return baked.sample(time, start, visit);
+
+        assert(keyframeCursors.size() == channels.size() && "Animation needs one keyframe cursor per channel");
+
+        bool visited = false;
+        for (size_t i = 0; i < channels.size(); i++) {
+            const AnimationChannel &channel = channels[i];
+            // Morph weights are not a single value (see applyMorphWeights())
+            if (channel.path == AnimationChannel::PathType::WEIGHTS) continue;
+
+            glm::vec4 value;
+            if (!samplers[channel.samplerIdx].sample(time, channel.path, keyframeCursors[i], value)) continue;
+
+            visit(channel.nodeIdx, channel.path, value);
+            visited = true;
+        }
+
+        return visited;
+    }
+
+    bool Animation::applyMorphWeights(
+        float time, float weight, bool additive, const std::vector<float> *mask,
+        const NodeHierarchy &targets, std::vector<uint32_t> &keyframeCursors
+    ) const {
+        bool applied = false;
+        for (size_t i = 0; i < channels.size(); i++) {
+            const AnimationChannel &channel = channels[i];
+            if (channel.path != AnimationChannel::PathType::WEIGHTS) continue;
+
+            Mesh *mesh = targets.getNode(channel.nodeIdx)->mesh.get();
+            const AnimationSampler &sampler = samplers[channel.samplerIdx];
+            const float channelWeight = mask ? weight * (*mask)[channel.nodeIdx] : weight;
+            if (!mesh || channelWeight <= 0.0f) continue;
+
+            uint32_t keyframe;
+            float u;
+            if (!sampler.findInterpolant(time, keyframeCursors[i], keyframe, u)) continue;
+
+            const uint32_t nTargets = std::min(sampler.weightCount, static_cast<uint32_t>(mesh->morphWeights.size()));
+            for (uint32_t t = 0; t < nTargets; t++) {
+                const float target = sampler.sampleWeight(keyframe, u, t);
+                float &morphWeight = mesh->morphWeights[t];
+                morphWeight = additive
+                    ? morphWeight + channelWeight * (target - mesh->defaultMorphWeights[t])
+                    : morphWeight + channelWeight * (target - morphWeight);
+            }
+            applied = true;
+        }
+        return applied;
+    }
+
+    bool Animation::sample(float time, const NodeHierarchy &targets, std::vector<uint32_t> &keyframeCursors) const {
+        const bool morphed = applyMorphWeights(time, 1.0f, false, nullptr, targets, keyframeCursors);
+
+        const bool moved = visitValues(time, keyframeCursors, [&](uint32_t nodeIdx, AnimationChannel::PathType path, const glm::vec4 &value) {
+            // Update pointed mesh node parameters (T,S,R)
+            Node *node = targets.getNode(nodeIdx);
+            switch (path) {
+                case AnimationChannel::PathType::TRANSLATION: {
+                    node->setTranslation(glm::vec3(value));
+                }
+                break;
+                case AnimationChannel::PathType::SCALE: {
+                    node->setScale(glm::vec3(value));
+                }
+                break;
+                case AnimationChannel::PathType::ROTATION: {
+                    node->setRotation(glm::quat{ value.w, value.x, value.y, value.z });
+                }
+                break;
+                default: break;
+            }
+        });
+
+        return moved || morphed;
+    }
+
+    // Normalized lerp along the shorter arc.
+    static glm::quat nlerp(const glm::quat &q0, glm::quat q1, float u) {
+        if (glm::dot(q0, q1) < 0.0f) q1 = -q1;
+        return glm::normalize(q0 * (1.0f - u) + q1 * u);
+    }
+
+    bool Animation::blend(
+        const AnimationLayer &layer, const AnimationPose &restPose, AnimationPose &pose,
+        const NodeHierarchy &targets, std::vector<uint32_t> &keyframeCursors
+    ) const {
+        const float time = layer.loop ? loopTime(layer.time) : layer.time;
+
+        bool blended = false;
+        visitValues(time, keyframeCursors, [&](uint32_t idx, AnimationChannel::PathType path, const glm::vec4 &value) {
+            assert(idx < pose.touched.size() && "Animated node is not in the pose's hierarchy");
+
+            const float weight = layer.mask ? layer.weight * (*layer.mask)[idx] : layer.weight;
+            if (weight <= 0.0f) return;
+
+            const bool additive = layer.blendMode == AnimationLayer::BLEND_ADDITIVE;
+            switch (path) {
+                case AnimationChannel::PathType::TRANSLATION: {
+                    const glm::vec3 translation{ value };
+                    pose.translations[idx] = additive
+                        ? pose.translations[idx] + weight * (translation - restPose.translations[idx])
+                        : glm::mix(pose.translations[idx], translation, weight);
+                }
+                break;
+                case AnimationChannel::PathType::ROTATION: {
+                    const glm::quat rotation{ value.w, value.x, value.y, value.z };
+                    if (additive) {
+                        const glm::quat delta = rotation * glm::inverse(restPose.rotations[idx]);
+                        const glm::quat identity{ 1.0f, 0.0f, 0.0f, 0.0f };
+                        pose.rotations[idx] = glm::normalize(nlerp(identity, delta, weight) * pose.rotations[idx]);
+                    } else {
+                        pose.rotations[idx] = nlerp(pose.rotations[idx], rotation, weight);
+                    }
+                }
+                break;
+                case AnimationChannel::PathType::SCALE: {
+                    const glm::vec3 scale{ value };
+                    if (additive) {
+                        // A zero rest scale component has no meaningful ratio, so it adds nothing.
+                        const glm::vec3 &restScale = restPose.scales[idx];
+                        glm::vec3 delta{ 1.0f };
+                        for (int c = 0; c < 3; c++) {
+                            if (restScale[c] != 0.0f) delta[c] = scale[c] / restScale[c];
+                        }
+                        pose.scales[idx] *= glm::mix(glm::vec3{ 1.0f }, delta, weight);
+                    } else {
+                        pose.scales[idx] = glm::mix(pose.scales[idx], scale, weight);
+                    }
+                }
+                break;
+                default: break;
+            }
+
+            pose.touched[idx] = 1u;
+            blended = true;
+        });
+
+        const bool morphed = applyMorphWeights(
+            time, layer.weight, layer.blendMode == AnimationLayer::BLEND_ADDITIVE, layer.mask,
+            targets, keyframeCursors
+        );
+
+        return blended || morphed;
+    }
+
+    bool Animation::bake(float sampleRate) {
+        assert(sampleRate > 0.0f && "Animation bake sample rate must be positive");
+
+        for (const auto& channel : channels) {
+            if (channel.path == AnimationChannel::PathType::WEIGHTS) return false;
+        }
+
+        baked = BakedAnimation::bake(samplers, channels, start, end, sampleRate);
+        return true;
+    }
+
+    size_t Animation::getMemorySize() const {
+        size_t size = sizeof(Animation) + channels.size() * sizeof(AnimationChannel);
+        for (const auto& sampler : samplers) {
+            size += sizeof(AnimationSampler)
+                + sampler.inputs.size() * sizeof(float)
+                + sampler.outputs.size() * sizeof(glm::vec4)
+                + sampler.weightOutputs.size() * sizeof(float);
+        }
+        return size;
+    }
+
+}
\ No newline at end of file
@@ -1,27 +1,48 @@
 #pragma once
 
+#include <sumire/core/models/animation_sampler.hpp>
 #include <sumire/core/models/node.hpp>
+#include <sumire/core/models/node_hierarchy.hpp>
 #include <sumire/util/gltf_interpolators.hpp>
 
+#include <cstdint>
+#include <vector>
+
 namespace sumire {
 
-    struct AnimationChannel {
-        enum PathType { TRANSLATION, ROTATION, SCALE, WEIGHTS };
-        PathType path;
-        Node *node;
-        uint32_t samplerIdx;
-        
-        ~AnimationChannel() {
-            node = nullptr;
-        };
+    // Local translation, rotation and scale of every node in a model, indexed by Node::hierarchyIdx.
+    struct AnimationPose {
+        std::vector<glm::vec3> translations;
+        std::vector<glm::quat> rotations;
+        std::vector<glm::vec3> scales;
+        // Whether any layer wrote to each node during the current evaluation.
+        std::vector<uint8_t> touched;
+
+        void resize(uint32_t nodeCount);
     };
 
-    struct AnimationSampler {
-        util::GLTFinterpolationType interpolation;
-        std::vector<float> inputs;
-        std::vector<glm::vec4> outputs;
+    // One clip of a batched animation evaluation (see SumiModel::evaluateAnimations).
+    struct AnimationLayer {
+        enum BlendMode {
+            // Blend towards the clip's pose by weight, layered over the layers before it.
+            BLEND_LERP,
+            // Add the clip's offset from the rest pose, scaled by weight.
+            BLEND_ADDITIVE
+        };
+
+        uint32_t animationIdx = 0u;
+        float time = 0.0f;
+        float weight = 1.0f;
+        BlendMode blendMode = BLEND_LERP;
+        bool loop = true;
+        // Optional per node weights, indexed by Node::hierarchyIdx (see SumiModel::createAnimationMask).
+        //  Null applies the layer to every node.
+        const std::vector<float> *mask = nullptr;
     };
 
+    // An animation clip. Clips only refer to nodes by hierarchy index, and keep no playback state
+    //  (see keyframe cursors below), so one clip is shared between all instances of a model
+    //  (see SumiModel::createInstance) and evaluated against each instance's own nodes.
     struct Animation {
         std::string name;
         std::vector<AnimationSampler> samplers;
@@ -29,9 +50,50 @@ namespace sumire {
         float start = std::numeric_limits<float>::max();
         float end = std::numeric_limits<float>::min();
 
+        // Optional uniformly resampled copy of the channels, used in place of them once baked.
+        BakedAnimation baked;
+
+        // Wraps time into [start, end] for looped playback.
+        float loopTime(float time) const;
+
+        // Swaps channel node pointers for their hierarchy indices. Called once the owning model's hierarchy is built.
+        void resolveNodes();
+
+        // keyframeCursors hold the keyframe interval each channel found in the previous evaluation
+        //  (see AnimationSampler::findKeyframe), one per channel. They belong to the caller, so that
+        //  instances sharing the clip can be evaluated concurrently.
+        //
+        // Applies the animation's pose at time to its target nodes in targets. Returns true if any node was moved.
+        bool sample(float time, const NodeHierarchy &targets, std::vector<uint32_t> &keyframeCursors) const;
+        // Blends the animation's pose at layer.time into pose rather than writing to the nodes.
+        //  restPose is the reference for additive layers. Returns true if any node was written.
+        //  Morph weights are blended into the target meshes directly, from their default weights if additive.
+        bool blend(
+            const AnimationLayer &layer, const AnimationPose &restPose, AnimationPose &pose,
+            const NodeHierarchy &targets, std::vector<uint32_t> &keyframeCursors
+        ) const;
+
+        // Resamples translation, rotation and scale channels at sampleRate into baked tracks.
+        //  Returns false, leaving the animation unbaked, if it has channels that cannot be baked (e.g. weights).
+        bool bake(float sampleRate = BakedAnimation::DEFAULT_SAMPLE_RATE);
+        // Size of the authored sampler and channel data, for comparison with BakedAnimation::getMemorySize().
+        size_t getMemorySize() const;
+
         ~Animation() {
             channels.clear();
         }
+
+    private:
+        // Calls visit(nodeIdx, path, value) for each animated value at time, from the baked tracks if present.
+        //  Rotations are given as (x, y, z, w). Returns true if any value was visited.
+        template <typename Visitor>
+        bool visitValues(float time, std::vector<uint32_t> &keyframeCursors, Visitor &&visit) const;
+        // Writes WEIGHTS channels to their meshes' morph weights, mixed in by weight (1 replaces them).
+        //  mask is indexed by Node::hierarchyIdx as in AnimationLayer. Returns true if any weights were written.
+        bool applyMorphWeights(
+            float time, float weight, bool additive, const std::vector<float> *mask,
+            const NodeHierarchy &targets, std::vector<uint32_t> &keyframeCursors
+        ) const;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include <sumire/core/models/animation_sampler.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace sumire {
+
+    bool AnimationSampler::findKeyframe(float time, uint32_t &cursor, uint32_t &keyframe) const {
+        if (inputs.size() < 2 || time < inputs.front() || time > inputs.back()) return false;
+
+        // The last keyframe interval starting at or before time. Keyframes are interpolated between
+        //  i and i + 1, so the final keyframe only ever ends an interval.
+        const uint32_t lastInterval = static_cast<uint32_t>(inputs.size()) - 2u;
+        const auto inInterval = [&](uint32_t i) {
+            return inputs[i] <= time && (i == lastInterval || time < inputs[i + 1]);
+        };
+
+        // Forward playback advances by at most a few keyframes per update.
+        if (cursor <= lastInterval && inputs[cursor] <= time) {
+            const uint32_t lastStep = std::min(cursor + MAX_CURSOR_STEPS, lastInterval);
+            for (uint32_t i = cursor; i <= lastStep; i++) {
+                if (inInterval(i)) {
+                    cursor   = i;
+                    keyframe = i;
+                    return true;
+                }
+            }
+        }
+
+        // Seeked or looped
+        const auto next = std::upper_bound(inputs.begin(), inputs.end(), time);
+        const uint32_t i = static_cast<uint32_t>(std::distance(inputs.begin(), next)) - 1u;
+        cursor   = std::min(i, lastInterval);
+        keyframe = cursor;
+        return true;
+    }
+
+    bool AnimationSampler::findInterpolant(float time, uint32_t &cursor, uint32_t &keyframe, float &u) const {
+        if (!findKeyframe(time, cursor, keyframe)) return false;
+
+        // current keyframe (0) and next keyframe (1) input data
+        float input0 = inputs[keyframe];
+        float input1 = inputs[keyframe + 1];
+
+        // Interpolation value
+        u = std::max(0.0f, time - input0) / (input1 - input0);
+        return u >= 0.0f && u <= 1.0f;
+    }
+
+    bool AnimationSampler::sample(float time, AnimationChannel::PathType path, uint32_t &cursor, glm::vec4 &value) const {
+        // Keyframes i and i + 1 to interpolate between, if time is within the sampler's time-frame.
+        uint32_t i;
+        float u;
+        if (!findInterpolant(time, cursor, i, u)) return false;
+
+        // current keyframe (0) and next keyframe (1) output data
+        glm::vec4 output0;
+        glm::vec4 output1;
+        // (output data to fill if cubic spline):
+        glm::vec4 inTangent0{0.0f};
+        glm::vec4 outTangent0{0.0f};
+        glm::vec4 inTangent1{0.0f};
+        glm::vec4 outTangent1{0.0f};
+
+        // Fill output data
+        switch (interpolation) {
+            case util::INTERP_STEP:
+            case util::INTERP_LINEAR: {
+                output0 = outputs[i];
+                output1 = outputs[i + 1];
+            }
+            break;
+            case util::INTERP_CUBIC_SPLINE: {
+                // Cublic spline data is formatted as (in tangent, value, out tangent) triplets.
+                uint32_t offset0 = 3*i;
+                uint32_t offset1 = 3*(i+1);
+                inTangent0  = outputs[offset0];
+                output0     = outputs[offset0 + 1];
+                outTangent0 = outputs[offset0 + 2];
+                inTangent1  = outputs[offset1];
+                output1     = outputs[offset1 + 1];
+                outTangent1 = outputs[offset1 + 2];
+            }
+            break;
+        }
+
+        if (path == AnimationChannel::PathType::ROTATION) {
+            // glm::quat's constructor takes w first
+            glm::quat q0{ output0.w, output0.x, output0.y, output0.z };
+            glm::quat q0_ot{ outTangent0.w, outTangent0.x, outTangent0.y, outTangent0.z };
+            glm::quat q1{ output1.w, output1.x, output1.y, output1.z };
+            glm::quat q1_it{ inTangent1.w, inTangent1.x, inTangent1.y, inTangent1.z };
+
+            glm::quat q = util::interpQuat(q0, q0_ot, q1, q1_it, u, interpolation);
+            value = glm::vec4{ q.x, q.y, q.z, q.w };
+        } else {
+            value = util::interpVec4(output0, outTangent0, output1, inTangent1, u, interpolation);
+        }
+
+        return true;
+    }
+
+    float AnimationSampler::sampleWeight(uint32_t keyframe, float u, uint32_t target) const {
+        assert(target < weightCount && "Morph target weight index out of range");
+
+        switch (interpolation) {
+            case util::INTERP_STEP: {
+                return weightOutputs[keyframe * weightCount + target];
+            }
+            case util::INTERP_LINEAR: {
+                const float w0 = weightOutputs[keyframe * weightCount + target];
+                const float w1 = weightOutputs[(keyframe + 1) * weightCount + target];
+                return w0 + u * (w1 - w0);
+            }
+            case util::INTERP_CUBIC_SPLINE: {
+                // (in tangents, values, out tangents) per keyframe, as cubicSplineVec4 on one component.
+                const uint32_t offset0 = 3 * keyframe * weightCount;
+                const uint32_t offset1 = 3 * (keyframe + 1) * weightCount;
+                const float w0          = weightOutputs[offset0 + weightCount + target];
+                const float outTangent0 = weightOutputs[offset0 + 2 * weightCount + target];
+                const float inTangent1  = weightOutputs[offset1 + target];
+                const float w1          = weightOutputs[offset1 + weightCount + target];
+                return util::cubicSplineVec4(
+                    glm::vec4{ w0 }, glm::vec4{ outTangent0 }, glm::vec4{ w1 }, glm::vec4{ inTangent1 }, u
+                ).x;
+            }
+        }
+        return 0.0f;
+    }
+
+    size_t BakedAnimation::getMemorySize() const {
+        return (translationNodes.size() + rotationNodes.size() + scaleNodes.size()) * sizeof(uint32_t)
+            + translations.size() * sizeof(glm::vec3)
+            + rotations.size() * sizeof(PackedQuat)
+            + scales.size() * sizeof(glm::vec3);
+    }
+
+    BakedAnimation::PackedQuat BakedAnimation::packQuat(const glm::quat &q) {
+        auto pack = [](float c) {
+            return static_cast<int16_t>(std::round(std::clamp(c, -1.0f, 1.0f) * 32767.0f));
+        };
+        return PackedQuat{ pack(q.x), pack(q.y), pack(q.z), pack(q.w) };
+    }
+
+    glm::quat BakedAnimation::unpackQuat(const PackedQuat &q) {
+        constexpr float scale = 1.0f / 32767.0f;
+        return glm::quat{ q.w * scale, q.x * scale, q.y * scale, q.z * scale };
+    }
+
+    BakedAnimation BakedAnimation::bake(
+        const std::vector<AnimationSampler> &samplers, const std::vector<AnimationChannel> &channels,
+        float start, float end, float sampleRate
+    ) {
+        BakedAnimation bakeTarget{};
+
+        // At least two frames, so that sampling always has a frame pair to lerp between.
+        const float duration = std::max(0.0f, end - start);
+        bakeTarget.frameCount = std::max(2u, static_cast<uint32_t>(std::ceil(duration * sampleRate)) + 1u);
+        bakeTarget.sampleRate = duration > 0.0f ? static_cast<float>(bakeTarget.frameCount - 1u) / duration : 0.0f;
+
+        std::vector<const AnimationChannel*> translationChannels;
+        std::vector<const AnimationChannel*> rotationChannels;
+        std::vector<const AnimationChannel*> scaleChannels;
+        for (const auto& channel : channels) {
+            switch (channel.path) {
+                case AnimationChannel::PathType::TRANSLATION: {
+                    translationChannels.push_back(&channel);
+                    bakeTarget.translationNodes.push_back(channel.nodeIdx);
+                }
+                break;
+                case AnimationChannel::PathType::ROTATION: {
+                    rotationChannels.push_back(&channel);
+                    bakeTarget.rotationNodes.push_back(channel.nodeIdx);
+                }
+                break;
+                case AnimationChannel::PathType::SCALE: {
+                    scaleChannels.push_back(&channel);
+                    bakeTarget.scaleNodes.push_back(channel.nodeIdx);
+                }
+                break;
+                default: break;
+            }
+        }
+
+        // Samples a channel with its time clamped to its sampler's time-frame.
+        auto sampleClamped = [&](const AnimationChannel *channel, float time, uint32_t &cursor) {
+            const AnimationSampler &sampler = samplers[channel->samplerIdx];
+            assert(!sampler.inputs.empty() && "Animation sampler has no keyframes");
+
+            glm::vec4 value;
+            const float clampedTime = std::clamp(time, sampler.inputs.front(), sampler.inputs.back());
+            if (sampler.sample(clampedTime, channel->path, cursor, value)) return value;
+
+            // Single keyframe samplers hold their value
+            return sampler.interpolation == util::INTERP_CUBIC_SPLINE ? sampler.outputs[1] : sampler.outputs[0];
+        };
+
+        const uint32_t nFrames = bakeTarget.frameCount;
+        const float frameTime = duration / static_cast<float>(nFrames - 1u);
+        bakeTarget.translations.resize(nFrames * translationChannels.size());
+        bakeTarget.rotations.resize(nFrames * rotationChannels.size());
+        bakeTarget.scales.resize(nFrames * scaleChannels.size());
+
+        // Tracks are sampled one at a time so that each keeps its own keyframe cursor.
+        for (size_t t = 0; t < translationChannels.size(); t++) {
+            uint32_t cursor = 0u;
+            for (uint32_t f = 0; f < nFrames; f++) {
+                const float time = start + static_cast<float>(f) * frameTime;
+                bakeTarget.translations[f * translationChannels.size() + t] =
+                    glm::vec3{ sampleClamped(translationChannels[t], time, cursor) };
+            }
+        }
+
+        for (size_t t = 0; t < rotationChannels.size(); t++) {
+            uint32_t cursor = 0u;
+            glm::quat previous{ 1.0f, 0.0f, 0.0f, 0.0f };
+            for (uint32_t f = 0; f < nFrames; f++) {
+                const float time = start + static_cast<float>(f) * frameTime;
+                glm::vec4 value = sampleClamped(rotationChannels[t], time, cursor);
+                glm::quat q = glm::normalize(glm::quat{ value.w, value.x, value.y, value.z });
+
+                // Keep consecutive frames in the same hemisphere for the runtime normalized lerp
+                if (f > 0 && glm::dot(previous, q) < 0.0f) q = -q;
+                previous = q;
+
+                bakeTarget.rotations[f * rotationChannels.size() + t] = BakedAnimation::packQuat(q);
+            }
+        }
+
+        for (size_t t = 0; t < scaleChannels.size(); t++) {
+            uint32_t cursor = 0u;
+            for (uint32_t f = 0; f < nFrames; f++) {
+                const float time = start + static_cast<float>(f) * frameTime;
+                bakeTarget.scales[f * scaleChannels.size() + t] =
+                    glm::vec3{ sampleClamped(scaleChannels[t], time, cursor) };
+            }
+        }
+
+        return bakeTarget;
+    }
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <sumire/util/gltf_interpolators.hpp>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace sumire {
+
+    // Channels only point at their target node until it is resolved to a hierarchy index.
+    struct Node;
+
+    struct AnimationChannel {
+        enum PathType { TRANSLATION, ROTATION, SCALE, WEIGHTS };
+        PathType path;
+        // Target node as loaded. Replaced by nodeIdx once the model's hierarchy is built (see Animation::resolveNodes).
+        Node *node;
+        // Target node's Node::hierarchyIdx, which is the same in every instance of the model.
+        uint32_t nodeIdx = 0u;
+        uint32_t samplerIdx;
+
+        ~AnimationChannel() {
+            node = nullptr;
+        };
+    };
+
+    struct AnimationSampler {
+        util::GLTFinterpolationType interpolation;
+        std::vector<float> inputs;
+        std::vector<glm::vec4> outputs;
+        // Morph target weights for WEIGHTS channels, weightCount per keyframe (or per tangent & value for
+        //  cubic splines, as in-tangents, values, out-tangents).
+        std::vector<float> weightOutputs;
+        uint32_t weightCount = 0u;
+
+        // Keyframes the cursor may step forward before falling back to a binary search.
+        static constexpr uint32_t MAX_CURSOR_STEPS = 4u;
+
+        // Finds the keyframe i such that time lies in [inputs[i], inputs[i + 1]], or returns false if time is
+        //  outside of the sampler's time-frame. The cursor caches the previous result so forward playback is
+        //  O(1) amortized, falling back to a binary search after seeks and loops.
+        bool findKeyframe(float time, uint32_t &cursor, uint32_t &keyframe) const;
+        // As findKeyframe(), also giving the interpolation value u within the keyframe interval.
+        bool findInterpolant(float time, uint32_t &cursor, uint32_t &keyframe, float &u) const;
+
+        // Evaluates the sampler at time for a channel of the given path. Rotations are returned as (x, y, z, w).
+        //  Returns false if time is outside of the sampler's time-frame.
+        bool sample(float time, AnimationChannel::PathType path, uint32_t &cursor, glm::vec4 &value) const;
+        // Evaluates morph target weight target between keyframe and keyframe + 1 (see findInterpolant()).
+        float sampleWeight(uint32_t keyframe, float u, uint32_t target) const;
+    };
+
+
+    // An Animation resampled at a uniform rate into SoA tracks (see Animation::bake), so that sampling
+    //  indexes frames directly by time and lerps, with no keyframe search or spline evaluation.
+    //  Step keyframes are blended over one sample interval.
+    struct BakedAnimation {
+        static constexpr float DEFAULT_SAMPLE_RATE = 30.0f;
+
+        // Rotation quaternion (x, y, z, w) as snorm16.
+        struct PackedQuat {
+            int16_t x, y, z, w;
+        };
+
+        // Frames per second, adjusted so that the last frame lies on Animation::end.
+        float sampleRate = 0.0f;
+        uint32_t frameCount = 0u;
+
+        // Target Node::hierarchyIdx of each track
+        std::vector<uint32_t> translationNodes;
+        std::vector<uint32_t> rotationNodes;
+        std::vector<uint32_t> scaleNodes;
+
+        // Frame-major, so that all tracks of frame f are contiguous from f * (track count).
+        std::vector<glm::vec3> translations;
+        std::vector<PackedQuat> rotations;
+        std::vector<glm::vec3> scales;
+
+        bool empty() const { return frameCount == 0u; }
+        size_t getMemorySize() const;
+
+        // Resamples the translation, rotation and scale channels over [start, end] at sampleRate.
+        //  WEIGHTS channels are not baked.
+        static BakedAnimation bake(
+            const std::vector<AnimationSampler> &samplers, const std::vector<AnimationChannel> &channels,
+            float start, float end, float sampleRate
+        );
+
+        // Calls visit(nodeIdx, path, value) for each track at time, for tracks baked from start.
+        //  Rotations are given as (x, y, z, w). Returns true if any value was visited.
+        template <typename Visitor>
+        bool sample(float time, float start, Visitor &&visit) const;
+
+        static PackedQuat packQuat(const glm::quat &q);
+        static glm::quat unpackQuat(const PackedQuat &q);
+    };
+
+    template <typename Visitor>
+    bool BakedAnimation::sample(float time, float start, Visitor &&visit) const {
+        // Clamped rather than skipped outside of the animation's time-frame, as baked tracks span all of it.
+        const float lastFrame = static_cast<float>(frameCount - 1u);
+        const float framePos = std::clamp((time - start) * sampleRate, 0.0f, lastFrame);
+        const uint32_t f0 = std::min(static_cast<uint32_t>(framePos), frameCount - 2u);
+        const float u = framePos - static_cast<float>(f0);
+
+        const size_t nTranslations = translationNodes.size();
+        const glm::vec3 *translations0 = &translations[f0 * nTranslations];
+        const glm::vec3 *translations1 = translations0 + nTranslations;
+        for (size_t i = 0; i < nTranslations; i++) {
+            visit(
+                translationNodes[i], AnimationChannel::PathType::TRANSLATION,
+                glm::vec4{ glm::mix(translations0[i], translations1[i], u), 0.0f }
+            );
+        }
+
+        // Tracks are baked in one hemisphere, so a normalized lerp needs no sign check.
+        const size_t nRotations = rotationNodes.size();
+        const PackedQuat *rotations0 = &rotations[f0 * nRotations];
+        const PackedQuat *rotations1 = rotations0 + nRotations;
+        for (size_t i = 0; i < nRotations; i++) {
+            glm::quat q0 = unpackQuat(rotations0[i]);
+            glm::quat q1 = unpackQuat(rotations1[i]);
+            glm::quat q = glm::normalize(q0 * (1.0f - u) + q1 * u);
+            visit(rotationNodes[i], AnimationChannel::PathType::ROTATION, glm::vec4{ q.x, q.y, q.z, q.w });
+        }
+
+        const size_t nScales = scaleNodes.size();
+        const glm::vec3 *scales0 = &scales[f0 * nScales];
+        const glm::vec3 *scales1 = scales0 + nScales;
+        for (size_t i = 0; i < nScales; i++) {
+            visit(
+                scaleNodes[i], AnimationChannel::PathType::SCALE,
+                glm::vec4{ glm::mix(scales0[i], scales1[i], u), 0.0f }
+            );
+        }
+
+        return nTranslations + nRotations + nScales > 0;
+    }
+
+}
@@ -1,4 +1,5 @@
 #include <sumire/core/models/mesh.hpp>
+#include <sumire/core/graphics_pipeline/sumi_swap_chain.hpp>
 
 namespace sumire {
 
@@ -6,34 +7,49 @@ namespace sumire {
         // Create Uniform Buffer
         uniforms.matrix = matrix;
         
-        // Create mesh uniform buffer and descriptor
-        // TODO: Maybe use host coherent here for ease of update
-        uniformBuffer = std::make_unique<SumiBuffer>(
-            device,
-            sizeof(Mesh::UniformData),
-            1,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        );
-        uniformBuffer->map();
-        uniformBuffer->writeToBuffer(&uniforms); // initial uniform buffer write
+        // Create mesh uniform buffers, one per frame in flight
+        uniformBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (auto& uniformBuffer : uniformBuffers) {
+            uniformBuffer = std::make_unique<SumiBuffer>(
+                device,
+                sizeof(Mesh::UniformData),
+                1,
+                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            );
+            uniformBuffer->map();
+            uniformBuffer->writeToBuffer(&uniforms); // initial uniform buffer write
+        }
 
         // Descriptor is left unanitialized until the model initializes it.
     }
 
     void Mesh::initJointBuffer(SumiDevice &device, uint32_t nJoints) {
-        // Leave buffer as VK_NULL_HANDLE if no joints present
+        // Leave buffers empty if no joints present
         if (nJoints <= 0) return;
 
-        // Create Joint SSBO
-        jointBuffer = std::make_unique<SumiBuffer>(
-            device,
-            nJoints * sizeof(Mesh::JointData),
-            1,
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        );
-        jointBuffer->map();
+        // Create Joint SSBOs, one per frame in flight
+        jointBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (auto& jointBuffer : jointBuffers) {
+            jointBuffer = std::make_unique<SumiBuffer>(
+                device,
+                nJoints * sizeof(Mesh::JointData),
+                1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            );
+            jointBuffer->map();
+        }
     }
 
-}
\ No newline at end of file
+    void Mesh::setPositionBounds(const glm::vec3 &boundsMin, const glm::vec3 &boundsExtent) {
+        uniforms.positionScale = glm::vec4{ boundsExtent, 0.0f };
+        uniforms.positionOffset = glm::vec4{ boundsMin, 0.0f };
+
+        // Node updates of unskinned meshes only rewrite the matrices, so the bounds are written once here.
+        for (auto& uniformBuffer : uniformBuffers) {
+            uniformBuffer->writeToBuffer(&uniforms);
+        }
+    }
+
+}
@@ -2,38 +2,97 @@
 
 #include <sumire/core/graphics_pipeline/sumi_device.hpp>
 #include <sumire/core/models/primitive.hpp>
+#include <sumire/core/models/morph_target.hpp>
+
+#include <memory>
+#include <vector>
 
 namespace sumire {
 
     struct Mesh {
         std::vector<std::unique_ptr<Primitive>> primitives;
 
+        // Layout of the joint SSBO (see inc_joint.glsl)
+        enum JointFormat {
+            JOINT_FORMAT_MATRIX = 0,
+            JOINT_FORMAT_COMPACT = 1
+        };
+
         struct UniformData {
             glm::mat4 matrix;
             glm::mat4 normalMatrix;
             int nJoints{ 0 };
+            int jointFormat{ JOINT_FORMAT_MATRIX };
+            // Restores quantized vertex positions to mesh space (see QuantizedVertex). Identity otherwise.
+            alignas(16) glm::vec4 positionScale{ 1.0f };
+            glm::vec4 positionOffset{ 0.0f };
         } uniforms;
 
         struct JointData {
             glm::mat4 jointMatrix;
             glm::mat4 jointNormalMatrix;
         };
+
+        // Rotation, translation and uniform scale of a joint. A quarter of the size of JointData, and
+        //  the normal matrix is derived in the shader rather than from an inverse on the CPU.
+        //  Cannot represent non-uniform scale, shear or mirroring.
+        struct CompactJointData {
+            glm::vec4 rotation;          // quaternion (x, y, z, w)
+            glm::vec4 translationScale;  // translation (xyz), uniform scale (w)
+        };
         
-        // Unform Buffer & Descriptor Set
-        // Only one buffer as constant between swap-chain images
-        std::unique_ptr<SumiBuffer> uniformBuffer = VK_NULL_HANDLE; 
+        // Unform Buffers & Descriptor Sets
+        // One of each per frame in flight, so that animation can write the next frame's matrices
+        //  while the GPU is still reading the previous frame's.
+        std::vector<std::unique_ptr<SumiBuffer>> uniformBuffers;
         // for skinning & animation, stored in host-coherent memory not local gpu memory.
-        std::unique_ptr<SumiBuffer> jointBuffer = VK_NULL_HANDLE; 
-        // Note: This descriptor is PARTIALLY_BOUND as jointBuffer can be VK_NULL_HANDLE if there is no skin.
-        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        //  Left empty if there is no skin.
+        std::vector<std::unique_ptr<SumiBuffer>> jointBuffers;
+        // Note: These descriptors are PARTIALLY_BOUND as there are no joint buffers if there is no skin.
+        std::vector<VkDescriptorSet> descriptorSets;
+
+        // Compute skinning (see SumiModel::setComputeSkinning), per frame in flight.
+        //  Compute skinned meshes are written with nJoints = 0 so that the vertex shader does not skin again.
+        bool computeSkinned = false;
+        std::vector<VkDescriptorSet> skinningDescriptorSets;
+
+        // Joint buffers are sized for JOINT_FORMAT_MATRIX, so the format can be switched in place.
+        JointFormat jointFormat = JOINT_FORMAT_MATRIX;
+
+        // Range of the model's vertices covering this mesh's primitives.
+        uint32_t firstVertex = 0u;
+        uint32_t vertexCount = 0u;
+        // Where that range starts in the model's per frame in flight skinned and morphed vertex buffers, which
+        //  only hold the vertices of skinned and of morphed meshes respectively (see SumiModel::layoutVertexCopies).
+        uint32_t firstSkinnedVertex = 0u;
+        uint32_t firstMorphedVertex = 0u;
+        // Offsets from model vertex indices to this mesh's skinned and morphed vertices.
+        int32_t skinnedVertexOffset() const { return static_cast<int32_t>(firstSkinnedVertex) - static_cast<int32_t>(firstVertex); }
+        int32_t morphedVertexOffset() const { return static_cast<int32_t>(firstMorphedVertex) - static_cast<int32_t>(firstVertex); }
+
+        // Morph targets (see SumiModel::recordMorphTargetRound), empty if the mesh has none.
+        std::vector<MorphTarget> morphTargets;
+        // Current target weights, animated through AnimationChannel::WEIGHTS.
+        std::vector<float> morphWeights;
+        std::vector<float> defaultMorphWeights;
+        // Range of the model's morph vertex indices, covering every vertex any target moves.
+        uint32_t firstMorphVertex = 0u;
+        uint32_t morphVertexCount = 0u;
+        // Targets with a non-zero weight this frame, gathered when recording.
+        std::vector<uint32_t> activeMorphTargets;
+        // Whether each frame in flight's morphed vertices hold any target offsets.
+        std::vector<bool> frameMorphActive;
 
         Mesh(SumiDevice &device, glm::mat4 matrix);
         ~Mesh() {
             primitives.clear();
-            uniformBuffer = nullptr;
+            uniformBuffers.clear();
+            jointBuffers.clear();
         }
 
         void initJointBuffer(SumiDevice &device, uint32_t nJoints);
+        // Sets the bounds this mesh's vertex positions are quantized to, in every frame in flight's uniforms.
+        void setPositionBounds(const glm::vec3 &boundsMin, const glm::vec3 &boundsExtent);
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace sumire {
+
+    // Offset of one vertex for one morph target. Only vertices a target moves have a delta.
+    //  Read as a flat struct by shaders/morphing/compute_morph_targets.comp.
+    struct MorphDelta {
+        uint32_t vertex;
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec3 tangent;
+    };
+
+    // A mesh's morph target, as a range of the model's morph deltas.
+    struct MorphTarget {
+        uint32_t firstDelta = 0u;
+        uint32_t deltaCount = 0u;
+    };
+
+}
@@ -1,5 +1,7 @@
 #include <sumire/core/models/node.hpp>
 
+#include <cassert>
+
 namespace sumire {
 
     void Node::setMatrix(glm::mat4 matrix) {
@@ -22,6 +24,13 @@ namespace sumire {
         needsUpdate = true;
     }
 
+    void Node::setLocalTRS(glm::vec3 translation, glm::quat rotation, glm::vec3 scale) {
+        this->translation = translation;
+        this->rotation = rotation;
+        this->scale = scale;
+        needsUpdate = true;
+    }
+
     // local transform matrix for a *single* node
     glm::mat4 Node::getLocalTransform() {
         if (needsUpdate) {
@@ -47,61 +56,78 @@ namespace sumire {
         return globalMatrix;
     }
 
-    void Node::applyTransformHierarchy() {
+    // Decomposes a joint matrix into rotation, translation and uniform scale.
+    //  Scale is taken as the mean basis vector length, so it is only exact for uniformly scaled joints.
+    Mesh::CompactJointData Node::compactJoint(const glm::mat4 &jointMat) {
+        glm::mat3 basis{ jointMat };
+        float scale = (glm::length(basis[0]) + glm::length(basis[1]) + glm::length(basis[2])) / 3.0f;
+        if (scale <= 0.0f) scale = 1.0f;
 
-        worldTransform = parent ? parent->worldTransform * getLocalTransform() : getLocalTransform();
-        invWorldTransform = glm::inverse(worldTransform);
-        normalMatrix = glm::transpose(invWorldTransform);
+        glm::quat rotation = glm::normalize(glm::quat_cast(basis / scale));
 
-        for (auto& child : children) {
-            child->applyTransformHierarchy();
-        }
+        return Mesh::CompactJointData{
+            glm::vec4{ rotation.x, rotation.y, rotation.z, rotation.w },
+            glm::vec4{ glm::vec3{ jointMat[3] }, scale }
+        };
     }
 
-    // Updates a node and its children.
-    void Node::updateRecursive() {
-        update();
-        
-        // Update Children
-        for (auto& child : children) {
-            child->updateRecursive();
+    // Updates this node only, and not its children.
+    uint64_t Node::update(int frameIdx, uint64_t sinceGeneration) {
+        if (!mesh) return 0u;
+
+        mesh->uniforms.matrix = worldTransform;
+        mesh->uniforms.normalMatrix = normalMatrix;
+
+        // Frames in flight to write to
+        const int firstFrame = frameIdx == ALL_FRAMES ? 0 : frameIdx;
+        const int lastFrame = frameIdx == ALL_FRAMES ? static_cast<int>(mesh->uniformBuffers.size()) - 1 : frameIdx;
+        assert(lastFrame < static_cast<int>(mesh->uniformBuffers.size()) && "Frame index out of range");
+
+        if (!skin) {
+            // Update only the meshnode matrix & normal matrix.
+            for (int i = firstFrame; i <= lastFrame; i++) {
+                mesh->uniformBuffers[i]->writeToBuffer(&mesh->uniforms, 2 * sizeof(glm::mat4), 0);
+            }
+            return 0u;
         }
-    }
 
-    // Updates this node only, and not its children.
-    void Node::update() {
-        // Update mesh nodes
-        if (mesh) {
-            mesh->uniforms.matrix = worldTransform;
-            mesh->uniforms.normalMatrix = normalMatrix;
-
-            // Update joint matrix
-            if (skin) {
-                uint32_t nJoints = static_cast<uint32_t>(skin->joints.size());
-                
-                auto jointData = std::vector<Mesh::JointData>(nJoints);
-                for (uint32_t i = 0; i < nJoints; i++) {
-                    Node *jointNode = skin->joints[i];
-                    glm::mat4 jointMat = invWorldTransform * jointNode->worldTransform * skin->inverseBindMatrices[i];
-                    glm::mat4 jointNormalMat = glm::transpose(glm::inverse(jointMat));
-                    // mesh->uniforms.jointMatrices[i] = jointMat;
-                    // mesh->uniforms.jointNormalMatrices[i] = jointNormalMat;
-                    jointData[i] = Mesh::JointData{jointMat, jointNormalMat};
-                }
-                mesh->uniforms.nJoints = static_cast<int>(nJoints);
+        const uint32_t nJoints = static_cast<uint32_t>(skin->joints.size());
+        const bool compact = mesh->jointFormat == Mesh::JOINT_FORMAT_COMPACT;
+        mesh->uniforms.nJoints = mesh->computeSkinned ? 0 : static_cast<int>(nJoints);
+        mesh->uniforms.jointFormat = mesh->jointFormat;
+
+        for (int i = firstFrame; i <= lastFrame; i++) {
+            mesh->uniformBuffers[i]->writeToBuffer(&mesh->uniforms);
+        }
+
+        // Joint matrices are relative to the mesh node, so every joint is dirty if the mesh node moved.
+        //  Otherwise only joints whose world transform changed since the frame was last written.
+        const bool allJointsDirty = sinceGeneration == 0u || worldGeneration > sinceGeneration;
+        const VkDeviceSize jointSize = compact ? sizeof(Mesh::CompactJointData) : sizeof(Mesh::JointData);
+
+        // Joints are written straight into the mapped buffers, which are host coherent (see Mesh::initJointBuffer).
+        uint32_t nDirty = 0u;
+        for (uint32_t j = 0; j < nJoints; j++) {
+            Node *jointNode = skin->joints[j];
+            if (!allJointsDirty && jointNode->worldGeneration <= sinceGeneration) continue;
+            nDirty++;
 
-                // Write updated uniforms
-                mesh->uniformBuffer->writeToBuffer(&mesh->uniforms);
+            glm::mat4 jointMat = invWorldTransform * jointNode->worldTransform * skin->inverseBindMatrices[j];
 
-                // Write joints to SSBO
-                // TODO: Currently we rewrite the whole joint buffer which may be quite slow if a lot of data
-                //		 is unchanged. It may be faster to rewrite on changed instances only (would require benchmark)
-                mesh->jointBuffer->writeToBuffer(jointData.data());
+            if (compact) {
+                const Mesh::CompactJointData jointData = compactJoint(jointMat);
+                for (int i = firstFrame; i <= lastFrame; i++) {
+                    static_cast<Mesh::CompactJointData*>(mesh->jointBuffers[i]->getMappedMemory())[j] = jointData;
+                }
             } else {
-                // Update only the meshnode matrix & normal matrix.
-                mesh->uniformBuffer->writeToBuffer(&mesh->uniforms, 2 * sizeof(glm::mat4), 0);
+                const Mesh::JointData jointData{ jointMat, glm::transpose(glm::inverse(jointMat)) };
+                for (int i = firstFrame; i <= lastFrame; i++) {
+                    static_cast<Mesh::JointData*>(mesh->jointBuffers[i]->getMappedMemory())[j] = jointData;
+                }
             }
         }
+
+        return static_cast<uint64_t>(nDirty) * jointSize * static_cast<uint64_t>(lastFrame - firstFrame + 1);
     }
 
 }
\ No newline at end of file
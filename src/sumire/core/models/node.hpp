@@ -30,11 +30,16 @@ namespace sumire {
         glm::mat4 worldTransform{ 1.0f };
         glm::mat4 invWorldTransform{ 1.0f };
         glm::mat4 normalMatrix{ 1.0f };
+        // Model node generation in which worldTransform last changed (see SumiModel::nodeGeneration).
+        uint64_t worldGeneration{ 0u };
+        // Index in the model's NodeHierarchy, set when it is built.
+        uint32_t hierarchyIdx{ 0u };
 
         void setMatrix(glm::mat4 matrix);
         void setTranslation(glm::vec3 translation);
         void setRotation(glm::quat rotation);
         void setScale(glm::vec3 scale);
+        void setLocalTRS(glm::vec3 translation, glm::quat rotation, glm::vec3 scale);
 
         glm::mat4 getLocalTransform();
         glm::mat4 getGlobalTransform();
@@ -43,10 +48,14 @@ namespace sumire {
         Skin *skin;
         int32_t skinIdx{-1};
 
-        // Update matrices, skinning, and joints
-        void applyTransformHierarchy();
-        void updateRecursive();
-        void update();
+        // Update mesh matrices, skinning, and joints from the world transforms (see NodeHierarchy::propagate).
+        //  Mesh buffers are written for one frame in flight, or for every frame with ALL_FRAMES.
+        //  Only joints that moved after sinceGeneration are written, or all of them if it is 0.
+        //  Returns the number of joint bytes written.
+        static constexpr int ALL_FRAMES = -1;
+        uint64_t update(int frameIdx = ALL_FRAMES, uint64_t sinceGeneration = 0u);
+
+        static Mesh::CompactJointData compactJoint(const glm::mat4 &jointMat);
         bool needsUpdate = true;
 
         ~Node() {
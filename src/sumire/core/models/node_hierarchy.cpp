@@ -0,0 +1,71 @@
+#include <sumire/core/models/node_hierarchy.hpp>
+
+#include <cassert>
+
+namespace sumire {
+
+    void NodeHierarchy::build(const std::vector<Node*> &roots) {
+        nodes.clear();
+        parents.clear();
+        meshNodes.clear();
+
+        for (Node *root : roots) {
+            nodes.push_back(root);
+            parents.push_back(NO_PARENT);
+        }
+
+        // Breadth-first, so each node is appended after its parent and siblings stay contiguous.
+        //  nodes grows while iterating, hence indexing rather than iterators.
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            Node *node = nodes[i];
+            node->hierarchyIdx = i;
+            if (node->mesh) meshNodes.push_back(i);
+
+            for (Node *child : node->children) {
+                assert(child->parent == node && "Node child does not reference its parent");
+                nodes.push_back(child);
+                parents.push_back(static_cast<int32_t>(i));
+            }
+        }
+
+        localTransforms = std::vector<glm::mat4>(nodes.size(), glm::mat4{ 1.0f });
+        worldTransforms = std::vector<glm::mat4>(nodes.size(), glm::mat4{ 1.0f });
+        worldChanged = std::vector<uint8_t>(nodes.size(), 0u);
+        fullUpdate = true;
+    }
+
+    bool NodeHierarchy::propagate(uint64_t generation) {
+        bool anyChanged = false;
+
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            Node *node = nodes[i];
+            const int32_t parent = parents[i];
+
+            const bool localChanged = node->needsUpdate || fullUpdate;
+            if (localChanged) localTransforms[i] = node->getLocalTransform();
+
+            // Parents always precede children, so the parent's flag is already final for this pass.
+            const bool changed = localChanged || (parent != NO_PARENT && worldChanged[parent]);
+            worldChanged[i] = changed ? 1u : 0u;
+            if (!changed) continue;
+
+            worldTransforms[i] = parent != NO_PARENT
+                ? worldTransforms[parent] * localTransforms[i]
+                : localTransforms[i];
+            node->worldTransform = worldTransforms[i];
+            node->worldGeneration = generation;
+
+            // Only mesh nodes read their inverse and normal matrices (see Node::update)
+            if (node->mesh) {
+                node->invWorldTransform = glm::inverse(node->worldTransform);
+                node->normalMatrix = glm::transpose(node->invWorldTransform);
+            }
+
+            anyChanged = true;
+        }
+
+        fullUpdate = false;
+        return anyChanged;
+    }
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <sumire/core/models/node.hpp>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sumire {
+
+    // A model's node trees flattened into one parent-before-child array, so that world transforms are
+    //  propagated in a single linear pass rather than by recursing through Node::children.
+    //  Transforms are held in SoA form indexed by hierarchy order, with parent indices in place of pointers.
+    class NodeHierarchy {
+    public:
+        static constexpr int32_t NO_PARENT = -1;
+
+        // Flattens the trees under roots breadth-first, and sets each node's hierarchyIdx.
+        //  Every node is recomputed by the next propagate().
+        void build(const std::vector<Node*> &roots);
+
+        // Recomputes world transforms of nodes whose local transform changed (see Node::needsUpdate),
+        //  and of their descendants. Untouched subtrees are skipped. World transforms are written back
+        //  to the nodes, along with inverse and normal matrices for mesh nodes, and the changed nodes are
+        //  stamped with generation (see Node::worldGeneration).
+        //  Returns true if any world transform changed.
+        bool propagate(uint64_t generation);
+
+        uint32_t size() const { return static_cast<uint32_t>(nodes.size()); }
+        Node* getNode(uint32_t idx) const { return nodes[idx]; }
+        int32_t getParent(uint32_t idx) const { return parents[idx]; }
+        // Hierarchy indices of nodes with a mesh, parent-before-child.
+        const std::vector<uint32_t>& getMeshNodes() const { return meshNodes; }
+
+    private:
+        std::vector<Node*> nodes;
+        std::vector<int32_t> parents;
+        std::vector<glm::mat4> localTransforms;
+        std::vector<glm::mat4> worldTransforms;
+        // Whether each node's world transform changed in the last propagate().
+        std::vector<uint8_t> worldChanged;
+        std::vector<uint32_t> meshNodes;
+
+        bool fullUpdate = true;
+    };
+
+}
@@ -7,15 +7,18 @@ namespace sumire {
     struct Primitive {
         uint32_t firstIndex;
         uint32_t indexCount;
+        uint32_t firstVertex;
         uint32_t vertexCount;
         SumiMaterial *material{nullptr};
         uint32_t materialIdx;
 
         Primitive(
             uint32_t firstIndex, 
-            uint32_t indexCount, uint32_t vertexCount, 
+            uint32_t indexCount, 
+            uint32_t firstVertex, uint32_t vertexCount, 
             SumiMaterial *material, uint32_t materialIdx
-        ) : firstIndex{firstIndex}, indexCount{indexCount}, vertexCount{vertexCount},
+        ) : firstIndex{firstIndex}, indexCount{indexCount}, 
+            firstVertex{firstVertex}, vertexCount{vertexCount},
             material{material}, materialIdx{materialIdx} {}
     };
     
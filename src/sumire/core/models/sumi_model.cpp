@@ -3,17 +3,23 @@
 
 // TODO: These structs should be unified between deferred and forward
 #include <sumire/core/render_systems/forward/mesh_rendersys_structs.hpp>
+#include <sumire/core/render_systems/skinning/compute_skinner_structs.hpp>
+#include <sumire/core/render_systems/morphing/compute_morpher_structs.hpp>
 
 #include <sumire/core/graphics_pipeline/sumi_swap_chain.hpp>
+#include <sumire/core/graphics_pipeline/sumi_upload_batch.hpp>
 
 // TODO: Could we find a way around using experimental GLM hashing? (though it seems stable)
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/string_cast.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <unordered_map>
 
 namespace sumire {
 
@@ -29,55 +35,410 @@ namespace sumire {
         flatNodes = std::move(data.flatNodes);
         meshCount = std::move(data.meshCount);
         skins = std::move(data.skins);
-        animations = std::move(data.animations);
-        materials = std::move(data.materials);
+        for (auto& animation : data.animations) animations.push_back(std::move(animation));
+        for (auto& material : data.materials) materials.push_back(std::move(material));
+
+        nodeHierarchy.build(nodes);
+        for (auto& animation : animations) animation->resolveNodes();
+        restPose.resize(nodeHierarchy.size());
+        for (uint32_t i = 0; i < nodeHierarchy.size(); i++) {
+            const Node *node = nodeHierarchy.getNode(i);
+            restPose.translations[i] = node->translation;
+            restPose.rotations[i] = node->rotation;
+            restPose.scales[i] = node->scale;
+        }
+        initInstanceState();
 
         // Init resources on the GPU
-        createVertexBuffers(data.vertices);
-        createIndexBuffer(data.indices);
+        createVertexBuffers(
+            data.vertexView.empty() ? std::span<const Vertex>{ data.vertices } : data.vertexView,
+            data.compactVertices
+        );
+        createIndexBuffer(data.indexView.empty() ? std::span<const uint32_t>{ data.indices } : data.indexView);
+        if (!morphMeshes.empty()) createMorphTargetResources(data.morphDeltas, data.morphVertices);
         createDefaultTextures();
-        initDescriptors();
+        initMeshNodeDescriptors();
+        initMaterialDescriptors();
         createMaterialStorageBuffer();
+
+        // The compact skin stream is only read by compute skinning.
+        if (vertexFormat != VERTEX_FORMAT_FULL) setComputeSkinning(true);
+
+        // Initial pose
+        updateNodes();
+    }
+
+    SumiModel::SumiModel(SumiDevice &device, const SumiModel &source)
+        : sumiDevice{ device }
+    {
+        // Shared resources
+        meshCount = source.meshCount;
+        animations = source.animations;
+        materials = source.materials;
+        vertexBuffer = source.vertexBuffer;
+        vertexCount = source.vertexCount;
+        vertexFormat = source.vertexFormat;
+        vertexStride = source.vertexStride;
+        vertexPipelineState = source.vertexPipelineState;
+        skinVertexBuffer = source.skinVertexBuffer;
+        skinJointBits = source.skinJointBits;
+        useIndexBuffer = source.useIndexBuffer;
+        indexBuffer = source.indexBuffer;
+        indexCount = source.indexCount;
+        morphDeltaBuffer = source.morphDeltaBuffer;
+        morphVertexBuffer = source.morphVertexBuffer;
+        materialDescriptorPool = source.materialDescriptorPool;
+        materialStorageDescriptorSet = source.materialStorageDescriptorSet;
+        materialStorageBuffer = source.materialStorageBuffer;
+        emptyTexture = source.emptyTexture;
+        restPose = source.restPose;
+        displayName = source.displayName;
+
+        // Per instance state, starting from the rest pose rather than the source's current pose.
+        //  Clips address nodes by hierarchy index, so the cloned hierarchy must match the source's.
+        cloneNodes(source);
+        nodeHierarchy.build(nodes);
+        assert(nodeHierarchy.size() == source.nodeHierarchy.size() && "Instance hierarchy does not match its source");
+        for (uint32_t i = 0; i < nodeHierarchy.size(); i++) {
+            assert(nodeHierarchy.getNode(i)->idx == source.nodeHierarchy.getNode(i)->idx
+                && "Instance hierarchy does not match its source");
+            nodeHierarchy.getNode(i)->setLocalTRS(restPose.translations[i], restPose.rotations[i], restPose.scales[i]);
+        }
+        initInstanceState();
+
+        if (!morphMeshes.empty()) createMorphedVertexBuffers();
+        initMeshNodeDescriptors();
+
+        setJointFormat(source.jointFormat);
+        setComputeSkinning(source.computeSkinning);
+
+        // Initial pose
+        updateNodes();
+    }
+
+    std::unique_ptr<SumiModel> SumiModel::createInstance() const {
+        // Constructor is private, so make_unique cannot be used.
+        return std::unique_ptr<SumiModel>(new SumiModel(sumiDevice, *this));
+    }
+
+    void SumiModel::cloneNodes(const SumiModel &source) {
+        std::unordered_map<const Node*, Node*> nodeMap;
+        nodeMap.reserve(source.flatNodes.size());
+
+        flatNodes.reserve(source.flatNodes.size());
+        for (const auto& sourceNode : source.flatNodes) {
+            std::unique_ptr<Node> node = std::make_unique<Node>();
+            node->idx = sourceNode->idx;
+            node->parent = nullptr;
+            node->name = sourceNode->name;
+            node->matrix = sourceNode->matrix;
+            node->translation = sourceNode->translation;
+            node->rotation = sourceNode->rotation;
+            node->scale = sourceNode->scale;
+            node->skin = nullptr;
+            node->skinIdx = sourceNode->skinIdx;
+
+            nodeMap[sourceNode.get()] = node.get();
+            flatNodes.push_back(std::move(node));
+        }
+
+        // Skins reference this instance's joints. Inverse bind matrices are copied as they are per joint.
+        skins.reserve(source.skins.size());
+        for (const auto& sourceSkin : source.skins) {
+            std::unique_ptr<Skin> skin = std::make_unique<Skin>();
+            skin->name = sourceSkin->name;
+            skin->skeletonRoot = sourceSkin->skeletonRoot ? nodeMap.at(sourceSkin->skeletonRoot) : nullptr;
+            skin->inverseBindMatrices = sourceSkin->inverseBindMatrices;
+            skin->joints.reserve(sourceSkin->joints.size());
+            for (Node *joint : sourceSkin->joints) {
+                skin->joints.push_back(nodeMap.at(joint));
+            }
+            skins.push_back(std::move(skin));
+        }
+
+        for (size_t i = 0; i < source.flatNodes.size(); i++) {
+            const Node &sourceNode = *source.flatNodes[i];
+            Node *node = flatNodes[i].get();
+
+            if (sourceNode.parent) node->parent = nodeMap.at(sourceNode.parent);
+            node->children.reserve(sourceNode.children.size());
+            for (Node *child : sourceNode.children) {
+                node->children.push_back(nodeMap.at(child));
+            }
+            if (node->skinIdx > -1) node->skin = skins[node->skinIdx].get();
+
+            // Meshes get their own buffers, but draw the same primitives.
+            if (sourceNode.mesh) {
+                const Mesh &sourceMesh = *sourceNode.mesh;
+                std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>(sumiDevice, node->matrix);
+                for (const auto& primitive : sourceMesh.primitives) {
+                    mesh->primitives.push_back(std::make_unique<Primitive>(*primitive));
+                }
+                mesh->morphTargets = sourceMesh.morphTargets;
+                mesh->defaultMorphWeights = sourceMesh.defaultMorphWeights;
+                mesh->morphWeights = sourceMesh.defaultMorphWeights;
+                mesh->firstMorphVertex = sourceMesh.firstMorphVertex;
+                mesh->morphVertexCount = sourceMesh.morphVertexCount;
+                if (vertexFormat == VERTEX_FORMAT_QUANTIZED) {
+                    mesh->setPositionBounds(
+                        glm::vec3{ sourceMesh.uniforms.positionOffset }, glm::vec3{ sourceMesh.uniforms.positionScale });
+                }
+                if (node->skin) mesh->initJointBuffer(sumiDevice, static_cast<uint32_t>(node->skin->joints.size()));
+                node->mesh = std::move(mesh);
+            }
+        }
+
+        nodes.reserve(source.nodes.size());
+        for (Node *root : source.nodes) {
+            nodes.push_back(nodeMap.at(root));
+        }
+    }
+
+    void SumiModel::initInstanceState() {
+        frameNodeGenerations = std::vector<uint64_t>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, 0u);
+        frameComputeSkinned = std::vector<bool>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, false);
+        frameSkinningRecorded = std::vector<bool>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, false);
+        for (auto& node : flatNodes) {
+            if (node->mesh && node->skin) skinnedMeshCount++;
+            if (node->mesh && !node->mesh->morphTargets.empty()) {
+                node->mesh->frameMorphActive = std::vector<bool>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, false);
+                morphMeshes.push_back(node->mesh.get());
+            }
+        }
+
+        animationCursors.resize(animations.size());
+        for (size_t i = 0; i < animations.size(); i++) {
+            animationCursors[i] = std::vector<uint32_t>(animations[i]->channels.size(), 0u);
+        }
+
+        layoutVertexCopies();
+    }
+
+    void SumiModel::layoutVertexCopies() {
+        skinnedVertexCount = 0u;
+        morphedVertexCount = 0u;
+        for (auto& node : flatNodes) {
+            Mesh *mesh = node->mesh.get();
+            if (!mesh) continue;
+
+            uint32_t firstVertex = std::numeric_limits<uint32_t>::max();
+            uint32_t endVertex = 0u;
+            for (auto& primitive : mesh->primitives) {
+                if (primitive->vertexCount == 0u) continue;
+                firstVertex = std::min(firstVertex, primitive->firstVertex);
+                endVertex = std::max(endVertex, primitive->firstVertex + primitive->vertexCount);
+            }
+            mesh->firstVertex = endVertex > 0u ? firstVertex : 0u;
+            mesh->vertexCount = endVertex > 0u ? endVertex - firstVertex : 0u;
+
+            // Static meshes draw from the shared bind pose, so take no space in the copies.
+            if (node->skin) {
+                mesh->firstSkinnedVertex = skinnedVertexCount;
+                skinnedVertexCount += mesh->vertexCount;
+            }
+            if (!mesh->morphTargets.empty()) {
+                mesh->firstMorphedVertex = morphedVertexCount;
+                morphedVertexCount += mesh->vertexCount;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<SumiBuffer>> SumiModel::createVertexCopies(
+        uint32_t copyVertexCount, const std::vector<VkBufferCopy> &regions
+    ) {
+        assert(copyVertexCount > 0u && !regions.empty() && "Vertex copies created without vertices to copy");
+
+        std::vector<std::unique_ptr<SumiBuffer>> copies(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        VkCommandBuffer commandBuffer = sumiDevice.beginSingleTimeCommands();
+        for (auto& copy : copies) {
+            copy = std::make_unique<SumiBuffer>(
+                sumiDevice,
+                vertexStride,
+                copyVertexCount,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                1,
+                VK_SHARING_MODE_CONCURRENT
+            );
+            vkCmdCopyBuffer(
+                commandBuffer, vertexBuffer->getBuffer(), copy->getBuffer(),
+                static_cast<uint32_t>(regions.size()), regions.data()
+            );
+        }
+        sumiDevice.endSingleTimeCommands(commandBuffer);
+        return copies;
     }
 
     SumiModel::~SumiModel() {
         materialDescriptorPool = nullptr;
         meshNodeDescriptorPool = nullptr;
+        skinningDescriptorPool = nullptr;
+        morphDescriptorPool = nullptr;
         indexBuffer = nullptr;
+        skinnedVertexBuffers.clear();
+        morphedVertexBuffers.clear();
+        morphDeltaBuffer = nullptr;
+        morphVertexBuffer = nullptr;
+        skinVertexBuffer = nullptr;
         vertexBuffer = nullptr;
     }
 
-    void SumiModel::createVertexBuffers(const std::vector<Vertex>& vertices) {
-        vertexCount = static_cast<uint32_t>(vertices.size());
-        assert(vertexCount >= 3 && "Vertex count must be at least 3");
-        uint32_t vertexInstanceSize = sizeof(vertices[0]);
-        VkDeviceSize bufferSize = vertexInstanceSize * vertexCount; // vb size
-
-        SumiBuffer stagingBuffer{
+    std::unique_ptr<SumiBuffer> SumiModel::createStaticBuffer(
+        const void *data, VkDeviceSize instanceSize, uint32_t instanceCount, VkBufferUsageFlags usage,
+        VkSharingMode sharingMode
+    ) {
+        auto stagingBuffer = std::make_unique<SumiBuffer>(
             sumiDevice,
-            vertexInstanceSize,
-            vertexCount,
+            instanceSize,
+            instanceCount,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             // Allow CPU to write to the staging buffer, which is then automatically flushed to the GPU (coherent bit)
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
+        );
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)vertices.data());
+        stagingBuffer->map();
+        stagingBuffer->writeToBuffer(const_cast<void *>(data));
 
-        vertexBuffer = std::make_unique<SumiBuffer>(
+        auto buffer = std::make_unique<SumiBuffer>(
             sumiDevice,
-            vertexInstanceSize,
-            vertexCount,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            instanceSize,
+            instanceCount,
+            usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
             // use fast local GPU memory.
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            1,
+            sharingMode
+        );
+
+        sumiDevice.copyBuffer(stagingBuffer->getBuffer(), buffer->getBuffer(), instanceSize * instanceCount);
+        SumiUploadBatch::releaseStaging(std::move(stagingBuffer));
+        return buffer;
+    }
+
+    VertexFormat SumiModel::chooseVertexFormat(std::span<const Vertex> vertices, bool compact) const {
+        if (!compact) return VERTEX_FORMAT_FULL;
+
+        // fp16 UVs keep sub-texel precision for 4k textures up to |uv| = 2, so tiled UVs stay full precision.
+        constexpr float maxCompactUv = 2.0f;
+        for (const Vertex &vertex : vertices) {
+            const glm::vec4 uvs{ vertex.uv0, vertex.uv1 };
+            if (glm::any(glm::greaterThan(glm::abs(uvs), glm::vec4{ maxCompactUv }))) {
+                std::cout << "[Sumire::SumiModel] WARNING: Model UVs exceed the compact vertex range of +-"
+                    << maxCompactUv << " - using full vertices instead." << std::endl;
+                return VERTEX_FORMAT_FULL;
+            }
+        }
+
+        // Skinned and morphed vertices leave their mesh's bounds, so cannot have quantized positions.
+        if (skinnedMeshCount > 0 || !morphMeshes.empty()) return VERTEX_FORMAT_COMPACT;
+        return VERTEX_FORMAT_QUANTIZED;
+    }
+
+    void SumiModel::createVertexBuffers(std::span<const Vertex> vertices, bool compact) {
+        vertexCount = static_cast<uint32_t>(vertices.size());
+        assert(vertexCount >= 3 && "Vertex count must be at least 3");
+
+        vertexFormat = chooseVertexFormat(vertices, compact);
+
+        // Also read by compute skinning & morphing on the compute queue, and copied into their vertex buffers.
+        constexpr VkBufferUsageFlags vertexBufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+            | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+        switch (vertexFormat) {
+            case VERTEX_FORMAT_FULL: {
+                vertexStride = sizeof(Vertex);
+                vertexBuffer = createStaticBuffer(
+                    vertices.data(), vertexStride, vertexCount, vertexBufferUsage, VK_SHARING_MODE_CONCURRENT);
+                vertexPipelineState = SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_DEFAULT;
+            } break;
+            case VERTEX_FORMAT_COMPACT: {
+                std::vector<CompactVertex> compactVertices(vertexCount);
+                for (uint32_t i = 0; i < vertexCount; i++) {
+                    compactVertices[i] = CompactVertex::encode(vertices[i]);
+                }
+                vertexStride = sizeof(CompactVertex);
+                vertexBuffer = createStaticBuffer(
+                    compactVertices.data(), vertexStride, vertexCount, vertexBufferUsage, VK_SHARING_MODE_CONCURRENT);
+                vertexPipelineState = SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_COMPACT_VERTEX_BIT;
+                if (skinnedMeshCount > 0) createSkinVertexBuffer(vertices);
+            } break;
+            case VERTEX_FORMAT_QUANTIZED: {
+                vertexStride = sizeof(QuantizedVertex);
+                createQuantizedVertexBuffer(vertices);
+                vertexPipelineState = SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_COMPACT_VERTEX_BIT
+                    | SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_QUANTIZED_POSITION_BIT;
+            } break;
+        }
+    }
+
+    void SumiModel::createQuantizedVertexBuffer(std::span<const Vertex> vertices) {
+        // Positions are quantized to the bounds of the mesh drawing them, for the most precision per mesh.
+        //  Vertices no primitive draws are left zeroed.
+        std::vector<QuantizedVertex> quantizedVertices(vertexCount);
+        for (auto& node : flatNodes) {
+            if (!node->mesh) continue;
+
+            glm::vec3 boundsMin{ std::numeric_limits<float>::max() };
+            glm::vec3 boundsMax{ std::numeric_limits<float>::lowest() };
+            for (auto& primitive : node->mesh->primitives) {
+                for (uint32_t v = primitive->firstVertex; v < primitive->firstVertex + primitive->vertexCount; v++) {
+                    boundsMin = glm::min(boundsMin, vertices[v].position);
+                    boundsMax = glm::max(boundsMax, vertices[v].position);
+                }
+            }
+            if (boundsMin.x > boundsMax.x) continue;
+
+            const glm::vec3 boundsExtent = boundsMax - boundsMin;
+            for (auto& primitive : node->mesh->primitives) {
+                for (uint32_t v = primitive->firstVertex; v < primitive->firstVertex + primitive->vertexCount; v++) {
+                    quantizedVertices[v] = QuantizedVertex::encode(vertices[v], boundsMin, boundsExtent);
+                }
+            }
+            node->mesh->setPositionBounds(boundsMin, boundsExtent);
+        }
+
+        vertexBuffer = createStaticBuffer(
+            quantizedVertices.data(), sizeof(QuantizedVertex), vertexCount,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
         );
+    }
 
-        sumiDevice.copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+    void SumiModel::createSkinVertexBuffer(std::span<const Vertex> vertices) {
+        float maxJoint = 0.0f;
+        for (const Vertex &vertex : vertices) {
+            maxJoint = std::max({ maxJoint, vertex.joint.x, vertex.joint.y, vertex.joint.z, vertex.joint.w });
+        }
+
+        // Byte joints cover most skins, for a 12 byte stream rather than 16.
+        skinJointBits = maxJoint < 256.0f ? 8u : 16u;
+        if (skinJointBits == 8u) {
+            std::vector<CompactSkinVertex8> skinVertices(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                skinVertices[i] = CompactSkinVertex8::encode(vertices[i]);
+            }
+            skinVertexBuffer = createStaticBuffer(
+                skinVertices.data(), sizeof(CompactSkinVertex8), vertexCount,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_CONCURRENT);
+        } else {
+            std::vector<CompactSkinVertex> skinVertices(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                skinVertices[i] = CompactSkinVertex::encode(vertices[i]);
+            }
+            skinVertexBuffer = createStaticBuffer(
+                skinVertices.data(), sizeof(CompactSkinVertex), vertexCount,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_CONCURRENT);
+        }
+    }
+
+    VkDeviceSize SumiModel::getVertexMemoryBytes() const {
+        VkDeviceSize bytes = vertexBuffer ? vertexBuffer->getBufferSize() : 0u;
+        if (skinVertexBuffer) bytes += skinVertexBuffer->getBufferSize();
+        for (auto& buffer : skinnedVertexBuffers) bytes += buffer->getBufferSize();
+        for (auto& buffer : morphedVertexBuffers) bytes += buffer->getBufferSize();
+        return bytes;
     }
 
-    void SumiModel::createIndexBuffer(const std::vector<uint32_t>& indices) {
+    void SumiModel::createIndexBuffer(std::span<const uint32_t> indices) {
         indexCount = static_cast<uint32_t>(indices.size());
         useIndexBuffer = indexCount > 0;
 
@@ -86,17 +447,17 @@ namespace sumire {
         uint32_t indexInstanceSize = sizeof(indices[0]);
         VkDeviceSize bufferSize = indexInstanceSize * indexCount; // ib size
         
-        SumiBuffer stagingBuffer{
+        auto stagingBuffer = std::make_unique<SumiBuffer>(
             sumiDevice,
             indexInstanceSize,
             indexCount,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             // Allow CPU to write to the staging buffer, which is then automatically flushed to the GPU (coherent bit)
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
+        );
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)indices.data());
+        stagingBuffer->map();
+        stagingBuffer->writeToBuffer((void *)indices.data());
 
         indexBuffer = std::make_unique<SumiBuffer>(
             sumiDevice,
@@ -107,7 +468,8 @@ namespace sumire {
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
 
-        sumiDevice.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
+        sumiDevice.copyBuffer(stagingBuffer->getBuffer(), indexBuffer->getBuffer(), bufferSize);
+        SumiUploadBatch::releaseStaging(std::move(stagingBuffer));
     }
 
     void SumiModel::createDefaultTextures() {
@@ -127,7 +489,7 @@ namespace sumire {
         );
     }
 
-    void SumiModel::initDescriptors() {
+    void SumiModel::initMeshNodeDescriptors() {
 
         // == Mesh Nodes ====================================================================
         // - To push local transform matrices to the shader via UBO
@@ -141,30 +503,34 @@ namespace sumire {
                 VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 
                 meshCount * SumiSwapChain::MAX_FRAMES_IN_FLIGHT)
             // Skinning information
-            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1)
+            .addPoolSize(
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                meshCount * SumiSwapChain::MAX_FRAMES_IN_FLIGHT)
             .build();
 
         // Nodes descriptor set layout
         auto meshNodeDescriptorSetLayout = SumiModel::meshNodeDescriptorLayout(sumiDevice);
 
-        // Per-Node Descriptor Sets for local matrices
+        // Per-Node Descriptor Sets for local matrices, one per frame in flight
         //   Iterate flat nodes to skip doing recursion here on children.
         for (auto &node : flatNodes) {
             if (node->mesh) {
-                auto uniformBufferInfo = node->mesh->uniformBuffer->descriptorInfo();
-                //auto jointBufferInfo = node->mesh->jointBuffer->descriptorInfo();
-                auto writer = SumiDescriptorWriter(*meshNodeDescriptorSetLayout, *meshNodeDescriptorPool);
-                writer.writeBuffer(0, &uniformBufferInfo);
-                if (node->mesh->jointBuffer) {
-                    auto jointBufferInfo = node->mesh->jointBuffer->descriptorInfo();
-                    writer.writeBuffer(1, &jointBufferInfo);
+                node->mesh->descriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+                for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+                    auto uniformBufferInfo = node->mesh->uniformBuffers[i]->descriptorInfo();
+                    auto writer = SumiDescriptorWriter(*meshNodeDescriptorSetLayout, *meshNodeDescriptorPool);
+                    writer.writeBuffer(0, &uniformBufferInfo);
+                    if (!node->mesh->jointBuffers.empty()) {
+                        auto jointBufferInfo = node->mesh->jointBuffers[i]->descriptorInfo();
+                        writer.writeBuffer(1, &jointBufferInfo);
+                    }
+                    writer.build(node->mesh->descriptorSets[i]);
                 }
-                writer.build(node->mesh->descriptorSet);
-
-                    //.writeBuffer(1, &jointBufferInfo)
-                    //.build(node->mesh->descriptorSet);
             }
         }
+    }
+
+    void SumiModel::initMaterialDescriptors() {
 
         // == Materials =====================================================================
         // - To push textures and material factors to the shader via CIS and UBO
@@ -220,17 +586,18 @@ namespace sumire {
             .build(materialStorageDescriptorSet);
 
         // Stage and write to device local memory
-        SumiBuffer stagingBuffer{
+        auto stagingBuffer = std::make_unique<SumiBuffer>(
             sumiDevice,
             bufferSize,
             1,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)matShaderData.data());
+        );
+        stagingBuffer->map();
+        stagingBuffer->writeToBuffer((void *)matShaderData.data());
 
-        sumiDevice.copyBuffer(stagingBuffer.getBuffer(), materialStorageBuffer->getBuffer(), bufferSize);
+        sumiDevice.copyBuffer(stagingBuffer->getBuffer(), materialStorageBuffer->getBuffer(), bufferSize);
+        SumiUploadBatch::releaseStaging(std::move(stagingBuffer));
     }
 
     std::unique_ptr<SumiDescriptorSetLayout> SumiModel::meshNodeDescriptorLayout(SumiDevice &device) {
@@ -244,6 +611,32 @@ namespace sumire {
             .build();
     }
 
+    std::unique_ptr<SumiDescriptorSetLayout> SumiModel::skinningDescriptorLayout(SumiDevice &device) {
+        return SumiDescriptorSetLayout::Builder(device)
+            // Bind-pose vertices
+            .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            // Joint palette
+            .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            // Skinned vertices
+            .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            // Compact skin vertices (joints & weights)
+            .addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+    }
+
+    std::unique_ptr<SumiDescriptorSetLayout> SumiModel::morphDescriptorLayout(SumiDevice &device) {
+        return SumiDescriptorSetLayout::Builder(device)
+            // Bind-pose vertices
+            .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            // Morphed vertices
+            .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            // Morph deltas
+            .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            // Morph vertex indices
+            .addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+    }
+
     std::unique_ptr<SumiDescriptorSetLayout> SumiModel::matTextureDescriptorLayout(SumiDevice &device) {
         return SumiMaterial::getDescriptorSetLayout(device);
     }
@@ -254,11 +647,8 @@ namespace sumire {
             .build();
     }
 
-    void SumiModel::bind(VkCommandBuffer commandBuffer) {
-        // Vertex and Index Buffers
-        VkBuffer buffers[] = { vertexBuffer->getBuffer() };
-        VkDeviceSize offsets[] = { 0 };
-        vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    void SumiModel::bind(VkCommandBuffer commandBuffer, int frameIdx) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
 
         if (useIndexBuffer) {
             vkCmdBindIndexBuffer(commandBuffer, indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
@@ -268,20 +658,42 @@ namespace sumire {
     void SumiModel::drawNode(
         Node *node, 
         VkCommandBuffer commandBuffer, 
+        int frameIdx,
         VkPipelineLayout pipelineLayout,
         const std::unordered_map<SumiPipelineStateFlags, std::unique_ptr<SumiPipeline>> &pipelines
     ) {
         // Draw this node's primitives
-        if (node->mesh) {
+        //  Compute skinned meshes wait for their frame's first skinning pass, rather than drawing the bind pose.
+        const bool awaitingSkinning = node->skin && frameComputeSkinned[frameIdx] && !frameSkinningRecorded[frameIdx];
+        if (node->mesh && !awaitingSkinning) {
+            // Skinned meshes of compute skinned frames draw from the frame's skinned copy of the vertex buffer,
+            //  and morphed meshes otherwise from its morphed copy. Other meshes draw the bind pose.
+            //  Copies only hold skinned or morphed meshes, so their indices are offset to the mesh's place in them.
+            VkBuffer vertices = vertexBuffer->getBuffer();
+            int32_t vertexOffset = 0;
+            if (node->skin && frameComputeSkinned[frameIdx]) {
+                vertices = skinnedVertexBuffers[frameIdx]->getBuffer();
+                vertexOffset = node->mesh->skinnedVertexOffset();
+            } else if (!node->mesh->morphTargets.empty()) {
+                vertices = morphedVertexBuffers[frameIdx]->getBuffer();
+                vertexOffset = node->mesh->morphedVertexOffset();
+            }
+            if (vertices != boundVertexBuffer) {
+                VkBuffer buffers[] = { vertices };
+                VkDeviceSize offsets[] = { 0 };
+                vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+                boundVertexBuffer = vertices;
+            }
+
             for (auto& primitive : node->mesh->primitives) {
 
                 // Bind required pipeline
-                pipelines.at(primitive->material->requiredPipelineState)->bind(commandBuffer);
+                pipelines.at(primitive->material->requiredPipelineState | vertexPipelineState)->bind(commandBuffer);
 
                 // Bind descriptor sets
                 const std::vector<VkDescriptorSet> descriptorSets{
                     primitive->material->getDescriptorSet(),
-                    node->mesh->descriptorSet,
+                    node->mesh->descriptorSets[frameIdx],
                     materialStorageDescriptorSet,
                 };
 
@@ -311,162 +723,505 @@ namespace sumire {
                 
                 // Draw
                 if (primitive->indexCount > 0) {
-                    vkCmdDrawIndexed(commandBuffer, primitive->indexCount, 1, primitive->firstIndex, 0, 0);
+                    vkCmdDrawIndexed(commandBuffer, primitive->indexCount, 1, primitive->firstIndex, vertexOffset, 0);
                 } else {
-                    vkCmdDraw(commandBuffer, primitive->vertexCount, 1, 0, 0);
+                    vkCmdDraw(commandBuffer, primitive->vertexCount, 1,
+                        static_cast<uint32_t>(static_cast<int32_t>(primitive->firstVertex) + vertexOffset), 0);
                 }
             }
         }
 
         // Draw children
         for (auto& child : node->children) {
-            drawNode(child, commandBuffer, pipelineLayout, pipelines);
+            drawNode(child, commandBuffer, frameIdx, pipelineLayout, pipelines);
         }
     }
 
     // Draw a model node tree. *Starts binding descriptors from set 1*
     void SumiModel::draw(
         VkCommandBuffer commandBuffer, 
+        int frameIdx,
         VkPipelineLayout pipelineLayout,
         const std::unordered_map<SumiPipelineStateFlags, std::unique_ptr<SumiPipeline>> &pipelines
     ) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
+        boundVertexBuffer = VK_NULL_HANDLE;
         for (auto& node : nodes) {
-            drawNode(node, commandBuffer, pipelineLayout, pipelines);
+            drawNode(node, commandBuffer, frameIdx, pipelineLayout, pipelines);
         }
     }
 
     // Update a range of animations for this model.
-    void SumiModel::updateAnimations(const std::vector<uint32_t> indices, float time, bool loop) {
+    void SumiModel::updateAnimations(const std::vector<uint32_t> &indices, float time, int frameIdx, bool loop) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
         if (animations.empty() || indices.empty()) return;
 
+        bool nodesMoved = false;
         for (const uint32_t &i : indices) {
-            updateAnimation(i, time, loop);
+            nodesMoved |= updateAnimation(i, time, loop);
+        }
+
+        commitAnimatedNodes(nodesMoved, frameIdx);
+    }
+
+    // Update all of this model's animations.
+    void SumiModel::updateAllAnimations(float time, int frameIdx, bool loop) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
+        if (animations.empty()) return;
+
+        bool nodesMoved = false;
+        for (uint32_t i = 0; i < animations.size(); i++) {
+            nodesMoved |= updateAnimation(i, time, loop);
+        }
+
+        commitAnimatedNodes(nodesMoved, frameIdx);
+    }
+
+    void SumiModel::evaluateAnimations(const std::vector<AnimationLayer> &layers, int frameIdx) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
+        if (animations.empty() || layers.empty()) return;
+
+        // Every layer starts from the rest pose, so that weights below 1 blend towards it.
+        blendPose.translations = restPose.translations;
+        blendPose.rotations = restPose.rotations;
+        blendPose.scales = restPose.scales;
+        blendPose.touched.assign(restPose.touched.size(), 0u);
+        for (Mesh *mesh : morphMeshes) {
+            mesh->morphWeights = mesh->defaultMorphWeights;
+        }
+
+        bool nodesMoved = false;
+        for (const AnimationLayer &layer : layers) {
+            assert(layer.animationIdx < animations.size() && "Animation index out of range");
+            assert((!layer.mask || layer.mask->size() == nodeHierarchy.size()) && "Animation mask size mismatch");
+            nodesMoved |= animations[layer.animationIdx]->blend(
+                layer, restPose, blendPose, nodeHierarchy, animationCursors[layer.animationIdx]
+            );
+        }
+
+        // Each node is written once, however many layers touched it
+        if (nodesMoved) {
+            for (uint32_t i = 0; i < nodeHierarchy.size(); i++) {
+                if (!blendPose.touched[i]) continue;
+                nodeHierarchy.getNode(i)->setLocalTRS(
+                    blendPose.translations[i], blendPose.rotations[i], blendPose.scales[i]
+                );
+            }
         }
+
+        commitAnimatedNodes(nodesMoved, frameIdx);
+    }
+
+    std::vector<float> SumiModel::createAnimationMask(const Node *root, float weight) const {
+        std::vector<float> mask(nodeHierarchy.size(), 0.0f);
+        std::vector<uint8_t> underRoot(nodeHierarchy.size(), 0u);
+
+        // Parents precede children, so a node is under root if it is root or its parent is.
+        for (uint32_t i = 0; i < nodeHierarchy.size(); i++) {
+            const int32_t parent = nodeHierarchy.getParent(i);
+            underRoot[i] = nodeHierarchy.getNode(i) == root
+                || (parent != NodeHierarchy::NO_PARENT && underRoot[parent]);
+            if (underRoot[i]) mask[i] = weight;
+        }
+        return mask;
+    }
+
+    void SumiModel::addAnimationLayer(const AnimationLayer &layer) {
+        assert(layer.animationIdx < animations.size() && "Animation index out of range");
+        animationLayers.push_back(layer);
+        animationLayerMasks.emplace_back();
+        animationLayerMaskRoots.push_back(NodeHierarchy::NO_PARENT);
+    }
+
+    void SumiModel::removeAnimationLayer(uint32_t layerIdx) {
+        assert(layerIdx < animationLayers.size() && "Animation layer index out of range");
+        animationLayers.erase(animationLayers.begin() + layerIdx);
+        animationLayerMasks.erase(animationLayerMasks.begin() + layerIdx);
+        animationLayerMaskRoots.erase(animationLayerMaskRoots.begin() + layerIdx);
+    }
+
+    void SumiModel::setAnimationLayerMask(uint32_t layerIdx, int32_t rootIdx) {
+        assert(layerIdx < animationLayers.size() && "Animation layer index out of range");
+        assert(rootIdx < static_cast<int32_t>(nodeHierarchy.size()) && "Node index out of range");
+
+        animationLayerMaskRoots[layerIdx] = rootIdx;
+        if (rootIdx == NodeHierarchy::NO_PARENT) {
+            animationLayerMasks[layerIdx].clear();
+        } else {
+            animationLayerMasks[layerIdx] = createAnimationMask(nodeHierarchy.getNode(rootIdx));
+        }
+    }
+
+    void SumiModel::updateAnimationLayers(float time, int frameIdx) {
+        // Masks are pointed to here, as they move whenever layers are added or removed.
+        for (size_t i = 0; i < animationLayers.size(); i++) {
+            animationLayers[i].time = time;
+            animationLayers[i].mask = animationLayerMasks[i].empty() ? nullptr : &animationLayerMasks[i];
+        }
+        evaluateAnimations(animationLayers, frameIdx);
     }
 
-    void SumiModel::updateAnimation(uint32_t animIdx, float time, bool loop) {
+    void SumiModel::commitAnimatedNodes(bool nodesMoved, int frameIdx) {
+        // Propagate transforms once for all animations, rather than once per animation
+        if (nodesMoved && nodeHierarchy.propagate(nodeGeneration + 1u)) {
+            nodeGeneration++;
+        }
+
+        // Frames in flight that missed earlier updates still need the current pose
+        if (frameNodeGenerations[frameIdx] != nodeGeneration) {
+            writeNodes(frameIdx);
+        }
+    }
+
+    bool SumiModel::updateAnimation(uint32_t animIdx, float time, bool loop) {
         assert(animIdx < animations.size() && animIdx >= 0 && "Animation index out of range");
         
-        std::unique_ptr<Animation>& animation = animations[animIdx];
-
-        // loop animation
-        // TODO: I'm not sure this works if time < animation->start
-        //		 it would be better to use math::fmod here
-        if (loop && time > animation->end) {
-            float duration = animation->end - animation->start;
-            float exceeds = time - animation->start - duration;
-            float n_times_exceeds = std::floor(exceeds/duration);
-            time = animation->start + (exceeds - n_times_exceeds * duration);
-        }
-
-        // TODO: Perhaps this "changed" flag should be given to each node so only updated nodes are affected.
-        bool modelUpdated = false;
-        for (auto& channel : animation->channels) {
-            AnimationSampler &sampler = animation->samplers[channel.samplerIdx];
-            
-            // Note: Only loop to penultimate animation state as we interpolate between keyframes
-            //		 i and i + 1.
-            for (size_t i = 0; i < sampler.inputs.size() - 1; i++) {
-                
-                // current keyframe (0) and next keyframe (1) input data
-                float input0 = sampler.inputs[i];
-                float input1 = sampler.inputs[i + 1];
-
-                // Only update this animation when we are within its specified time-frame
-                if (time < input0 || time > input1) continue;
-
-                // Interpolation value
-                float u = std::max(0.0f, time - input0) / (input1 - input0);
-                if (u < 0.0f || u > 1.0f) continue;
-
-                // current keyframe (0) and next keyframe (1) output data
-                glm::vec4 output0;
-                glm::vec4 output1;
-                // (output data to fill if cubic spline):
-                glm::vec4 inTangent0{0.0f};
-                glm::vec4 outTangent0{0.0f};
-                glm::vec4 inTangent1{0.0f};
-                glm::vec4 outTangent1{0.0f};
-
-                // Fill output data
-                switch (sampler.interpolation) {
-                    case util::INTERP_STEP:
-                    case util::INTERP_LINEAR: {
-                        output0 = sampler.outputs[i];
-                        output1 = sampler.outputs[i + 1];
-                    }
-                    break;
-                    case util::INTERP_CUBIC_SPLINE: {
-                        // Cublic spline data is formatted as (in tangent, value, out tangent) triplets.
-                        float offset0 = 3*i;
-                        float offset1 = 3*(i+1);
-                        inTangent0  = sampler.outputs[offset0];
-                        output0     = sampler.outputs[offset0 + 1];
-                        outTangent0 = sampler.outputs[offset0 + 2];
-                        inTangent1  = sampler.outputs[offset1];
-                        output1     = sampler.outputs[offset1 + 1];
-                        outTangent1 = sampler.outputs[offset1 + 2];
-                    }
-                    break;
-                }
+        const Animation &animation = *animations[animIdx];
 
-                // Update pointed mesh node parameters (T,S,R,W)
-                switch (channel.path) {
-                    case AnimationChannel::PathType::TRANSLATION: {
-                        glm::vec4 translation = util::interpVec4(output0, outTangent0, output1, inTangent1, u, sampler.interpolation);;
-                        channel.node->setTranslation(glm::vec3(translation));
-                    }
-                    break;
-                    case AnimationChannel::PathType::SCALE: {
-                        glm::vec4 scale = util::interpVec4(output0, outTangent0, output1, inTangent1, u, sampler.interpolation);
-                        channel.node->setScale(glm::vec3(scale));
-                    }
-                    break;
-                    case AnimationChannel::PathType::ROTATION: {
-                        glm::quat q0;
-                        q0.x = output0.x; 
-                        q0.y = output0.y; 
-                        q0.z = output0.z; 
-                        q0.w = output0.w;
-                        glm::quat q0_ot = glm::quat{outTangent0.x, outTangent0.y, outTangent0.z, outTangent0.w};
-                        q0_ot.x = outTangent0.x; 
-                        q0_ot.y = outTangent0.y;
-                        q0_ot.x = outTangent0.z; 
-                        q0_ot.y = outTangent0.w;
-                        glm::quat q1;
-                        q1.x = output1.x; 
-                        q1.y = output1.y; 
-                        q1.z = output1.z; 
-                        q1.w = output1.w;
-                        glm::quat q1_it = glm::quat(inTangent1.x, inTangent1.y, inTangent1.z, inTangent1.w);
-                        q1_it.x = inTangent1.x; 
-                        q1_it.y = inTangent1.y; 
-                        q1_it.z = inTangent1.z; 
-                        q1_it.w = inTangent1.w;
-
-                        channel.node->setRotation(util::interpQuat(q0, q0_ot, q1, q1_it, u, sampler.interpolation));
-                    }
-                    break;
-                    case AnimationChannel::PathType::WEIGHTS: {
-                        throw std::runtime_error("TODO: Morph target animation update via weights.");
-                    }
-                    break;
+        if (loop) time = animation.loopTime(time);
+
+        // Nodes are only updated by the caller if we advanced any animation channels
+        return animation.sample(time, nodeHierarchy, animationCursors[animIdx]);
+    }
+
+    void SumiModel::bakeAnimations(float sampleRate) {
+        for (auto& animation : animations) {
+            const size_t authoredSize = animation->getMemorySize();
+            if (!animation->bake(sampleRate)) {
+                std::cout << "[Sumire::SumiModel] Could not bake animation <" << animation->name
+                    << ">, it will be sampled from its keyframes" << std::endl;
+                continue;
+            }
+
+            std::cout << "[Sumire::SumiModel] Baked animation <" << animation->name << "> ("
+                << animation->baked.frameCount << " frames at " << animation->baked.sampleRate << " fps, "
+                << authoredSize << " bytes authored -> " << animation->baked.getMemorySize() << " bytes baked)"
+                << std::endl;
+        }
+    }
+
+    void SumiModel::updateNodes(int frameIdx) {
+        if (nodeHierarchy.propagate(nodeGeneration + 1u)) {
+            nodeGeneration++;
+        }
+
+        if (frameIdx == Node::ALL_FRAMES) {
+            for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+                writeNodes(i);
+            }
+        }
+        else {
+            writeNodes(frameIdx);
+        }
+    }
+
+    // Writes the current node matrices and joints to frameIdx's mesh buffers.
+    //  Only joints that moved since the frame was last written are rewritten.
+    void SumiModel::writeNodes(int frameIdx) {
+        const uint64_t frameGeneration = frameNodeGenerations[frameIdx];
+        const uint64_t sinceGeneration = frameGeneration >= jointLayoutGeneration ? frameGeneration : 0u;
+
+        for (uint32_t idx : nodeHierarchy.getMeshNodes()) {
+            jointUploadBytes += nodeHierarchy.getNode(idx)->update(frameIdx, sinceGeneration);
+        }
+        frameNodeGenerations[frameIdx] = nodeGeneration;
+        frameComputeSkinned[frameIdx] = computeSkinning;
+    }
+
+    void SumiModel::setComputeSkinning(bool enable) {
+        if (skinnedMeshCount == 0 || enable == computeSkinning) return;
+        // Compact vertices carry no joints or weights for the vertex shader.
+        if (!enable && vertexFormat != VERTEX_FORMAT_FULL) return;
+
+        if (enable && skinnedVertexBuffers.empty()) {
+            createSkinningResources();
+        }
+
+        computeSkinning = enable;
+        for (auto& node : flatNodes) {
+            if (node->mesh && node->skin) node->mesh->computeSkinned = enable;
+        }
+
+        // Frames in flight keep their current mode until their mesh buffers are next written,
+        //  so that a frame's joint count, bound vertex buffer and dispatches always agree.
+        nodeGeneration++;
+    }
+
+    void SumiModel::setJointFormat(Mesh::JointFormat format) {
+        if (format == jointFormat) return;
+
+        jointFormat = format;
+        for (auto& node : flatNodes) {
+            if (node->mesh && node->skin) node->mesh->jointFormat = format;
+        }
+
+        // Each frame's uniforms carry the format its joint buffer was written with.
+        nodeGeneration++;
+        jointLayoutGeneration = nodeGeneration;
+    }
+
+    uint64_t SumiModel::takeJointUploadBytes() {
+        uint64_t bytes = jointUploadBytes;
+        jointUploadBytes = 0u;
+        return bytes;
+    }
+
+    void SumiModel::recordSkinning(VkCommandBuffer commandBuffer, int frameIdx, VkPipelineLayout pipelineLayout) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
+
+        // Unanimated models are only rewritten here after a skinning mode change.
+        if (frameNodeGenerations[frameIdx] != nodeGeneration) {
+            writeNodes(frameIdx);
+        }
+        if (!frameComputeSkinned[frameIdx]) return;
+
+        for (uint32_t idx : nodeHierarchy.getMeshNodes()) {
+            Node *node = nodeHierarchy.getNode(idx);
+            if (!node->skin) continue;
+
+            vkCmdBindDescriptorSets(
+                commandBuffer,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                pipelineLayout,
+                0, 1,
+                &node->mesh->skinningDescriptorSets[frameIdx],
+                0, nullptr
+            );
+
+            for (auto& primitive : node->mesh->primitives) {
+                structs::computeSkinningPush push{};
+                push.firstVertex = primitive->firstVertex;
+                push.vertexCount = primitive->vertexCount;
+                push.jointFormat = static_cast<int32_t>(node->mesh->jointFormat);
+                push.skinJointBits = skinJointBits;
+                // Morphed meshes are skinned from their morphed vertices (see createSkinningResources)
+                push.bindPoseOffset = node->mesh->morphTargets.empty() ? 0 : node->mesh->morphedVertexOffset();
+                push.skinnedOffset = node->mesh->skinnedVertexOffset();
+
+                vkCmdPushConstants(
+                    commandBuffer,
+                    pipelineLayout,
+                    VK_SHADER_STAGE_COMPUTE_BIT,
+                    0,
+                    sizeof(structs::computeSkinningPush),
+                    &push
+                );
+
+                uint32_t groupCountX = 
+                    (primitive->vertexCount + structs::COMPUTE_SKINNING_GROUP_SIZE - 1) / structs::COMPUTE_SKINNING_GROUP_SIZE;
+                vkCmdDispatch(commandBuffer, groupCountX, 1, 1);
+            }
+        }
+        frameSkinningRecorded[frameIdx] = true;
+    }
+
+    void SumiModel::createSkinningResources() {
+        // Skinned vertices start as copies of their meshes' bind pose, so that the attributes
+        //  compute skinning does not write stay valid.
+        std::vector<VkBufferCopy> regions;
+        for (auto& node : flatNodes) {
+            if (!node->mesh || !node->skin || node->mesh->vertexCount == 0u) continue;
+            regions.push_back(VkBufferCopy{
+                VkDeviceSize{ node->mesh->firstVertex } * vertexStride,
+                VkDeviceSize{ node->mesh->firstSkinnedVertex } * vertexStride,
+                VkDeviceSize{ node->mesh->vertexCount } * vertexStride
+            });
+        }
+        skinnedVertexBuffers = createVertexCopies(skinnedVertexCount, regions);
+
+        const uint32_t nSets = skinnedMeshCount * SumiSwapChain::MAX_FRAMES_IN_FLIGHT;
+        skinningDescriptorPool = SumiDescriptorPool::Builder(sumiDevice)
+            .setMaxSets(nSets)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * nSets)
+            .build();
+
+        auto skinningDescriptorSetLayout = SumiModel::skinningDescriptorLayout(sumiDevice);
+
+        for (auto& node : flatNodes) {
+            if (!node->mesh || !node->skin) continue;
+
+            node->mesh->skinningDescriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+            for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+                // Morph targets are applied before skinning
+                auto bindPoseInfo = node->mesh->morphTargets.empty() ?
+                    vertexBuffer->descriptorInfo() : morphedVertexBuffers[i]->descriptorInfo();
+                auto jointBufferInfo = node->mesh->jointBuffers[i]->descriptorInfo();
+                auto skinnedInfo = skinnedVertexBuffers[i]->descriptorInfo();
+                // Full vertices carry their own joints & weights, so the bind pose stands in for the unread stream.
+                auto skinVertexInfo = skinVertexBuffer ? skinVertexBuffer->descriptorInfo() : bindPoseInfo;
+                SumiDescriptorWriter(*skinningDescriptorSetLayout, *skinningDescriptorPool)
+                    .writeBuffer(0, &bindPoseInfo)
+                    .writeBuffer(1, &jointBufferInfo)
+                    .writeBuffer(2, &skinnedInfo)
+                    .writeBuffer(3, &skinVertexInfo)
+                    .build(node->mesh->skinningDescriptorSets[i]);
+            }
+        }
+    }
+
+    uint32_t SumiModel::prepareMorphTargets(int frameIdx) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
+
+        uint32_t nRounds = 0u;
+        for (Mesh *mesh : morphMeshes) {
+            mesh->activeMorphTargets.clear();
+            for (uint32_t t = 0; t < mesh->morphTargets.size(); t++) {
+                if (mesh->morphWeights[t] != 0.0f && mesh->morphTargets[t].deltaCount > 0u) {
+                    mesh->activeMorphTargets.push_back(t);
                 }
+            }
+            nRounds = std::max(nRounds, static_cast<uint32_t>(mesh->activeMorphTargets.size()));
+        }
+        return nRounds;
+    }
+
+    bool SumiModel::recordMorphReset(VkCommandBuffer commandBuffer, int frameIdx, VkPipelineLayout pipelineLayout) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
+
+        bool bound = false;
+        for (Mesh *mesh : morphMeshes) {
+            const bool active = !mesh->activeMorphTargets.empty();
+            const bool wasActive = mesh->frameMorphActive[frameIdx];
+            mesh->frameMorphActive[frameIdx] = active;
 
-                modelUpdated = true;
+            // Meshes at rest in this frame's buffer stay untouched
+            if (!active && !wasActive) continue;
+
+            if (!bound) {
+                vkCmdBindDescriptorSets(
+                    commandBuffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                    pipelineLayout,
+                    0, 1,
+                    &morphDescriptorSets[frameIdx],
+                    0, nullptr
+                );
+                bound = true;
             }
+
+            structs::computeMorphPush push{};
+            push.mode = structs::COMPUTE_MORPH_MODE_RESET;
+            push.first = mesh->firstMorphVertex;
+            push.count = mesh->morphVertexCount;
+            push.weight = 0.0f;
+            push.vertexOffset = mesh->morphedVertexOffset();
+
+            vkCmdPushConstants(
+                commandBuffer,
+                pipelineLayout,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0,
+                sizeof(structs::computeMorphPush),
+                &push
+            );
+
+            uint32_t groupCountX =
+                (push.count + structs::COMPUTE_MORPH_GROUP_SIZE - 1) / structs::COMPUTE_MORPH_GROUP_SIZE;
+            vkCmdDispatch(commandBuffer, groupCountX, 1, 1);
         }
 
-        // Only update nodes if we advanced any animation channels
-        if (modelUpdated) {
-            updateNodes();
+        return bound;
+    }
+
+    void SumiModel::recordMorphTargetRound(
+        VkCommandBuffer commandBuffer, int frameIdx, VkPipelineLayout pipelineLayout, uint32_t round
+    ) {
+        assert(frameIdx >= 0 && frameIdx < SumiSwapChain::MAX_FRAMES_IN_FLIGHT && "Frame index out of range");
+
+        bool bound = false;
+        for (Mesh *mesh : morphMeshes) {
+            if (round >= mesh->activeMorphTargets.size()) continue;
+
+            if (!bound) {
+                vkCmdBindDescriptorSets(
+                    commandBuffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                    pipelineLayout,
+                    0, 1,
+                    &morphDescriptorSets[frameIdx],
+                    0, nullptr
+                );
+                bound = true;
+            }
+
+            const uint32_t targetIdx = mesh->activeMorphTargets[round];
+            const MorphTarget &target = mesh->morphTargets[targetIdx];
+
+            structs::computeMorphPush push{};
+            push.mode = structs::COMPUTE_MORPH_MODE_ACCUMULATE;
+            push.first = target.firstDelta;
+            push.count = target.deltaCount;
+            push.weight = mesh->morphWeights[targetIdx];
+            push.vertexOffset = mesh->morphedVertexOffset();
+
+            vkCmdPushConstants(
+                commandBuffer,
+                pipelineLayout,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0,
+                sizeof(structs::computeMorphPush),
+                &push
+            );
+
+            uint32_t groupCountX =
+                (push.count + structs::COMPUTE_MORPH_GROUP_SIZE - 1) / structs::COMPUTE_MORPH_GROUP_SIZE;
+            vkCmdDispatch(commandBuffer, groupCountX, 1, 1);
         }
     }
 
-    void SumiModel::updateNodes() {
-        for (auto& node : nodes) {
-            node->applyTransformHierarchy();
-            node->updateRecursive();
+    void SumiModel::createMorphTargetResources(
+        const std::vector<MorphDelta> &morphDeltas, const std::vector<uint32_t> &morphVertices
+    ) {
+        assert(!morphDeltas.empty() && !morphVertices.empty() && "Morph target resources created without morph data");
+
+        // Deltas and vertex indices are static, so live in device local memory. Uploaded on the graphics
+        //  queue and read by the compute queue.
+        morphDeltaBuffer = createStaticBuffer(
+            morphDeltas.data(), sizeof(MorphDelta), static_cast<uint32_t>(morphDeltas.size()),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_CONCURRENT
+        );
+        morphVertexBuffer = createStaticBuffer(
+            morphVertices.data(), sizeof(uint32_t), static_cast<uint32_t>(morphVertices.size()),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_CONCURRENT
+        );
+
+        createMorphedVertexBuffers();
+    }
+
+    void SumiModel::createMorphedVertexBuffers() {
+        // Morphed vertices start as copies of their meshes' bind pose, and are only ever reset to it
+        //  at the vertices morph targets move.
+        std::vector<VkBufferCopy> regions;
+        for (Mesh *mesh : morphMeshes) {
+            if (mesh->vertexCount == 0u) continue;
+            regions.push_back(VkBufferCopy{
+                VkDeviceSize{ mesh->firstVertex } * vertexStride,
+                VkDeviceSize{ mesh->firstMorphedVertex } * vertexStride,
+                VkDeviceSize{ mesh->vertexCount } * vertexStride
+            });
+        }
+        morphedVertexBuffers = createVertexCopies(morphedVertexCount, regions);
+
+        // One set per frame in flight for the whole model, as meshes are selected by push constant ranges.
+        morphDescriptorPool = SumiDescriptorPool::Builder(sumiDevice)
+            .setMaxSets(SumiSwapChain::MAX_FRAMES_IN_FLIGHT)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * SumiSwapChain::MAX_FRAMES_IN_FLIGHT)
+            .build();
+
+        auto morphDescriptorSetLayout = SumiModel::morphDescriptorLayout(sumiDevice);
+
+        auto bindPoseInfo = vertexBuffer->descriptorInfo();
+        auto deltaInfo = morphDeltaBuffer->descriptorInfo();
+        auto morphVertexInfo = morphVertexBuffer->descriptorInfo();
+        morphDescriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            auto morphedInfo = morphedVertexBuffers[i]->descriptorInfo();
+            SumiDescriptorWriter(*morphDescriptorSetLayout, *morphDescriptorPool)
+                .writeBuffer(0, &bindPoseInfo)
+                .writeBuffer(1, &morphedInfo)
+                .writeBuffer(2, &deltaInfo)
+                .writeBuffer(3, &morphVertexInfo)
+                .build(morphDescriptorSets[i]);
         }
     }
 
@@ -9,10 +9,12 @@
 // Model components
 #include <sumire/core/models/vertex.hpp>
 #include <sumire/core/models/node.hpp>
+#include <sumire/core/models/node_hierarchy.hpp>
 #include <sumire/core/models/mesh.hpp>
 #include <sumire/core/models/primitive.hpp>
 #include <sumire/core/models/skin.hpp>
 #include <sumire/core/models/animation.hpp>
+#include <sumire/core/models/morph_target.hpp>
 
 #include <sumire/core/flags/sumi_pipeline_state_flags.hpp>
 #include <sumire/util/gltf_interpolators.hpp>
@@ -24,11 +26,16 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include <memory>
+#include <span>
 #include <vector>
 #include <string>
 
 namespace sumire {
 
+    // A loaded model. Geometry, materials, morph target deltas and animation clips are immutable after
+    //  loading and shared between instances (see createInstance()), while each instance owns its node tree,
+    //  skins, mesh buffers and per frame in flight copies of its skinned and morphed meshes' vertices, so that
+    //  instances animate independently. Static meshes of every instance draw from the shared vertex buffer.
     class SumiModel {
 
     public:
@@ -42,11 +49,22 @@ namespace sumire {
             // Temporary holders for Mesh data (Uploaded to GPU on model init).
             std::vector<Vertex> vertices{};
             std::vector<uint32_t> indices{};
+            // Vertices and indices held elsewhere (e.g. a mapped mesh cache, see loaders::SumimeshCache),
+            //  uploaded in place of the arrays above if set. Must stay valid until the model is created.
+            std::span<const Vertex> vertexView{};
+            std::span<const uint32_t> indexView{};
             uint32_t meshCount;
+            // Store vertices in a compact format (see VertexFormat) where the model allows it. Vertices are
+            //  loaded as Vertex either way, and encoded when the model is created.
+            bool compactVertices = false;
             
             // Mesh Skinning Data
             std::vector<std::unique_ptr<Skin>> skins;
 
+            // Morph target deltas of all meshes, and the vertices each mesh's targets move (see Mesh).
+            std::vector<MorphDelta> morphDeltas;
+            std::vector<uint32_t> morphVertices;
+
             // Animations
             std::vector<std::unique_ptr<Animation>> animations;
 
@@ -74,43 +92,144 @@ namespace sumire {
         SumiModel(const SumiModel&) = delete;
         SumiModel& operator=(const SumiModel&) = delete;
 
+        // Creates an instance of this model, with its own node tree and pose starting from the rest pose.
+        //  Shared resources are kept alive by any instance, so the model can be destroyed before its instances.
+        //  Compute skinning and joint format settings are copied from this model.
+        //  Uploads the instance's vertex copies with single time commands, so create instances inside a
+        //  SumiUploadBatch scope (e.g. loaders::AsyncModelLoader) to avoid idling the graphics queue.
+        std::unique_ptr<SumiModel> createInstance() const;
+
         static std::unique_ptr<SumiDescriptorSetLayout> meshNodeDescriptorLayout(SumiDevice &device);
+        static std::unique_ptr<SumiDescriptorSetLayout> skinningDescriptorLayout(SumiDevice &device);
+        static std::unique_ptr<SumiDescriptorSetLayout> morphDescriptorLayout(SumiDevice &device);
         static std::unique_ptr<SumiDescriptorSetLayout> matTextureDescriptorLayout(SumiDevice &device);
         static std::unique_ptr<SumiDescriptorSetLayout> matStorageDescriptorLayout(SumiDevice &device);
 
         uint32_t getAnimationCount() { return static_cast<uint32_t>(animations.size()); }
+        const std::string &getAnimationName(uint32_t animIdx) const { return animations[animIdx]->name; }
+        const NodeHierarchy &getNodeHierarchy() const { return nodeHierarchy; }
+        bool isAnimated() const { return !animations.empty(); }
+        bool hasSkin() const { return skinnedMeshCount > 0; }
+        bool hasMorphTargets() const { return !morphMeshes.empty(); }
         bool hasIndices() { return useIndexBuffer; }
-
-        void bind(VkCommandBuffer commandbuffer);
+        VertexFormat getVertexFormat() const { return vertexFormat; }
+        // Device memory held by this model's vertices: the bind pose, any skin stream, and any per frame
+        //  in flight skinned or morphed copies.
+        VkDeviceSize getVertexMemoryBytes() const;
+
+        // Binds the index buffer. Vertex buffers are bound per mesh by draw(), as meshes of one model
+        //  can draw from the bind pose or from this frame's skinned or morphed vertices.
+        void bind(VkCommandBuffer commandbuffer, int frameIdx);
         void draw(
             VkCommandBuffer commandbuffer, 
+            int frameIdx,
             VkPipelineLayout pipelineLayout,
             const std::unordered_map<
                 SumiPipelineStateFlags, std::unique_ptr<SumiPipeline>> &pipelines
         );
 
-        void updateAnimations(const std::vector<uint32_t> indices, float time, bool loop = true);
-        void updateAnimation(uint32_t animIdx, float time, bool loop = true);
-        void updateNodes();
+        // Advance animations and write the resulting node matrices to frameIdx's mesh buffers.
+        //  Only touches this model, so different models can be updated concurrently.
+        void updateAnimations(const std::vector<uint32_t> &indices, float time, int frameIdx, bool loop = true);
+        void updateAllAnimations(float time, int frameIdx, bool loop = true);
+        // Evaluates a batch of layered clips into one pose, blended in order from the rest pose, then applies it
+        //  with a single hierarchy propagation. Nodes not animated by any layer keep their current transform.
+        void evaluateAnimations(const std::vector<AnimationLayer> &layers, int frameIdx);
+        // Per node layer weights (see AnimationLayer::mask) covering the subtree under root.
+        std::vector<float> createAnimationMask(const Node *root, float weight = 1.0f) const;
+
+        // Layered playback. While any layers are set, updateAnimationLayers() blends them with evaluateAnimations()
+        //  (see SumiAnimationSystem) in place of playing every clip. Layer masks are held by the model.
+        void addAnimationLayer(const AnimationLayer &layer);
+        void removeAnimationLayer(uint32_t layerIdx);
+        uint32_t getAnimationLayerCount() const { return static_cast<uint32_t>(animationLayers.size()); }
+        // The layer's mask is managed by setAnimationLayerMask(), and is ignored here.
+        AnimationLayer &getAnimationLayer(uint32_t layerIdx) { return animationLayers[layerIdx]; }
+        // Restricts a layer to the subtree under the node at rootIdx (see createAnimationMask), or to no
+        //  subtree if rootIdx is NodeHierarchy::NO_PARENT.
+        void setAnimationLayerMask(uint32_t layerIdx, int32_t rootIdx);
+        int32_t getAnimationLayerMaskRoot(uint32_t layerIdx) const { return animationLayerMaskRoots[layerIdx]; }
+        bool hasAnimationLayers() const { return !animationLayers.empty(); }
+        // Evaluates the animation layers at time.
+        void updateAnimationLayers(float time, int frameIdx);
+        void updateNodes(int frameIdx = Node::ALL_FRAMES);
+        // Resample animations into baked tracks (see Animation::bake). Should be called at load time,
+        //  as clips are shared with every instance of the model.
+        void bakeAnimations(float sampleRate = BakedAnimation::DEFAULT_SAMPLE_RATE);
+
+        // Skin on the GPU (see ComputeSkinner) instead of in the vertex shader. Each frame in flight
+        //  switches over the next time its skinning is recorded. Compact vertex models are always compute skinned.
+        void setComputeSkinning(bool enable);
+        bool usesComputeSkinning() const { return computeSkinning; }
+        // Joint palette format of skinned meshes. Frames in flight switch over as their mesh buffers are next written.
+        void setJointFormat(Mesh::JointFormat format);
+        Mesh::JointFormat getJointFormat() const { return jointFormat; }
+        // Joint bytes written to mesh buffers since the last call, for upload bandwidth stats.
+        uint64_t takeJointUploadBytes();
+        // Records this frame's skinning dispatches. Expects the skinning pipeline to be bound.
+        void recordSkinning(VkCommandBuffer commandBuffer, int frameIdx, VkPipelineLayout pipelineLayout);
+
+        // Morph targets are evaluated in compute (see ComputeMorpher), into per frame in flight vertex buffers
+        //  that drawing and compute skinning read in place of the bind pose. Targets are applied in rounds,
+        //  one active target per mesh per round, with a barrier between rounds as targets may share vertices.
+        //
+        // Gathers this frame's active targets from the current morph weights. Returns the number of rounds needed.
+        uint32_t prepareMorphTargets(int frameIdx);
+        // Restores the vertices of meshes with active targets, or that had active targets when the frame
+        //  was last morphed. Returns false if nothing needed restoring. Expects the morph pipeline to be bound.
+        bool recordMorphReset(VkCommandBuffer commandBuffer, int frameIdx, VkPipelineLayout pipelineLayout);
+        // Adds the round'th active target of each morphed mesh. Expects the morph pipeline to be bound.
+        void recordMorphTargetRound(
+            VkCommandBuffer commandBuffer, int frameIdx, VkPipelineLayout pipelineLayout, uint32_t round);
 
         std::string displayName{"Unnamed"};
 
     private:
+        // Instance constructor (see createInstance())
+        SumiModel(SumiDevice &device, const SumiModel &source);
+
         void drawNode(
             Node *node, 
             VkCommandBuffer commandBuffer, 
+            int frameIdx,
             VkPipelineLayout pipelineLayout,
             const std::unordered_map<
                 SumiPipelineStateFlags, std::unique_ptr<SumiPipeline>
             > &pipelines
         );
 
+        // Returns true if any channel was advanced.
+        bool updateAnimation(uint32_t animIdx, float time, bool loop = true);
+        void commitAnimatedNodes(bool nodesMoved, int frameIdx);
+        void writeNodes(int frameIdx);
+
         // Resource Initializers
-        void createVertexBuffers(const std::vector<Vertex> &vertices);
-        void createIndexBuffer(const std::vector<uint32_t> &indices);
+        // Device local buffer holding data, uploaded through a staging buffer. Buffers read by the compute
+        //  skinning or morphing passes must be VK_SHARING_MODE_CONCURRENT, as the upload is on the graphics queue.
+        std::unique_ptr<SumiBuffer> createStaticBuffer(
+            const void *data, VkDeviceSize instanceSize, uint32_t instanceCount, VkBufferUsageFlags usage,
+            VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE);
+        void createVertexBuffers(std::span<const Vertex> vertices, bool compact);
+        VertexFormat chooseVertexFormat(std::span<const Vertex> vertices, bool compact) const;
+        void createQuantizedVertexBuffer(std::span<const Vertex> vertices);
+        void createSkinVertexBuffer(std::span<const Vertex> vertices);
+        void createIndexBuffer(std::span<const uint32_t> indices);
         void createDefaultTextures();
-        void initDescriptors();
+        void initMaterialDescriptors();
         void createMaterialStorageBuffer();
+        void createSkinningResources();
+        void createMorphTargetResources(const std::vector<MorphDelta> &morphDeltas, const std::vector<uint32_t> &morphVertices);
+        // Per instance resources
+        void cloneNodes(const SumiModel &source);
+        void initInstanceState();
+        // Sets each mesh's vertex range, and packs the ranges of skinned and of morphed meshes into the
+        //  per frame in flight skinned and morphed vertex buffers.
+        void layoutVertexCopies();
+        // Per frame in flight buffers of copyVertexCount vertices, seeded with the bind pose vertex regions.
+        std::vector<std::unique_ptr<SumiBuffer>> createVertexCopies(
+            uint32_t copyVertexCount, const std::vector<VkBufferCopy> &regions);
+        void initMeshNodeDescriptors();
+        void createMorphedVertexBuffers();
 
         SumiDevice &sumiDevice;
 
@@ -119,32 +238,93 @@ namespace sumire {
         // Model data
         std::vector<Node*> nodes{};
         std::vector<std::unique_ptr<Node>> flatNodes{};
+        // Parent-before-child order of nodes for transform propagation
+        NodeHierarchy nodeHierarchy;
 
         uint32_t meshCount;
 
         std::vector<std::unique_ptr<Skin>> skins;
-        std::vector<std::unique_ptr<Animation>> animations;
-
-        std::vector<std::unique_ptr<SumiMaterial>> materials;
+        // Shared between instances
+        std::vector<std::shared_ptr<Animation>> animations;
+        // Each animation's keyframe cursors, one per channel (see Animation::sample).
+        std::vector<std::vector<uint32_t>> animationCursors;
+        // Node transforms as loaded, and the pose evaluateAnimations() blends into, reused between updates.
+        AnimationPose restPose;
+        AnimationPose blendPose;
+        // Layered playback state (see addAnimationLayer()). Each layer's mask is empty if it is unmasked.
+        std::vector<AnimationLayer> animationLayers;
+        std::vector<std::vector<float>> animationLayerMasks;
+        std::vector<int32_t> animationLayerMaskRoots;
+        // Bumped whenever an animation moves the nodes. Each frame in flight's mesh buffers are
+        //  rewritten when the generation they hold is out of date. The initial pose is written to all frames.
+        uint64_t nodeGeneration = 1u;
+        std::vector<uint64_t> frameNodeGenerations;
+        // Generation of the last change that invalidates every written joint, e.g. a joint format switch.
+        //  Frames written before it rewrite all joints rather than only those that moved.
+        uint64_t jointLayoutGeneration = 0u;
+        // Joint bytes written since the last takeJointUploadBytes().
+        uint64_t jointUploadBytes = 0u;
+
+        // Compute skinning
+        uint32_t skinnedMeshCount = 0u;
+        bool computeSkinning = false;
+        // Skinning mode each frame in flight's mesh buffers were last written with.
+        std::vector<bool> frameComputeSkinned;
+        // Whether each frame in flight's skinned vertices have been written by a skinning pass yet.
+        //  Until then they hold the bind pose, and skinned meshes are not drawn.
+        std::vector<bool> frameSkinningRecorded;
+        Mesh::JointFormat jointFormat = Mesh::JOINT_FORMAT_MATRIX;
+        // Per frame in flight copies of the vertices of skinned meshes, posed (see Mesh::firstSkinnedVertex).
+        //  Written by pre-draw compute and read by graphics, so shared between their queue families,
+        //  as are the morphed copies below.
+        std::vector<std::unique_ptr<SumiBuffer>> skinnedVertexBuffers;
+        uint32_t skinnedVertexCount = 0u;
+
+        // Morph targets
+        std::vector<Mesh*> morphMeshes;
+        // Per frame in flight copies of the vertices of morphed meshes with morph targets applied, which
+        //  replace the bind pose of those meshes for drawing and compute skinning (see Mesh::firstMorphedVertex).
+        std::vector<std::unique_ptr<SumiBuffer>> morphedVertexBuffers;
+        uint32_t morphedVertexCount = 0u;
+        // Shared between instances
+        std::shared_ptr<SumiBuffer> morphDeltaBuffer;
+        std::shared_ptr<SumiBuffer> morphVertexBuffer;
+        std::unique_ptr<SumiDescriptorPool> morphDescriptorPool;
+        std::vector<VkDescriptorSet> morphDescriptorSets;
+
+        // Materials, geometry and their descriptors are shared between instances.
+        std::vector<std::shared_ptr<SumiMaterial>> materials;
 
         // Vertex Buffer params
-        std::unique_ptr<SumiBuffer> vertexBuffer;
+        std::shared_ptr<SumiBuffer> vertexBuffer;
         uint32_t vertexCount;
+        VertexFormat vertexFormat = VERTEX_FORMAT_FULL;
+        uint32_t vertexStride = sizeof(Vertex);
+        // Pipeline state bits of the vertex format, added to each material's when drawing.
+        SumiPipelineStateFlags vertexPipelineState = SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_DEFAULT;
+        // Joints and weights of compact skinned models (CompactSkinVertex, or CompactSkinVertex8 if
+        //  skinJointBits is 8), only read by compute skinning.
+        std::shared_ptr<SumiBuffer> skinVertexBuffer;
+        uint32_t skinJointBits = 16u;
+
+        // Vertex buffer last bound by draw()
+        VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
 
         // Index Buffer params
         bool useIndexBuffer = true;
-        std::unique_ptr<SumiBuffer> indexBuffer;
+        std::shared_ptr<SumiBuffer> indexBuffer;
         uint32_t indexCount;
 
         // Descriptors
         std::unique_ptr<SumiDescriptorPool> meshNodeDescriptorPool;
-        std::unique_ptr<SumiDescriptorPool> materialDescriptorPool;
+        std::shared_ptr<SumiDescriptorPool> materialDescriptorPool;
+        std::unique_ptr<SumiDescriptorPool> skinningDescriptorPool;
         VkDescriptorSet materialStorageDescriptorSet = VK_NULL_HANDLE;
         // Texture Descriptor sets are stored in material textures,
         //	 and mesh node descriptor sets are stored in SumiModel::Mesh
 
         // Buffers
-        std::unique_ptr<SumiBuffer> materialStorageBuffer; // for static materials
+        std::shared_ptr<SumiBuffer> materialStorageBuffer; // for static materials
 
         // Default Textures & Materials
         // TODO: These could be cached
@@ -1,5 +1,10 @@
 #include <sumire/core/models/vertex.hpp>
 
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+
 namespace sumire {
     std::vector<VkVertexInputBindingDescription> Vertex::getBindingDescriptions() {
         std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
@@ -23,4 +28,130 @@ namespace sumire {
 
         return attributeDescriptions;
     }
-}
\ No newline at end of file
+
+    namespace {
+        // Octahedral encoding of a direction, in [-1, 1]^2. Zero length vectors encode as +z.
+        glm::vec2 octEncode(const glm::vec3 &v) {
+            const float l1 = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+            if (l1 <= 0.0f) return glm::vec2{ 0.0f };
+
+            const glm::vec3 n = v / l1;
+            if (n.z >= 0.0f) return glm::vec2{ n.x, n.y };
+
+            return glm::vec2{
+                (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)
+            };
+        }
+
+        uint32_t encodeUvs(const glm::vec2 &uv) {
+            return glm::packHalf2x16(uv);
+        }
+
+        uint32_t encodeColor(const glm::vec3 &color) {
+            return glm::packUnorm4x8(glm::vec4{ glm::clamp(color, 0.0f, 1.0f), 1.0f });
+        }
+
+        void encodeWeights(const glm::vec4 &weight, uint32_t (&weights)[2]) {
+            weights[0] = glm::packUnorm2x16(glm::vec2{ weight.x, weight.y });
+            weights[1] = glm::packUnorm2x16(glm::vec2{ weight.z, weight.w });
+        }
+
+        uint32_t jointIndex(float joint, uint32_t maxIndex) {
+            return std::min(static_cast<uint32_t>(std::max(joint, 0.0f) + 0.5f), maxIndex);
+        }
+    }
+
+    std::vector<VkVertexInputBindingDescription> CompactVertex::getBindingDescriptions() {
+        std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+        bindingDescriptions[0].binding = 0;
+        bindingDescriptions[0].stride = sizeof(CompactVertex);
+        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescriptions;
+    }
+
+    // Locations match Vertex's where the attribute is kept. Normal & tangent are read as one uvec2 at 5.
+    std::vector<VkVertexInputAttributeDescription> CompactVertex::getAttributeDescriptions() {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+        attributeDescriptions.push_back({3, 0 , VK_FORMAT_R32G32B32_SFLOAT, offsetof(CompactVertex, position)});
+        attributeDescriptions.push_back({4, 0 , VK_FORMAT_R8G8B8A8_UNORM,   offsetof(CompactVertex, color)});
+        attributeDescriptions.push_back({5, 0 , VK_FORMAT_R32G32_UINT,      offsetof(CompactVertex, normal)});
+        attributeDescriptions.push_back({6, 0 , VK_FORMAT_R16G16_SFLOAT,    offsetof(CompactVertex, uv0)});
+        attributeDescriptions.push_back({7, 0 , VK_FORMAT_R16G16_SFLOAT,    offsetof(CompactVertex, uv1)});
+
+        return attributeDescriptions;
+    }
+
+    CompactVertex CompactVertex::encode(const Vertex &vertex) {
+        CompactVertex compact{};
+        compact.position = vertex.position;
+        compact.normal = encodeNormal(vertex.normal);
+        compact.tangent = encodeTangent(vertex.tangent);
+        compact.color = encodeColor(vertex.color);
+        compact.uv0 = encodeUvs(vertex.uv0);
+        compact.uv1 = encodeUvs(vertex.uv1);
+        return compact;
+    }
+
+    uint32_t CompactVertex::encodeNormal(const glm::vec3 &normal) {
+        return glm::packSnorm2x16(octEncode(normal));
+    }
+
+    uint32_t CompactVertex::encodeTangent(const glm::vec4 &tangent) {
+        return (glm::packSnorm2x16(octEncode(glm::vec3{ tangent })) & ~1u) | (tangent.w < 0.0f ? 1u : 0u);
+    }
+
+    std::vector<VkVertexInputBindingDescription> QuantizedVertex::getBindingDescriptions() {
+        std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+        bindingDescriptions[0].binding = 0;
+        bindingDescriptions[0].stride = sizeof(QuantizedVertex);
+        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescriptions;
+    }
+
+    std::vector<VkVertexInputAttributeDescription> QuantizedVertex::getAttributeDescriptions() {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+        attributeDescriptions.push_back({3, 0 , VK_FORMAT_R16G16B16A16_UNORM, offsetof(QuantizedVertex, position)});
+        attributeDescriptions.push_back({4, 0 , VK_FORMAT_R8G8B8A8_UNORM,     offsetof(QuantizedVertex, color)});
+        attributeDescriptions.push_back({5, 0 , VK_FORMAT_R32G32_UINT,        offsetof(QuantizedVertex, normal)});
+        attributeDescriptions.push_back({6, 0 , VK_FORMAT_R16G16_SFLOAT,      offsetof(QuantizedVertex, uv0)});
+        attributeDescriptions.push_back({7, 0 , VK_FORMAT_R16G16_SFLOAT,      offsetof(QuantizedVertex, uv1)});
+
+        return attributeDescriptions;
+    }
+
+    QuantizedVertex QuantizedVertex::encode(
+        const Vertex &vertex, const glm::vec3 &boundsMin, const glm::vec3 &boundsExtent
+    ) {
+        QuantizedVertex quantized{};
+        for (int i = 0; i < 3; i++) {
+            const float t = boundsExtent[i] > 0.0f ? (vertex.position[i] - boundsMin[i]) / boundsExtent[i] : 0.0f;
+            quantized.position[i] = static_cast<uint16_t>(std::round(std::clamp(t, 0.0f, 1.0f) * 65535.0f));
+        }
+        quantized.normal = CompactVertex::encodeNormal(vertex.normal);
+        quantized.tangent = CompactVertex::encodeTangent(vertex.tangent);
+        quantized.color = encodeColor(vertex.color);
+        quantized.uv0 = encodeUvs(vertex.uv0);
+        quantized.uv1 = encodeUvs(vertex.uv1);
+        return quantized;
+    }
+
+    CompactSkinVertex CompactSkinVertex::encode(const Vertex &vertex) {
+        CompactSkinVertex skin{};
+        skin.joints[0] = jointIndex(vertex.joint.x, 0xFFFFu) | (jointIndex(vertex.joint.y, 0xFFFFu) << 16);
+        skin.joints[1] = jointIndex(vertex.joint.z, 0xFFFFu) | (jointIndex(vertex.joint.w, 0xFFFFu) << 16);
+        encodeWeights(vertex.weight, skin.weights);
+        return skin;
+    }
+
+    CompactSkinVertex8 CompactSkinVertex8::encode(const Vertex &vertex) {
+        CompactSkinVertex8 skin{};
+        skin.joints =
+            jointIndex(vertex.joint.x, 0xFFu) | (jointIndex(vertex.joint.y, 0xFFu) << 8) |
+            (jointIndex(vertex.joint.z, 0xFFu) << 16) | (jointIndex(vertex.joint.w, 0xFFu) << 24);
+        encodeWeights(vertex.weight, skin.weights);
+        return skin;
+    }
+}
@@ -2,10 +2,24 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <vector>
 #include <vulkan/vulkan.h>
 
 namespace sumire {
+
+    // Formats a model's vertex buffer can be stored in, chosen at load time (see SumiModel::Data::compactVertices).
+    enum VertexFormat {
+        // Vertex, fp32 throughout. Skinned in the vertex shader or in compute.
+        VERTEX_FORMAT_FULL = 0,
+        // CompactVertex. Joints and weights live in a separate CompactSkinVertex stream that only compute
+        //  skinning reads, so compact skinned models are always compute skinned.
+        VERTEX_FORMAT_COMPACT = 1,
+        // QuantizedVertex, a CompactVertex with positions quantized to the bounds of their mesh.
+        //  Only for models with no skins or morph targets, as posed vertices leave the bounds.
+        VERTEX_FORMAT_QUANTIZED = 2
+    };
+
     struct Vertex {
         glm::vec4 joint{};
         glm::vec4 weight{};
@@ -32,4 +46,57 @@ namespace sumire {
             );
         }
     };
+
+    // Vertex attributes packed for drawing, at 32 bytes rather than Vertex's 104.
+    //  Normals and tangents are octahedral encoded into two snorm16, with the tangent's handedness (w < 0)
+    //  in the lowest bit of its encoding. Decoded by shaders/includes/inc_compact_vertex.glsl.
+    struct CompactVertex {
+        glm::vec3 position{};
+        uint32_t normal{ 0u };  // octahedral snorm16x2
+        uint32_t tangent{ 0u }; // octahedral snorm16x2, handedness in bit 0
+        uint32_t color{ 0u };   // unorm8x4
+        uint32_t uv0{ 0u };     // fp16x2
+        uint32_t uv1{ 0u };     // fp16x2
+
+        static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+        static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+
+        static CompactVertex encode(const Vertex &vertex);
+        static uint32_t encodeNormal(const glm::vec3 &normal);
+        static uint32_t encodeTangent(const glm::vec4 &tangent);
+    };
+
+    // A CompactVertex with its position stored as unorm16 relative to the bounds of its mesh, and
+    //  restored in the vertex shader from Mesh::UniformData::positionScale & positionOffset. 28 bytes.
+    struct QuantizedVertex {
+        uint16_t position[4]{}; // unorm16x4, w unused
+        uint32_t normal{ 0u };
+        uint32_t tangent{ 0u };
+        uint32_t color{ 0u };
+        uint32_t uv0{ 0u };
+        uint32_t uv1{ 0u };
+
+        static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+        static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+
+        // boundsMin & boundsExtent are the bounds positions are quantized to.
+        static QuantizedVertex encode(const Vertex &vertex, const glm::vec3 &boundsMin, const glm::vec3 &boundsExtent);
+    };
+
+    // Joints and weights of a compact vertex, read by compute skinning only (see compute_skinning_compact.comp).
+    //  Joints are uint16x4, or uint8x4 in the 12 byte CompactSkinVertex8 for skins of at most 256 joints.
+    //  Weights are unorm16x4 in both, renormalized when skinning.
+    struct CompactSkinVertex {
+        uint32_t joints[2]{};
+        uint32_t weights[2]{};
+
+        static CompactSkinVertex encode(const Vertex &vertex);
+    };
+
+    struct CompactSkinVertex8 {
+        uint32_t joints{ 0u };
+        uint32_t weights[2]{};
+
+        static CompactSkinVertex8 encode(const Vertex &vertex);
+    };
 }
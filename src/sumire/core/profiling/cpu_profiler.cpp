@@ -15,14 +15,21 @@ namespace sumire {
         return *this;
     };
 
+    CpuProfiler::Builder& CpuProfiler::Builder::addCounter(std::string name) {
+        counters.emplace(name, 0u);
+
+        return *this;
+    }
+
     std::unique_ptr<CpuProfiler> CpuProfiler::Builder::build() const {
-        return std::make_unique<CpuProfiler>(profilingBlocks);
+        return std::make_unique<CpuProfiler>(profilingBlocks, counters);
     }
 
     // ---- Profiler ---------------------------------------------------------------------------------------------
     CpuProfiler::CpuProfiler(
-        NamedProfilingBlockMap profilingBlocks
-    ) : namedProfilingBlocks{ profilingBlocks } { 
+        NamedProfilingBlockMap profilingBlocks,
+        NamedCounterMap counters
+    ) : namedProfilingBlocks{ profilingBlocks }, namedCounters{ counters } { 
         for (auto& kv : namedProfilingBlocks) {
             recordedTimestamps.emplace(kv.first, ProfilingBlockTimestamp{});
         }
@@ -45,8 +52,20 @@ namespace sumire {
         ProfilingBlock& block = namedProfilingBlocks[name];
         recordedTimestamps[name].end = std::chrono::high_resolution_clock::now();
 
-        block.ms = std::chrono::duration<float, std::chrono::seconds::period>(
+        block.ms = std::chrono::duration<double, std::milli>(
             recordedTimestamps[name].end - recordedTimestamps[name].start).count();
     }
 
+    void CpuProfiler::incrementCounter(const std::string& name) {
+        assert(namedCounters.find(name) != namedCounters.end()
+            && "Tried to increment a counter not specified when building the CpuProfiler.");
+        namedCounters[name]++;
+    }
+
+    void CpuProfiler::setCounter(const std::string& name, uint64_t value) {
+        assert(namedCounters.find(name) != namedCounters.end()
+            && "Tried to set a counter not specified when building the CpuProfiler.");
+        namedCounters[name] = value;
+    }
+
 }
\ No newline at end of file
@@ -3,43 +3,68 @@
 #include <sumire/core/profiling/profiling_block.hpp>
 #include <sumire/core/profiling/profiling_block_timestamp.hpp>
 
+#include <cstdint>
 #include <memory>
 #include <map>
 
+#define BEGIN_CPU_PROFILING_BLOCK(profiler, blockName)  \
+   if ((profiler)) (profiler)->beginBlock((blockName)); \
+
+#define END_CPU_PROFILING_BLOCK(profiler, blockName)  \
+   if ((profiler)) (profiler)->endBlock((blockName)); \
+
+#define INCREMENT_CPU_PROFILING_COUNTER(profiler, counterName)  \
+   if ((profiler)) (profiler)->incrementCounter((counterName)); \
+
+#define SET_CPU_PROFILING_COUNTER(profiler, counterName, value)  \
+   if ((profiler)) (profiler)->setCounter((counterName), (value)); \
+
 namespace sumire {
 
     class CpuProfiler {
     public:
 
         typedef std::map<std::string, ProfilingBlock> NamedProfilingBlockMap;
+        typedef std::map<std::string, uint64_t> NamedCounterMap;
 
         class Builder {
         public:
             Builder() {}
 
             Builder& addBlock(std::string name);
+            // Counters accumulate over the profiler's lifetime, e.g. frames that skipped some work,
+            //  or hold a per frame value set with setCounter().
+            Builder& addCounter(std::string name);
             std::unique_ptr<CpuProfiler> build() const;
 
         private:
             uint32_t currentBlockIdx = 0u;
             NamedProfilingBlockMap profilingBlocks;
+            NamedCounterMap counters;
         };
 
         CpuProfiler(
-            NamedProfilingBlockMap profilingBlocks
+            NamedProfilingBlockMap profilingBlocks,
+            NamedCounterMap counters = {}
         );
         ~CpuProfiler() = default;
 
         void setBlockMillis(const std::string& name, double ms);
         void beginBlock(const std::string& name);
         void endBlock(const std::string& name);
+        void incrementCounter(const std::string& name);
+        void setCounter(const std::string& name, uint64_t value);
 
         const NamedProfilingBlockMap& getNamedBlocks() const {
             return namedProfilingBlocks;
         }
+        const NamedCounterMap& getNamedCounters() const {
+            return namedCounters;
+        }
 
     private:
         NamedProfilingBlockMap namedProfilingBlocks;
+        NamedCounterMap namedCounters;
         std::map<std::string, ProfilingBlockTimestamp> recordedTimestamps;
     };
 
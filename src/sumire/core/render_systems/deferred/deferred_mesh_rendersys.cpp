@@ -303,13 +303,29 @@ namespace sumire {
             std::string permutationVertShader = defaultVertShader;
             std::string permutationFragShader = defaultFragShader;
 
+            const bool compactVertex = permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_COMPACT_VERTEX_BIT;
+            const bool quantizedPosition =
+                permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_QUANTIZED_POSITION_BIT;
+            if (quantizedPosition && !compactVertex) continue;
+
             // Deal with each bit flag
             if (permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_UNLIT_BIT) {
-                permutationVertShader = SUMIRE_ENGINE_PATH("shaders/deferred/mesh_gbuffer_fill_unlit.vert");
+                permutationVertShader = compactVertex ?
+                    SUMIRE_ENGINE_PATH("shaders/deferred/mesh_gbuffer_fill_unlit_compact.vert") :
+                    SUMIRE_ENGINE_PATH("shaders/deferred/mesh_gbuffer_fill_unlit.vert");
                 permutationFragShader = SUMIRE_ENGINE_PATH("shaders/deferred/mesh_gbuffer_fill_unlit.frag");
+            } else if (compactVertex) {
+                permutationVertShader = SUMIRE_ENGINE_PATH("shaders/deferred/mesh_gbuffer_fill_compact.vert");
             }
             if (permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_DOUBLE_SIDED_BIT)
                 permutationConfig.rasterizationInfo.cullMode = VK_CULL_MODE_NONE;
+            if (quantizedPosition) {
+                permutationConfig.bindingDescriptions = QuantizedVertex::getBindingDescriptions();
+                permutationConfig.attributeDescriptions = QuantizedVertex::getAttributeDescriptions();
+            } else if (compactVertex) {
+                permutationConfig.bindingDescriptions = CompactVertex::getBindingDescriptions();
+                permutationConfig.attributeDescriptions = CompactVertex::getAttributeDescriptions();
+            }
 
             // Create pipeline and map it
             std::unique_ptr<SumiPipeline> permutationPipeline = std::make_unique<SumiPipeline>(
@@ -407,20 +423,11 @@ namespace sumire {
                 &push
             );
 
-            // TODO: Link animation playback (e.g. index, timer, loop) to UI.
-            //		 For now, play all animations, looped.
-            // TODO: This update can and should be done on a separate thread.
-            //		 Updating joint matrices may need to be made thread safe / double buffered as a result.
-            if (obj.model->getAnimationCount() > 0) {
-                std::vector<uint32_t> indices(obj.model->getAnimationCount());
-                for (uint32_t i = 0; i < indices.size(); i++) indices[i] = i;
-                obj.model->updateAnimations(indices, frameInfo.cumulativeFrameTime);
-            }
-            
+            // Animated node matrices and joints were written for this frame by SumiAnimationSystem.
             // SumiModel handles the binding of descriptor sets 1-3 and frag push constants
-            obj.model->bind(commandBuffer);
+            obj.model->bind(commandBuffer, frameInfo.frameIdx);
             // Each draw command may need a different pipeline, so the model draw binds pipelines at call time.
-            obj.model->draw(commandBuffer, pipelineLayout, pipelines);
+            obj.model->draw(commandBuffer, frameInfo.frameIdx, pipelineLayout, pipelines);
         }
     }
 }
\ No newline at end of file
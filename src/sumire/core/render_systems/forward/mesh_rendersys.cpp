@@ -119,11 +119,25 @@ namespace sumire {
             std::string permutationVertShader = defaultVertShader;
             std::string permutationFragShader = defaultFragShader;
 
+            const bool compactVertex = permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_COMPACT_VERTEX_BIT;
+            const bool quantizedPosition =
+                permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_QUANTIZED_POSITION_BIT;
+            if (quantizedPosition && !compactVertex) continue;
+
             // Deal with each bit flag
             if (permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_UNLIT_BIT)
                 permutationFragShader = SUMIRE_ENGINE_PATH("shaders/forward/mesh_unlit.frag");
             if (permutationFlags & SumiPipelineStateFlagBits::SUMI_PIPELINE_STATE_DOUBLE_SIDED_BIT)
                 permutationConfig.rasterizationInfo.cullMode = VK_CULL_MODE_NONE;
+            if (compactVertex)
+                permutationVertShader = SUMIRE_ENGINE_PATH("shaders/forward/mesh_compact.vert");
+            if (quantizedPosition) {
+                permutationConfig.bindingDescriptions = QuantizedVertex::getBindingDescriptions();
+                permutationConfig.attributeDescriptions = QuantizedVertex::getAttributeDescriptions();
+            } else if (compactVertex) {
+                permutationConfig.bindingDescriptions = CompactVertex::getBindingDescriptions();
+                permutationConfig.attributeDescriptions = CompactVertex::getAttributeDescriptions();
+            }
 
             // Create pipeline and map it
             std::unique_ptr<SumiPipeline> permutationPipeline = std::make_unique<SumiPipeline>(
@@ -166,19 +180,10 @@ namespace sumire {
                 &push
             );
 
-            // TODO: Link animation playback (e.g. index, timer, loop) to UI.
-            //		 For now, play all animations, looped.
-            // TODO: This update can and should be done on a separate thread.
-            //		 Updating joint matrices may need to be made thread safe / double buffered as a result.
-            if (obj.model->getAnimationCount() > 0) {
-                std::vector<uint32_t> indices(obj.model->getAnimationCount());
-                for (uint32_t i = 0; i < indices.size(); i++) indices[i] = i;
-                obj.model->updateAnimations(indices, frameInfo.cumulativeFrameTime);
-            }
-            
+            // Animated node matrices and joints were written for this frame by SumiAnimationSystem.
             // SumiModel handles the binding of descriptor sets 1-3 and frag push constants
-            obj.model->bind(commandBuffer);
-            obj.model->draw(commandBuffer, pipelineLayout, pipelines);
+            obj.model->bind(commandBuffer, frameInfo.frameIdx);
+            obj.model->draw(commandBuffer, frameInfo.frameIdx, pipelineLayout, pipelines);
         }
     }
 }
\ No newline at end of file
@@ -1,13 +1,12 @@
 #include <sumire/core/render_systems/high_quality_shadow_mapping/high_quality_shadow_mapper.hpp>
 
-#include <sumire/math/view_space_depth.hpp>
-#include <sumire/math/frustum_culling.hpp>
-#include <sumire/math/coord_space_converters.hpp>
 #include <sumire/util/vk_check_success.hpp>
 #include <sumire/util/sumire_engine_path.hpp>
 
 #include <algorithm>
 #include <array>
+#include <stdexcept>
+#include <string>
 
 // debug
 #define GLM_ENABLE_EXPERIMENTAL
@@ -23,18 +22,34 @@ namespace sumire {
         SumiHZB* hzb,
         SumiAttachment* zbuffer,
         SumiAttachment* gWorldPos,
-        VkDescriptorSetLayout globalDescriptorSetLayout
+        VkDescriptorSetLayout globalDescriptorSetLayout,
+        uint32_t maxLights,
+        SumiThreadPool* threadPool,
+        HQSMprepareMode prepareMode
     ) : sumiDevice{ device },
         screenWidth{ screenWidth }, 
         screenHeight{ screenHeight }, 
-        zBin{ NUM_SLICES }
+        zBin{ NUM_SLICES },
+        maxLights{ maxLights },
+        threadPool{ threadPool },
+        prepareMode{ prepareMode }
     {
+        if (maxLights > structs::lightMask::MAX_LIGHTS) {
+            throw std::runtime_error(
+                "[Sumire::HighQualityShadowMapper] Max light count exceeds the light mask limit of "
+                + std::to_string(structs::lightMask::MAX_LIGHTS) + " lights."
+            );
+        }
+
         lightMask = std::make_unique<structs::lightMask>(screenWidth, screenHeight);
+        lightMaskCapacity = initialLightMaskCapacity();
         calculateTileResolutions();
 
         initDescriptorLayouts();
 
         initPreparePhase();                           // Phase 1
+        if (prepareMode != HQSM_PREPARE_CPU) 
+            initGpuPreparePhase();
         initLightsApproxPhase(hzb);                   // Phase 2
         initLightsAccuratePhase(zbuffer, gWorldPos);  // Phase 3
         initDeferredShadowsPhase(                     // Phase 4
@@ -44,43 +59,17 @@ namespace sumire {
     }
 
     HighQualityShadowMapper::~HighQualityShadowMapper() {
+        cleanupGpuPreparePhase();
         cleanupLightsApproxPhase();
         cleanupLightsAccuratePhase();
         cleanupDeferredShadowsPhase();
     }
 
-    std::vector<structs::viewSpaceLight> HighQualityShadowMapper::sortLightsByViewSpaceDepth(
-        SumiLight::Map& lights,
-        glm::mat4 view,
-        float near
+    std::span<const structs::viewSpaceLight> HighQualityShadowMapper::sortLightsByViewSpaceDepth(
+        const SumiLightStore& lights,
+        const glm::mat4& view
     ) {
-        // Create view space lights & calculate view space depths
-        auto viewSpaceLights = std::vector<structs::viewSpaceLight>();
-        for (auto& kv : lights) {
-            auto& light = kv.second;
-
-            structs::viewSpaceLight viewSpaceLight{};
-            viewSpaceLight.lightPtr = &light;
-
-            viewSpaceLight.viewSpaceDepth = calculateOrthogonalViewSpaceDepth(
-                light.transform.getTranslation(),
-                view,
-                &viewSpaceLight.viewSpacePosition
-            );
-            viewSpaceLight.minDepth = viewSpaceLight.viewSpaceDepth - light.range;
-            viewSpaceLight.maxDepth = viewSpaceLight.viewSpaceDepth + light.range;
-
-            viewSpaceLights.push_back(std::move(viewSpaceLight));
-        }
-
-        // Sort by (min) view space depth
-        std::sort(viewSpaceLights.begin(), viewSpaceLights.end(), 
-            [](const structs::viewSpaceLight& a, const structs::viewSpaceLight& b) {
-                return a.minDepth < b.minDepth;
-            }
-        );
-
-        return viewSpaceLights;
+        return lightSorter.sort(lights, view);
     }
 
     void HighQualityShadowMapper::updateScreenBounds(
@@ -93,31 +82,41 @@ namespace sumire {
         screenHeight = height;
 
         lightMask = std::make_unique<structs::lightMask>(screenWidth, screenHeight);
+        lightMaskBuilder.invalidateTilePlanes();
+        lightMaskCapacity = std::max(lightMaskCapacity, initialLightMaskCapacity());
         calculateTileResolutions();
 
-        // ---- Recreate Lights Approx Buffers -------------------------------------------------------------------
-        lightMaskBuffer = nullptr;
-        createLightMaskBuffer();
+        // ---- Recreate Prepare Buffers -------------------------------------------------------------------------
+        createLightMaskBuffers();
+        prepareFrameTracker.invalidateAll();
 
-        tileGroupLightMaskBuffer = nullptr;
-        createTileGroupLightMaskBuffer();
+        if (prepareMode != HQSM_PREPARE_CPU) {
+            if (prepareMode == HQSM_PREPARE_GPU_VALIDATED) {
+                lightMaskReadbackBuffer = nullptr;
+                createLightMaskReadbackBuffer();
+            }
+            // Usage read back for the old tile resolution no longer says anything about the new one.
+            std::fill(lightMaskUsagePending.begin(), lightMaskUsagePending.end(), false);
+            updatePrepareDescriptorSets();
+        }
 
+        // ---- Recreate Lights Approx Buffers -------------------------------------------------------------------
         tileShadowSlotIDsBuffer = nullptr;
         createTileShadowSlotIDsBuffer();
 
         slotCountersBuffer = nullptr;
         createSlotCountersBuffer();
 
-        updateLightsApproxDescriptorSet(hzb);
+        updateLightsApproxDescriptorSets(hzb);
 
-        // ---- Recreate Lights Accurate Buffers -----------------------------------------------------------------
+        // ---- Recreate Lights Accurate Buffers ----------------------------------------------------------------
         tileLightListEarlyBuffer = nullptr;
         createTileLightListEarlyBuffer();
 
         tileLightCountEarlyBuffer = nullptr;
         createTileLightCountEarlyBuffer();
 
-        updateLightsAccurateDescriptorSet(zbuffer, gWorldPos);
+        updateLightsAccurateDescriptorSets(zbuffer, gWorldPos);
 
         // ---- Recreate Deferred Shadows Buffers ----------------------------------------------------------------
         tileLightListFinalBuffer = nullptr;
@@ -133,19 +132,89 @@ namespace sumire {
     }
 
     void HighQualityShadowMapper::prepare(
-        const std::vector<structs::viewSpaceLight>& lights,
-        const SumiCamera& camera
+        std::span<const structs::viewSpaceLight> lights,
+        const SumiCamera& camera,
+        CpuProfiler* cpuProfiler
     ) {
-        // We end up doing this preparation step on the CPU as the light list needs
-        //  to be view-depth sorted prior to zBin and light mask generation for memory reduction.
+        // The light list is always view-depth sorted on the CPU prior to zBin and light mask generation
+        //  for memory reduction. Binning and culling can then run on either the CPU or the GPU.
+        prepareFrameTracker.advance();
+        prepareFrameStats.preparedFrames++;
+
+        if (prepareMode != HQSM_PREPARE_CPU) {
+            BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "0-2: Prepared Lights Upload");
+            packPreparedLights(lights, camera);
+            END_CPU_PROFILING_BLOCK(cpuProfiler, "0-2: Prepared Lights Upload");
+
+            if (prepareMode == HQSM_PREPARE_GPU_VALIDATED) {
+                // CPU reference, diffed against the GPU outputs by the next prepareFrame().
+                generateZbin(lights, camera);
+                prepareValidationStats.zBinReferenceMismatches =
+                    zBinBuilder.validate(zBin, &prepareValidationStats.firstZbinReferenceMismatch);
+                generateLightMask(lights, camera);
+                // The GPU culls the same lights into blocks of the same size, so it needs as many words
+                //  plus the word kept clear for overflowing tiles.
+                reserveLightMaskWords(static_cast<uint32_t>(lightMask->words.size()) + 1u);
+                gpuValidationPending = true;
+            }
+            return;
+        }
+
+        BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "0-0: zBin Generation");
         generateZbin(lights, camera);
-        writeZbinBuffer();
+        END_CPU_PROFILING_BLOCK(cpuProfiler, "0-0: zBin Generation");
+
+        BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "0-1: Light Mask Generation");
         generateLightMask(lights, camera);
-        writeLightMaskBuffer();
+        reserveLightMaskWords(static_cast<uint32_t>(lightMask->words.size()));
+        END_CPU_PROFILING_BLOCK(cpuProfiler, "0-1: Light Mask Generation");
+    }
+
+    void HighQualityShadowMapper::prepareFrame(
+        int frameIdx,
+        VkCommandBuffer commandBuffer,
+        CpuProfiler* cpuProfiler
+    ) {
+        // The frame's fence has signalled, so its buffers can be reallocated if the light mask outgrew them.
+        if (prepareMode != HQSM_PREPARE_CPU) readLightMaskUsage(frameIdx);
+        growFrameLightMaskBuffers(frameIdx);
+
+        // Frames only read their own buffers, so they are written at most once per prepare().
+        if (!prepareFrameTracker.acquire(frameIdx)) {
+            prepareFrameStats.skippedFrames++;
+            return;
+        }
+        prepareFrameStats.frameUploads++;
+
+        BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "0-5: Frame Buffers Upload");
+        if (prepareMode == HQSM_PREPARE_CPU) {
+            writeZbinBuffer(frameIdx);
+            writeLightMaskBuffer(frameIdx);
+        }
+        else {
+            writePreparedLightsBuffer(frameIdx);
+            writeSliceBoundariesBuffer(frameIdx);
+        }
+        END_CPU_PROFILING_BLOCK(cpuProfiler, "0-5: Frame Buffers Upload");
+
+        if (prepareMode == HQSM_PREPARE_CPU) return;
+
+        if (gpuValidationPending) {
+            // Validation dispatches into this frame's buffers itself.
+            gpuValidationPending = false;
+
+            BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "0-3: GPU Prepare Validation");
+            validateGpuPrepare(frameIdx);
+            END_CPU_PROFILING_BLOCK(cpuProfiler, "0-3: GPU Prepare Validation");
+            return;
+        }
+
+        recordPrepareDispatches(commandBuffer, frameIdx);
     }
 
     void HighQualityShadowMapper::findLightsApproximate(
         VkCommandBuffer commandBuffer,
+        int frameIdx,
         float near, float far
     ) {
         findLightsApproxPipeline->bind(commandBuffer);
@@ -169,7 +238,7 @@ namespace sumire {
         );
 
         std::array<VkDescriptorSet, 1> descriptors{
-            lightsApproxDescriptorSet
+            lightsApproxDescriptorSets[frameIdx]
         };
 
         vkCmdBindDescriptorSets(
@@ -186,7 +255,8 @@ namespace sumire {
     }
 
     void HighQualityShadowMapper::findLightsAccurate(
-        VkCommandBuffer commandBuffer
+        VkCommandBuffer commandBuffer,
+        int frameIdx
     ) {
         findLightsAccuratePipeline->bind(commandBuffer);
 
@@ -207,7 +277,7 @@ namespace sumire {
         );
 
         std::array<VkDescriptorSet, 1> descriptors{
-            lightsAccurateDescriptorSet
+            lightsAccurateDescriptorSets[frameIdx]
         };
 
         vkCmdBindDescriptorSets(
@@ -264,267 +334,657 @@ namespace sumire {
 
     // ---- (CPU) Phase 1: Prepare -------------------------------------------------------------------------------
     void HighQualityShadowMapper::initPreparePhase() {
-        createZbinBuffer();
-        createLightMaskBuffer();
+        // Most frames only move a handful of lights relative to the camera, so only re-bin the slices they touch.
+        zBinBuilder.setIncremental(true);
+
+        prepareFrameTracker = PrepareFrameTracker{ SumiSwapChain::MAX_FRAMES_IN_FLIGHT };
+        lightMaskBufferCapacities = std::vector<uint32_t>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, 0u);
+        lightMaskBufferGenerations = std::vector<uint64_t>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, 0u);
+        createZbinBuffers();
+        createLightMaskBuffers();
     }
 
-    void HighQualityShadowMapper::createZbinBuffer() {
-        zBinBuffer = std::make_unique<SumiBuffer>(
+    void HighQualityShadowMapper::createZbinBuffers() {
+        zBinBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+
+        for (auto& zBinBuffer : zBinBuffers) {
+            if (prepareMode != HQSM_PREPARE_CPU) {
+                // Filled by the GPU prepare pass
+                zBinBuffer = std::make_unique<SumiBuffer>(
+                    sumiDevice,
+                    NUM_SLICES * sizeof(structs::zBinData),
+                    1,
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                );
+                continue;
+            }
+
+            zBinBuffer = std::make_unique<SumiBuffer>(
+                sumiDevice,
+                NUM_SLICES * sizeof(structs::zBinData),
+                1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+            );
+            zBinBuffer->map();
+        }
+    }
+
+    void HighQualityShadowMapper::createLightMaskBuffers() {
+        lightMaskBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        tileGroupLightMaskBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            createFrameLightMaskBuffers(i);
+        }
+    }
+
+    void HighQualityShadowMapper::createFrameLightMaskBuffers(int frameIdx) {
+        std::unique_ptr<SumiBuffer>& lightMaskBuffer = lightMaskBuffers[frameIdx];
+        lightMaskBuffer = nullptr;
+
+        if (prepareMode != HQSM_PREPARE_CPU) {
+            // Filled by the GPU prepare pass. The allocation counter is reset with a transfer each dispatch,
+            //  and copied out afterwards to size the buffer.
+            lightMaskBuffer = std::make_unique<SumiBuffer>(
+                sumiDevice,
+                lightMaskCapacity * sizeof(uint32_t),
+                1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                    | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+            );
+        }
+        else {
+            lightMaskBuffer = std::make_unique<SumiBuffer>(
+                sumiDevice,
+                lightMaskCapacity * sizeof(uint32_t),
+                1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+            );
+            lightMaskBuffer->map();
+        }
+
+        // 1 Light mask block per 8x8 shadow tile group, written in place of its 2x2 light mask tile blocks.
+        tileGroupLightMaskBuffers[frameIdx] = nullptr;
+        tileGroupLightMaskBuffers[frameIdx] = std::make_unique<SumiBuffer>(
             sumiDevice,
-            NUM_SLICES * sizeof(structs::zBinData),
+            lightMaskCapacity * sizeof(uint32_t),
             1,
             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
-        zBinBuffer->map();
+
+        lightMaskBufferCapacities[frameIdx] = lightMaskCapacity;
+        lightMaskBufferGenerations[frameIdx]++;
     }
 
-    void HighQualityShadowMapper::createLightMaskBuffer() {
-        uint32_t nTiles = lightMask->numTilesX * lightMask->numTilesY;
-        lightMaskBuffer = std::make_unique<SumiBuffer>(
-            sumiDevice,
-            nTiles * sizeof(structs::lightMaskTile),
-            1,
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    uint32_t HighQualityShadowMapper::initialLightMaskCapacity() const {
+        return structs::lightMask::HEADER_WORDS + lightMask->numTiles() * (1u + INITIAL_LIGHT_MASK_WORDS_PER_TILE);
+    }
+
+    void HighQualityShadowMapper::reserveLightMaskWords(uint32_t numWords) {
+        if (numWords <= lightMaskCapacity) return;
+
+        // Only the target size grows here, frames in flight grow their buffers in prepareFrame().
+        lightMaskCapacity = std::max(
+            numWords + numWords / LIGHT_MASK_HEADROOM_DIVISOR,
+            lightMaskCapacity + lightMaskCapacity / 2u
         );
-        lightMaskBuffer->map();
+    }
+
+    void HighQualityShadowMapper::growFrameLightMaskBuffers(int frameIdx) {
+        if (lightMaskBufferCapacities[frameIdx] >= lightMaskCapacity) return;
+
+        // Only this frame's command buffers bind its light mask buffers, and they have finished executing,
+        //  so the old buffers are freed straight away. Other frames in flight keep theirs until their turn.
+        createFrameLightMaskBuffers(frameIdx);
+        updateFrameLightMaskDescriptors(frameIdx);
+
+        // The new buffers hold nothing yet.
+        prepareFrameTracker.invalidate(frameIdx);
+        prepareFrameStats.lightMaskGrowths++;
+    }
+
+    void HighQualityShadowMapper::updateFrameLightMaskDescriptors(int frameIdx) {
+        // Only the light mask bindings changed, so leave the other descriptors alone.
+        VkDescriptorBufferInfo lightMaskInfo          = lightMaskBuffers[frameIdx]->descriptorInfo();
+        VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffers[frameIdx]->descriptorInfo();
+
+        if (prepareMode != HQSM_PREPARE_CPU) {
+            SumiDescriptorWriter(*prepareDescriptorLayout, *descriptorPool)
+                .writeBuffer(2, &lightMaskInfo)
+                .overwrite(prepareDescriptorSets[frameIdx]);
+        }
+
+        SumiDescriptorWriter(*lightsApproxDescriptorLayout, *descriptorPool)
+            .writeBuffer(1, &tileGroupLightMaskInfo)
+            .writeBuffer(5, &lightMaskInfo)
+            .overwrite(lightsApproxDescriptorSets[frameIdx]);
+
+        SumiDescriptorWriter(*lightsAccurateDescriptorLayout, *descriptorPool)
+            .writeBuffer(2, &tileGroupLightMaskInfo)
+            .overwrite(lightsAccurateDescriptorSets[frameIdx]);
     }
 
     void HighQualityShadowMapper::generateZbin(
-        const std::vector<structs::viewSpaceLight>& lights,
+        std::span<const structs::viewSpaceLight> lights,
         const SumiCamera& camera
     ) {
         // Bin lights into discrete z intervals between the near and far camera plane.
         // Note: lights MUST BE PRE-SORTED BY VIEWSPACE DISTANCE. ( see sortLightsByViewSpaceDepth() ).
-        
-        zBin.reset();
-
-        if (lights.size() == 0)  return;
-
-        const glm::mat4 view = camera.getViewMatrix();
-        const float near     = camera.getNear();
-        const float far      = camera.getFar();
-
-        const float logFarNear = glm::log(far / near);
-        const float sliceFrac1 = static_cast<float>(NUM_SLICES) / logFarNear;
-        const float sliceFrac2 = static_cast<float>(NUM_SLICES) * glm::log(near) / logFarNear;
-
-        // Fill standard zBin
-        uint32_t lastLightIdx = static_cast<uint32_t>(lights.size()) - 1u;
-        for (size_t i = 0; i <= lastLightIdx; i++) {
-            float minZ = lights[i].minDepth;
-            float maxZ = lights[i].maxDepth;
-
-            // Slice calculation from Tiago Sous' DOOM 2016 Siggraph presentation.
-            //   Interactive graph: https://www.desmos.com/calculator/bf0g6n0hqp
-            int minSlice = glm::floor<int>(glm::log(minZ) * sliceFrac1 - sliceFrac2);
-            int maxSlice = glm::floor<int>(glm::log(maxZ) * sliceFrac1 - sliceFrac2);
-
-            // Clamp to valid index range, leaving -1 and NUM_SLICES for out-of-range flags.
-            minSlice = glm::clamp<int>(minSlice, -1, NUM_SLICES);
-            maxSlice = glm::clamp<int>(maxSlice, -1, NUM_SLICES);
-
-            // Set min and max light indices (zBin metadata) when lights are visible
-            if (minSlice < static_cast<int>(NUM_SLICES) && maxSlice >= 0) {
-                if (zBin.minLight == -1) zBin.minLight = static_cast<int>(i);
-                zBin.maxLight = static_cast<int>(i);
-            }
+        zBinBuilder.build(lights, camera.getNear(), camera.getFar(), zBin);
+    }
 
-            for (int j = minSlice; j <= maxSlice; j++) {
-                // Disregard lights out of zBin range (either behind near plane or beyond far plane)
-                if (j < 0 || j >= NUM_SLICES) continue;
-
-                //   min
-                if (zBin.data[j].minLightIdx == -1) zBin.data[j].minLightIdx = i;
-                else zBin.data[j].minLightIdx = glm::min<int>(zBin.data[j].minLightIdx, i);
-                //   max
-                zBin.data[j].maxLightIdx = glm::max<int>(zBin.data[j].maxLightIdx, i);
-
-                // Fill first / last zBin idx (zBin metadata)
-                //  first
-                if (zBin.firstFullIdx == -1 && j != -1) 
-                    zBin.firstFullIdx = j;
-                else 
-                    zBin.firstFullIdx = glm::min(zBin.firstFullIdx, j);
-                //  last
-                zBin.lastFullIdx = glm::max(zBin.lastFullIdx, j);
-            }
+    void HighQualityShadowMapper::writeZbinBuffer(int frameIdx) {
+        zBinBuffers[frameIdx]->writeToBuffer(zBin.data.data());
+        zBinBuffers[frameIdx]->flush();
+    }
+
+    void HighQualityShadowMapper::generateLightMask(
+        std::span<const structs::viewSpaceLight> lights,
+        const SumiCamera& camera
+    ) {
+        assert(lights.size() <= maxLights);
+
+        // Tiles are cleared and filled by the builder, split by tile group rows over the thread pool.
+        lightMaskBuilder.build(
+            lights, camera,
+            glm::uvec2{ screenWidth, screenHeight },
+            *lightMask,
+            threadPool
+        );
+    }
+
+    void HighQualityShadowMapper::writeLightMaskBuffer(int frameIdx) {
+        // Capacity is reserved by prepare() and the frame's buffer grown to it by prepareFrame(). Only the words
+        //  in use are copied, the rest of the buffer is never read.
+        const uint32_t numWords = static_cast<uint32_t>(lightMask->words.size());
+        assert(numWords <= lightMaskBufferCapacities[frameIdx]);
+
+        lightMaskBuffers[frameIdx]->writeToBuffer((void *)lightMask->words.data(), numWords * sizeof(uint32_t));
+        lightMaskBuffers[frameIdx]->flush();
+    }
+
+    // ---- (GPU) Phase 1: Prepare -------------------------------------------------------------------------------
+    void HighQualityShadowMapper::initGpuPreparePhase() {
+        createPreparedLightsBuffers();
+        if (prepareMode == HQSM_PREPARE_GPU_VALIDATED) {
+            createZbinReadbackBuffer();
+            createLightMaskReadbackBuffer();
         }
+        createLightMaskUsageBuffers();
+        createSliceBoundariesBuffers();
+        initPrepareDescriptorSets();
+        initPreparePipelines();
+    }
 
-        // Fill ranged zBin
-        const uint32_t lastZbinIdx = static_cast<uint32_t>(zBin.data.size()) - 1u;
-        int nextIdx;
-        int currIdx;
-        int prevIdx;
-
-        int nextRangedMin = zBin.minLight;
-
-        // TODO: Here be some voodoo. There is likely a more straight forward way to fill this
-        //         ranged buffer, but the paper isn't very explicit about how they do it so I made my own
-        //		   solution. 
-        //       We fill explicit ranges first, then fill in the gaps with a reversed two-pointer type approach.
-
-        // First pass - fill in explicit ranges
-        for (uint32_t j = 0; j <= lastZbinIdx; j++) {
-            // rMin
-            if (j != lastZbinIdx) {
-                currIdx = zBin.data[j].minLightIdx;
-                nextIdx = zBin.data[j + 1].minLightIdx;
-
-                if (nextIdx == -1) 
-                    nextIdx = zBin.data[j].minLightIdx;
-                if (currIdx != -1)
-                    zBin.data[j].rangedMinLightIdx = glm::min(currIdx, nextIdx);
-            }
+    void HighQualityShadowMapper::createPreparedLightsBuffers() {
+        preparedLightsBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
 
-            // rMax
-            if (j != 0) {
-                currIdx = zBin.data[j].maxLightIdx;
-                prevIdx = zBin.data[j - 1].maxLightIdx;
+        for (auto& preparedLightsBuffer : preparedLightsBuffers) {
+            preparedLightsBuffer = std::make_unique<SumiBuffer>(
+                sumiDevice,
+                std::max(maxLights, 1u) * sizeof(structs::preparedLight),
+                1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+            );
+            preparedLightsBuffer->map();
+        }
+    }
 
-                if (prevIdx == -1) 
-                    prevIdx = zBin.data[j].maxLightIdx;
-                if (currIdx != -1)
-                    zBin.data[j].rangedMaxLightIdx = glm::max(currIdx, prevIdx);
-            }
+    void HighQualityShadowMapper::createZbinReadbackBuffer() {
+        zBinReadbackBuffer = std::make_unique<SumiBuffer>(
+            sumiDevice,
+            NUM_SLICES * sizeof(structs::zBinData),
+            1,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        );
+        zBinReadbackBuffer->map();
+    }
+
+    void HighQualityShadowMapper::createLightMaskReadbackBuffer() {
+        lightMaskReadbackBuffer = std::make_unique<SumiBuffer>(
+            sumiDevice,
+            lightMaskCapacity * sizeof(uint32_t),
+            1,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        );
+        lightMaskReadbackBuffer->map();
+    }
+
+    void HighQualityShadowMapper::createLightMaskUsageBuffers() {
+        lightMaskUsageBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        lightMaskUsagePending = std::vector<bool>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, false);
+
+        for (auto& lightMaskUsageBuffer : lightMaskUsageBuffers) {
+            // Light mask word 0 (the allocation counter) of the frame's last prepare dispatch.
+            lightMaskUsageBuffer = std::make_unique<SumiBuffer>(
+                sumiDevice,
+                sizeof(uint32_t),
+                1,
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+            );
+            lightMaskUsageBuffer->map();
         }
+    }
 
-        // Second pass - fill in implicit ranges (gaps) where indices are still undefined (-1)
-        //   but have prior (in the case of max) or following (in the case of min) lights.
-        // TODO: There may be a way to combine this into the pass above for O(2n) -> O(n).
-        int minIdxCache = zBin.maxLight;
-        int maxIdxCache = zBin.minLight;
-
-        uint32_t minPtr;
-        for (uint32_t maxPtr = 0; maxPtr <= lastZbinIdx; maxPtr++) {
-            // rMin
-            minPtr = lastZbinIdx - maxPtr;
-            if (minPtr <= zBin.lastFullIdx) {
-                int currMinIdx = zBin.data[minPtr].rangedMinLightIdx;
-                if (currMinIdx == -1) {
-                    zBin.data[minPtr].rangedMinLightIdx = minIdxCache;
-                }
-                else if (minPtr == 0 || zBin.data[minPtr - 1].rangedMinLightIdx == -1) {
-                    minIdxCache = currMinIdx;
-                }
-            }
+    void HighQualityShadowMapper::createSliceBoundariesBuffers() {
+        sliceBoundariesBuffers.resize(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        sliceBoundariesGenerations = std::vector<uint64_t>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, 0u);
+
+        for (auto& sliceBoundariesBuffer : sliceBoundariesBuffers) {
+            sliceBoundariesBuffer = std::make_unique<SumiBuffer>(
+                sumiDevice,
+                (NUM_SLICES + 1u) * sizeof(float),
+                1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+            );
+            sliceBoundariesBuffer->map();
+        }
+    }
 
-            // rMax
-            if (maxPtr >= zBin.firstFullIdx) {
-                int currMaxIdx = zBin.data[maxPtr].rangedMaxLightIdx;
-                if (currMaxIdx == -1) {
-                    zBin.data[maxPtr].rangedMaxLightIdx = maxIdxCache;
-                }
-                else if (maxPtr == lastZbinIdx || zBin.data[maxPtr + 1].rangedMaxLightIdx == -1) {
-                    maxIdxCache = currMaxIdx;
-                }
-            }
+    void HighQualityShadowMapper::initPrepareDescriptorSets() {
+        prepareDescriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            assert(preparedLightsBuffers[i] != nullptr
+                && "Cannot instantiate descriptor set with null prepared lights buffer");
+            assert(zBinBuffers[i] != nullptr
+                && "Cannot instantiate descriptor set with null zbin buffer");
+            assert(lightMaskBuffers[i] != nullptr
+                && "Cannot instantiate descriptor set with null light mask buffer");
+            assert(sliceBoundariesBuffers[i] != nullptr
+                && "Cannot instantiate descriptor set with null slice boundaries buffer");
+
+            VkDescriptorBufferInfo preparedLightsInfo = preparedLightsBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo zbinInfo           = zBinBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo lightMaskInfo      = lightMaskBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo sliceBoundsInfo    = sliceBoundariesBuffers[i]->descriptorInfo();
+
+            SumiDescriptorWriter(*prepareDescriptorLayout, *descriptorPool)
+                .writeBuffer(0, &preparedLightsInfo)
+                .writeBuffer(1, &zbinInfo)
+                .writeBuffer(2, &lightMaskInfo)
+                .writeBuffer(3, &sliceBoundsInfo)
+                .build(prepareDescriptorSets[i]);
         }
     }
 
-    void HighQualityShadowMapper::writeZbinBuffer() {
-        zBinBuffer->writeToBuffer(zBin.data.data());
-        zBinBuffer->flush();
+    void HighQualityShadowMapper::updatePrepareDescriptorSets() {
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            assert(preparedLightsBuffers[i] != nullptr
+                && "Cannot update descriptor set with null prepared lights buffer");
+            assert(zBinBuffers[i] != nullptr
+                && "Cannot update descriptor set with null zbin buffer");
+            assert(lightMaskBuffers[i] != nullptr
+                && "Cannot update descriptor set with null light mask buffer");
+            assert(sliceBoundariesBuffers[i] != nullptr
+                && "Cannot update descriptor set with null slice boundaries buffer");
+
+            VkDescriptorBufferInfo preparedLightsInfo = preparedLightsBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo zbinInfo           = zBinBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo lightMaskInfo      = lightMaskBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo sliceBoundsInfo    = sliceBoundariesBuffers[i]->descriptorInfo();
+
+            SumiDescriptorWriter(*prepareDescriptorLayout, *descriptorPool)
+                .writeBuffer(0, &preparedLightsInfo)
+                .writeBuffer(1, &zbinInfo)
+                .writeBuffer(2, &lightMaskInfo)
+                .writeBuffer(3, &sliceBoundsInfo)
+                .overwrite(prepareDescriptorSets[i]);
+        }
     }
 
-    void HighQualityShadowMapper::generateLightMask(
-        const std::vector<structs::viewSpaceLight>& lights,
+    void HighQualityShadowMapper::initPreparePipelines() {
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushRange.offset     = 0;
+        pushRange.size       = sizeof(structs::preparePush);
+
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{
+            prepareDescriptorLayout->getDescriptorSetLayout()
+        };
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount         = static_cast<uint32_t>(descriptorSetLayouts.size());
+        pipelineLayoutInfo.pSetLayouts            = descriptorSetLayouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges    = &pushRange;
+
+        VK_CHECK_SUCCESS(
+            vkCreatePipelineLayout(
+                sumiDevice.device(), &pipelineLayoutInfo, nullptr, &preparePipelineLayout),
+            "[Sumire::HighQualityShadowMapper] Failed to create prepare pipeline layout (Phase 1)."
+        );
+
+        prepareZbinPipeline = std::make_unique<SumiComputePipeline>(
+            sumiDevice,
+            SUMIRE_ENGINE_PATH(
+                "shaders/high_quality_shadow_mapping/prepare_zbin.comp"),
+            preparePipelineLayout
+        );
+
+        prepareLightMaskPipeline = std::make_unique<SumiComputePipeline>(
+            sumiDevice,
+            SUMIRE_ENGINE_PATH(
+                "shaders/high_quality_shadow_mapping/prepare_light_mask.comp"),
+            preparePipelineLayout
+        );
+    }
+
+    void HighQualityShadowMapper::cleanupGpuPreparePhase() {
+        vkDestroyPipelineLayout(sumiDevice.device(), preparePipelineLayout, nullptr);
+    }
+
+    void HighQualityShadowMapper::packPreparedLights(
+        std::span<const structs::viewSpaceLight> lights,
         const SumiCamera& camera
     ) {
-        assert(lights.size() < 1025);
-
-        lightMask->clear();
-
-        // Frustum calculations are done in view space as we have access
-        //   to all light positions in view space from the prior sort.
-        constexpr glm::vec3 origin = glm::vec3(0.0f);
-        const float near = camera.getNear();
-        const float far  = camera.getFar();
-
-        const glm::vec2 screenDim{ screenWidth, screenHeight };
-        const glm::mat4 invProjection = glm::inverse(camera.getProjectionMatrix());
-
-        // Cull lights against frusta with sphere intersection
-        for (uint32_t frustumX = 0; frustumX < lightMask->numTilesX; frustumX++) {
-            for (uint32_t frustumY = 0; frustumY < lightMask->numTilesY; frustumY++) {
-                structs::lightMaskTile& tile = lightMask->tileAtIdx(frustumX, frustumY);
-
-                constexpr float lightMaskTileSize = 32.0f;
-
-                // Screen space coords of frusta points
-                const glm::vec4 screenTopL = { lightMaskTileSize * glm::vec2{  frustumX  , frustumY  }, -1.0f, 1.0f };
-                const glm::vec4 screenTopR = { lightMaskTileSize * glm::vec2{  frustumX+1, frustumY  }, -1.0f, 1.0f };
-                const glm::vec4 screenBotL = { lightMaskTileSize * glm::vec2{  frustumX  , frustumY+1}, -1.0f, 1.0f };
-                const glm::vec4 screenBotR = { lightMaskTileSize * glm::vec2{  frustumX+1, frustumY+1}, -1.0f, 1.0f };
-
-                // View space coords of frusta points
-                // TODO: Can probably calculate these view space pos from camera's intrinsic to save 
-                //       On the inv projection calculation + four multiplications per tile
-                const glm::vec3 viewTopL = glm::vec3(screenToView(screenTopL, screenDim, invProjection));
-                const glm::vec3 viewTopR = glm::vec3(screenToView(screenTopR, screenDim, invProjection));
-                const glm::vec3 viewBotL = glm::vec3(screenToView(screenBotL, screenDim, invProjection));
-                const glm::vec3 viewBotR = glm::vec3(screenToView(screenBotR, screenDim, invProjection));
-
-                // Frusta bounding planes from points
-                const FrustumPlane tileFrustumT = computeFrustumPlane(origin, viewTopR, viewTopL);
-                const FrustumPlane tileFrustumB = computeFrustumPlane(origin, viewBotL, viewBotR);
-                const FrustumPlane tileFrustumR = computeFrustumPlane(origin, viewBotR, viewTopR);
-                const FrustumPlane tileFrustumL = computeFrustumPlane(origin, viewTopL, viewBotL);
-
-                for (uint32_t i = 0; i < lights.size(); i++) {
-                    const float r = lights[i].lightPtr->range;
-                    const glm::vec3 p = lights[i].viewSpacePosition;
-
-                    const bool intersectionIntT = tileFrustumT.intersectSphere(p, r);
-                    const bool intersectionIntB = tileFrustumB.intersectSphere(p, r);
-                    const bool intersectionIntL = tileFrustumL.intersectSphere(p, r);
-                    const bool intersectionIntR = tileFrustumR.intersectSphere(p, r);
-                    const bool intersectionIntN = lights[i].viewSpaceDepth + r > near;
-                    const bool intersectionIntF = lights[i].viewSpaceDepth - r < far;
-
-                    const bool intersects = (
-                        intersectionIntT &&
-                        intersectionIntB &&
-                        intersectionIntL &&
-                        intersectionIntR &&
-                        intersectionIntN &&
-                        intersectionIntF
-                    );
-
-                    if (intersects) tile.setLightBit(i);
-                }
-            }
+        assert(lights.size() <= maxLights);
+
+        // Packed once per prepare(), then copied into each frame in flight's light list by prepareFrame().
+        preparedLights.resize(lights.size());
+        for (size_t i = 0; i < lights.size(); i++) {
+            const structs::viewSpaceLight& light = lights[i];
+            preparedLights[i].viewSpacePositionRange = glm::vec4{ light.viewSpacePosition, light.range };
+            preparedLights[i].viewSpaceDepths = glm::vec4{ light.viewSpaceDepth, light.minDepth, light.maxDepth, 0.0f };
         }
+
+        preparePush.invProjection       = glm::inverse(camera.getProjectionMatrix());
+        preparePush.screenResolution    = glm::uvec2(screenWidth, screenHeight);
+        preparePush.lightMaskResolution = glm::uvec2(lightMask->numTilesX, lightMask->numTilesY);
+        preparePush.numLights           = static_cast<glm::uint>(lights.size());
+        preparePush.numZbinSlices       = NUM_SLICES;
+        preparePush.cameraNear          = glm::float32(camera.getNear());
+        preparePush.cameraFar           = glm::float32(camera.getFar());
+
+        // Only rebuilt when near or far change. Validated mode rebuilds it with the CPU zBin anyway.
+        zBinBuilder.updateSliceBoundaries(camera.getNear(), camera.getFar(), NUM_SLICES);
     }
 
-    void HighQualityShadowMapper::writeLightMaskBuffer() {
-        lightMaskBuffer->writeToBuffer((void *)lightMask->tiles.data());
-        lightMaskBuffer->flush();
+    void HighQualityShadowMapper::writePreparedLightsBuffer(int frameIdx) {
+        if (preparedLights.empty()) return;
+
+        SumiBuffer& preparedLightsBuffer = *preparedLightsBuffers[frameIdx];
+        const VkDeviceSize size = preparedLights.size() * sizeof(structs::preparedLight);
+        preparedLightsBuffer.writeToBuffer(preparedLights.data(), size);
+        preparedLightsBuffer.flush(size);
+    }
+
+    void HighQualityShadowMapper::writeSliceBoundariesBuffer(int frameIdx) {
+        const uint64_t generation = zBinBuilder.getSliceBoundariesGeneration();
+        if (sliceBoundariesGenerations[frameIdx] == generation) return;
+        sliceBoundariesGenerations[frameIdx] = generation;
+
+        std::span<const float> sliceBoundaries = zBinBuilder.getSliceBoundaries();
+        assert(sliceBoundaries.size() == NUM_SLICES + 1u);
+
+        SumiBuffer& sliceBoundariesBuffer = *sliceBoundariesBuffers[frameIdx];
+        sliceBoundariesBuffer.writeToBuffer((void *)sliceBoundaries.data());
+        sliceBoundariesBuffer.flush();
+    }
+
+    void HighQualityShadowMapper::recordPrepareDispatches(VkCommandBuffer commandBuffer, int frameIdx) {
+        // Reset the light mask allocation counter to just past the tile offset table.
+        vkCmdFillBuffer(
+            commandBuffer, lightMaskBuffers[frameIdx]->getBuffer(), 
+            0, sizeof(uint32_t), 
+            structs::lightMask::HEADER_WORDS + lightMask->numTiles()
+        );
+
+        VkMemoryBarrier transferToShader{};
+        transferToShader.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        transferToShader.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        transferToShader.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0x0,
+            1, &transferToShader,
+            0, nullptr,
+            0, nullptr
+        );
+
+        preparePush.lightMaskCapacity = lightMaskBufferCapacities[frameIdx];
+        vkCmdPushConstants(
+            commandBuffer,
+            preparePipelineLayout,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(structs::preparePush),
+            &preparePush
+        );
+
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            preparePipelineLayout,
+            0, 1,
+            &prepareDescriptorSets[frameIdx],
+            0, nullptr
+        );
+
+        // zBin and light mask outputs are independent, so no barrier is needed between them.
+        //  A single work group fills all zBin slices.
+        prepareZbinPipeline->bind(commandBuffer);
+        vkCmdDispatch(commandBuffer, 1, 1, 1);
+
+        // One work group per 2x2 light mask tile group, so each group's blocks are allocated contiguously.
+        prepareLightMaskPipeline->bind(commandBuffer);
+        vkCmdDispatch(commandBuffer, lightMask->numTileGroupsX, lightMask->numTileGroupsY, 1);
+
+        // Copy out the words the light mask needed, read by prepareFrame() once this frame comes around again.
+        VkMemoryBarrier shaderToTransfer{};
+        shaderToTransfer.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        shaderToTransfer.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        shaderToTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0x0,
+            1, &shaderToTransfer,
+            0, nullptr,
+            0, nullptr
+        );
+
+        VkBufferCopy usageCopy{};
+        usageCopy.size = sizeof(uint32_t);
+        vkCmdCopyBuffer(
+            commandBuffer, lightMaskBuffers[frameIdx]->getBuffer(), lightMaskUsageBuffers[frameIdx]->getBuffer(),
+            1, &usageCopy
+        );
+
+        VkMemoryBarrier transferToHost{};
+        transferToHost.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        transferToHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        transferToHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT,
+            0x0,
+            1, &transferToHost,
+            0, nullptr,
+            0, nullptr
+        );
+
+        lightMaskUsagePending[frameIdx] = true;
+    }
+
+    void HighQualityShadowMapper::readLightMaskUsage(int frameIdx) {
+        // Written by the frame's last prepare dispatch, which its fence has seen complete.
+        if (!lightMaskUsagePending[frameIdx]) return;
+        lightMaskUsagePending[frameIdx] = false;
+
+        SumiBuffer& lightMaskUsageBuffer = *lightMaskUsageBuffers[frameIdx];
+        lightMaskUsageBuffer.invalidate();
+        const uint32_t usedWords = *static_cast<const uint32_t*>(lightMaskUsageBuffer.getMappedMemory());
+
+        // The last word of the buffer is kept clear for overflowing tiles (see prepare_light_mask.comp).
+        if (usedWords >= lightMaskBufferCapacities[frameIdx]) {
+            // Overflowing tiles were left empty, so prepare the frame again once its buffers have grown.
+            prepareFrameTracker.invalidate(frameIdx);
+            prepareFrameStats.lightMaskOverflows++;
+        }
+        reserveLightMaskWords(usedWords + 1u);
+    }
+
+    void HighQualityShadowMapper::validateGpuPrepare(int frameIdx) {
+        // Debug only. The frame's own buffers are idle since its fence signalled, and the readback buffers are
+        //  shared between frames but only used within this call, which waits for its own submission.
+        //  The CPU reference was generated by prepare().
+        SumiBuffer& zBinBuffer      = *zBinBuffers[frameIdx];
+        SumiBuffer& lightMaskBuffer = *lightMaskBuffers[frameIdx];
+
+        if (lightMaskReadbackBuffer->getBufferSize() < lightMaskBuffer.getBufferSize()) {
+            lightMaskReadbackBuffer = nullptr;
+            createLightMaskReadbackBuffer();
+        }
+
+        VkCommandBuffer commandBuffer = sumiDevice.beginSingleTimeCommands();
+
+        recordPrepareDispatches(commandBuffer, frameIdx);
+
+        VkMemoryBarrier shaderToTransfer{};
+        shaderToTransfer.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        shaderToTransfer.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        shaderToTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0x0,
+            1, &shaderToTransfer,
+            0, nullptr,
+            0, nullptr
+        );
+
+        VkBufferCopy zBinCopy{};
+        zBinCopy.size = zBinBuffer.getBufferSize();
+        vkCmdCopyBuffer(commandBuffer, zBinBuffer.getBuffer(), zBinReadbackBuffer->getBuffer(), 1, &zBinCopy);
+
+        VkBufferCopy lightMaskCopy{};
+        lightMaskCopy.size = lightMaskBuffer.getBufferSize();
+        vkCmdCopyBuffer(
+            commandBuffer, lightMaskBuffer.getBuffer(), lightMaskReadbackBuffer->getBuffer(), 1, &lightMaskCopy);
+
+        VkMemoryBarrier transferToHost{};
+        transferToHost.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        transferToHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        transferToHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT,
+            0x0,
+            1, &transferToHost,
+            0, nullptr,
+            0, nullptr
+        );
+
+        sumiDevice.endSingleTimeCommands(commandBuffer);
+
+        zBinReadbackBuffer->invalidate();
+        lightMaskReadbackBuffer->invalidate();
+
+        // ---- Diff -------------------------------------------------------------------------------------------------
+        structs::prepareValidationStats& stats = prepareValidationStats;
+        stats.zBinMismatches         = 0u;
+        stats.lightMaskMismatches    = 0u;
+        stats.firstZbinMismatch      = -1;
+        stats.firstLightMaskMismatch = -1;
+
+        const auto* gpuZbin = static_cast<const structs::zBinData*>(zBinReadbackBuffer->getMappedMemory());
+        for (uint32_t i = 0; i < NUM_SLICES; i++) {
+            const structs::zBinData& cpu = zBin.data[i];
+            const structs::zBinData& gpu = gpuZbin[i];
+
+            const bool match = (
+                cpu.minLightIdx       == gpu.minLightIdx       &&
+                cpu.maxLightIdx       == gpu.maxLightIdx       &&
+                cpu.rangedMinLightIdx == gpu.rangedMinLightIdx &&
+                cpu.rangedMaxLightIdx == gpu.rangedMaxLightIdx
+            );
+
+            if (!match) {
+                if (stats.firstZbinMismatch == -1) stats.firstZbinMismatch = static_cast<int>(i);
+                stats.zBinMismatches++;
+            }
+        }
+
+        // GPU blocks are placed in dispatch order, so compare tiles by content rather than word for word.
+        const auto* gpuLightMask = static_cast<const uint32_t*>(lightMaskReadbackBuffer->getMappedMemory());
+        for (uint32_t i = 0; i < lightMask->numTiles(); i++) {
+            const uint32_t gpuOffset = gpuLightMask[structs::lightMask::HEADER_WORDS + i];
+
+            const bool match = gpuOffset < lightMaskBufferCapacities[frameIdx] && structs::lightMask::tilesEqual(
+                lightMask->words.data(), lightMask->tileOffset(i),
+                gpuLightMask, gpuOffset
+            );
+
+            if (!match) {
+                if (stats.firstLightMaskMismatch == -1) stats.firstLightMaskMismatch = static_cast<int>(i);
+                stats.lightMaskMismatches++;
+            }
+        }
+
+        stats.validatedFrames++;
+        if (stats.zBinMismatches > 0u || stats.lightMaskMismatches > 0u || stats.zBinReferenceMismatches > 0u) {
+            stats.failedFrames++;
+        }
     }
 
     // ---- (GPU) Phases 2+ --------------------------------------------------------------------------------------
     void HighQualityShadowMapper::initDescriptorLayouts() {
+        // Prepare, lights approx & lights accurate sets bind the per frame in flight zBin & light mask buffers.
+        constexpr uint32_t nFrames = SumiSwapChain::MAX_FRAMES_IN_FLIGHT;
+
         descriptorPool = SumiDescriptorPool::Builder(sumiDevice)
             .setMaxSets(
-                6 + // Lights Approx
-                6 + // Lights Accurate
-                9   // Deferred Shadows
+                3 * nFrames + // Prepare (GPU)
+                6 * nFrames + // Lights Approx
+                6 * nFrames + // Lights Accurate
+                9             // Deferred Shadows
             )
+            // ---- Prepare (GPU) -----------------------------------------
+            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * nFrames)
             // ---- Lights Approx -----------------------------------------
-            .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 * nFrames)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5 * nFrames)
             // ---- Lights Accurate ---------------------------------------
-            .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 * nFrames)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * nFrames)
             // ---- Deferred Shadows --------------------------------------
             .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2)
             .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 7)
             // ------------------------------------------------------------
             .build();
 
+        prepareDescriptorLayout = SumiDescriptorSetLayout::Builder(sumiDevice)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT) // PreparedLightsBuffer
+            .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT) // zBin
+            .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT) // LightMaskBuffer
+            .addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT) // SliceBoundaries
+            .build();
+
         // TODO: Consider splitting these descriptor sets into multiple sets so that 
-        //       shared buffers do not have to be re-bound (e.g. tileGroupLightMaskBuffer).
+        //       shared buffers do not have to be re-bound (e.g. tileShadowSlotIDsBuffer).
         lightsApproxDescriptorLayout = SumiDescriptorSetLayout::Builder(sumiDevice)
             .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT) // HZB
             .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT) // TileGroupLightMaskBuffer
@@ -584,24 +1044,12 @@ namespace sumire {
     // ---- Phase 2: Find Lights Approx --------------------------------------------------------------------------
     void HighQualityShadowMapper::initLightsApproxPhase(SumiHZB* hzb) {
         createAttachmentSampler();
-        createTileGroupLightMaskBuffer();
         createTileShadowSlotIDsBuffer();
         createSlotCountersBuffer();
-        initLightsApproxDescriptorSet(hzb);
+        initLightsApproxDescriptorSets(hzb);
         initLightsApproxPipeline();
     }
 
-    void HighQualityShadowMapper::createTileGroupLightMaskBuffer() {
-        // 1 Light mask entry per 8x8 shadow tile group
-        tileGroupLightMaskBuffer = std::make_unique<SumiBuffer>(
-            sumiDevice,
-            numTileGroups * sizeof(structs::lightMaskTile),
-            1,
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-        );
-    }
-
     void HighQualityShadowMapper::createTileShadowSlotIDsBuffer() {
         // 1 ID per shadow tile
         tileShadowSlotIDsBuffer = std::make_unique<SumiBuffer>(
@@ -624,70 +1072,80 @@ namespace sumire {
         );
     }
 
-    void HighQualityShadowMapper::initLightsApproxDescriptorSet(SumiHZB* hzb) {
-        assert(zBinBuffer != nullptr 
-            && "Cannot instantiate descriptor set with null zbin buffer");
-        assert(lightMaskBuffer != nullptr 
-            && "Cannot instantiate descriptor set with null light mask buffer");
-        assert(tileGroupLightMaskBuffer != nullptr 
-            && "Cannot instantiate descriptor set with null tile group light mask buffer");
+    void HighQualityShadowMapper::initLightsApproxDescriptorSets(SumiHZB* hzb) {
+        lightsApproxDescriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+
         assert(tileShadowSlotIDsBuffer != nullptr
             && "Cannot instantiate descriptor set with null tile shadow slot ids buffer");
         assert(slotCountersBuffer != nullptr
             && "Cannot instantiate descriptor set with null slot counters buffer");
 
-        VkDescriptorBufferInfo zbinInfo               = zBinBuffer->descriptorInfo();
-        VkDescriptorBufferInfo lightMaskInfo          = lightMaskBuffer->descriptorInfo();
-        VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffer->descriptorInfo();
-        VkDescriptorBufferInfo tileShadowSlotIDsInfo  = tileShadowSlotIDsBuffer->descriptorInfo();
-        VkDescriptorBufferInfo slotCountersInfo       = slotCountersBuffer->descriptorInfo();
+        VkDescriptorBufferInfo tileShadowSlotIDsInfo = tileShadowSlotIDsBuffer->descriptorInfo();
+        VkDescriptorBufferInfo slotCountersInfo      = slotCountersBuffer->descriptorInfo();
 
         VkDescriptorImageInfo hzbInfo{};
         hzbInfo.sampler     = attachmentSampler;
         hzbInfo.imageView   = hzb->getBaseImageView();
         hzbInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        SumiDescriptorWriter(*lightsApproxDescriptorLayout, *descriptorPool)
-            .writeImage(0, &hzbInfo)
-            .writeBuffer(1, &tileGroupLightMaskInfo)
-            .writeBuffer(2, &tileShadowSlotIDsInfo)
-            .writeBuffer(3, &slotCountersInfo)
-            .writeBuffer(4, &zbinInfo)
-            .writeBuffer(5, &lightMaskInfo)
-            .build(lightsApproxDescriptorSet);
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            assert(zBinBuffers[i] != nullptr 
+                && "Cannot instantiate descriptor set with null zbin buffer");
+            assert(lightMaskBuffers[i] != nullptr 
+                && "Cannot instantiate descriptor set with null light mask buffer");
+            assert(tileGroupLightMaskBuffers[i] != nullptr
+                && "Cannot instantiate descriptor set with null tile group light mask buffer");
+
+            VkDescriptorBufferInfo zbinInfo               = zBinBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo lightMaskInfo          = lightMaskBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffers[i]->descriptorInfo();
+
+            SumiDescriptorWriter(*lightsApproxDescriptorLayout, *descriptorPool)
+                .writeImage(0, &hzbInfo)
+                .writeBuffer(1, &tileGroupLightMaskInfo)
+                .writeBuffer(2, &tileShadowSlotIDsInfo)
+                .writeBuffer(3, &slotCountersInfo)
+                .writeBuffer(4, &zbinInfo)
+                .writeBuffer(5, &lightMaskInfo)
+                .build(lightsApproxDescriptorSets[i]);
+        }
     }
 
-    void HighQualityShadowMapper::updateLightsApproxDescriptorSet(SumiHZB* hzb) {
-        assert(zBinBuffer != nullptr
-            && "Cannot update descriptor set with null zbin buffer");
-        assert(lightMaskBuffer != nullptr 
-            && "Cannot update descriptor set with null light mask buffer");
-        assert(tileGroupLightMaskBuffer != nullptr
-            && "Cannot update descriptor set with null tile group light mask buffer");
+    void HighQualityShadowMapper::updateLightsApproxDescriptorSets(SumiHZB* hzb) {
         assert(tileShadowSlotIDsBuffer != nullptr
             && "Cannot update descriptor set with null tile shadow slot ids buffer");
         assert(slotCountersBuffer != nullptr
             && "Cannot update descriptor set with null slot counters buffer");
 
-        VkDescriptorBufferInfo zbinInfo               = zBinBuffer->descriptorInfo();
-        VkDescriptorBufferInfo lightMaskInfo          = lightMaskBuffer->descriptorInfo();
-        VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffer->descriptorInfo();
-        VkDescriptorBufferInfo tileShadowSlotIDsInfo  = tileShadowSlotIDsBuffer->descriptorInfo();
-        VkDescriptorBufferInfo slotCountersInfo       = slotCountersBuffer->descriptorInfo();
+        VkDescriptorBufferInfo tileShadowSlotIDsInfo = tileShadowSlotIDsBuffer->descriptorInfo();
+        VkDescriptorBufferInfo slotCountersInfo      = slotCountersBuffer->descriptorInfo();
 
         VkDescriptorImageInfo hzbInfo{};
         hzbInfo.sampler = attachmentSampler;
         hzbInfo.imageView = hzb->getBaseImageView();
         hzbInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        SumiDescriptorWriter(*lightsApproxDescriptorLayout, *descriptorPool)
-            .writeImage(0, &hzbInfo)
-            .writeBuffer(1, &tileGroupLightMaskInfo)
-            .writeBuffer(2, &tileShadowSlotIDsInfo)
-            .writeBuffer(3, &slotCountersInfo)
-            .writeBuffer(4, &zbinInfo)
-            .writeBuffer(5, &lightMaskInfo)
-            .overwrite(lightsApproxDescriptorSet);
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            assert(zBinBuffers[i] != nullptr
+                && "Cannot update descriptor set with null zbin buffer");
+            assert(lightMaskBuffers[i] != nullptr 
+                && "Cannot update descriptor set with null light mask buffer");
+            assert(tileGroupLightMaskBuffers[i] != nullptr
+                && "Cannot update descriptor set with null tile group light mask buffer");
+
+            VkDescriptorBufferInfo zbinInfo               = zBinBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo lightMaskInfo          = lightMaskBuffers[i]->descriptorInfo();
+            VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffers[i]->descriptorInfo();
+
+            SumiDescriptorWriter(*lightsApproxDescriptorLayout, *descriptorPool)
+                .writeImage(0, &hzbInfo)
+                .writeBuffer(1, &tileGroupLightMaskInfo)
+                .writeBuffer(2, &tileShadowSlotIDsInfo)
+                .writeBuffer(3, &slotCountersInfo)
+                .writeBuffer(4, &zbinInfo)
+                .writeBuffer(5, &lightMaskInfo)
+                .overwrite(lightsApproxDescriptorSets[i]);
+        }
     }
 
     void HighQualityShadowMapper::initLightsApproxPipeline() {
@@ -735,7 +1193,7 @@ namespace sumire {
     ) {
         createTileLightListEarlyBuffer();
         createTileLightCountEarlyBuffer();
-        initLightsAccurateDescriptorSet(zbuffer, gWorldPos);
+        initLightsAccurateDescriptorSets(zbuffer, gWorldPos);
         initLightsAccuratePipeline();
     }
 
@@ -762,10 +1220,12 @@ namespace sumire {
         );
     }
 
-    void HighQualityShadowMapper::initLightsAccurateDescriptorSet(
+    void HighQualityShadowMapper::initLightsAccurateDescriptorSets(
         SumiAttachment* zbuffer,
         SumiAttachment* gWorldPos
     ) {
+        lightsAccurateDescriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+
         assert(zbuffer != nullptr
             && "Cannot instantiate descriptor set with null zbuffer");
         assert(gWorldPos != nullptr
@@ -785,22 +1245,28 @@ namespace sumire {
         gWorldPosInfo.imageView   = gWorldPos->getImageView();
         gWorldPosInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffer->descriptorInfo();
-        VkDescriptorBufferInfo tileShadowSlotIDsInfo  = tileShadowSlotIDsBuffer->descriptorInfo();
-        VkDescriptorBufferInfo lightListEarlyInfo     = tileLightListEarlyBuffer->descriptorInfo();
-        VkDescriptorBufferInfo lightCountEarlyInfo    = tileLightCountEarlyBuffer->descriptorInfo();
+        VkDescriptorBufferInfo tileShadowSlotIDsInfo = tileShadowSlotIDsBuffer->descriptorInfo();
+        VkDescriptorBufferInfo lightListEarlyInfo    = tileLightListEarlyBuffer->descriptorInfo();
+        VkDescriptorBufferInfo lightCountEarlyInfo   = tileLightCountEarlyBuffer->descriptorInfo();
+
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            assert(tileGroupLightMaskBuffers[i] != nullptr
+                && "Cannot instantiate descriptor set with null tile group light mask buffer");
 
-        SumiDescriptorWriter(*lightsAccurateDescriptorLayout, *descriptorPool)
-            .writeImage(0, &zbufferInfo)
-            .writeImage(1, &gWorldPosInfo)
-            .writeBuffer(2, &tileGroupLightMaskInfo)
-            .writeBuffer(3, &tileShadowSlotIDsInfo)
-            .writeBuffer(4, &lightListEarlyInfo)
-            .writeBuffer(5, &lightCountEarlyInfo)
-            .build(lightsAccurateDescriptorSet);
+            VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffers[i]->descriptorInfo();
+
+            SumiDescriptorWriter(*lightsAccurateDescriptorLayout, *descriptorPool)
+                .writeImage(0, &zbufferInfo)
+                .writeImage(1, &gWorldPosInfo)
+                .writeBuffer(2, &tileGroupLightMaskInfo)
+                .writeBuffer(3, &tileShadowSlotIDsInfo)
+                .writeBuffer(4, &lightListEarlyInfo)
+                .writeBuffer(5, &lightCountEarlyInfo)
+                .build(lightsAccurateDescriptorSets[i]);
+        }
     }
 
-    void HighQualityShadowMapper::updateLightsAccurateDescriptorSet(
+    void HighQualityShadowMapper::updateLightsAccurateDescriptorSets(
         SumiAttachment* zbuffer, 
         SumiAttachment* gWorldPos
     ) {
@@ -823,19 +1289,25 @@ namespace sumire {
         gWorldPosInfo.imageView   = gWorldPos->getImageView();
         gWorldPosInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffer->descriptorInfo();
-        VkDescriptorBufferInfo tileShadowSlotIDsInfo  = tileShadowSlotIDsBuffer->descriptorInfo();
-        VkDescriptorBufferInfo lightListEarlyInfo     = tileLightListEarlyBuffer->descriptorInfo();
-        VkDescriptorBufferInfo lightCountEarlyInfo    = tileLightCountEarlyBuffer->descriptorInfo();
+        VkDescriptorBufferInfo tileShadowSlotIDsInfo = tileShadowSlotIDsBuffer->descriptorInfo();
+        VkDescriptorBufferInfo lightListEarlyInfo    = tileLightListEarlyBuffer->descriptorInfo();
+        VkDescriptorBufferInfo lightCountEarlyInfo   = tileLightCountEarlyBuffer->descriptorInfo();
 
-        SumiDescriptorWriter(*lightsAccurateDescriptorLayout, *descriptorPool)
-            .writeImage(0, &zbufferInfo)
-            .writeImage(1, &gWorldPosInfo)
-            .writeBuffer(2, &tileGroupLightMaskInfo)
-            .writeBuffer(3, &tileShadowSlotIDsInfo)
-            .writeBuffer(4, &lightListEarlyInfo)
-            .writeBuffer(5, &lightCountEarlyInfo)
-            .overwrite(lightsAccurateDescriptorSet);
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            assert(tileGroupLightMaskBuffers[i] != nullptr
+                && "Cannot update descriptor set with null tile group light mask buffer");
+
+            VkDescriptorBufferInfo tileGroupLightMaskInfo = tileGroupLightMaskBuffers[i]->descriptorInfo();
+
+            SumiDescriptorWriter(*lightsAccurateDescriptorLayout, *descriptorPool)
+                .writeImage(0, &zbufferInfo)
+                .writeImage(1, &gWorldPosInfo)
+                .writeBuffer(2, &tileGroupLightMaskInfo)
+                .writeBuffer(3, &tileShadowSlotIDsInfo)
+                .writeBuffer(4, &lightListEarlyInfo)
+                .writeBuffer(5, &lightCountEarlyInfo)
+                .overwrite(lightsAccurateDescriptorSets[i]);
+        }
     }
 
     void HighQualityShadowMapper::initLightsAccuratePipeline() {
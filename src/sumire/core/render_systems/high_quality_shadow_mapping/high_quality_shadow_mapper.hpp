@@ -19,19 +19,36 @@
 #include <sumire/core/render_systems/high_quality_shadow_mapping/zbin.hpp>
 #include <sumire/core/render_systems/high_quality_shadow_mapping/light_mask.hpp>
 #include <sumire/core/render_systems/high_quality_shadow_mapping/view_space_light.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_mask_builder.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/zbin_builder.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_sorter.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/prepare_validation.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/prepare_frame_stats.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/prepare_frame_tracker.hpp>
 
 #include <sumire/core/graphics_pipeline/sumi_buffer.hpp>
 #include <sumire/core/graphics_pipeline/sumi_compute_pipeline.hpp>
-#include <sumire/core/rendering/lighting/sumi_light.hpp>
+#include <sumire/core/graphics_pipeline/sumi_swap_chain.hpp>
+#include <sumire/core/rendering/lighting/sumi_light_store.hpp>
 #include <sumire/core/rendering/general/sumi_frame_info.hpp>
 #include <sumire/core/rendering/general/sumi_camera.hpp>
 #include <sumire/core/rendering/geometry/sumi_hzb.hpp>
 #include <sumire/core/rendering/geometry/sumi_gbuffer.hpp>
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+#include <sumire/core/profiling/cpu_profiler.hpp>
 
 #include <memory>
+#include <span>
+#include <vector>
 
 namespace sumire {
 
+    enum HQSMprepareMode {
+        HQSM_PREPARE_CPU,
+        HQSM_PREPARE_GPU,
+        HQSM_PREPARE_GPU_VALIDATED // GPU, diffed against the CPU reference after every prepare
+    };
+
     class HighQualityShadowMapper {
     public:
         HighQualityShadowMapper(
@@ -41,16 +58,24 @@ namespace sumire {
             SumiHZB* hzb,
             SumiAttachment* zbuffer,
             SumiAttachment* gWorldPos,
-            VkDescriptorSetLayout globalDescriptorSetLayout
+            VkDescriptorSetLayout globalDescriptorSetLayout,
+            uint32_t maxLights,
+            SumiThreadPool* threadPool = nullptr,
+            HQSMprepareMode prepareMode = HQSM_PREPARE_CPU
         );
         ~HighQualityShadowMapper();
 
         static constexpr uint32_t NUM_SLICES = 1024u;
-
-        static std::vector<structs::viewSpaceLight> sortLightsByViewSpaceDepth(
-            SumiLight::Map& lights,
-            glm::mat4 view,
-            float near
+        // Initial light mask buffer size. Buffers grow with the number of lights per tile.
+        static constexpr uint32_t INITIAL_LIGHT_MASK_WORDS_PER_TILE = 8u;
+        // Grown light mask buffers leave 1/LIGHT_MASK_HEADROOM_DIVISOR of the words in use spare.
+        static constexpr uint32_t LIGHT_MASK_HEADROOM_DIVISOR = 4u;
+
+        // Sorts lights by min view space depth (see LightSorter). The result is only valid until
+        //  the next call.
+        std::span<const structs::viewSpaceLight> sortLightsByViewSpaceDepth(
+            const SumiLightStore& lights,
+            const glm::mat4& view
         );
 
         void updateScreenBounds(
@@ -65,23 +90,40 @@ namespace sumire {
         glm::uvec2 getShadowTileResolution() const { return glm::uvec2{ numShadowTilesX, numShadowTilesY }; }
         glm::uvec2 getTileGroupResolution() const { return glm::uvec2{ numTileGroupsX, numTileGroupsY }; }
         glm::uvec2 getLightMaskResolution() const { return glm::uvec2{ lightMask->numTilesX, lightMask->numTilesY }; }
+        uint32_t getMaxLights() const { return maxLights; }
 
         // ---- Phase 1: Prepare ---------------------------------------------------------------------------------
+        // Builds the zBin & light mask (CPU prepare), or packs the lights for the GPU prepare pass. Only needs
+        //  calling when the lights or camera change; the frame in flight is brought up to date by prepareFrame().
         void prepare(
-            const std::vector<structs::viewSpaceLight>& lights,
-            const SumiCamera& camera
+            std::span<const structs::viewSpaceLight> lights,
+            const SumiCamera& camera,
+            CpuProfiler* cpuProfiler = nullptr
         );
-        SumiBuffer* getLightMaskBuffer() const { return lightMaskBuffer.get(); }
+        // Brings the frame in flight's zBin & light mask buffers up to date with the last prepare(), by
+        //  uploading them (CPU prepare) or recording the prepare dispatches (GPU prepare). No-op if the
+        //  frame's buffers are already current.
+        void prepareFrame(int frameIdx, VkCommandBuffer commandBuffer, CpuProfiler* cpuProfiler = nullptr);
+        HQSMprepareMode getPrepareMode() const { return prepareMode; }
+        const structs::prepareValidationStats* getPrepareValidationStats() const {
+            return prepareMode == HQSM_PREPARE_GPU_VALIDATED ? &prepareValidationStats : nullptr;
+        }
+        const structs::prepareFrameStats& getPrepareFrameStats() const { return prepareFrameStats; }
+        SumiBuffer* getLightMaskBuffer(int frameIdx) const { return lightMaskBuffers[frameIdx].get(); }
+        // Advanced whenever the frame's light mask & tile group light mask buffers are reallocated, so
+        //  external descriptor sets binding them know to rewrite them.
+        uint64_t getLightMaskBufferGeneration(int frameIdx) const { return lightMaskBufferGenerations[frameIdx]; }
 
         // ---- Phase 2: Find Lights Approx ----------------------------------------------------------------------
         void findLightsApproximate(
             VkCommandBuffer commandBuffer,
+            int frameIdx,
             float near, float far
         );
-        SumiBuffer* getTileGroupLightMaskBuffer() const { return tileGroupLightMaskBuffer.get(); }
+        SumiBuffer* getTileGroupLightMaskBuffer(int frameIdx) const { return tileGroupLightMaskBuffers[frameIdx].get(); }
 
         // ---- Phase 3: Find Lights Accurate --------------------------------------------------------------------
-        void findLightsAccurate(VkCommandBuffer commandBuffer);
+        void findLightsAccurate(VkCommandBuffer commandBuffer, int frameIdx);
         SumiBuffer* getLightCountEarlyBuffer() const { return tileLightCountEarlyBuffer.get(); }
 
         // ---- Phase 4: Generate Deferred Shadows ---------------------------------------------------------------
@@ -100,24 +142,93 @@ namespace sumire {
         // ---- (CPU) Phase 1: Prepare ---------------------------------------------------------------------------
         void initPreparePhase();
 
-        void createZbinBuffer();
+        void createZbinBuffers();
         void generateZbin(
-            const std::vector<structs::viewSpaceLight>& lights,
+            std::span<const structs::viewSpaceLight> lights,
             const SumiCamera& camera
         );
-        void writeZbinBuffer();
-
-        void createLightMaskBuffer();
+        void writeZbinBuffer(int frameIdx);
+
+        void createLightMaskBuffers();
+        void createFrameLightMaskBuffers(int frameIdx);
+        uint32_t initialLightMaskCapacity() const;
+        void reserveLightMaskWords(uint32_t numWords);
+        void growFrameLightMaskBuffers(int frameIdx);
+        void updateFrameLightMaskDescriptors(int frameIdx);
         void generateLightMask(
-            const std::vector<structs::viewSpaceLight>& lights,
+            std::span<const structs::viewSpaceLight> lights,
             const SumiCamera& camera
         );
-        void writeLightMaskBuffer();
+        void writeLightMaskBuffer(int frameIdx);
 
         structs::zBin zBin;
-        std::unique_ptr<SumiBuffer> zBinBuffer;
         std::unique_ptr<structs::lightMask> lightMask;
-        std::unique_ptr<SumiBuffer> lightMaskBuffer;
+        // The zBin & light mask buffers (and the descriptor sets binding them) are duplicated per frame in
+        //  flight, so preparing frame N+1 never overwrites buffers frame N may still be reading.
+        std::vector<std::unique_ptr<SumiBuffer>> zBinBuffers;
+        std::vector<std::unique_ptr<SumiBuffer>> lightMaskBuffers;
+        // Size in words the light mask & tile group light mask buffers grow to. Each frame in flight
+        //  reallocates its own buffers the next time it is prepared, once its fence has signalled and
+        //  nothing can still be reading them, so growth never waits on the device.
+        uint32_t lightMaskCapacity = 0u;
+        std::vector<uint32_t> lightMaskBufferCapacities;
+        std::vector<uint64_t> lightMaskBufferGenerations;
+        uint32_t maxLights;
+
+        PrepareFrameTracker prepareFrameTracker;
+        structs::prepareFrameStats prepareFrameStats{};
+
+        LightSorter lightSorter;
+        ZbinBuilder zBinBuilder;
+        LightMaskBuilder lightMaskBuilder;
+        SumiThreadPool* threadPool = nullptr;
+
+        // ---- (GPU) Phase 1: Prepare ---------------------------------------------------------------------------
+        void initGpuPreparePhase();
+        void createPreparedLightsBuffers();
+        void createZbinReadbackBuffer();
+        void createLightMaskReadbackBuffer();
+        void createLightMaskUsageBuffers();
+        void createSliceBoundariesBuffers();
+        void initPrepareDescriptorSets();
+        void updatePrepareDescriptorSets();
+        void initPreparePipelines();
+        void cleanupGpuPreparePhase();
+
+        void packPreparedLights(
+            std::span<const structs::viewSpaceLight> lights,
+            const SumiCamera& camera
+        );
+        void writePreparedLightsBuffer(int frameIdx);
+        void writeSliceBoundariesBuffer(int frameIdx);
+        void recordPrepareDispatches(VkCommandBuffer commandBuffer, int frameIdx);
+        void readLightMaskUsage(int frameIdx);
+        void validateGpuPrepare(int frameIdx);
+
+        HQSMprepareMode prepareMode;
+        // Set by prepare() in GPU_VALIDATED mode, the next prepareFrame() diffs against the CPU reference.
+        bool gpuValidationPending = false;
+        structs::preparePush preparePush{};
+        std::vector<structs::preparedLight> preparedLights;
+
+        std::vector<std::unique_ptr<SumiBuffer>> preparedLightsBuffers;
+        std::unique_ptr<SumiBuffer> zBinReadbackBuffer;
+        std::unique_ptr<SumiBuffer> lightMaskReadbackBuffer;
+        // The light mask allocation counter of each frame's last dispatch, read back once the frame's fence
+        //  has signalled to grow the light mask to the words the GPU actually needed.
+        std::vector<std::unique_ptr<SumiBuffer>> lightMaskUsageBuffers;
+        std::vector<bool> lightMaskUsagePending;
+        // The CPU zBin builder's slice boundary table, so both paths bin lights into identical slices.
+        std::vector<std::unique_ptr<SumiBuffer>> sliceBoundariesBuffers;
+        std::vector<uint64_t> sliceBoundariesGenerations;
+        structs::prepareValidationStats prepareValidationStats{};
+
+        std::unique_ptr<SumiDescriptorSetLayout> prepareDescriptorLayout;
+        std::vector<VkDescriptorSet> prepareDescriptorSets;
+
+        VkPipelineLayout preparePipelineLayout = VK_NULL_HANDLE;
+        std::unique_ptr<SumiComputePipeline> prepareZbinPipeline;
+        std::unique_ptr<SumiComputePipeline> prepareLightMaskPipeline;
 
         // ---- (GPU) Phases 2+ ----------------------------------------------------------------------------------
         void initDescriptorLayouts();
@@ -127,20 +238,20 @@ namespace sumire {
 
         // ---- Phase 2: Find Lights Approx ----------------------------------------------------------------------
         void initLightsApproxPhase(SumiHZB* hzb);
-        void createTileGroupLightMaskBuffer();
         void createTileShadowSlotIDsBuffer();
         void createSlotCountersBuffer();
-        void initLightsApproxDescriptorSet(SumiHZB* hzb);
-        void updateLightsApproxDescriptorSet(SumiHZB* hzb);
+        void initLightsApproxDescriptorSets(SumiHZB* hzb);
+        void updateLightsApproxDescriptorSets(SumiHZB* hzb);
         void initLightsApproxPipeline();
         void cleanupLightsApproxPhase();
 
-        std::unique_ptr<SumiBuffer> tileGroupLightMaskBuffer;
+        // Per frame in flight, sized and reallocated alongside the frame's light mask buffer.
+        std::vector<std::unique_ptr<SumiBuffer>> tileGroupLightMaskBuffers;
         std::unique_ptr<SumiBuffer> tileShadowSlotIDsBuffer;
         std::unique_ptr<SumiBuffer> slotCountersBuffer;
 
         std::unique_ptr<SumiDescriptorSetLayout> lightsApproxDescriptorLayout;
-        VkDescriptorSet lightsApproxDescriptorSet = VK_NULL_HANDLE;
+        std::vector<VkDescriptorSet> lightsApproxDescriptorSets;
 
         VkPipelineLayout findLightsApproxPipelineLayout = VK_NULL_HANDLE;
         std::unique_ptr<SumiComputePipeline> findLightsApproxPipeline;
@@ -149,8 +260,8 @@ namespace sumire {
         void initLightsAccuratePhase(SumiAttachment* zbuffer, SumiAttachment* gWorldPos);
         void createTileLightListEarlyBuffer();
         void createTileLightCountEarlyBuffer();
-        void initLightsAccurateDescriptorSet(SumiAttachment* zbuffer, SumiAttachment* gWorldPos);
-        void updateLightsAccurateDescriptorSet(SumiAttachment* zbuffer, SumiAttachment* gWorldPos);
+        void initLightsAccurateDescriptorSets(SumiAttachment* zbuffer, SumiAttachment* gWorldPos);
+        void updateLightsAccurateDescriptorSets(SumiAttachment* zbuffer, SumiAttachment* gWorldPos);
         void initLightsAccuratePipeline();
         void cleanupLightsAccuratePhase();
 
@@ -158,7 +269,8 @@ namespace sumire {
         std::unique_ptr<SumiBuffer> tileLightCountEarlyBuffer;
 
         std::unique_ptr<SumiDescriptorSetLayout> lightsAccurateDescriptorLayout;
-        VkDescriptorSet lightsAccurateDescriptorSet = VK_NULL_HANDLE;
+        // Per frame in flight, as each binds the frame's tile group light mask.
+        std::vector<VkDescriptorSet> lightsAccurateDescriptorSets;
 
         VkPipelineLayout findLightsAccuratePipelineLayout = VK_NULL_HANDLE;
         std::unique_ptr<SumiComputePipeline> findLightsAccuratePipeline;
@@ -23,13 +23,13 @@ namespace sumire {
         vkDestroyPipelineLayout(sumiDevice.device(), lightCountDebugPipelineLayout, nullptr);
     }
 
-    void HQSMdebugger::renderDebugView(VkCommandBuffer commandBuffer, HQSMdebuggerView debuggerView) {
+    void HQSMdebugger::renderDebugView(VkCommandBuffer commandBuffer, int frameIdx, HQSMdebuggerView debuggerView) {
         switch (debuggerView) {
         case HQSM_DEBUG_HZB:
             renderHzbDebugInfo(commandBuffer);
             break;
         case HQSMdebuggerView::HQSM_DEBUG_LIGHT_COUNT:
-            renderLightCountDebugInfo(commandBuffer);
+            renderLightCountDebugInfo(commandBuffer, frameIdx);
             break;
         case HQSMdebuggerView::HQSM_DEBUG_LIGHT_CULLING:
             break;
@@ -72,7 +72,11 @@ namespace sumire {
         vkCmdDraw(commandBuffer, 3, 1, 0, 0);
     }
 
-    void HQSMdebugger::renderLightCountDebugInfo(VkCommandBuffer commandBuffer) {
+    void HQSMdebugger::renderLightCountDebugInfo(VkCommandBuffer commandBuffer, int frameIdx) {
+        if (lightMaskBufferGenerations[frameIdx] != shadowMapper->getLightMaskBufferGeneration(frameIdx)) {
+            updateLightCountDebugDescriptorSet(frameIdx);
+        }
+
         lightCountDebugPipeline->bind(commandBuffer);
 
         structs::LightCountDebugPush push{};
@@ -92,7 +96,7 @@ namespace sumire {
         );
 
         std::array<VkDescriptorSet, 1> lightCountDebugDescriptors{
-            lightCountDebugDescriptorSet
+            lightCountDebugDescriptorSets[frameIdx]
         };
 
         vkCmdBindDescriptorSets(
@@ -112,15 +116,18 @@ namespace sumire {
     }
 
     void HQSMdebugger::initDescriptorLayouts() {
+        // Light count view sets bind the per frame in flight light mask buffers.
+        constexpr uint32_t nFrames = SumiSwapChain::MAX_FRAMES_IN_FLIGHT;
+
         descriptorPool = SumiDescriptorPool::Builder(sumiDevice)
             .setMaxSets(
-                1 + // HZB View
-                4   // Light Count View
+                1 +          // HZB View
+                4 * nFrames  // Light Count View
             )
             // ---- HZB View ----------------------------------------------
             .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1)
             // ---- Light Count View --------------------------------------
-            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * nFrames)
             // ------------------------------------------------------------
             .build();
 
@@ -138,12 +145,14 @@ namespace sumire {
 
     void HQSMdebugger::initDescriptors(SumiHZB* hzb) {
         initHzbDebugDescriptorSet(hzb);
-        initLightCountDebugDescriptorSet();
+        initLightCountDebugDescriptorSets();
     }
 
     void HQSMdebugger::updateDescriptors(SumiHZB* hzb) {
         updateHzbDebugDescriptorSet(hzb);
-        updateLightCountDebugDescriptorSet();
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            updateLightCountDebugDescriptorSet(i);
+        }
     }
 
     void HQSMdebugger::createPipelineLayouts() {
@@ -228,23 +237,33 @@ namespace sumire {
     }
 
     // ---- Light Count View -------------------------------------------------------------------------------------
-    void HQSMdebugger::initLightCountDebugDescriptorSet() {
-        VkDescriptorBufferInfo lightMaskBufferInfo = shadowMapper->getLightMaskBuffer()->descriptorInfo();
-        VkDescriptorBufferInfo tileGroupLightMaskBufferInfo = shadowMapper->getTileGroupLightMaskBuffer()->descriptorInfo();
+    void HQSMdebugger::initLightCountDebugDescriptorSets() {
+        lightCountDebugDescriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+        lightMaskBufferGenerations = std::vector<uint64_t>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, 0u);
+
         VkDescriptorBufferInfo earlyLightCountBufferInfo = shadowMapper->getLightCountEarlyBuffer()->descriptorInfo();
         VkDescriptorBufferInfo finalLightCountBufferInfo = shadowMapper->getLightCountFinalBuffer()->descriptorInfo();
 
-        SumiDescriptorWriter(*lightCountDebugDescriptorSetLayout, *descriptorPool)
-            .writeBuffer(0, &lightMaskBufferInfo)
-            .writeBuffer(1, &tileGroupLightMaskBufferInfo)
-            .writeBuffer(2, &earlyLightCountBufferInfo)
-            .writeBuffer(3, &finalLightCountBufferInfo)
-            .build(lightCountDebugDescriptorSet);
+        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            lightMaskBufferGenerations[i] = shadowMapper->getLightMaskBufferGeneration(i);
+
+            VkDescriptorBufferInfo lightMaskBufferInfo = shadowMapper->getLightMaskBuffer(i)->descriptorInfo();
+            VkDescriptorBufferInfo tileGroupLightMaskBufferInfo = shadowMapper->getTileGroupLightMaskBuffer(i)->descriptorInfo();
+
+            SumiDescriptorWriter(*lightCountDebugDescriptorSetLayout, *descriptorPool)
+                .writeBuffer(0, &lightMaskBufferInfo)
+                .writeBuffer(1, &tileGroupLightMaskBufferInfo)
+                .writeBuffer(2, &earlyLightCountBufferInfo)
+                .writeBuffer(3, &finalLightCountBufferInfo)
+                .build(lightCountDebugDescriptorSets[i]);
+        }
     }
 
-    void HQSMdebugger::updateLightCountDebugDescriptorSet() {
-        VkDescriptorBufferInfo lightMaskBufferInfo = shadowMapper->getLightMaskBuffer()->descriptorInfo();
-        VkDescriptorBufferInfo tileGroupLightMaskBufferInfo = shadowMapper->getTileGroupLightMaskBuffer()->descriptorInfo();
+    void HQSMdebugger::updateLightCountDebugDescriptorSet(int frameIdx) {
+        lightMaskBufferGenerations[frameIdx] = shadowMapper->getLightMaskBufferGeneration(frameIdx);
+
+        VkDescriptorBufferInfo lightMaskBufferInfo = shadowMapper->getLightMaskBuffer(frameIdx)->descriptorInfo();
+        VkDescriptorBufferInfo tileGroupLightMaskBufferInfo = shadowMapper->getTileGroupLightMaskBuffer(frameIdx)->descriptorInfo();
         VkDescriptorBufferInfo earlyLightCountBufferInfo = shadowMapper->getLightCountEarlyBuffer()->descriptorInfo();
         VkDescriptorBufferInfo finalLightCountBufferInfo = shadowMapper->getLightCountFinalBuffer()->descriptorInfo();
 
@@ -253,7 +272,7 @@ namespace sumire {
             .writeBuffer(1, &tileGroupLightMaskBufferInfo)
             .writeBuffer(2, &earlyLightCountBufferInfo)
             .writeBuffer(3, &finalLightCountBufferInfo)
-            .overwrite(lightCountDebugDescriptorSet);
+            .overwrite(lightCountDebugDescriptorSets[frameIdx]);
     }
 
     void HQSMdebugger::createLightCountDebugPipelineLayout() {
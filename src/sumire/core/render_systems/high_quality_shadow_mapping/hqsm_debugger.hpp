@@ -15,9 +15,9 @@ namespace sumire {
         );
         ~HQSMdebugger();
 
-        void renderDebugView(VkCommandBuffer commandBuffer, HQSMdebuggerView debuggerView);
+        void renderDebugView(VkCommandBuffer commandBuffer, int frameIdx, HQSMdebuggerView debuggerView);
         void renderHzbDebugInfo(VkCommandBuffer commandBuffer);
-        void renderLightCountDebugInfo(VkCommandBuffer commandBuffer);
+        void renderLightCountDebugInfo(VkCommandBuffer commandBuffer, int frameIdx);
         void updateScreenBounds(SumiHZB* hzb);
 
         // ---- View Configs
@@ -49,8 +49,8 @@ namespace sumire {
         VkDescriptorSet hzbDebugDescriptorSet = VK_NULL_HANDLE;
 
         // ---- Light Count View
-        void initLightCountDebugDescriptorSet();
-        void updateLightCountDebugDescriptorSet();
+        void initLightCountDebugDescriptorSets();
+        void updateLightCountDebugDescriptorSet(int frameIdx);
         void createLightCountDebugPipelineLayout();
         void createLightCountDebugPipeline(VkRenderPass renderPass);
 
@@ -58,7 +58,11 @@ namespace sumire {
         VkPipelineLayout lightCountDebugPipelineLayout = VK_NULL_HANDLE;
 
         std::unique_ptr<SumiDescriptorSetLayout> lightCountDebugDescriptorSetLayout;
-        VkDescriptorSet lightCountDebugDescriptorSet = VK_NULL_HANDLE;
+        // One set per frame in flight, binding that frame's light mask buffers. Light mask buffers are
+        //  reallocated as they grow (see getLightMaskBufferGeneration()), so each set is rewritten
+        //  when its frame next renders.
+        std::vector<uint64_t> lightMaskBufferGenerations;
+        std::vector<VkDescriptorSet> lightCountDebugDescriptorSets;
 
     };
 
@@ -1,72 +1,114 @@
 #pragma once
 
-#include <sumire/util/bit_field_operators.hpp>
-
+/*
+* Sparse hierarchical light mask. Mirrored by inc_light_mask.glsl on the GPU.
+*
+* The whole mask is a flat array of 32-bit words, uploaded as-is:
+*   [0]                    Number of words in use
+*   [1, 1 + numTiles)      Word index of each tile's block
+*   [1 + numTiles, ...)    Tile blocks
+*
+* Each tile block is a two-level group hierarchy over the view-depth sorted light list, so its size
+*  only depends on the lights actually in the tile (an empty tile is a single zero word):
+*   [0]                    Super group mask. Bit s is set if any light in [1024s, 1024s + 1024) is set.
+*   [1 + 2i]               Group mask of the i-th set super group. Bit g is set if any of its g-th
+*                            group of 32 lights is set.
+*   [2 + 2i]               Index of the first light word of the i-th set super group (block relative).
+*   [1 + 2 * nSuper, ...)  One light word per set group bit, in ascending light order.
+*
+* Blocks are laid out by 2x2 tile group (one 64x64 pixel HQSM tile group), top-left tile first. A tile
+*  group's mask is never larger than the sum of its tiles' blocks, so phase 2 writes each tile group's
+*  mask in place of its tiles' blocks (see find_lights_approximate.comp).
+*/
+
+#include <glm/glm.hpp>
+
+#include <bit>
+#include <cassert>
 #include <cstdint>
 #include <vector>
 
 namespace sumire::structs {
 
-    // We send light mask bits to a shader as vectors of uint32_t
-    struct lightMaskBitField {
-        long bits : 32;
-    };
-
-    struct lightMaskTile {
-        // Idx 0: Reserved for light groups
-        // Idx 1-32: Light mask bits
-        lightMaskBitField bitFields[33]{ 0b0 };
-
-        void clear() {
-            for (auto& field : bitFields)
-                field.bits = 0b0;
-        }
-
-        bool isBitSet(uint32_t x, uint32_t y) const {
-            assert(x < 32 && y < 33 && "queried bit index is out of range");
-            return BIT_IS_SET(bitFields[y].bits, x);
-        }
-
-        void setLightBit(uint32_t lightIdx) {
-            uint32_t lightGroupIdx = lightIdx / 32u;
-            uint32_t bitIdx = lightIdx - 32u * lightGroupIdx;
-
-            // Set light group bit and light bit
-            BIT_SET(bitFields[0].bits, lightGroupIdx);
-            BIT_SET(bitFields[lightGroupIdx + 1].bits, bitIdx);
-        }
-    };
-
     struct lightMask {
-        // Idx 0 is reserved for light *groups* for speeding up iteration
-        //  of this buffer.
+        static constexpr uint32_t LIGHTS_PER_GROUP       = 32u;
+        static constexpr uint32_t GROUPS_PER_SUPER_GROUP = 32u;
+        static constexpr uint32_t LIGHTS_PER_SUPER_GROUP = LIGHTS_PER_GROUP * GROUPS_PER_SUPER_GROUP;
+        static constexpr uint32_t MAX_SUPER_GROUPS       = 32u;
+        static constexpr uint32_t MAX_LIGHTS             = LIGHTS_PER_SUPER_GROUP * MAX_SUPER_GROUPS;
+        static constexpr uint32_t HEADER_WORDS           = 1u;
+        // Light mask tiles per tile group side.
+        static constexpr uint32_t TILE_GROUP_DIM         = 2u;
 
         const uint32_t width;
         const uint32_t height;
         const uint32_t numTilesX;
         const uint32_t numTilesY;
+        const uint32_t numTileGroupsX;
+        const uint32_t numTileGroupsY;
 
-        std::vector<lightMaskTile> tiles;
+        std::vector<uint32_t> words;
+
+        uint32_t numTiles() const { return numTilesX * numTilesY; }
+        uint32_t tileIdx(const uint32_t x, const uint32_t y) const { return x + y * numTilesX; }
+        uint32_t tileOffset(const uint32_t tileIdx) const { return words[HEADER_WORDS + tileIdx]; }
 
         void clear() {
-            // clear bits of all tiles
-            for (auto& tile : tiles)
-                tile.clear();
+            // Header and offsets, followed by one empty block per tile
+            const uint32_t firstBlock = HEADER_WORDS + numTiles();
+            words.assign(firstBlock + numTiles(), 0u);
+            words[0] = static_cast<uint32_t>(words.size());
+            for (uint32_t i = 0; i < numTiles(); i++)
+                words[HEADER_WORDS + i] = firstBlock + i;
         }
 
-        const lightMaskTile& readTileAtIdx(const uint32_t x, const uint32_t y) const {
-            return tiles[x + y * numTilesX];
-        }
+        // Calls func(groupIdx, lightBits) for each non-empty group of 32 lights in a tile block, in order.
+        template <typename Func>
+        static void forEachGroup(const uint32_t* words, const uint32_t tileOffset, Func&& func) {
+            const uint32_t* block = words + tileOffset;
+            uint32_t superGroupMask = block[0];
 
-        lightMaskTile& tileAtIdx(const uint32_t x, const uint32_t y) {
-            return tiles[x + y * numTilesX];
+            for (uint32_t i = 0; superGroupMask != 0u; i++) {
+                const uint32_t superGroup = static_cast<uint32_t>(std::countr_zero(superGroupMask));
+                superGroupMask &= superGroupMask - 1u;
+
+                uint32_t groupMask = block[1u + 2u * i];
+                const uint32_t* lightWords = block + block[2u + 2u * i];
+
+                while (groupMask != 0u) {
+                    const uint32_t group = static_cast<uint32_t>(std::countr_zero(groupMask));
+                    groupMask &= groupMask - 1u;
+
+                    func(superGroup * GROUPS_PER_SUPER_GROUP + group, *lightWords++);
+                }
+            }
         }
 
-        lightMaskTile& tileAtRasterPos(const uint32_t x, const uint32_t y) {
-            uint32_t xIdx = x - (x / 32u);
-            uint32_t yIdx = y - (y / 32u);
+        template <typename Func>
+        void forEachGroup(const uint32_t tileIdx, Func&& func) const {
+            forEachGroup(words.data(), tileOffset(tileIdx), func);
+        }
 
-            return tiles[x + y * numTilesX];
+        // Compares two tile blocks by content, as blocks may be placed differently (e.g. GPU prepare).
+        //  Groups with no lights set compare equal to absent groups.
+        static bool tilesEqual(
+            const uint32_t* wordsA, const uint32_t tileOffsetA,
+            const uint32_t* wordsB, const uint32_t tileOffsetB
+        ) {
+            std::vector<uint32_t> groupsA;
+            forEachGroup(wordsA, tileOffsetA, [&groupsA](uint32_t group, uint32_t bits) {
+                if (bits != 0u) { groupsA.push_back(group); groupsA.push_back(bits); }
+            });
+
+            size_t i = 0;
+            bool equal = true;
+            forEachGroup(wordsB, tileOffsetB, [&](uint32_t group, uint32_t bits) {
+                if (bits == 0u) return;
+                equal &= i + 1 < groupsA.size() && groupsA[i] == group && groupsA[i + 1] == bits;
+                i += 2;
+            });
+
+            return equal && i == groupsA.size();
         }
 
         lightMask(
@@ -74,11 +116,12 @@ namespace sumire::structs {
         ) : width{ width },
             height{ height },
             numTilesX{ static_cast<uint32_t>(glm::ceil(static_cast<float>(width) / 32.0f)) },
-            numTilesY{ static_cast<uint32_t>(glm::ceil(static_cast<float>(height) / 32.0f)) }
+            numTilesY{ static_cast<uint32_t>(glm::ceil(static_cast<float>(height) / 32.0f)) },
+            numTileGroupsX{ (numTilesX + TILE_GROUP_DIM - 1u) / TILE_GROUP_DIM },
+            numTileGroupsY{ (numTilesY + TILE_GROUP_DIM - 1u) / TILE_GROUP_DIM }
         {
-
-            tiles = std::vector<lightMaskTile>(numTilesX * numTilesY);
+            clear();
         }
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,312 @@
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_mask_builder.hpp>
+
+#include <sumire/math/coord_space_converters.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SUMI_LIGHT_MASK_SSE
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace sumire {
+
+    bool LightMaskBuilder::usesSimd() {
+#ifdef SUMI_LIGHT_MASK_SSE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void LightMaskBuilder::build(
+        std::span<const structs::viewSpaceLight> lights,
+        const SumiCamera& camera,
+        glm::uvec2 screenDim,
+        structs::lightMask& lightMask,
+        SumiThreadPool* threadPool
+    ) {
+        assert(lights.size() <= structs::lightMask::MAX_LIGHTS && "Too many lights for the light mask encoding.");
+
+        updateTilePlanes(camera, screenDim, lightMask);
+        gatherLights(lights, camera.getNear(), camera.getFar());
+
+        tileGroupRows.resize(lightMask.numTileGroupsY);
+        tileBlockOffsets.resize(lightMask.numTiles());
+
+        auto cullRows = [this, &lightMask](uint32_t begin, uint32_t end) {
+            for (uint32_t tileGroupY = begin; tileGroupY < end; tileGroupY++) {
+                cullTileGroupRow(tileGroupY, lightMask);
+            }
+        };
+
+        if (threadPool) {
+            threadPool->parallelFor(lightMask.numTileGroupsY, cullRows);
+        }
+        else {
+            cullRows(0u, lightMask.numTileGroupsY);
+        }
+
+        gatherTileGroupRows(lightMask, threadPool);
+    }
+
+    void LightMaskBuilder::updateTilePlanes(
+        const SumiCamera& camera,
+        glm::uvec2 screenDim,
+        const structs::lightMask& lightMask
+    ) {
+        const glm::uvec2 tileDim{ lightMask.numTilesX, lightMask.numTilesY };
+        const uint64_t projectionVersion = camera.getProjectionVersion();
+
+        // Screen and tile dims are cheap to compare, so guard against callers that resize without
+        //  invalidating the table.
+        if (
+            tilePlanesValid &&
+            projectionVersion == cachedProjectionVersion &&
+            screenDim == cachedScreenDim &&
+            tileDim == cachedTileDim
+        ) return;
+
+        tilePlanesValid         = true;
+        cachedProjectionVersion = projectionVersion;
+        cachedScreenDim         = screenDim;
+        cachedTileDim           = tileDim;
+
+        const size_t numTiles = static_cast<size_t>(tileDim.x) * tileDim.y;
+        for (auto& side : tilePlanes) side.resize(numTiles);
+
+        // Frustum calculations are done in view space as we have access
+        //   to all light positions in view space from the prior sort.
+        constexpr glm::vec3 origin = glm::vec3(0.0f);
+        const glm::vec2 screenDimF{ screenDim };
+        const glm::mat4 invProjection = glm::inverse(camera.getProjectionMatrix());
+
+        for (uint32_t frustumY = 0; frustumY < tileDim.y; frustumY++) {
+            for (uint32_t frustumX = 0; frustumX < tileDim.x; frustumX++) {
+                // Screen space coords of frusta points
+                const glm::vec4 screenTopL = { TILE_SIZE * glm::vec2{  frustumX  , frustumY  }, -1.0f, 1.0f };
+                const glm::vec4 screenTopR = { TILE_SIZE * glm::vec2{  frustumX+1, frustumY  }, -1.0f, 1.0f };
+                const glm::vec4 screenBotL = { TILE_SIZE * glm::vec2{  frustumX  , frustumY+1}, -1.0f, 1.0f };
+                const glm::vec4 screenBotR = { TILE_SIZE * glm::vec2{  frustumX+1, frustumY+1}, -1.0f, 1.0f };
+
+                // View space coords of frusta points
+                const glm::vec3 viewTopL = glm::vec3(screenToView(screenTopL, screenDimF, invProjection));
+                const glm::vec3 viewTopR = glm::vec3(screenToView(screenTopR, screenDimF, invProjection));
+                const glm::vec3 viewBotL = glm::vec3(screenToView(screenBotL, screenDimF, invProjection));
+                const glm::vec3 viewBotR = glm::vec3(screenToView(screenBotR, screenDimF, invProjection));
+
+                // Frusta bounding planes from points
+                const size_t tileIdx = frustumX + frustumY * tileDim.x;
+                tilePlanes[TILE_SIDE_TOP  ].set(tileIdx, computeFrustumPlane(origin, viewTopR, viewTopL));
+                tilePlanes[TILE_SIDE_BOT  ].set(tileIdx, computeFrustumPlane(origin, viewBotL, viewBotR));
+                tilePlanes[TILE_SIDE_RIGHT].set(tileIdx, computeFrustumPlane(origin, viewBotR, viewTopR));
+                tilePlanes[TILE_SIDE_LEFT ].set(tileIdx, computeFrustumPlane(origin, viewTopL, viewBotL));
+            }
+        }
+    }
+
+    void LightMaskBuilder::gatherLights(
+        std::span<const structs::viewSpaceLight> lights,
+        float near, float far
+    ) {
+        numLights = static_cast<uint32_t>(lights.size());
+        const uint32_t paddedCount =
+            (numLights + LIGHT_BATCH_SIZE - 1u) / LIGHT_BATCH_SIZE * LIGHT_BATCH_SIZE;
+
+        // Padding lanes are never set as their depth mask is zero.
+        lightPosX.assign(paddedCount, 0.0f);
+        lightPosY.assign(paddedCount, 0.0f);
+        lightPosZ.assign(paddedCount, 0.0f);
+        lightRange.assign(paddedCount, 0.0f);
+        lightDepthMask.assign(paddedCount, 0u);
+
+        for (uint32_t i = 0; i < numLights; i++) {
+            const float r = lights[i].range;
+            const glm::vec3& p = lights[i].viewSpacePosition;
+
+            lightPosX[i]  = p.x;
+            lightPosY[i]  = p.y;
+            lightPosZ[i]  = p.z;
+            lightRange[i] = r;
+
+            // Near and far tests do not depend on the tile, so resolve them once per light.
+            const bool intersectionIntN = lights[i].viewSpaceDepth + r > near;
+            const bool intersectionIntF = lights[i].viewSpaceDepth - r < far;
+            lightDepthMask[i] = (intersectionIntN && intersectionIntF) ? ~0u : 0u;
+        }
+    }
+
+    void LightMaskBuilder::cullTileGroupRow(uint32_t tileGroupY, const structs::lightMask& lightMask) {
+        constexpr uint32_t TILE_GROUP_DIM = structs::lightMask::TILE_GROUP_DIM;
+
+        TileGroupRow& row = tileGroupRows[tileGroupY];
+        row.words.clear();
+
+        // Tiles of a tile group are kept contiguous, top-left tile first.
+        const uint32_t firstTileY = tileGroupY * TILE_GROUP_DIM;
+        const uint32_t lastTileY  = glm::min(firstTileY + TILE_GROUP_DIM, lightMask.numTilesY);
+
+        for (uint32_t tileGroupX = 0; tileGroupX < lightMask.numTileGroupsX; tileGroupX++) {
+            const uint32_t firstTileX = tileGroupX * TILE_GROUP_DIM;
+            const uint32_t lastTileX  = glm::min(firstTileX + TILE_GROUP_DIM, lightMask.numTilesX);
+
+            for (uint32_t tileY = firstTileY; tileY < lastTileY; tileY++) {
+                for (uint32_t tileX = firstTileX; tileX < lastTileX; tileX++) {
+                    cullTile(lightMask.tileIdx(tileX, tileY), tileGroupY);
+                }
+            }
+        }
+    }
+
+    void LightMaskBuilder::cullTile(uint32_t tileIdx, uint32_t tileGroupY) {
+        constexpr uint32_t LIGHTS_PER_GROUP       = structs::lightMask::LIGHTS_PER_GROUP;
+        constexpr uint32_t GROUPS_PER_SUPER_GROUP = structs::lightMask::GROUPS_PER_SUPER_GROUP;
+
+        TileGroupRow& row = tileGroupRows[tileGroupY];
+        const uint32_t numGroups = (numLights + LIGHTS_PER_GROUP - 1u) / LIGHTS_PER_GROUP;
+
+        // ---- Cull lights, keeping only non-empty groups -----------------------------------------------------
+        row.tileGroups.clear();
+        uint32_t superGroupMask = 0u;
+
+        for (uint32_t group = 0; group < numGroups; group++) {
+            const uint32_t firstLight = group * LIGHTS_PER_GROUP;
+            const uint32_t lastLight  = glm::min(firstLight + LIGHTS_PER_GROUP, numLights);
+
+            uint32_t lightBits = 0u;
+            for (uint32_t i = firstLight; i < lastLight; i += LIGHT_BATCH_SIZE) {
+                lightBits |= cullLightBatch(tileIdx, i) << (i - firstLight);
+            }
+
+            if (lightBits != 0u) {
+                superGroupMask |= 1u << (group / GROUPS_PER_SUPER_GROUP);
+                row.tileGroups.push_back(group);
+                row.tileGroups.push_back(lightBits);
+            }
+        }
+
+        // ---- Write tile block -------------------------------------------------------------------------------
+        const uint32_t blockOffset    = static_cast<uint32_t>(row.words.size());
+        const uint32_t numSuperGroups = static_cast<uint32_t>(std::popcount(superGroupMask));
+        tileBlockOffsets[tileIdx] = blockOffset;
+
+        row.words.resize(blockOffset + 1u + 2u * numSuperGroups, 0u);
+        row.words[blockOffset] = superGroupMask;
+
+        uint32_t superGroupEntry = 0u;
+        uint32_t prevSuperGroup  = UINT32_MAX;
+        for (size_t i = 0; i < row.tileGroups.size(); i += 2) {
+            const uint32_t group      = row.tileGroups[i];
+            const uint32_t superGroup = group / GROUPS_PER_SUPER_GROUP;
+
+            // Groups are in ascending order, so each super group's light words are contiguous.
+            if (superGroup != prevSuperGroup) {
+                if (prevSuperGroup != UINT32_MAX) superGroupEntry++;
+                prevSuperGroup = superGroup;
+                row.words[blockOffset + 2u + 2u * superGroupEntry] =
+                    static_cast<uint32_t>(row.words.size()) - blockOffset;
+            }
+
+            row.words[blockOffset + 1u + 2u * superGroupEntry] |= 1u << (group % GROUPS_PER_SUPER_GROUP);
+            row.words.push_back(row.tileGroups[i + 1]);
+        }
+    }
+
+    void LightMaskBuilder::gatherTileGroupRows(structs::lightMask& lightMask, SumiThreadPool* threadPool) {
+        constexpr uint32_t TILE_GROUP_DIM = structs::lightMask::TILE_GROUP_DIM;
+
+        uint32_t numWords = structs::lightMask::HEADER_WORDS + lightMask.numTiles();
+        for (TileGroupRow& row : tileGroupRows) {
+            row.offset = numWords;
+            numWords  += static_cast<uint32_t>(row.words.size());
+        }
+
+        lightMask.words.resize(numWords);
+        lightMask.words[0] = numWords;
+
+        auto copyRows = [this, &lightMask](uint32_t begin, uint32_t end) {
+            for (uint32_t tileGroupY = begin; tileGroupY < end; tileGroupY++) {
+                const TileGroupRow& row = tileGroupRows[tileGroupY];
+                std::copy(row.words.begin(), row.words.end(), lightMask.words.begin() + row.offset);
+
+                const uint32_t firstTileY = tileGroupY * TILE_GROUP_DIM;
+                const uint32_t lastTileY  = glm::min(firstTileY + TILE_GROUP_DIM, lightMask.numTilesY);
+                for (uint32_t tileY = firstTileY; tileY < lastTileY; tileY++) {
+                    for (uint32_t tileX = 0; tileX < lightMask.numTilesX; tileX++) {
+                        const uint32_t tileIdx = lightMask.tileIdx(tileX, tileY);
+                        lightMask.words[structs::lightMask::HEADER_WORDS + tileIdx] =
+                            row.offset + tileBlockOffsets[tileIdx];
+                    }
+                }
+            }
+        };
+
+        if (threadPool) {
+            threadPool->parallelFor(lightMask.numTileGroupsY, copyRows);
+        }
+        else {
+            copyRows(0u, lightMask.numTileGroupsY);
+        }
+    }
+
+    // Returns a LIGHT_BATCH_SIZE-bit mask of lights [firstLight, firstLight + LIGHT_BATCH_SIZE)
+    //  that intersect the frustum of the given tile.
+    uint32_t LightMaskBuilder::cullLightBatch(uint32_t tileIdx, uint32_t firstLight) const {
+#ifdef SUMI_LIGHT_MASK_SSE
+        const __m128 px = _mm_loadu_ps(&lightPosX[firstLight]);
+        const __m128 py = _mm_loadu_ps(&lightPosY[firstLight]);
+        const __m128 pz = _mm_loadu_ps(&lightPosZ[firstLight]);
+        const __m128 r  = _mm_loadu_ps(&lightRange[firstLight]);
+        const __m128 depthMask = _mm_castsi128_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lightDepthMask[firstLight])));
+
+        // Mirrors FrustumPlane::intersectSphere exactly: ((n.x*p.x + n.y*p.y) + n.z*p.z) - dist - r < 0
+        //  Operation order is kept identical so results are bit-identical to the scalar path.
+        auto intersectSpheres = [&](const TilePlanes& plane) {
+            const __m128 dot = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(plane.nx[tileIdx]), px),
+                    _mm_mul_ps(_mm_set1_ps(plane.ny[tileIdx]), py)
+                ),
+                _mm_mul_ps(_mm_set1_ps(plane.nz[tileIdx]), pz)
+            );
+            const __m128 sdf = _mm_sub_ps(dot, _mm_set1_ps(plane.d[tileIdx]));
+            return _mm_cmplt_ps(_mm_sub_ps(sdf, r), _mm_setzero_ps());
+        };
+
+        __m128 intersects = _mm_and_ps(
+            intersectSpheres(tilePlanes[TILE_SIDE_TOP]), intersectSpheres(tilePlanes[TILE_SIDE_BOT]));
+        intersects = _mm_and_ps(intersects, intersectSpheres(tilePlanes[TILE_SIDE_LEFT]));
+        intersects = _mm_and_ps(intersects, intersectSpheres(tilePlanes[TILE_SIDE_RIGHT]));
+        intersects = _mm_and_ps(intersects, depthMask);
+
+        return static_cast<uint32_t>(_mm_movemask_ps(intersects));
+#else
+        auto intersectSphere = [tileIdx](const TilePlanes& plane, const glm::vec3& p, float r) {
+            const float sdf = ((plane.nx[tileIdx] * p.x + plane.ny[tileIdx] * p.y) + plane.nz[tileIdx] * p.z) - plane.d[tileIdx];
+            return sdf - r < 0.0f;
+        };
+
+        uint32_t mask = 0u;
+        for (uint32_t lane = 0; lane < LIGHT_BATCH_SIZE; lane++) {
+            const uint32_t i = firstLight + lane;
+            const glm::vec3 p{ lightPosX[i], lightPosY[i], lightPosZ[i] };
+            const float r = lightRange[i];
+
+            const bool intersects = (
+                intersectSphere(tilePlanes[TILE_SIDE_TOP  ], p, r) &&
+                intersectSphere(tilePlanes[TILE_SIDE_BOT  ], p, r) &&
+                intersectSphere(tilePlanes[TILE_SIDE_LEFT ], p, r) &&
+                intersectSphere(tilePlanes[TILE_SIDE_RIGHT], p, r) &&
+                lightDepthMask[i] != 0u
+            );
+
+            if (intersects) mask |= 1u << lane;
+        }
+        return mask;
+#endif
+    }
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+* CPU light mask generation for phase 1 (prepare) of HQSM.
+*
+* Each 32x32 pixel light mask tile is a small frustum built from the camera projection.
+*  Lights are culled against these frusta in batches of 4 (one light per SIMD lane), and
+*  rows of tile groups are distributed over a thread pool. The output is bit-identical to the
+*  reference scalar cull (FrustumPlane::intersectSphere per light, per tile).
+*
+* Each row writes its tiles' sparse blocks (see light_mask.hpp) to its own scratch, and rows are then
+*  concatenated into the light mask, so the output size follows the number of lights per tile.
+*
+* Tile frusta only depend on the projection and screen dimensions, so their planes are kept in
+*  a persistent SoA table and only rebuilt when the camera projection changes (tracked through
+*  SumiCamera::getProjectionVersion()) or the table is invalidated on a screen resize.
+*/
+
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_mask.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/view_space_light.hpp>
+#include <sumire/core/rendering/general/sumi_camera.hpp>
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+#include <sumire/math/frustum_culling.hpp>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sumire {
+
+    class LightMaskBuilder {
+    public:
+        // Lights tested together per SIMD batch.
+        static constexpr uint32_t LIGHT_BATCH_SIZE = 4u;
+        static constexpr float TILE_SIZE = 32.0f;
+
+        LightMaskBuilder() = default;
+
+        LightMaskBuilder(const LightMaskBuilder&) = delete;
+        LightMaskBuilder& operator=(const LightMaskBuilder&) = delete;
+
+        // Whether lights are culled with SSE, rather than the scalar fallback, in this build.
+        static bool usesSimd();
+
+        // Forces the tile plane table to be rebuilt on the next build(), e.g. after a resize.
+        void invalidateTilePlanes() { tilePlanesValid = false; }
+
+        // Lights MUST be pre-sorted by view space depth.
+        //  If threadPool is null, all tiles are culled on the calling thread.
+        void build(
+            std::span<const structs::viewSpaceLight> lights,
+            const SumiCamera& camera,
+            glm::uvec2 screenDim,
+            structs::lightMask& lightMask,
+            SumiThreadPool* threadPool
+        );
+
+    private:
+        enum TileSide : uint32_t {
+            TILE_SIDE_TOP   = 0,
+            TILE_SIDE_BOT   = 1,
+            TILE_SIDE_LEFT  = 2,
+            TILE_SIDE_RIGHT = 3,
+            TILE_SIDE_COUNT = 4
+        };
+
+        // One plane per tile for a single side, indexed by (tileX + tileY * numTilesX).
+        struct TilePlanes {
+            std::vector<float> nx;
+            std::vector<float> ny;
+            std::vector<float> nz;
+            std::vector<float> d;
+
+            void resize(size_t n) { nx.resize(n); ny.resize(n); nz.resize(n); d.resize(n); }
+            void set(size_t i, const FrustumPlane& plane) {
+                nx[i] = plane.normal.x; ny[i] = plane.normal.y; nz[i] = plane.normal.z; d[i] = plane.dist;
+            }
+        };
+
+        void updateTilePlanes(
+            const SumiCamera& camera,
+            glm::uvec2 screenDim,
+            const structs::lightMask& lightMask
+        );
+        void gatherLights(
+            std::span<const structs::viewSpaceLight> lights,
+            float near, float far
+        );
+        void cullTileGroupRow(uint32_t tileGroupY, const structs::lightMask& lightMask);
+        void cullTile(uint32_t tileIdx, uint32_t tileGroupY);
+        uint32_t cullLightBatch(uint32_t tileIdx, uint32_t firstLight) const;
+        void gatherTileGroupRows(structs::lightMask& lightMask, SumiThreadPool* threadPool);
+
+        // ---- Tile plane table -----------------------------------------------------------------------------
+        TilePlanes tilePlanes[TILE_SIDE_COUNT];
+        bool tilePlanesValid = false;
+        uint64_t cachedProjectionVersion = 0u;
+        glm::uvec2 cachedScreenDim{ 0u };
+        glm::uvec2 cachedTileDim{ 0u };
+
+        // ---- Per-frame light data (SoA, padded to LIGHT_BATCH_SIZE) --------------------------------------
+        uint32_t numLights = 0u;
+        std::vector<float> lightPosX;
+        std::vector<float> lightPosY;
+        std::vector<float> lightPosZ;
+        std::vector<float> lightRange;
+        // All bits set if the light intersects the [near, far] depth range, else 0.
+        std::vector<uint32_t> lightDepthMask;
+
+        // ---- Per tile group row output -------------------------------------------------------------------
+        struct TileGroupRow {
+            // Tile blocks of the row, in light mask order
+            std::vector<uint32_t> words;
+            // (group, light bits) of the non-empty groups of the tile being culled
+            std::vector<uint32_t> tileGroups;
+            // Offset of the row in the light mask
+            uint32_t offset = 0u;
+        };
+        std::vector<TileGroupRow> tileGroupRows;
+        // Row relative block offset per tile
+        std::vector<uint32_t> tileBlockOffsets;
+    };
+
+}
@@ -0,0 +1,201 @@
+#include <sumire/core/render_systems/high_quality_shadow_mapping/light_sorter.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SUMI_LIGHT_SORT_SSE
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <numeric>
+
+namespace sumire {
+
+    std::span<const structs::viewSpaceLight> LightSorter::sort(const SumiLightStore& lights, const glm::mat4& view) {
+        // Slots refer to the same lights unless the store has added, removed or moved any.
+        const bool sameLights = lights.size() == numLights && lights.getLayoutVersion() == layoutVersion;
+        numLights     = lights.size();
+        layoutVersion = lights.getLayoutVersion();
+
+        viewX.resize(numLights);
+        viewY.resize(numLights);
+        viewZ.resize(numLights);
+        minDepth.resize(numLights);
+        sortKeys.resize(numLights);
+
+        transformToViewSpace(lights, view);
+        computeSortKeys(lights);
+
+        // Start from the previous order if it refers to the same lights, so a nearly sorted order
+        //  only needs repairing.
+        const bool reuseOrder = sameLights && orderValid;
+        if (!reuseOrder) {
+            order.resize(numLights);
+            std::iota(order.begin(), order.end(), 0u);
+        }
+
+        orderKeys.resize(numLights);
+        for (uint32_t i = 0; i < numLights; i++) {
+            orderKeys[i] = sortKeys[order[i]];
+        }
+
+        bool sorted = false;
+        if (numLights <= INSERTION_SORT_THRESHOLD) {
+            sorted = insertionSort(UINT32_MAX);
+        }
+        else if (reuseOrder) {
+            sorted = insertionSort(INSERTION_SORT_MOVES_PER_LIGHT * numLights);
+        }
+        if (!sorted) radixSort();
+
+        orderValid = true;
+
+        const std::span<const float> ranges = lights.getRanges();
+
+        sortedLights.resize(numLights);
+        for (uint32_t i = 0; i < numLights; i++) {
+            const uint32_t j = order[i];
+
+            structs::viewSpaceLight& light = sortedLights[i];
+            light.slot              = j;
+            light.range             = ranges[j];
+            light.viewSpacePosition = glm::vec3{ viewX[j], viewY[j], viewZ[j] };
+            // Camera is -z oriented so negate z-value
+            light.viewSpaceDepth    = -viewZ[j];
+            light.minDepth          = minDepth[j];
+            light.maxDepth          = light.viewSpaceDepth + ranges[j];
+        }
+
+        assert(std::is_sorted(sortedLights.begin(), sortedLights.end(),
+            [](const structs::viewSpaceLight& a, const structs::viewSpaceLight& b) {
+                return a.minDepth < b.minDepth;
+            }
+        ) && "Lights were not sorted by min view space depth.");
+
+        return sortedLights;
+    }
+
+    void LightSorter::transformToViewSpace(const SumiLightStore& lights, const glm::mat4& view) {
+        const std::span<const float> posX = lights.getPositionsX();
+        const std::span<const float> posY = lights.getPositionsY();
+        const std::span<const float> posZ = lights.getPositionsZ();
+
+        // Same operation order as glm's mat4 * vec4 ((col0 * x + col1 * y) + col2 * z) + col3. The view
+        //  matrix is affine, so w is always 1 and the divide by w is skipped.
+        uint32_t i = 0;
+#ifdef SUMI_LIGHT_SORT_SSE
+        auto transformRow = [&view](uint32_t row, __m128 x, __m128 y, __m128 z) {
+            return _mm_add_ps(
+                _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(view[0][row]), x),
+                        _mm_mul_ps(_mm_set1_ps(view[1][row]), y)
+                    ),
+                    _mm_mul_ps(_mm_set1_ps(view[2][row]), z)
+                ),
+                _mm_set1_ps(view[3][row])
+            );
+        };
+
+        for (; i + LIGHT_BATCH_SIZE <= numLights; i += LIGHT_BATCH_SIZE) {
+            const __m128 x = _mm_loadu_ps(&posX[i]);
+            const __m128 y = _mm_loadu_ps(&posY[i]);
+            const __m128 z = _mm_loadu_ps(&posZ[i]);
+
+            _mm_storeu_ps(&viewX[i], transformRow(0u, x, y, z));
+            _mm_storeu_ps(&viewY[i], transformRow(1u, x, y, z));
+            _mm_storeu_ps(&viewZ[i], transformRow(2u, x, y, z));
+        }
+#endif
+        // Remaining lights (all of them without SSE)
+        for (; i < numLights; i++) {
+            viewX[i] = ((view[0][0] * posX[i] + view[1][0] * posY[i]) + view[2][0] * posZ[i]) + view[3][0];
+            viewY[i] = ((view[0][1] * posX[i] + view[1][1] * posY[i]) + view[2][1] * posZ[i]) + view[3][1];
+            viewZ[i] = ((view[0][2] * posX[i] + view[1][2] * posY[i]) + view[2][2] * posZ[i]) + view[3][2];
+        }
+    }
+
+    void LightSorter::computeSortKeys(const SumiLightStore& lights) {
+        const std::span<const float> range = lights.getRanges();
+
+        for (uint32_t i = 0; i < numLights; i++) {
+            minDepth[i] = -viewZ[i] - range[i];
+
+            // Order-preserving float -> uint: flip all bits of negatives, only the sign bit of positives.
+            const uint32_t bits = std::bit_cast<uint32_t>(minDepth[i]);
+            sortKeys[i] = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        }
+    }
+
+    // Returns false (leaving a valid, partially sorted order) if more than maxMoves moves are needed.
+    bool LightSorter::insertionSort(uint32_t maxMoves) {
+        uint32_t moves = 0u;
+
+        for (uint32_t i = 1; i < numLights; i++) {
+            const uint32_t key = orderKeys[i];
+            if (orderKeys[i - 1] <= key) continue;
+
+            const uint32_t idx = order[i];
+            uint32_t j = i;
+            while (j > 0 && orderKeys[j - 1] > key) {
+                orderKeys[j] = orderKeys[j - 1];
+                order[j]     = order[j - 1];
+                j--;
+            }
+            orderKeys[j] = key;
+            order[j]     = idx;
+
+            moves += i - j;
+            if (moves > maxMoves) return false;
+        }
+
+        return true;
+    }
+
+    void LightSorter::radixSort() {
+        constexpr uint32_t RADIX_BITS = 8u;
+        constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+        constexpr uint32_t NUM_PASSES = 32u / RADIX_BITS;
+
+        orderScratch.resize(numLights);
+        orderKeysScratch.resize(numLights);
+
+        // Histograms for every pass are built in one read over the keys.
+        std::array<std::array<uint32_t, RADIX_SIZE>, NUM_PASSES> histograms{};
+        for (uint32_t i = 0; i < numLights; i++) {
+            const uint32_t key = orderKeys[i];
+            for (uint32_t pass = 0; pass < NUM_PASSES; pass++) {
+                histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1u)]++;
+            }
+        }
+
+        for (uint32_t pass = 0; pass < NUM_PASSES; pass++) {
+            auto& histogram = histograms[pass];
+            const uint32_t shift = pass * RADIX_BITS;
+
+            // Every key shares this digit, so the pass would not change the order.
+            if (histogram[(orderKeys[0] >> shift) & (RADIX_SIZE - 1u)] == numLights) continue;
+
+            // Exclusive prefix sum -> scatter offsets
+            uint32_t offset = 0u;
+            for (uint32_t& count : histogram) {
+                const uint32_t bucketCount = count;
+                count = offset;
+                offset += bucketCount;
+            }
+
+            for (uint32_t i = 0; i < numLights; i++) {
+                const uint32_t key = orderKeys[i];
+                const uint32_t dst = histogram[(key >> shift) & (RADIX_SIZE - 1u)]++;
+                orderKeysScratch[dst] = key;
+                orderScratch[dst]     = order[i];
+            }
+
+            std::swap(orderKeys, orderKeysScratch);
+            std::swap(order, orderScratch);
+        }
+    }
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+* View space depth sort of the scene lights, run prior to phase 1 (prepare) of HQSM.
+*
+* Light positions are read straight from the SoA light store and transformed to view space 4 lights
+*  at a time. Lights are then ordered by min view space depth, using order-preserving float-to-uint
+*  keys and an LSD radix sort (8 bits per pass, skipping passes where every key shares the digit).
+*
+* Frame to frame, the light order rarely changes much. When the light set is unchanged, the previous
+*  order is re-checked first and repaired with an insertion sort if only a few lights moved, falling
+*  back to the radix sort if the repair exceeds its move budget.
+*
+* All scratch storage is kept across frames; the result is a span into the sorter's own storage,
+*  valid until the next call to sort().
+*/
+
+#include <sumire/core/render_systems/high_quality_shadow_mapping/view_space_light.hpp>
+#include <sumire/core/rendering/lighting/sumi_light_store.hpp>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sumire {
+
+    class LightSorter {
+    public:
+        // Lights transformed to view space together per SIMD batch.
+        static constexpr uint32_t LIGHT_BATCH_SIZE = 4u;
+        // Below this many lights, an insertion sort always beats the radix passes.
+        static constexpr uint32_t INSERTION_SORT_THRESHOLD = 32u;
+        // Insertion sort repairs abort after (moves per light * light count) element moves.
+        static constexpr uint32_t INSERTION_SORT_MOVES_PER_LIGHT = 4u;
+
+        LightSorter() = default;
+
+        LightSorter(const LightSorter&) = delete;
+        LightSorter& operator=(const LightSorter&) = delete;
+
+        std::span<const structs::viewSpaceLight> sort(const SumiLightStore& lights, const glm::mat4& view);
+
+    private:
+        void transformToViewSpace(const SumiLightStore& lights, const glm::mat4& view);
+        void computeSortKeys(const SumiLightStore& lights);
+
+        bool insertionSort(uint32_t maxMoves);
+        void radixSort();
+
+        // ---- Per-light data, in store slot order ------------------------------------------------------------
+        uint32_t numLights = 0u;
+        // Store layout the order below refers to. Slots are only stable while it is unchanged.
+        uint64_t layoutVersion = 0u;
+        std::vector<float> viewX;
+        std::vector<float> viewY;
+        std::vector<float> viewZ;
+        std::vector<float> minDepth;
+        std::vector<uint32_t> sortKeys;
+
+        // ---- Sort state -----------------------------------------------------------------------------------
+        // Store slots of the lights, in sorted order. Kept as the starting point for the next sort.
+        std::vector<uint32_t> order;
+        // Sort keys of the lights in order, sorted alongside it to avoid indirect key reads.
+        std::vector<uint32_t> orderKeys;
+        std::vector<uint32_t> orderScratch;
+        std::vector<uint32_t> orderKeysScratch;
+        bool orderValid = false;
+
+        std::vector<structs::viewSpaceLight> sortedLights;
+    };
+
+}
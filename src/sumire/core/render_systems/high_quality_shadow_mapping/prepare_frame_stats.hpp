@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sumire::structs {
+
+    // Counters for the per-frame in flight prepare buffers, e.g. to check that moving lights every frame
+    //  uploads each frame's buffers once and stops reallocating them once the light mask has grown to fit.
+    struct prepareFrameStats {
+        uint32_t preparedFrames     = 0u;  // prepare() calls
+        uint32_t frameUploads       = 0u;  // Frame in flight buffer uploads / prepare dispatches
+        uint32_t skippedFrames      = 0u;  // prepareFrame() calls with the frame's buffers already current
+        uint32_t lightMaskGrowths   = 0u;  // Frame in flight light mask buffer reallocations
+        uint32_t lightMaskOverflows = 0u;  // GPU prepare dispatches that ran out of light mask words
+    };
+
+}
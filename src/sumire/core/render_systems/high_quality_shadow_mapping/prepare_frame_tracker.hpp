@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace sumire {
+
+    // Which frames in flight hold prepare buffers (zBin, light mask, prepared lights) written from the
+    //  latest prepare(). Each frame in flight has its own buffers, and only writes them when it is
+    //  prepared again, so that preparing frame N+1 never touches buffers frame N may still be reading.
+    //
+    //  prepare() advances the generation; each frame stores the generation its buffers were last written
+    //  from. 0 marks the frame's buffers as unwritten, and is only current before the first prepare(),
+    //  when there is nothing to write.
+    class PrepareFrameTracker {
+    public:
+        explicit PrepareFrameTracker(uint32_t numFrames = 0u) : frameGenerations(numFrames, 0u) {}
+
+        // A prepare() made every frame's buffers out of date.
+        void advance() { generation++; }
+
+        // Whether the frame's buffers must be written from the latest prepare(), marking them current if so.
+        bool acquire(uint32_t frameIdx) {
+            assert(frameIdx < frameGenerations.size() && "Frame index out of range.");
+            if (frameGenerations[frameIdx] == generation) return false;
+            frameGenerations[frameIdx] = generation;
+            return true;
+        }
+
+        bool isCurrent(uint32_t frameIdx) const { return frameGenerations[frameIdx] == generation; }
+
+        // The frame's buffers were reallocated or left incomplete, so must be written again.
+        void invalidate(uint32_t frameIdx) { frameGenerations[frameIdx] = 0u; }
+        void invalidateAll() { std::fill(frameGenerations.begin(), frameGenerations.end(), 0u); }
+
+    private:
+        uint64_t generation = 0u;
+        std::vector<uint64_t> frameGenerations;
+    };
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sumire::structs {
+
+    // Results of diffing GPU prepare outputs against the CPU reference, and the CPU zBin against the
+    //  original two pass fill (see ZbinBuilder::validate()).
+    struct prepareValidationStats {
+        uint32_t validatedFrames = 0u;
+        uint32_t failedFrames    = 0u;
+
+        // Mismatching entries from the most recent validation
+        uint32_t zBinMismatches      = 0u;
+        uint32_t lightMaskMismatches = 0u;
+        uint32_t zBinReferenceMismatches = 0u;
+        // First mismatching entry from the most recent validation, or -1 if none.
+        int firstZbinMismatch      = -1;
+        int firstLightMaskMismatch = -1;
+        int firstZbinReferenceMismatch = -1;
+    };
+
+}
@@ -4,6 +4,18 @@
 
 namespace sumire::structs {
 
+    // Shared by the zBin and light mask GPU prepare passes.
+    struct preparePush {
+        glm::mat4    invProjection;
+        glm::uvec2   screenResolution;
+        glm::uvec2   lightMaskResolution;
+        glm::uint    numLights;
+        glm::uint    numZbinSlices;
+        glm::float32 cameraNear;
+        glm::float32 cameraFar;
+        glm::uint    lightMaskCapacity; // Words in the dispatched frame's light mask buffer
+    };
+
     struct findLightsApproxPush {
         glm::uvec2   screenResolution;
         glm::uvec2   shadowTileResolution;
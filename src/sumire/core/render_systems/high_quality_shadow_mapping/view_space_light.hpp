@@ -1,17 +1,25 @@
 #pragma once
 
-#include <sumire/core/rendering/lighting/sumi_light.hpp>
-
 #include <glm/glm.hpp>
 
+#include <cstdint>
+
 namespace sumire::structs {
 
     struct viewSpaceLight {
-        SumiLight* lightPtr = nullptr;
+        // Slot of the light in the SumiLightStore it was sorted from.
+        uint32_t slot = 0u;
+        float range = 0.0f;
         glm::vec3 viewSpacePosition{ 0.0f };
         float viewSpaceDepth = 0.0f;
         float minDepth = 0.0f;
         float maxDepth = 0.0f;
     };
 
+    // Shader-compatible view space light for GPU prepare (see inc_prepared_light.glsl).
+    struct preparedLight {
+        glm::vec4 viewSpacePositionRange; // xyz: view space position, w: range
+        glm::vec4 viewSpaceDepths;        // x: view space depth, y: min depth, z: max depth
+    };
+
 }
\ No newline at end of file
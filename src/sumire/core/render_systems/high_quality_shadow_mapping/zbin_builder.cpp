@@ -0,0 +1,433 @@
+#include <sumire/core/render_systems/high_quality_shadow_mapping/zbin_builder.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SUMI_ZBIN_SSE
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace sumire {
+
+#ifdef SUMI_ZBIN_SSE
+    namespace {
+        // log2(x) for positive, normal x. The exponent is extracted exactly and the mantissa term
+        //  uses a quartic fit of log2(1 + t), t in [0, 1), with a max abs error of ~2e-4.
+        __m128 fastLog2(__m128 x) {
+            const __m128i bits = _mm_castps_si128(x);
+            const __m128 exponent = _mm_cvtepi32_ps(
+                _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+            const __m128 mantissa = _mm_or_ps(
+                _mm_castsi128_ps(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF))), _mm_set1_ps(1.0f));
+            const __m128 t = _mm_sub_ps(mantissa, _mm_set1_ps(1.0f));
+
+            __m128 p = _mm_set1_ps(-0.08427316f);
+            p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps( 0.32361048f));
+            p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(-0.67807154f));
+            p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps( 1.43854537f));
+            return _mm_add_ps(exponent, _mm_mul_ps(p, t));
+        }
+    }
+#endif
+
+    void ZbinBuilder::build(
+        std::span<const structs::viewSpaceLight> lights,
+        float near, float far,
+        structs::zBin& zBin
+    ) {
+        assert(!zBin.data.empty() && "zBin must have at least one slice.");
+
+        const int32_t numSlices = static_cast<int32_t>(zBin.data.size());
+        updateSliceBoundaries(near, far, static_cast<uint32_t>(numSlices));
+        const bool boundariesChanged = previousBoundariesGeneration != sliceBoundariesGeneration;
+
+        computeLightSlices(lights);
+
+        // zBin metadata: first and last lights that cover at least one slice.
+        zBin.minLight = -1;
+        zBin.maxLight = -1;
+        for (uint32_t i = 0; i < numLights; i++) {
+            if (lightSliceMin[i] < numSlices && lightSliceMax[i] >= 0) {
+                if (zBin.minLight == -1) zBin.minLight = static_cast<int>(i);
+                zBin.maxLight = static_cast<int>(i);
+            }
+        }
+
+        // Range of slices to re-bin. A slice's min / max light can only change if some light started
+        //  or stopped covering it, so only the old and new ranges of changed lights are dirty.
+        int32_t firstDirty = 0;
+        int32_t lastDirty = numSlices - 1;
+
+        if (incremental && previousValid && !boundariesChanged && previousNumLights == numLights) {
+            firstDirty = numSlices;
+            lastDirty = -1;
+
+            auto markDirty = [&](int32_t sliceMin, int32_t sliceMax) {
+                const int32_t first = std::max(sliceMin, 0);
+                const int32_t last  = std::min(sliceMax, numSlices - 1);
+                if (first > last) return;
+                firstDirty = std::min(firstDirty, first);
+                lastDirty  = std::max(lastDirty, last);
+            };
+
+            for (uint32_t i = 0; i < numLights; i++) {
+                if (lightSliceMin[i] == previousSliceMin[i] && lightSliceMax[i] == previousSliceMax[i]) continue;
+                markDirty(previousSliceMin[i], previousSliceMax[i]);
+                markDirty(lightSliceMin[i], lightSliceMax[i]);
+            }
+        }
+
+        // Otherwise slice coverage is unchanged, and so is the zBin from the previous build.
+        if (firstDirty <= lastDirty) {
+            binLights(firstDirty, lastDirty, zBin);
+            fillRanges(zBin);
+        }
+
+        previousValid = true;
+        previousBoundariesGeneration = sliceBoundariesGeneration;
+        previousNumLights = numLights;
+        std::swap(previousSliceMin, lightSliceMin);
+        std::swap(previousSliceMax, lightSliceMax);
+    }
+
+    void ZbinBuilder::updateSliceBoundaries(float near, float far, uint32_t numSlices) {
+        if (
+            sliceBoundaries.size() == numSlices + 1u &&
+            near == cachedNear &&
+            far == cachedFar
+        ) return;
+
+        cachedNear = near;
+        cachedFar  = far;
+
+        // Slice calculation from Tiago Sous' DOOM 2016 Siggraph presentation.
+        //   Interactive graph: https://www.desmos.com/calculator/bf0g6n0hqp
+        //   slice = floor(log2(z / near) * numSlices / log2(far / near))
+        log2Near   = std::log2(near);
+        sliceScale = static_cast<float>(numSlices) / std::log2(far / near);
+
+        const double farNear = static_cast<double>(far) / static_cast<double>(near);
+        sliceBoundaries.resize(numSlices + 1u);
+        for (uint32_t j = 0; j <= numSlices; j++) {
+            sliceBoundaries[j] = static_cast<float>(
+                static_cast<double>(near) * std::pow(farNear, static_cast<double>(j) / numSlices));
+        }
+        sliceBoundaries.front() = near;
+        sliceBoundaries.back()  = far;
+
+        sliceBoundariesGeneration++;
+    }
+
+    void ZbinBuilder::computeLightSlices(std::span<const structs::viewSpaceLight> lights) {
+        numLights = static_cast<uint32_t>(lights.size());
+        const uint32_t paddedCount =
+            (numLights + LIGHT_BATCH_SIZE - 1u) / LIGHT_BATCH_SIZE * LIGHT_BATCH_SIZE;
+
+        // Padding lanes are estimated but never snapped or binned.
+        lightMinDepth.assign(paddedCount, cachedFar);
+        lightMaxDepth.assign(paddedCount, cachedFar);
+        lightSliceMin.resize(paddedCount);
+        lightSliceMax.resize(paddedCount);
+
+        for (uint32_t i = 0; i < numLights; i++) {
+            lightMinDepth[i] = lights[i].minDepth;
+            lightMaxDepth[i] = lights[i].maxDepth;
+        }
+
+        const float maxSlice = static_cast<float>(sliceBoundaries.size() - 1u);
+
+#ifdef SUMI_ZBIN_SSE
+        const __m128 nearV     = _mm_set1_ps(cachedNear);
+        const __m128 log2NearV = _mm_set1_ps(log2Near);
+        const __m128 scaleV    = _mm_set1_ps(sliceScale);
+        const __m128 maxSliceV = _mm_set1_ps(maxSlice);
+
+        auto estimateSlices = [&](const float* depths, int32_t* slices) {
+            // log2 is only valid for positive depths. Anything in front of the near plane is
+            //  resolved to -1 when snapping.
+            const __m128 z = _mm_max_ps(_mm_loadu_ps(depths), nearV);
+            __m128 slice = _mm_mul_ps(_mm_sub_ps(fastLog2(z), log2NearV), scaleV);
+            slice = _mm_min_ps(_mm_max_ps(slice, _mm_setzero_ps()), maxSliceV);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(slices), _mm_cvttps_epi32(slice));
+        };
+
+        for (uint32_t i = 0; i < paddedCount; i += LIGHT_BATCH_SIZE) {
+            estimateSlices(&lightMinDepth[i], &lightSliceMin[i]);
+            estimateSlices(&lightMaxDepth[i], &lightSliceMax[i]);
+        }
+#else
+        auto estimateSlice = [&](float depth) {
+            const float z = depth > cachedNear ? depth : cachedNear;
+            const float slice = (std::log2(z) - log2Near) * sliceScale;
+            return static_cast<int32_t>(std::clamp(slice, 0.0f, maxSlice));
+        };
+
+        for (uint32_t i = 0; i < numLights; i++) {
+            lightSliceMin[i] = estimateSlice(lightMinDepth[i]);
+            lightSliceMax[i] = estimateSlice(lightMaxDepth[i]);
+        }
+#endif
+
+        for (uint32_t i = 0; i < numLights; i++) {
+            lightSliceMin[i] = snapToSlice(lightMinDepth[i], lightSliceMin[i]);
+            lightSliceMax[i] = snapToSlice(lightMaxDepth[i], lightSliceMax[i]);
+
+            // The binning sweeps rely on min slices being monotonic, which follows from the sort.
+            assert(
+                (i == 0 || lightSliceMin[i] >= lightSliceMin[i - 1]) &&
+                "Lights must be sorted by min view space depth."
+            );
+        }
+    }
+
+    // Corrects an estimated slice index against the boundary table, returning -1 for depths in front
+    //  of the near plane and NUM_SLICES for depths at or beyond the far plane.
+    int32_t ZbinBuilder::snapToSlice(float depth, int32_t estimate) const {
+        const int32_t numSlices = static_cast<int32_t>(sliceBoundaries.size()) - 1;
+
+        int32_t slice = estimate;
+        while (slice < numSlices && depth >= sliceBoundaries[slice + 1]) slice++;
+        while (slice >= 0 && depth < sliceBoundaries[slice]) slice--;
+        return slice;
+    }
+
+    void ZbinBuilder::binLights(int32_t firstSlice, int32_t lastSlice, structs::zBin& zBin) {
+        for (int32_t j = firstSlice; j <= lastSlice; j++) {
+            zBin.data[j].minLightIdx = -1;
+            zBin.data[j].maxLightIdx = -1;
+        }
+
+        // Min: the first light to reach a slice is its min light. As min slices are monotonic, slices
+        //  from the current light's min slice up to the frontier are already covered, so each slice is
+        //  written once. Lights starting past the window (incl. beyond the far plane) end the sweep.
+        int32_t frontier = firstSlice - 1;
+        for (uint32_t i = 0; i < numLights; i++) {
+            if (lightSliceMin[i] > lastSlice) break;
+
+            const int32_t begin = std::max(lightSliceMin[i], frontier + 1);
+            const int32_t end   = std::min(lightSliceMax[i], lastSlice);
+            for (int32_t j = begin; j <= end; j++) {
+                zBin.data[j].minLightIdx = static_cast<int>(i);
+            }
+            frontier = std::max(frontier, end);
+        }
+
+        // Max: lights that have started by slice j are pushed in index order. Lights that have ended
+        //  can never cover a later slice, so they are popped for good and the top is the max light.
+        activeLights.clear();
+        uint32_t nextLight = 0u;
+        for (int32_t j = firstSlice; j <= lastSlice; j++) {
+            while (nextLight < numLights && lightSliceMin[nextLight] <= j) {
+                if (lightSliceMax[nextLight] >= j) activeLights.push_back(static_cast<int32_t>(nextLight));
+                nextLight++;
+            }
+            while (!activeLights.empty() && lightSliceMax[activeLights.back()] < j) {
+                activeLights.pop_back();
+            }
+
+            zBin.data[j].maxLightIdx = activeLights.empty() ? -1 : activeLights.back();
+        }
+    }
+
+    void ZbinBuilder::fillRanges(structs::zBin& zBin) const {
+        const int32_t numSlices = static_cast<int32_t>(zBin.data.size());
+        const int32_t lastSlice = numSlices - 1;
+
+        zBin.firstFullIdx = -1;
+        zBin.lastFullIdx = -1;
+        for (int32_t j = 0; j < numSlices; j++) {
+            if (zBin.data[j].minLightIdx != -1) { zBin.firstFullIdx = j; break; }
+        }
+        for (int32_t j = lastSlice; j >= 0; j--) {
+            if (zBin.data[j].minLightIdx != -1) { zBin.lastFullIdx = j; break; }
+        }
+
+        // Explicit ranges: a full slice combined with its neighbour (next for min, previous for max).
+        auto explicitRangedMin = [&zBin, lastSlice](int32_t j) {
+            const int currIdx = zBin.data[j].minLightIdx;
+            if (j == lastSlice || currIdx == -1) return -1;
+            const int nextIdx = zBin.data[j + 1].minLightIdx;
+            return nextIdx == -1 ? currIdx : std::min(currIdx, nextIdx);
+        };
+        auto explicitRangedMax = [&zBin](int32_t j) {
+            const int currIdx = zBin.data[j].maxLightIdx;
+            if (j == 0 || currIdx == -1) return -1;
+            const int prevIdx = zBin.data[j - 1].maxLightIdx;
+            return prevIdx == -1 ? currIdx : std::max(currIdx, prevIdx);
+        };
+
+        // Implicit ranges (gaps): rMin takes the explicit range of the next populated slice (suffix
+        //  sweep) and rMax that of the previous populated slice (prefix sweep), falling back to the
+        //  max / min light at the ends. Comparisons are unsigned, so an empty zBin (-1) fills rMin
+        //  everywhere and rMax nowhere, as the original two-pass fill did.
+        const uint32_t firstFull = static_cast<uint32_t>(zBin.firstFullIdx);
+        const uint32_t lastFull  = static_cast<uint32_t>(zBin.lastFullIdx);
+        int minIdxCache = zBin.maxLight;
+        int maxIdxCache = zBin.minLight;
+
+        for (int32_t k = 0; k < numSlices; k++) {
+            // rMin
+            const int32_t minPtr = lastSlice - k;
+            int rangedMin = explicitRangedMin(minPtr);
+            if (rangedMin != -1) minIdxCache = rangedMin;
+            else if (static_cast<uint32_t>(minPtr) <= lastFull) rangedMin = minIdxCache;
+            zBin.data[minPtr].rangedMinLightIdx = rangedMin;
+
+            // rMax
+            const int32_t maxPtr = k;
+            int rangedMax = explicitRangedMax(maxPtr);
+            if (rangedMax != -1) maxIdxCache = rangedMax;
+            else if (static_cast<uint32_t>(maxPtr) >= firstFull) rangedMax = maxIdxCache;
+            zBin.data[maxPtr].rangedMaxLightIdx = rangedMax;
+        }
+    }
+
+    void ZbinBuilder::buildReference(
+        const std::vector<int32_t>& sliceMin,
+        const std::vector<int32_t>& sliceMax,
+        uint32_t numLights,
+        structs::zBin& zBin
+    ) {
+        zBin.reset();
+
+        if (numLights == 0) return;
+
+        const int numSlices = static_cast<int>(zBin.data.size());
+
+        // Fill standard zBin
+        for (uint32_t i = 0; i < numLights; i++) {
+            const int minSlice = sliceMin[i];
+            const int maxSlice = sliceMax[i];
+
+            // Set min and max light indices (zBin metadata) when lights are visible
+            if (minSlice < numSlices && maxSlice >= 0) {
+                if (zBin.minLight == -1) zBin.minLight = static_cast<int>(i);
+                zBin.maxLight = static_cast<int>(i);
+            }
+
+            for (int j = minSlice; j <= maxSlice; j++) {
+                // Disregard lights out of zBin range (either behind near plane or beyond far plane)
+                if (j < 0 || j >= numSlices) continue;
+
+                //   min
+                if (zBin.data[j].minLightIdx == -1) zBin.data[j].minLightIdx = i;
+                else zBin.data[j].minLightIdx = std::min<int>(zBin.data[j].minLightIdx, i);
+                //   max
+                zBin.data[j].maxLightIdx = std::max<int>(zBin.data[j].maxLightIdx, i);
+
+                // Fill first / last zBin idx (zBin metadata)
+                //  first
+                if (zBin.firstFullIdx == -1 && j != -1)
+                    zBin.firstFullIdx = j;
+                else
+                    zBin.firstFullIdx = std::min(zBin.firstFullIdx, j);
+                //  last
+                zBin.lastFullIdx = std::max(zBin.lastFullIdx, j);
+            }
+        }
+
+        // Fill ranged zBin
+        const uint32_t lastZbinIdx = static_cast<uint32_t>(numSlices) - 1u;
+        int nextIdx;
+        int currIdx;
+        int prevIdx;
+
+        // First pass - fill in explicit ranges
+        for (uint32_t j = 0; j <= lastZbinIdx; j++) {
+            // rMin
+            if (j != lastZbinIdx) {
+                currIdx = zBin.data[j].minLightIdx;
+                nextIdx = zBin.data[j + 1].minLightIdx;
+
+                if (nextIdx == -1)
+                    nextIdx = zBin.data[j].minLightIdx;
+                if (currIdx != -1)
+                    zBin.data[j].rangedMinLightIdx = std::min(currIdx, nextIdx);
+            }
+
+            // rMax
+            if (j != 0) {
+                currIdx = zBin.data[j].maxLightIdx;
+                prevIdx = zBin.data[j - 1].maxLightIdx;
+
+                if (prevIdx == -1)
+                    prevIdx = zBin.data[j].maxLightIdx;
+                if (currIdx != -1)
+                    zBin.data[j].rangedMaxLightIdx = std::max(currIdx, prevIdx);
+            }
+        }
+
+        // Second pass - fill in implicit ranges (gaps) where indices are still undefined (-1)
+        //   but have prior (in the case of max) or following (in the case of min) lights.
+        int minIdxCache = zBin.maxLight;
+        int maxIdxCache = zBin.minLight;
+
+        uint32_t minPtr;
+        for (uint32_t maxPtr = 0; maxPtr <= lastZbinIdx; maxPtr++) {
+            // rMin
+            minPtr = lastZbinIdx - maxPtr;
+            if (minPtr <= static_cast<uint32_t>(zBin.lastFullIdx)) {
+                int currMinIdx = zBin.data[minPtr].rangedMinLightIdx;
+                if (currMinIdx == -1) {
+                    zBin.data[minPtr].rangedMinLightIdx = minIdxCache;
+                }
+                else if (minPtr == 0 || zBin.data[minPtr - 1].rangedMinLightIdx == -1) {
+                    minIdxCache = currMinIdx;
+                }
+            }
+
+            // rMax
+            if (maxPtr >= static_cast<uint32_t>(zBin.firstFullIdx)) {
+                int currMaxIdx = zBin.data[maxPtr].rangedMaxLightIdx;
+                if (currMaxIdx == -1) {
+                    zBin.data[maxPtr].rangedMaxLightIdx = maxIdxCache;
+                }
+                else if (maxPtr == lastZbinIdx || zBin.data[maxPtr + 1].rangedMaxLightIdx == -1) {
+                    maxIdxCache = currMaxIdx;
+                }
+            }
+        }
+    }
+
+    // Property check: build() must match the reference fill for the same slice ranges, whether the zBin
+    //  was fully rebuilt, incrementally updated or left untouched.
+    uint32_t ZbinBuilder::validate(const structs::zBin& zBin, int* firstMismatch) const {
+        assert(previousValid && "zBin must be built before it can be validated.");
+
+        // build() keeps the ranges it binned as the previous ranges for the next build.
+        structs::zBin reference{ static_cast<uint32_t>(zBin.data.size()) };
+        buildReference(previousSliceMin, previousSliceMax, previousNumLights, reference);
+
+        uint32_t mismatches = 0u;
+        int first = -1;
+        for (size_t j = 0; j < zBin.data.size(); j++) {
+            const structs::zBinData& a = zBin.data[j];
+            const structs::zBinData& b = reference.data[j];
+            const bool match = (
+                a.minLightIdx       == b.minLightIdx       &&
+                a.maxLightIdx       == b.maxLightIdx       &&
+                a.rangedMinLightIdx == b.rangedMinLightIdx &&
+                a.rangedMaxLightIdx == b.rangedMaxLightIdx
+            );
+
+            if (!match) {
+                if (first == -1) first = static_cast<int>(j);
+                mismatches++;
+            }
+        }
+
+        const bool metadataMatches = (
+            zBin.minLight     == reference.minLight     &&
+            zBin.maxLight     == reference.maxLight     &&
+            zBin.firstFullIdx == reference.firstFullIdx &&
+            zBin.lastFullIdx  == reference.lastFullIdx
+        );
+        if (!metadataMatches && mismatches == 0u) mismatches = 1u;
+
+        if (firstMismatch) *firstMismatch = first;
+        return mismatches;
+    }
+
+}
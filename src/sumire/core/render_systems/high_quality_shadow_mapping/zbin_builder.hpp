@@ -0,0 +1,108 @@
+#pragma once
+
+/*
+* CPU zBin generation for phase 1 (prepare) of HQSM.
+*
+* Slice ranges are estimated 4 lights at a time with a fast SIMD log2, then snapped against a
+*  cached table of slice boundary depths so that slice indices are exact and monotonic in depth.
+*  As lights are sorted by min depth, the min / max light index of every slice is resolved in
+*  O(lights + slices) with a frontier sweep (min) and a stack sweep (max) rather than by looping
+*  over each light's full slice span. Ranged indices are then filled with one linear sweep
+*  (suffix for rMin, prefix for rMax).
+*
+* In incremental mode, only the slices covered by lights whose slice range changed since the
+*  previous build are re-binned. If no slice range changed, the zBin is left untouched.
+*
+* The GPU prepare pass snaps to the same boundary table (see prepare_zbin.comp), and validate()
+*  diffs a build against the reference two-pass fill (buildReference()).
+*/
+
+#include <sumire/core/render_systems/high_quality_shadow_mapping/zbin.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/view_space_light.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sumire {
+
+    class ZbinBuilder {
+    public:
+        // Lights converted to slice indices together per SIMD batch.
+        static constexpr uint32_t LIGHT_BATCH_SIZE = 4u;
+
+        ZbinBuilder() = default;
+
+        ZbinBuilder(const ZbinBuilder&) = delete;
+        ZbinBuilder& operator=(const ZbinBuilder&) = delete;
+
+        void setIncremental(bool enabled) { incremental = enabled; }
+        bool isIncremental() const { return incremental; }
+
+        // Forces the next build() to re-bin every slice.
+        void invalidate() { previousValid = false; }
+
+        // Lights MUST be pre-sorted by min view space depth (see sortLightsByViewSpaceDepth()).
+        void build(
+            std::span<const structs::viewSpaceLight> lights,
+            float near, float far,
+            structs::zBin& zBin
+        );
+
+        // Diffs zBin, as left by the last build(), against buildReference() over the same slice ranges.
+        //  Returns the number of mismatching slices, or 1 if only the zBin metadata differs.
+        uint32_t validate(const structs::zBin& zBin, int* firstMismatch = nullptr) const;
+
+        // The original (two pass) zBin fill over per-light slice ranges, kept as a reference for validation.
+        static void buildReference(
+            const std::vector<int32_t>& sliceMin,
+            const std::vector<int32_t>& sliceMax,
+            uint32_t numLights,
+            structs::zBin& zBin
+        );
+
+        // Rebuilds the slice boundary table if near, far or the slice count changed. Called by build(), or
+        //  directly when only the table is needed (GPU prepare).
+        void updateSliceBoundaries(float near, float far, uint32_t numSlices);
+        // numSlices + 1 view space depths. Slice j covers [sliceBoundaries[j], sliceBoundaries[j + 1]).
+        std::span<const float> getSliceBoundaries() const { return sliceBoundaries; }
+        // Advanced whenever the slice boundary table is rebuilt.
+        uint64_t getSliceBoundariesGeneration() const { return sliceBoundariesGeneration; }
+
+    private:
+        void computeLightSlices(std::span<const structs::viewSpaceLight> lights);
+        int32_t snapToSlice(float depth, int32_t estimate) const;
+
+        void binLights(int32_t firstSlice, int32_t lastSlice, structs::zBin& zBin);
+        void fillRanges(structs::zBin& zBin) const;
+
+        bool incremental = false;
+
+        // ---- Slice boundary table -------------------------------------------------------------------------
+        std::vector<float> sliceBoundaries;
+        uint64_t sliceBoundariesGeneration = 0u;
+        float cachedNear = 0.0f;
+        float cachedFar  = 0.0f;
+        float log2Near   = 0.0f;
+        float sliceScale = 0.0f;
+
+        // ---- Per-light slice ranges (padded to LIGHT_BATCH_SIZE) ------------------------------------------
+        //  -1 marks depths in front of the near plane, NUM_SLICES depths beyond the far plane.
+        uint32_t numLights = 0u;
+        std::vector<float> lightMinDepth;
+        std::vector<float> lightMaxDepth;
+        std::vector<int32_t> lightSliceMin;
+        std::vector<int32_t> lightSliceMax;
+
+        // Slice ranges from the previous build, for incremental updates and validation.
+        bool previousValid = false;
+        uint64_t previousBoundariesGeneration = 0u;
+        uint32_t previousNumLights = 0u;
+        std::vector<int32_t> previousSliceMin;
+        std::vector<int32_t> previousSliceMax;
+
+        // Scratch stack of candidate lights for the max sweep.
+        std::vector<int32_t> activeLights;
+    };
+
+}
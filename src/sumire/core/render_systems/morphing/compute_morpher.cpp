@@ -0,0 +1,133 @@
+#include <sumire/core/render_systems/morphing/compute_morpher.hpp>
+#include <sumire/core/render_systems/morphing/compute_morpher_structs.hpp>
+
+#include <sumire/util/sumire_engine_path.hpp>
+#include <sumire/util/vk_check_success.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace sumire {
+
+    // compute_morph_targets.comp reads vertices as a flat float array, compute_morph_targets_compact.comp
+    //  as words, and both read deltas as packed floats.
+    static_assert(sizeof(Vertex) == 25 * sizeof(float), "Compute morphing expects a tightly packed Vertex.");
+    static_assert(sizeof(CompactVertex) == 8 * sizeof(uint32_t), "Compute morphing expects a tightly packed CompactVertex.");
+    static_assert(sizeof(MorphDelta) == 10 * sizeof(float), "Compute morphing expects a tightly packed MorphDelta.");
+
+    ComputeMorpher::ComputeMorpher(SumiDevice& device) : sumiDevice{ device } {
+        morphDescriptorLayout = SumiModel::morphDescriptorLayout(sumiDevice);
+        createPipelineLayout();
+        createPipeline();
+    }
+
+    ComputeMorpher::~ComputeMorpher() {
+        vkDestroyPipelineLayout(sumiDevice.device(), morphPipelineLayout, nullptr);
+    }
+
+    void ComputeMorpher::morph(VkCommandBuffer commandBuffer, int frameIdx, SumiObject::Map& objects) {
+        morphedModels.clear();
+        for (auto& kv : objects) {
+            SumiModel* model = kv.second.model.get();
+            if (model && model->hasMorphTargets()) morphedModels.push_back(model);
+        }
+
+        // Objects can share a model, which only needs morphing once.
+        std::sort(morphedModels.begin(), morphedModels.end());
+        morphedModels.erase(std::unique(morphedModels.begin(), morphedModels.end()), morphedModels.end());
+        if (morphedModels.empty()) return;
+
+        uint32_t nRounds = 0u;
+        for (SumiModel* model : morphedModels) {
+            nRounds = std::max(nRounds, model->prepareMorphTargets(frameIdx));
+        }
+
+        // Compact vertex models are morphed by their own pipeline, so models are recorded grouped by format.
+        std::stable_partition(morphedModels.begin(), morphedModels.end(), [](const SumiModel* model) {
+            return model->getVertexFormat() == VERTEX_FORMAT_FULL;
+        });
+        auto bindPipelineFor = [&](const SumiModel* model) {
+            (model->getVertexFormat() == VERTEX_FORMAT_FULL ? morphPipeline : compactMorphPipeline)->bind(commandBuffer);
+        };
+
+        // Meshes that were morphed last time this frame was recorded still need resetting to the bind pose.
+        bool anyDispatched = false;
+        for (SumiModel* model : morphedModels) {
+            bindPipelineFor(model);
+            anyDispatched |= model->recordMorphReset(commandBuffer, frameIdx, morphPipelineLayout);
+        }
+        if (!anyDispatched) return;
+        recordBarrier(commandBuffer);
+
+        // Targets of a mesh can share vertices, so each round adds at most one target per mesh,
+        //  and rounds are separated by barriers. Meshes of different models never alias.
+        for (uint32_t round = 0; round < nRounds; round++) {
+            for (SumiModel* model : morphedModels) {
+                bindPipelineFor(model);
+                model->recordMorphTargetRound(commandBuffer, frameIdx, morphPipelineLayout, round);
+            }
+            recordBarrier(commandBuffer);
+        }
+
+        // The last barrier also orders the morphed vertices before compute skinning. Visibility to vertex
+        //  input comes from the early graphics submission waiting on pre-draw compute.
+    }
+
+    void ComputeMorpher::recordBarrier(VkCommandBuffer commandBuffer) {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr
+        );
+    }
+
+    void ComputeMorpher::createPipelineLayout() {
+        VkPushConstantRange morphPushRange{};
+        morphPushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        morphPushRange.offset = 0;
+        morphPushRange.size = sizeof(structs::computeMorphPush);
+
+        std::vector<VkDescriptorSetLayout> morphDescriptorSetLayouts{
+            morphDescriptorLayout->getDescriptorSetLayout()
+        };
+
+        VkPipelineLayoutCreateInfo morphPipelineLayoutInfo{};
+        morphPipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        morphPipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(morphDescriptorSetLayouts.size());
+        morphPipelineLayoutInfo.pSetLayouts = morphDescriptorSetLayouts.data();
+        morphPipelineLayoutInfo.pushConstantRangeCount = 1;
+        morphPipelineLayoutInfo.pPushConstantRanges = &morphPushRange;
+
+        VK_CHECK_SUCCESS(
+            vkCreatePipelineLayout(
+                sumiDevice.device(), &morphPipelineLayoutInfo, nullptr, &morphPipelineLayout),
+            "[Sumire::ComputeMorpher] Failed to create morph pipeline layout."
+        );
+    }
+
+    void ComputeMorpher::createPipeline() {
+        assert(morphPipelineLayout != VK_NULL_HANDLE
+            && "Cannot create pipelines when pipeline layout is VK_NULL_HANDLE.");
+
+        morphPipeline = std::make_unique<SumiComputePipeline>(
+            sumiDevice,
+            SUMIRE_ENGINE_PATH("shaders/morphing/compute_morph_targets.comp"),
+            morphPipelineLayout
+        );
+        compactMorphPipeline = std::make_unique<SumiComputePipeline>(
+            sumiDevice,
+            SUMIRE_ENGINE_PATH("shaders/morphing/compute_morph_targets_compact.comp"),
+            morphPipelineLayout
+        );
+    }
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <sumire/core/graphics_pipeline/sumi_device.hpp>
+#include <sumire/core/graphics_pipeline/sumi_compute_pipeline.hpp>
+#include <sumire/core/graphics_pipeline/sumi_descriptors.hpp>
+#include <sumire/core/rendering/general/sumi_object.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace sumire {
+
+    // Applies the weighted morph targets of every morphed model into per frame in flight vertex buffers
+    //  (see SumiModel::prepareMorphTargets). Only vertices that targets move are touched, and only
+    //  targets with non-zero weight are dispatched. Runs ahead of compute skinning, which reads the result.
+    class ComputeMorpher {
+    public:
+        ComputeMorpher(SumiDevice& device);
+        ~ComputeMorpher();
+
+        ComputeMorpher(const ComputeMorpher&) = delete;
+        ComputeMorpher& operator=(const ComputeMorpher&) = delete;
+
+        // Records the morph dispatches of every morphed model for frameIdx. Reads the models' current
+        //  morph weights, so animation for the frame must have finished first.
+        void morph(VkCommandBuffer commandBuffer, int frameIdx, SumiObject::Map& objects);
+
+    private:
+        void createPipelineLayout();
+        void createPipeline();
+        // Orders morph writes before the next compute pass reading or writing the same vertices.
+        void recordBarrier(VkCommandBuffer commandBuffer);
+
+        SumiDevice& sumiDevice;
+
+        std::unique_ptr<SumiDescriptorSetLayout> morphDescriptorLayout;
+
+        std::unique_ptr<SumiComputePipeline> morphPipeline;
+        // For models with compact vertices (see VertexFormat)
+        std::unique_ptr<SumiComputePipeline> compactMorphPipeline;
+        VkPipelineLayout morphPipelineLayout = VK_NULL_HANDLE;
+
+        // Reused between frames so that steady state recording does not allocate.
+        std::vector<SumiModel*> morphedModels;
+    };
+
+}
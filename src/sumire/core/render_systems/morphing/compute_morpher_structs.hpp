@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sumire::structs {
+
+    // Must match local_size_x in shaders/morphing/compute_morph_targets.comp
+    constexpr uint32_t COMPUTE_MORPH_GROUP_SIZE = 64u;
+
+    // Must match the MORPH_MODE constants in shaders/morphing/compute_morph_targets.comp
+    enum ComputeMorphMode : uint32_t {
+        // Restore a mesh's morphed vertices to the bind pose
+        COMPUTE_MORPH_MODE_RESET = 0u,
+        // Add one target's deltas, scaled by its weight
+        COMPUTE_MORPH_MODE_ACCUMULATE = 1u
+    };
+
+    struct computeMorphPush {
+        uint32_t mode;
+        // Range of morph vertex indices (reset) or morph deltas (accumulate)
+        uint32_t first;
+        uint32_t count;
+        float weight;
+        // Offset from model vertex indices to the mesh's morphed vertices (see Mesh::morphedVertexOffset).
+        //  The bind pose is read at model vertex indices.
+        int32_t vertexOffset;
+    };
+
+}
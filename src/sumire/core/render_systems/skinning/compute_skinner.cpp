@@ -0,0 +1,96 @@
+#include <sumire/core/render_systems/skinning/compute_skinner.hpp>
+#include <sumire/core/render_systems/skinning/compute_skinner_structs.hpp>
+
+#include <sumire/util/sumire_engine_path.hpp>
+#include <sumire/util/vk_check_success.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace sumire {
+
+    // compute_skinning.comp reads vertices as a flat float array, and compute_skinning_compact.comp as words.
+    static_assert(sizeof(Vertex) == 25 * sizeof(float), "Compute skinning expects a tightly packed Vertex.");
+    static_assert(sizeof(CompactVertex) == 8 * sizeof(uint32_t), "Compute skinning expects a tightly packed CompactVertex.");
+    static_assert(sizeof(CompactSkinVertex) == 4 * sizeof(uint32_t) && sizeof(CompactSkinVertex8) == 3 * sizeof(uint32_t),
+        "Compute skinning expects tightly packed compact skin vertices.");
+
+    ComputeSkinner::ComputeSkinner(SumiDevice& device) : sumiDevice{ device } {
+        skinningDescriptorLayout = SumiModel::skinningDescriptorLayout(sumiDevice);
+        createPipelineLayout();
+        createPipeline();
+    }
+
+    ComputeSkinner::~ComputeSkinner() {
+        vkDestroyPipelineLayout(sumiDevice.device(), skinningPipelineLayout, nullptr);
+    }
+
+    void ComputeSkinner::skin(VkCommandBuffer commandBuffer, int frameIdx, SumiObject::Map& objects) {
+        skinnedModels.clear();
+        for (auto& kv : objects) {
+            SumiModel* model = kv.second.model.get();
+            if (model && model->hasSkin()) skinnedModels.push_back(model);
+        }
+
+        // Objects can share a model, which only needs skinning once.
+        std::sort(skinnedModels.begin(), skinnedModels.end());
+        skinnedModels.erase(std::unique(skinnedModels.begin(), skinnedModels.end()), skinnedModels.end());
+
+        // Models that have switched skinning mode still need visiting, to update this frame's mesh buffers.
+        //  Compact vertex models are skinned by their own pipeline.
+        skinningPipeline->bind(commandBuffer);
+        for (SumiModel* model : skinnedModels) {
+            if (model->getVertexFormat() == VERTEX_FORMAT_FULL)
+                model->recordSkinning(commandBuffer, frameIdx, skinningPipelineLayout);
+        }
+        compactSkinningPipeline->bind(commandBuffer);
+        for (SumiModel* model : skinnedModels) {
+            if (model->getVertexFormat() != VERTEX_FORMAT_FULL)
+                model->recordSkinning(commandBuffer, frameIdx, skinningPipelineLayout);
+        }
+
+        // No barrier is recorded here: the early graphics submission waits on pre-draw compute at the
+        //  vertex input stage, which makes the skinned vertices visible to the gbuffer fill.
+    }
+
+    void ComputeSkinner::createPipelineLayout() {
+        VkPushConstantRange skinningPushRange{};
+        skinningPushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        skinningPushRange.offset = 0;
+        skinningPushRange.size = sizeof(structs::computeSkinningPush);
+
+        std::vector<VkDescriptorSetLayout> skinningDescriptorSetLayouts{
+            skinningDescriptorLayout->getDescriptorSetLayout()
+        };
+
+        VkPipelineLayoutCreateInfo skinningPipelineLayoutInfo{};
+        skinningPipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        skinningPipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(skinningDescriptorSetLayouts.size());
+        skinningPipelineLayoutInfo.pSetLayouts = skinningDescriptorSetLayouts.data();
+        skinningPipelineLayoutInfo.pushConstantRangeCount = 1;
+        skinningPipelineLayoutInfo.pPushConstantRanges = &skinningPushRange;
+
+        VK_CHECK_SUCCESS(
+            vkCreatePipelineLayout(
+                sumiDevice.device(), &skinningPipelineLayoutInfo, nullptr, &skinningPipelineLayout),
+            "[Sumire::ComputeSkinner] Failed to create skinning pipeline layout."
+        );
+    }
+
+    void ComputeSkinner::createPipeline() {
+        assert(skinningPipelineLayout != VK_NULL_HANDLE
+            && "Cannot create pipelines when pipeline layout is VK_NULL_HANDLE.");
+
+        skinningPipeline = std::make_unique<SumiComputePipeline>(
+            sumiDevice,
+            SUMIRE_ENGINE_PATH("shaders/skinning/compute_skinning.comp"),
+            skinningPipelineLayout
+        );
+        compactSkinningPipeline = std::make_unique<SumiComputePipeline>(
+            sumiDevice,
+            SUMIRE_ENGINE_PATH("shaders/skinning/compute_skinning_compact.comp"),
+            skinningPipelineLayout
+        );
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <sumire/core/graphics_pipeline/sumi_device.hpp>
+#include <sumire/core/graphics_pipeline/sumi_compute_pipeline.hpp>
+#include <sumire/core/graphics_pipeline/sumi_descriptors.hpp>
+#include <sumire/core/rendering/general/sumi_object.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace sumire {
+
+    // Skins the vertices of compute skinned models (see SumiModel::setComputeSkinning) into per frame
+    //  in flight vertex buffers, so that later passes draw posed vertices without per-vertex skinning.
+    //  Models that are not compute skinned keep skinning in the vertex shader.
+    class ComputeSkinner {
+    public:
+        ComputeSkinner(SumiDevice& device);
+        ~ComputeSkinner();
+
+        ComputeSkinner(const ComputeSkinner&) = delete;
+        ComputeSkinner& operator=(const ComputeSkinner&) = delete;
+
+        // Records the skinning dispatches of every skinned model for frameIdx. Reads this frame's joint
+        //  palettes, so animation for the frame must have been written first.
+        void skin(VkCommandBuffer commandBuffer, int frameIdx, SumiObject::Map& objects);
+
+    private:
+        void createPipelineLayout();
+        void createPipeline();
+
+        SumiDevice& sumiDevice;
+
+        std::unique_ptr<SumiDescriptorSetLayout> skinningDescriptorLayout;
+
+        std::unique_ptr<SumiComputePipeline> skinningPipeline;
+        // For models with compact vertices (see VertexFormat)
+        std::unique_ptr<SumiComputePipeline> compactSkinningPipeline;
+        VkPipelineLayout skinningPipelineLayout = VK_NULL_HANDLE;
+
+        // Reused between frames so that steady state recording does not allocate.
+        std::vector<SumiModel*> skinnedModels;
+    };
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sumire::structs {
+
+    // Must match local_size_x in shaders/skinning/compute_skinning.comp
+    constexpr uint32_t COMPUTE_SKINNING_GROUP_SIZE = 64u;
+
+    struct computeSkinningPush {
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+        int32_t jointFormat;
+        // Joint index width of compact skin vertices, 8 or 16 (see CompactSkinVertex). Unused for full vertices.
+        uint32_t skinJointBits;
+        // Offsets from model vertex indices to the vertices read as the bind pose, and written skinned
+        //  (see Mesh::skinnedVertexOffset). Compact skin vertices are read at model vertex indices.
+        int32_t bindPoseOffset;
+        int32_t skinnedOffset;
+    };
+
+}
@@ -66,6 +66,7 @@ namespace sumire {
             bot / zoom, top / zoom,
             nearPlane, farPlane
         );
+        projectionVersion++;
     }
     
     void SumiCamera::setPerspectiveProjection(float fovy, float aspect) {
@@ -77,6 +78,7 @@ namespace sumire {
             fovy, aspect, 
             nearPlane, farPlane
         );
+        projectionVersion++;
     }
 
     void SumiCamera::setNear(float dist, bool recomputeProjMatrix) {
@@ -157,19 +159,21 @@ namespace sumire {
         const glm::vec3 u{glm::normalize(glm::cross(w, up))};
         const glm::vec3 v{glm::cross(w, u)};
 
-        viewMatrix = glm::mat4{1.0};
-        viewMatrix[0][0] = u.x;
-        viewMatrix[1][0] = u.y;
-        viewMatrix[2][0] = u.z;
-        viewMatrix[0][1] = v.x;
-        viewMatrix[1][1] = v.y;
-        viewMatrix[2][1] = v.z;
-        viewMatrix[0][2] = w.x;
-        viewMatrix[1][2] = w.y;
-        viewMatrix[2][2] = w.z;
-        viewMatrix[3][0] = -glm::dot(u, pos);
-        viewMatrix[3][1] = -glm::dot(v, pos);
-        viewMatrix[3][2] = -glm::dot(w, pos);
+        glm::mat4 view{1.0};
+        view[0][0] = u.x;
+        view[1][0] = u.y;
+        view[2][0] = u.z;
+        view[0][1] = v.x;
+        view[1][1] = v.y;
+        view[2][1] = v.z;
+        view[0][2] = w.x;
+        view[1][2] = w.y;
+        view[2][2] = w.z;
+        view[3][0] = -glm::dot(u, pos);
+        view[3][1] = -glm::dot(v, pos);
+        view[3][2] = -glm::dot(w, pos);
+
+        setViewMatrix(view);
     }
 
     void SumiCamera::setViewTarget(glm::vec3 pos, glm::vec3 target, glm::vec3 up) {
@@ -186,22 +190,30 @@ namespace sumire {
         const glm::vec3 u{(c1 * c3 + s1 * s2 * s3), (c2 * s3), (c1 * s2 * s3 - c3 * s1)};
         const glm::vec3 v{(c3 * s1 * s2 - c1 * s3), (c2 * c3), (c1 * c3 * s2 + s1 * s3)};
         const glm::vec3 w{(c2 * s1), (-s2), (c1 * c2)};
-        viewMatrix = glm::mat4{1.f};
-        viewMatrix[0][0] = u.x;
-        viewMatrix[1][0] = u.y;
-        viewMatrix[2][0] = u.z;
-        viewMatrix[0][1] = v.x;
-        viewMatrix[1][1] = v.y;
-        viewMatrix[2][1] = v.z;
-        viewMatrix[0][2] = w.x;
-        viewMatrix[1][2] = w.y;
-        viewMatrix[2][2] = w.z;
-        viewMatrix[3][0] = -glm::dot(u, pos);
-        viewMatrix[3][1] = -glm::dot(v, pos);
-        viewMatrix[3][2] = -glm::dot(w, pos);
+        glm::mat4 view{1.f};
+        view[0][0] = u.x;
+        view[1][0] = u.y;
+        view[2][0] = u.z;
+        view[0][1] = v.x;
+        view[1][1] = v.y;
+        view[2][1] = v.z;
+        view[0][2] = w.x;
+        view[1][2] = w.y;
+        view[2][2] = w.z;
+        view[3][0] = -glm::dot(u, pos);
+        view[3][1] = -glm::dot(v, pos);
+        view[3][2] = -glm::dot(w, pos);
 
         // TODO: It may be possible to elimite this matrix calculation with better linear algebra :P
-        viewMatrix = orthonormalBasis * viewMatrix;
+        setViewMatrix(orthonormalBasis * view);
+    }
+
+    void SumiCamera::setViewMatrix(const glm::mat4& view) {
+        // The view is rebuilt every frame, so only count changes that actually moved it.
+        if (view == viewMatrix) return;
+
+        viewMatrix = view;
+        viewVersion++;
     }
 
     void SumiCamera::setCameraType(SmCameraType projType, bool recomputeProjMatrix) {
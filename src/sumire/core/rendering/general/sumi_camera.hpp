@@ -4,7 +4,9 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
-#include <sumire/core/rendering/general/sumi_object.hpp>
+#include <cstdint>
+
+#include <sumire/core/rendering/general/sumi_transform3d.hpp>
 
 namespace sumire {
 
@@ -99,7 +101,12 @@ namespace sumire {
         void setViewYXZ(glm::vec3 pos, glm::vec3 rot);
 
         const glm::mat4& getProjectionMatrix() const { return projectionMatrix; }
+        // Incremented every time the projection matrix is rebuilt, so dependents can
+        //  cache data derived from it (e.g. tile frusta) without comparing matrices.
+        uint64_t getProjectionVersion() const { return projectionVersion; }
         const glm::mat4& getViewMatrix() const { return viewMatrix; }
+        // Incremented only when a setView* call actually changes the view matrix.
+        uint64_t getViewVersion() const { return viewVersion; }
 
         SmCameraType getCameraType() const { return camType; }
         void setCameraType(SmCameraType projType, bool recomputeProjMatrix = false);
@@ -111,8 +118,12 @@ namespace sumire {
         bool projMatrixNeedsUpdate{ true };
 
     private:
+        void setViewMatrix(const glm::mat4& view);
+
         glm::mat4 projectionMatrix{ 1.0f };
+        uint64_t projectionVersion{ 0 };
         glm::mat4 viewMatrix{ 1.0f };
+        uint64_t viewVersion{ 0 };
         glm::mat4 orthonormalBasis{ 1.0f };
 
         // Camera properties
@@ -2,7 +2,7 @@
 
 #include <sumire/core/rendering/general/sumi_camera.hpp>
 #include <sumire/core/rendering/general/sumi_object.hpp>
-#include <sumire/core/rendering/lighting/sumi_light.hpp>
+#include <sumire/core/rendering/lighting/sumi_light_store.hpp>
 
 #include <vulkan/vulkan.h>
 
@@ -15,7 +15,7 @@ namespace sumire {
         SumiCamera &camera;
         VkDescriptorSet globalDescriptorSet;
         SumiObject::Map &objects;
-        SumiLight::Map &lights;
+        SumiLightStore &lights;
     };
 
 }
\ No newline at end of file
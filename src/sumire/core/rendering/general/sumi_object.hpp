@@ -27,6 +27,8 @@ namespace sumire {
 
         const id_t getId() { return id; }
 
+        // Objects sharing a model also share its pose. Use SumiModel::createInstance() for independently
+        //  animated objects, which only duplicates per instance state.
         std::shared_ptr<SumiModel> model{};
         glm::vec3 colour{};
         Transform3DComponent transform{};
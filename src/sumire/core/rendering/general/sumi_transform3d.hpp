@@ -2,6 +2,8 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cstdint>
+
 class Transform3DComponent {
 
     public:
@@ -9,23 +11,29 @@ class Transform3DComponent {
         glm::vec3 getScale() const { return scale; }
         glm::vec3 getRotation() const { return rotation; }
 
+        // Incremented whenever translation, scale or rotation change, for dirty tracking.
+        uint64_t getVersion() const { return version; }
+
         void setTranslation(glm::vec3 translation) { 
             if (this->translation == translation) return;
 
             this->translation = translation;
             needsCacheUpdate = true;
+            version++;
         }
         void setScale(glm::vec3 scale) {
             if (this->scale == scale) return;
 
             this->scale = scale;
             needsCacheUpdate = true;
+            version++;
         }
         void setRotation(glm::vec3 rotation) {
             if (this->rotation == rotation) return;
 
             this->rotation = rotation;
             needsCacheUpdate = true;
+            version++;
         }
 
         glm::mat4 normalMatrix() {
@@ -46,6 +54,7 @@ class Transform3DComponent {
         glm::mat4 cachedModelMatrix{1.0f};
         glm::mat4 cachedNormalMatrix{1.0f};
         bool needsCacheUpdate = true;
+        uint64_t version = 0u;
 
         void calculateCacheMatrices() {
 
@@ -32,34 +32,4 @@ namespace sumire {
         return light;
     }
 
-    SumiLight::LightShaderData SumiLight::getShaderData() {
-        float lightAngleScale = 0;
-        float lightAngleOffset = 0;
-        coneToLightAngle(innerConeAngle, outerConeAngle, lightAngleScale, lightAngleOffset);
-
-        glm::vec3 direction = glm::mat3(transform.modelMatrix()) * glm::vec3(0.0, 0.0, 1.0);
-
-        return LightShaderData{
-            color,
-            transform.getTranslation(),
-            direction,
-            static_cast<uint32_t>(type),
-            range,
-            lightAngleScale,
-            lightAngleOffset
-        };
-    }
-
-    void SumiLight::coneToLightAngle(
-        float innerConeAngle, float outerConeAngle, 
-        float &lightAngleScale, float &lightAngleOffset
-    ) {
-        float cosInner = glm::cos(innerConeAngle);
-        float cosOuter = glm::cos(outerConeAngle);
-
-        //https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_lights_punctual/README.md#inner-and-outer-cone-angles
-        lightAngleScale  = 1.0f / glm::max(0.001f, cosInner - cosOuter);
-        lightAngleOffset = -cosOuter * lightAngleScale;
-    }
-
 }
\ No newline at end of file
@@ -5,17 +5,17 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 
+#include <cstdint>
 #include <string>
-#include <map>
 
 namespace sumire {
 
+    // Description of a light to add to the scene. Live light data is held by SumiLightStore,
+    //  which copies the light in on add().
     class SumiLight {
         public:
             using id_t = uint32_t;
             static id_t nextId;
-            // SumiLight map is *ordered* so that it can be used to form a SSBO.
-            using Map = std::map<id_t, SumiLight>;
 
             enum Type {
                 // AMBIENT ? 
@@ -44,8 +44,9 @@ namespace sumire {
                 alignas(4)  float range; // PUNCTUAL_POINT, PUNCTUAL_SPOT
                 alignas(4)  float lightAngleScale; // PUNCTUAL_SPOT
                 alignas(4)  float lightAngleOffset; // PUNCTUAL_SPOT
+
+                bool operator==(const LightShaderData&) const = default;
             };
-            LightShaderData getShaderData();
 
             // Internal Data
             std::string name = "Unnamed Light";
@@ -63,12 +64,6 @@ namespace sumire {
                 name = "Unnamed Light " + std::to_string(id);
             };
 
-            void coneToLightAngle(
-                float innerConeAngle, float outerConeAngle, 
-                float &lightAngleScale, float &lightAngleOffset
-            );
-
             id_t id;
-        
     };
 }
\ No newline at end of file
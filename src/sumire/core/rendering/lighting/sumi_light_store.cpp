@@ -0,0 +1,191 @@
+#include <sumire/core/rendering/lighting/sumi_light_store.hpp>
+
+#include <cassert>
+
+namespace sumire {
+
+    SumiLight::id_t SumiLightStore::add(const SumiLight& light) {
+        const SumiLight::id_t id = light.getId();
+        assert(slotOf(id) == INVALID_SLOT && "Light is already in the store");
+
+        const glm::vec3 position = light.transform.getTranslation();
+        const glm::vec3 rotation = light.transform.getRotation();
+
+        positionsX.push_back(position.x);
+        positionsY.push_back(position.y);
+        positionsZ.push_back(position.z);
+        ranges.push_back(light.range);
+        colors.push_back(light.color);
+        types.push_back(light.type);
+        directions.push_back(rotationToDirection(rotation));
+        innerConeAngles.push_back(light.innerConeAngle);
+        outerConeAngles.push_back(light.outerConeAngle);
+        slotVersions.push_back(0u);
+        rotations.push_back(rotation);
+        names.push_back(light.name);
+        ids.push_back(id);
+
+        if (id >= idToSlot.size()) idToSlot.resize(id + 1u, INVALID_SLOT);
+        idToSlot[id] = size() - 1u;
+
+        layoutVersion++;
+        markChanged(size() - 1u);
+        return id;
+    }
+
+    bool SumiLightStore::remove(SumiLight::id_t id) {
+        const uint32_t slot = slotOf(id);
+        if (slot == INVALID_SLOT) return false;
+
+        // Swap-remove: the last light fills the hole.
+        const uint32_t last = size() - 1u;
+        if (slot != last) {
+            moveSlot(last, slot);
+            markChanged(slot);
+        }
+        idToSlot[id] = INVALID_SLOT;
+
+        positionsX.pop_back();
+        positionsY.pop_back();
+        positionsZ.pop_back();
+        ranges.pop_back();
+        colors.pop_back();
+        types.pop_back();
+        directions.pop_back();
+        innerConeAngles.pop_back();
+        outerConeAngles.pop_back();
+        slotVersions.pop_back();
+        rotations.pop_back();
+        names.pop_back();
+        ids.pop_back();
+
+        layoutVersion++;
+        version++;
+        return true;
+    }
+
+    void SumiLightStore::clear() {
+        positionsX.clear();
+        positionsY.clear();
+        positionsZ.clear();
+        ranges.clear();
+        colors.clear();
+        types.clear();
+        directions.clear();
+        innerConeAngles.clear();
+        outerConeAngles.clear();
+        slotVersions.clear();
+        rotations.clear();
+        names.clear();
+        ids.clear();
+        idToSlot.clear();
+
+        layoutVersion++;
+        version++;
+    }
+
+    SumiLight::LightShaderData SumiLightStore::getShaderData(uint32_t slot) const {
+        // https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_lights_punctual/README.md#inner-and-outer-cone-angles
+        const float cosInner = glm::cos(innerConeAngles[slot]);
+        const float cosOuter = glm::cos(outerConeAngles[slot]);
+        const float lightAngleScale  = 1.0f / glm::max(0.001f, cosInner - cosOuter);
+        const float lightAngleOffset = -cosOuter * lightAngleScale;
+
+        return SumiLight::LightShaderData{
+            colors[slot],
+            getPosition(slot),
+            directions[slot],
+            static_cast<uint32_t>(types[slot]),
+            ranges[slot],
+            lightAngleScale,
+            lightAngleOffset
+        };
+    }
+
+    void SumiLightStore::setPosition(uint32_t slot, glm::vec3 position) {
+        if (getPosition(slot) == position) return;
+
+        positionsX[slot] = position.x;
+        positionsY[slot] = position.y;
+        positionsZ[slot] = position.z;
+        markChanged(slot);
+    }
+
+    void SumiLightStore::setRotation(uint32_t slot, glm::vec3 rotation) {
+        if (rotations[slot] == rotation) return;
+
+        rotations[slot]  = rotation;
+        directions[slot] = rotationToDirection(rotation);
+        markChanged(slot);
+    }
+
+    void SumiLightStore::setColor(uint32_t slot, glm::vec4 color) {
+        if (colors[slot] == color) return;
+
+        colors[slot] = color;
+        markChanged(slot);
+    }
+
+    void SumiLightStore::setRange(uint32_t slot, float range) {
+        if (ranges[slot] == range) return;
+
+        ranges[slot] = range;
+        markChanged(slot);
+    }
+
+    void SumiLightStore::setType(uint32_t slot, SumiLight::Type type) {
+        if (types[slot] == type) return;
+
+        types[slot] = type;
+        markChanged(slot);
+    }
+
+    void SumiLightStore::setConeAngles(uint32_t slot, float innerConeAngle, float outerConeAngle) {
+        if (innerConeAngles[slot] == innerConeAngle && outerConeAngles[slot] == outerConeAngle) return;
+
+        innerConeAngles[slot] = innerConeAngle;
+        outerConeAngles[slot] = outerConeAngle;
+        markChanged(slot);
+    }
+
+    void SumiLightStore::collectChangedSince(uint64_t sinceVersion, std::vector<uint64_t>& changedSlots) const {
+        changedSlots.assign((size() + 63u) / 64u, 0u);
+
+        for (uint32_t slot = 0; slot < size(); slot++) {
+            if (slotVersions[slot] > sinceVersion) changedSlots[slot / 64u] |= uint64_t{ 1 } << (slot % 64u);
+        }
+    }
+
+    void SumiLightStore::markChanged(uint32_t slot) {
+        slotVersions[slot] = ++version;
+    }
+
+    void SumiLightStore::moveSlot(uint32_t from, uint32_t to) {
+        positionsX[to]      = positionsX[from];
+        positionsY[to]      = positionsY[from];
+        positionsZ[to]      = positionsZ[from];
+        ranges[to]          = ranges[from];
+        colors[to]          = colors[from];
+        types[to]           = types[from];
+        directions[to]      = directions[from];
+        innerConeAngles[to] = innerConeAngles[from];
+        outerConeAngles[to] = outerConeAngles[from];
+        slotVersions[to]    = slotVersions[from];
+        rotations[to]       = rotations[from];
+        names[to]           = std::move(names[from]);
+        ids[to]             = ids[from];
+
+        idToSlot[ids[to]] = to;
+    }
+
+    // Forward (+z) axis of the YXZ Tait-Bryan rotation used by Transform3DComponent.
+    glm::vec3 SumiLightStore::rotationToDirection(glm::vec3 rotation) {
+        const float c2 = glm::cos(rotation.x);
+        const float s2 = glm::sin(rotation.x);
+        const float c1 = glm::cos(rotation.y);
+        const float s1 = glm::sin(rotation.y);
+
+        return glm::vec3{ c2 * s1, -s2, c1 * c2 };
+    }
+
+}
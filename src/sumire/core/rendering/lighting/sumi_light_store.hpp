@@ -0,0 +1,114 @@
+#pragma once
+
+#include <sumire/core/rendering/lighting/sumi_light.hpp>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sumire {
+
+    // Dense structure-of-arrays storage for the scene lights.
+    //
+    //  Lights occupy slots [0, size()), with each property in its own array so per-frame passes
+    //  (view transform, sort, cull, SSBO packing) read memory linearly. Ids map to slots through a
+    //  stable indirection; removal swap-removes the last slot into the hole, so add and remove are O(1)
+    //  but slot order is not stable across removals (see getLayoutVersion()).
+    //
+    //  All writes go through setters which skip unchanged values, and stamp the slot with the store
+    //  version so consumers can find what changed since they last looked (see collectChangedSince()).
+    class SumiLightStore {
+    public:
+        static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+        SumiLightStore() = default;
+
+        SumiLightStore(const SumiLightStore&) = delete;
+        SumiLightStore& operator=(const SumiLightStore&) = delete;
+
+        SumiLight::id_t add(const SumiLight& light);
+        bool remove(SumiLight::id_t id);
+        void clear();
+
+        uint32_t size() const { return static_cast<uint32_t>(ids.size()); }
+        bool empty() const { return ids.empty(); }
+
+        uint32_t slotOf(SumiLight::id_t id) const {
+            return id < idToSlot.size() ? idToSlot[id] : INVALID_SLOT;
+        }
+        SumiLight::id_t idAt(uint32_t slot) const { return ids[slot]; }
+
+        // ---- SoA views, indexed by slot --------------------------------------------------------------------
+        std::span<const float> getPositionsX() const { return positionsX; }
+        std::span<const float> getPositionsY() const { return positionsY; }
+        std::span<const float> getPositionsZ() const { return positionsZ; }
+        std::span<const float> getRanges() const { return ranges; }
+
+        glm::vec3 getPosition(uint32_t slot) const {
+            return glm::vec3{ positionsX[slot], positionsY[slot], positionsZ[slot] };
+        }
+        glm::vec3 getRotation(uint32_t slot) const { return rotations[slot]; }
+        glm::vec4 getColor(uint32_t slot) const { return colors[slot]; }
+        float getRange(uint32_t slot) const { return ranges[slot]; }
+        SumiLight::Type getType(uint32_t slot) const { return types[slot]; }
+        float getInnerConeAngle(uint32_t slot) const { return innerConeAngles[slot]; }
+        float getOuterConeAngle(uint32_t slot) const { return outerConeAngles[slot]; }
+        const std::string& getName(uint32_t slot) const { return names[slot]; }
+
+        SumiLight::LightShaderData getShaderData(uint32_t slot) const;
+
+        // ---- Setters ---------------------------------------------------------------------------------------
+        void setPosition(uint32_t slot, glm::vec3 position);
+        void setRotation(uint32_t slot, glm::vec3 rotation);
+        void setColor(uint32_t slot, glm::vec4 color);
+        void setRange(uint32_t slot, float range);
+        void setType(uint32_t slot, SumiLight::Type type);
+        void setConeAngles(uint32_t slot, float innerConeAngle, float outerConeAngle);
+        void setName(uint32_t slot, std::string name) { names[slot] = std::move(name); }
+
+        // ---- Change tracking -------------------------------------------------------------------------------
+        // Advances on every change to the store, including adds and removes.
+        uint64_t getVersion() const { return version; }
+        // Advances whenever slots are added, removed or moved, i.e. when slot indices are invalidated.
+        uint64_t getLayoutVersion() const { return layoutVersion; }
+        // Store version at which the slot was last written.
+        uint64_t getSlotVersion(uint32_t slot) const { return slotVersions[slot]; }
+
+        // Fills a bitset (bit s of word s / 64) of the slots written after the given store version.
+        void collectChangedSince(uint64_t sinceVersion, std::vector<uint64_t>& changedSlots) const;
+
+    private:
+        void markChanged(uint32_t slot);
+        void moveSlot(uint32_t from, uint32_t to);
+
+        static glm::vec3 rotationToDirection(glm::vec3 rotation);
+
+        // Hot, per-frame data
+        std::vector<float> positionsX;
+        std::vector<float> positionsY;
+        std::vector<float> positionsZ;
+        std::vector<float> ranges;
+        std::vector<glm::vec4> colors;
+        std::vector<SumiLight::Type> types;
+        std::vector<glm::vec3> directions;
+        std::vector<float> innerConeAngles;
+        std::vector<float> outerConeAngles;
+        std::vector<uint64_t> slotVersions;
+
+        // Cold data
+        std::vector<glm::vec3> rotations;
+        std::vector<std::string> names;
+
+        std::vector<SumiLight::id_t> ids;
+        // Light ids are allocated sequentially, so the id -> slot indirection is a flat array.
+        std::vector<uint32_t> idToSlot;
+
+        uint64_t version = 0u;
+        uint64_t layoutVersion = 0u;
+    };
+
+}
@@ -0,0 +1,34 @@
+#include <sumire/core/rendering/lighting/sumi_light_tracker.hpp>
+
+namespace sumire {
+
+    bool SumiLightTracker::update(const SumiLightStore& lights, const SumiCamera& camera) {
+        // Both states are always refreshed so the next comparison is against this frame.
+        const bool lightsChanged = lights.getVersion() != lightsVersion;
+        lightsVersion = lights.getVersion();
+        const bool cameraChanged = updateCameraState(camera);
+
+        const bool changed = lightsChanged || cameraChanged || forceChange;
+        forceChange = false;
+
+        if (changed) generation++;
+        return changed;
+    }
+
+    bool SumiLightTracker::updateCameraState(const SumiCamera& camera) {
+        const bool changed = (
+            camera.getViewVersion()       != viewVersion       ||
+            camera.getProjectionVersion() != projectionVersion ||
+            camera.getNear()              != near              ||
+            camera.getFar()               != far
+        );
+
+        viewVersion       = camera.getViewVersion();
+        projectionVersion = camera.getProjectionVersion();
+        near              = camera.getNear();
+        far               = camera.getFar();
+
+        return changed;
+    }
+
+}
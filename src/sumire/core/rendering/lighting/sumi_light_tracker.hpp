@@ -0,0 +1,45 @@
+#pragma once
+
+#include <sumire/core/rendering/lighting/sumi_light_store.hpp>
+#include <sumire/core/rendering/general/sumi_camera.hpp>
+
+#include <cstdint>
+
+namespace sumire {
+
+    // Dirty tracking for per-frame light preparation (light sort, HQSM prepare, light SSBO writes).
+    //  Each update() compares the light store and camera view / projection versions against those seen
+    //  by the previous call, and advances a generation counter if anything relevant changed.
+    //  Per-frame resources can then store the generation they were last built from and be skipped
+    //  (or patched) while it is current.
+    class SumiLightTracker {
+    public:
+        SumiLightTracker() = default;
+
+        SumiLightTracker(const SumiLightTracker&) = delete;
+        SumiLightTracker& operator=(const SumiLightTracker&) = delete;
+
+        // Returns true if anything changed, in which case the generation has been advanced.
+        bool update(const SumiLightStore& lights, const SumiCamera& camera);
+
+        // Forces the next update() to report a change, e.g. after a screen resize.
+        void invalidate() { forceChange = true; }
+
+        // Generation 0 is never current, so resources can use it to mark themselves as unwritten.
+        uint64_t getGeneration() const { return generation; }
+
+    private:
+        bool updateCameraState(const SumiCamera& camera);
+
+        // Light store version seen by the previous update(). Any add, remove or edit advances it.
+        uint64_t lightsVersion = 0u;
+        uint64_t viewVersion = 0u;
+        uint64_t projectionVersion = 0u;
+        float near = 0.0f;
+        float far = 0.0f;
+
+        bool forceChange = true;
+        uint64_t generation = 0u;
+    };
+
+}
@@ -849,7 +849,9 @@ namespace sumire {
         );
 
         // Submit early graphics
-        VkPipelineStageFlags earlyGraphicsWaitStageFlag = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        //  Vertex input waits too, as pre-draw compute writes the skinned vertex buffers.
+        VkPipelineStageFlags earlyGraphicsWaitStageFlag = 
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         VkSubmitInfo earlyGraphicsSubmitInfo{};
         earlyGraphicsSubmitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         earlyGraphicsSubmitInfo.commandBufferCount   = 1;
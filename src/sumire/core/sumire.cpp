@@ -21,11 +21,6 @@
    if ((profiler)) (profiler)->endBlock((cmdBuffer), (blockName)); \
 
 #include <sumire/core/profiling/cpu_profiler.hpp>
-#define BEGIN_CPU_PROFILING_BLOCK(profiler, blockName)  \
-   if ((profiler)) (profiler)->beginBlock((blockName)); \
-
-#define END_CPU_PROFILING_BLOCK(profiler, blockName)  \
-   if ((profiler)) (profiler)->endBlock((blockName)); \
 
 // glmw
 #define GLM_FORCE_RADIANS
@@ -74,45 +69,25 @@ namespace sumire {
     }
 
     void Sumire::initBuffers() {
-        // ---- Global Descriptor Set ----------------------------------------------------------------------------
-        // Uniform Buffers
-        globalUniformBuffers = std::vector<std::unique_ptr<SumiBuffer>>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
-        cameraUniformBuffers = std::vector<std::unique_ptr<SumiBuffer>>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
-        for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        // ---- Global Descriptor Set & Light SSBOs --------------------------------------------------------------
+        //   One ring region per frame in flight, holding that frame's uniform buffers and light SSBO.
+        const VkBufferUsageFlags uploadUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        const VkDeviceSize lightSSBOsize =
+            sumiConfig.runtimeData.graphics.internal.MAX_N_LIGHTS * sizeof(SumiLight::LightShaderData);
 
-            // Global uniforms
-            globalUniformBuffers[i] = std::make_unique<SumiBuffer>(
-                sumiDevice,
-                sizeof(GlobalUBO),
-                1,
-                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-            );
-            globalUniformBuffers[i]->map(); //enable writing to buffer memory
-
-            // Camera uniforms
-            cameraUniformBuffers[i] = std::make_unique<SumiBuffer>(
-                sumiDevice,
-                sizeof(CameraUBO),
-                1,
-                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-            );
-            cameraUniformBuffers[i]->map(); //enable writing to buffer memory
-        }
+        frameUploadRing = std::make_unique<SumiUploadRing>(
+            sumiDevice,
+            SumiUploadRing::frameSizeFor(
+                sumiDevice, uploadUsage, { sizeof(GlobalUBO), sizeof(CameraUBO), lightSSBOsize }),
+            SumiSwapChain::MAX_FRAMES_IN_FLIGHT,
+            uploadUsage
+        );
 
-        // ---- Light SSBOs --------------------------------------------------------------------------------------
-        lightSSBOs = std::vector<std::unique_ptr<SumiBuffer>>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
+        frameUploads = std::vector<FrameUploads>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
         for (int i = 0; i < SumiSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-            lightSSBOs[i] = std::make_unique<SumiBuffer>(
-                sumiDevice,
-                sumiConfig.runtimeData.graphics.internal.MAX_N_LIGHTS * sizeof(SumiLight::LightShaderData),
-                1,
-                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-            );
-            lightSSBOs[i]->map();
+            allocateFrameUploads(static_cast<uint32_t>(i));
         }
+        lightSSBOGenerations = std::vector<uint64_t>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT, 0u);
     }
 
     void Sumire::initDescriptors() {
@@ -132,9 +107,9 @@ namespace sumire {
         // Write Descriptor Sets
         globalDescriptorSets = std::vector<VkDescriptorSet>(SumiSwapChain::MAX_FRAMES_IN_FLIGHT);
         for (int i = 0; i < globalDescriptorSets.size(); i++) {
-            auto globalBufferInfo = globalUniformBuffers[i]->descriptorInfo();
-            auto cameraBufferInfo = cameraUniformBuffers[i]->descriptorInfo();
-            auto lightSSBOinfo = lightSSBOs[i]->descriptorInfo();
+            auto globalBufferInfo = frameUploadRing->descriptorInfo(frameUploads[i].global);
+            auto cameraBufferInfo = frameUploadRing->descriptorInfo(frameUploads[i].camera);
+            auto lightSSBOinfo = frameUploadRing->descriptorInfo(frameUploads[i].lights);
             SumiDescriptorWriter(*globalDescriptorSetLayout, *globalDescriptorPool)
                 .writeBuffer(0, &globalBufferInfo)
                 .writeBuffer(1, &cameraBufferInfo)
@@ -168,15 +143,27 @@ namespace sumire {
             sumiRenderer.getHZB()
         );
 
+        HQSMprepareMode hqsmPrepareMode = HQSM_PREPARE_CPU;
+        if (sumiConfig.startupData.graphics.internal.GPU_HQSM_PREPARE) {
+            hqsmPrepareMode = sumiConfig.startupData.graphics.internal.VALIDATE_GPU_HQSM_PREPARE ?
+                HQSM_PREPARE_GPU_VALIDATED : HQSM_PREPARE_GPU;
+        }
+
         shadowMapper = std::make_unique<HighQualityShadowMapper>(
             sumiDevice,
             screenWidth, screenHeight,
             sumiRenderer.getHZB(),
             sumiRenderer.getSwapChain()->getDepthAttachment(),
             sumiRenderer.getGbuffer()->positionAttachment(),
-            globalDescriptorSetLayout->getDescriptorSetLayout()
+            globalDescriptorSetLayout->getDescriptorSetLayout(),
+            sumiConfig.runtimeData.graphics.internal.MAX_N_LIGHTS,
+            &threadPool,
+            hqsmPrepareMode
         );
 
+        computeMorpher = std::make_unique<ComputeMorpher>(sumiDevice);
+        computeSkinner = std::make_unique<ComputeSkinner>(sumiDevice);
+
         postProcessor = std::make_unique<PostProcessor>(
             sumiDevice,
             sumiRenderer.getIntermediateColorAttachments(),
@@ -241,6 +228,9 @@ namespace sumire {
                 //       or else we will never have query results available.
                 gpuProfiler = GpuProfiler::Builder(sumiDevice)
                     .addBlock("0-- Predraw Compute")
+                    .addBlock("0-0: HQSM Prepare")
+                    .addBlock("0-1: Compute Morph Targets")
+                    .addBlock("0-2: Compute Skinning")
                     .addBlock("1-- Early Graphics")
                     .addBlock("2-- Early Compute")
                     .addBlock("2-0: HZB building")
@@ -258,11 +248,22 @@ namespace sumire {
         if (sumiConfig.startupData.profiling.CPU_PROFILING) {
             cpuProfiler = CpuProfiler::Builder()
                 .addBlock("0: Shadow Map Prepare")
+                .addBlock("0-0: zBin Generation")
+                .addBlock("0-1: Light Mask Generation")
+                .addBlock("0-2: Prepared Lights Upload")
+                .addBlock("0-3: GPU Prepare Validation")
+                .addBlock("0-4: Light Sort")
+                .addBlock("0-5: Frame Buffers Upload")
+                .addBlock("1: Animation Update Submit")
+                .addBlock("1-0: Animation Update Wait")
+                .addCounter("0: Shadow Map Prepare Skipped Frames")
+                .addCounter("1-0: Animation Joint Upload Bytes")
                 .build();
         }
 
         auto currentTime = std::chrono::high_resolution_clock::now();
         float cumulativeFrameTime = 0.0f;
+        bool firstFrame = true;
 
         // Poll Mouse pos once directly before starting loop to prevent an incorrect
         //  Mouse update on start.
@@ -330,6 +331,7 @@ namespace sumire {
                     sumiRenderer.getGbuffer()->positionAttachment()
                 );
                 if (hqsmDebugger) hqsmDebugger->updateScreenBounds(sumiRenderer.getHZB());
+                lightTracker.invalidate();
 
                 sumiRenderer.resetScRecreatedFlag();
             }
@@ -339,6 +341,9 @@ namespace sumire {
                 sumiRenderer.resetGbufferRecreatedFlag();
             }
 
+            // Add streamed in models to the scene, and submit uploads recorded since the last frame.
+            modelLoader.update();
+
             // Set up FrameInfo for GUI, and add remaining props later;
             FrameInfo frameInfo{
                 -1,        // frameIdx
@@ -365,55 +370,96 @@ namespace sumire {
                 //frameInfo.commandBuffer = frameCommandBuffers.graphics;
                 frameInfo.globalDescriptorSet = globalDescriptorSets[frameIdx];
 
+                // Sub-allocate this frame's uploads. These land in the same place every frame unless the
+                //  frame's allocations change, in which case the descriptors follow.
+                if (allocateFrameUploads(static_cast<uint32_t>(frameIdx))) {
+                    updateGlobalDescriptorSet(static_cast<uint32_t>(frameIdx));
+                    // The light SSBO is patched in place, so a moved SSBO needs a full rewrite.
+                    lightSSBOGenerations[frameIdx] = 0u;
+                }
+                const FrameUploads& uploads = frameUploads[frameIdx];
+
                 // Populate uniform buffers with data
                 CameraUBO cameraUbo{};
                 cameraUbo.projectionMatrix     = camera.getProjectionMatrix();
                 cameraUbo.viewMatrix           = camera.getViewMatrix();
                 cameraUbo.projectionViewMatrix = cameraUbo.projectionMatrix * cameraUbo.viewMatrix;
                 cameraUbo.cameraPosition = camera.transform.getTranslation();
-                cameraUniformBuffers[frameIdx]->writeToBuffer(&cameraUbo);
-                cameraUniformBuffers[frameIdx]->flush();
+                frameUploadRing->write(uploads.camera, &cameraUbo, sizeof(CameraUBO));
 
                 const int nLights = static_cast<int>(lights.size());
                 GlobalUBO globalUbo{};
                 globalUbo.nLights = nLights;
-                globalUniformBuffers[frameIdx]->writeToBuffer(&globalUbo);
-                globalUniformBuffers[frameIdx]->flush();
+                frameUploadRing->write(uploads.global, &globalUbo, sizeof(GlobalUBO));
 
-                // Prepare Lights
-                //   Sort lights by view space depth for shadow mapping pass
-                auto sortedLights = HighQualityShadowMapper::sortLightsByViewSpaceDepth(
-                    lights, 
-                    cameraUbo.viewMatrix, 
-                    camera.getNear()
-                );
+                // ---- Animation -------------------------------------------------------------------------------
+                //  This frame in flight's mesh buffers are no longer read by the GPU, so animation jobs can write
+                //  them while the main thread prepares lights. They are waited on before draws are recorded.
+                BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "1: Animation Update Submit");
+                animationSystem.beginUpdate(objects, cumulativeFrameTime, frameIdx);
+                END_CPU_PROFILING_BLOCK(cpuProfiler, "1: Animation Update Submit");
 
-                //   Write lights SSBO
-                //   TODO: This will be very slow when the number of lights increases.
-                //          We should only write to the buffer when absolutely necessary, i.e. on light change.
-                //   TODO: This also needs ring buffering as the sort will make in progress frames flicker.
-                auto lightData = std::vector<SumiLight::LightShaderData>{};
-                for (auto& viewSpaceLight : sortedLights) {
-                    lightData.push_back(viewSpaceLight.lightPtr->getShaderData());
+                if (gui.HQSMstressMoveLights) stressMoveLights(frameTime, cumulativeFrameTime);
+
+                // Prepare Lights
+                //   Lights are only re-sorted and re-prepared when they or the camera have changed.
+                //   Everything the GPU reads from the sort is buffered per frame in flight.
+                const bool lightsChanged = lightTracker.update(lights, camera);
+                if (lightsChanged) {
+                    //   Sort lights by view space depth for shadow mapping pass
+                    BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "0-4: Light Sort");
+                    sortedLights = shadowMapper->sortLightsByViewSpaceDepth(lights, cameraUbo.viewMatrix);
+                    END_CPU_PROFILING_BLOCK(cpuProfiler, "0-4: Light Sort");
+                    updateLightData();
                 }
-                lightSSBOs[frameIdx]->writeToBuffer(lightData.data(), nLights * sizeof(SumiLight::LightShaderData));
-                lightSSBOs[frameIdx]->flush();
 
-                // ---- Shadow mapping preparation on the CPU ----------------------------------------------------
-                //  TODO: Only re-prepare if lights / camera view have changed.
+                //   Patch lights SSBO with the lights that changed since this frame's SSBO was last written
+                writeLightSSBO(frameIdx);
+
+                //   All of this frame's uploads are flushed together.
+                frameUploadRing->flushFrame();
+
+                // ---- Shadow mapping preparation --------------------------------------------------------------
+                //  Runs fully on the CPU, or only uploads the sorted lights in GPU prepare mode.
                 BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "0: Shadow Map Prepare");
-                shadowMapper->prepare(
-                    sortedLights,
-                    camera
-                );
+                if (lightsChanged) {
+                    shadowMapper->prepare(
+                        sortedLights,
+                        camera,
+                        cpuProfiler.get()
+                    );
+                }
+                else {
+                    INCREMENT_CPU_PROFILING_COUNTER(cpuProfiler, "0: Shadow Map Prepare Skipped Frames");
+                }
                 END_CPU_PROFILING_BLOCK(cpuProfiler, "0: Shadow Map Prepare");
                 
+                // Skinning reads this frame's joint palettes
+                BEGIN_CPU_PROFILING_BLOCK(cpuProfiler, "1-0: Animation Update Wait");
+                animationSystem.waitForUpdate();
+                END_CPU_PROFILING_BLOCK(cpuProfiler, "1-0: Animation Update Wait");
+                SET_CPU_PROFILING_COUNTER(
+                    cpuProfiler, "1-0: Animation Joint Upload Bytes", animationSystem.getJointUploadBytes()
+                );
+
                 if (gpuProfiler) gpuProfiler->beginFrame(frameCommandBuffers.predrawCompute);
 
                 // ---- Pre-draw compute dispatches --------------------------------------------------------------
-                // TODO: Compute based culling and skinning.
+                // TODO: Compute based culling.
                 BEGIN_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-- Predraw Compute");
 
+                BEGIN_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-0: HQSM Prepare");
+                shadowMapper->prepareFrame(frameIdx, frameCommandBuffers.predrawCompute, cpuProfiler.get());
+                END_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-0: HQSM Prepare");
+
+                BEGIN_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-1: Compute Morph Targets");
+                computeMorpher->morph(frameCommandBuffers.predrawCompute, frameIdx, objects);
+                END_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-1: Compute Morph Targets");
+
+                BEGIN_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-2: Compute Skinning");
+                computeSkinner->skin(frameCommandBuffers.predrawCompute, frameIdx, objects);
+                END_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-2: Compute Skinning");
+
                 END_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.predrawCompute, "0-- Predraw Compute");
 
                 // ---- Early Graphics ---------------------------------------------------------------------------
@@ -458,12 +504,13 @@ namespace sumire {
                 BEGIN_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.earlyCompute, "2-1: Find Lights Approx");
                 shadowMapper->findLightsApproximate(
                     frameCommandBuffers.earlyCompute,
+                    frameIdx,
                     camera.getNear(), camera.getFar()
                 );
                 END_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.earlyCompute, "2-1: Find Lights Approx");
 
                 BEGIN_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.earlyCompute, "2-2: Find Lights Accurate");
-                shadowMapper->findLightsAccurate(frameCommandBuffers.earlyCompute);
+                shadowMapper->findLightsAccurate(frameCommandBuffers.earlyCompute, frameIdx);
                 END_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.earlyCompute, "2-2: Find Lights Accurate");
 
                 BEGIN_GPU_PROFILING_BLOCK(gpuProfiler, frameCommandBuffers.earlyCompute, "2-3: Generate Deferred Shadows");
@@ -514,7 +561,7 @@ namespace sumire {
                 postProcessor->compositeFrame(frameCommandBuffers.present, frameInfo.frameIdx);
 
                 if (hqsmDebugger) {
-                    hqsmDebugger->renderDebugView(frameCommandBuffers.present, gui.HQSMdebugView);
+                    hqsmDebugger->renderDebugView(frameCommandBuffers.present, frameIdx, gui.HQSMdebugView);
                 }
 
                 gui.beginFrame();
@@ -523,6 +570,8 @@ namespace sumire {
                     cameraController,
                     shadowMapper->getZbin(),
                     shadowMapper->getLightMask(),
+                    shadowMapper->getPrepareValidationStats(),
+                    shadowMapper->getPrepareFrameStats(),
                     hqsmDebugger.get(),
                     gpuProfiler.get(),
                     cpuProfiler.get()
@@ -536,6 +585,14 @@ namespace sumire {
 
                 sumiRenderer.endFrame();
                 if (gpuProfiler) gpuProfiler->endFrame();
+
+                if (firstFrame) {
+                    const float startupMs = std::chrono::duration<float, std::milli>(
+                        std::chrono::steady_clock::now() - startupTime).count();
+                    std::cout << "[Sumire::Sumire] First frame submitted " << startupMs
+                        << "ms after startup (models still loading: " << modelLoader.getPendingCount() << ")" << std::endl;
+                    firstFrame = false;
+                }
             }
         }
 
@@ -545,7 +602,6 @@ namespace sumire {
     }
 
     void Sumire::loadObjects() {
-        // TODO: Load objects in asynchronously
         // std::shared_ptr<SumiModel> modelObj1 = loaders::OBJloader::createModelFromFile(sumiDevice, SUMIRE_ENGINE_PATH("assets/models/obj/clorinde.obj"));
         //std::shared_ptr<SumiModel> modelObj1 = loaders::GLTFloader::createModelFromFile(sumiDevice, SUMIRE_ENGINE_PATH("assets/models/gltf/test/NormalTangentMirrorTest.glb"));
         //std::shared_ptr<SumiModel> modelObj1 = loaders::GLTFloader::createModelFromFile(sumiDevice, SUMIRE_ENGINE_PATH("assets/models/gltf/clorinde.glb"));
@@ -569,12 +625,36 @@ namespace sumire {
         // glb2.transform.setScale(glm::vec3{1.0f});
         // objects.emplace(glb2.getId(), std::move(glb2));
 
-        std::shared_ptr<SumiModel> modelGlb3 = loaders::GLTFloader::createModelFromFile(sumiDevice, SUMIRE_ENGINE_PATH("assets/models/gltf/2b.glb"));
-        auto glb3 = SumiObject::createObject();
-        glb3.model = modelGlb3;
-        glb3.transform.setTranslation(glm::vec3{0.0f, 0.0f, 0.0f});
-        glb3.transform.setScale(glm::vec3{1.0f});
-        objects.emplace(glb3.getId(), std::move(glb3));
+        // Loaded in the background; the scene renders without it until its uploads complete.
+        const bool computeSkinning = sumiConfig.startupData.graphics.internal.COMPUTE_SKINNING;
+        const bool bakeAnimations = sumiConfig.startupData.graphics.internal.BAKE_ANIMATIONS;
+        modelLoader.loadGLTF(
+            SUMIRE_ENGINE_PATH("assets/models/gltf/2b.glb"),
+            [computeSkinning, bakeAnimations](SumiModel &model) {
+                model.setComputeSkinning(computeSkinning);
+                if (bakeAnimations) model.bakeAnimations();
+            },
+            [this](std::shared_ptr<SumiModel> modelGlb3, std::vector<std::shared_ptr<SumiModel>> instances) {
+                auto glb3 = SumiObject::createObject();
+                glb3.model = modelGlb3;
+                glb3.transform.setTranslation(glm::vec3{0.0f, 0.0f, 0.0f});
+                glb3.transform.setScale(glm::vec3{1.0f});
+                objects.emplace(glb3.getId(), std::move(glb3));
+
+                // Instances share geometry, materials & animation clips, and animate independently.
+                for (size_t i = 0; i < instances.size(); i++) {
+                    auto glb3Instance = SumiObject::createObject();
+                    glb3Instance.model = std::move(instances[i]);
+                    glb3Instance.transform.setTranslation(glm::vec3{1.5f * (i + 1), 0.0f, 0.0f});
+                    objects.emplace(glb3Instance.getId(), std::move(glb3Instance));
+                }
+            },
+            true,
+            sumiConfig.startupData.graphics.internal.CACHE_MODELS,
+            sumiConfig.startupData.graphics.internal.COMPACT_VERTICES,
+            sumiConfig.startupData.graphics.internal.OPTIMIZE_MESHES,
+            2u
+        );
     }
 
     void Sumire::loadLights() {
@@ -585,38 +665,137 @@ namespace sumire {
             float hue = i * 360.0f / radial_n_lights;
             light.color = glm::vec4(glm::rgbColor(glm::vec3{ hue, 1.0, 1.0 }), 1.0);
             light.range = 4.0f;
-            lights.emplace(light.getId(), std::move(light));
+            lights.add(light);
         }
 
         // zBin Light Tests
         //auto light1 = SumiLight::createPointLight({ 0.0f, 1.0f, 0.0f });
         //light1.range = 1.0f;
-        //lights.emplace(light1.getId(), std::move(light1));
+        //lights.add(light1);
 
         //auto light2 = SumiLight::createPointLight({ -1.0f, 1.0f, -5.5f });
         //light2.range = 2.0f;
-        //lights.emplace(light2.getId(), std::move(light2));
+        //lights.add(light2);
 
         //auto light3 = SumiLight::createPointLight({ 1.0f, 1.0f, -5.0f });
         //light3.range = 1.0f;
-        //lights.emplace(light3.getId(), std::move(light3));
+        //lights.add(light3);
 
         //auto light4 = SumiLight::createPointLight({ -2.0f, 1.0f, -10.0f });
         //light4.range = 1.0f;
-        //lights.emplace(light4.getId(), std::move(light4));
+        //lights.add(light4);
 
         //auto light5 = SumiLight::createPointLight({ 0.5f, 1.0f, -11.0f });
         //light5.range = 1.0f;
-        //lights.emplace(light5.getId(), std::move(light5));
+        //lights.add(light5);
 
         //auto light6 = SumiLight::createPointLight({ 0.5f, 1.0f, -100.0f });
         //light6.range = 1.0f;
-        //lights.emplace(light6.getId(), std::move(light6));
+        //lights.add(light6);
 
         // Light Mask Buffer Tests
         //auto light1 = SumiLight::createPointLight({ 0.0f, 1.0f, 0.0f });
         //light1.range = 1.0f;
-        //lights.emplace(light1.getId(), std::move(light1));
+        //lights.add(light1);
+
+    }
+
+    // Returns true if any of the frame's uploads were allocated at a different offset than last time.
+    bool Sumire::allocateFrameUploads(uint32_t frameIdx) {
+        FrameUploads& uploads = frameUploads[frameIdx];
+        const FrameUploads previous = uploads;
+
+        frameUploadRing->beginFrame(frameIdx);
+        uploads.global = frameUploadRing->allocate(sizeof(GlobalUBO));
+        uploads.camera = frameUploadRing->allocate(sizeof(CameraUBO));
+        uploads.lights = frameUploadRing->allocate(
+            sumiConfig.runtimeData.graphics.internal.MAX_N_LIGHTS * sizeof(SumiLight::LightShaderData));
+
+        return (
+            uploads.global.offset != previous.global.offset ||
+            uploads.camera.offset != previous.camera.offset ||
+            uploads.lights.offset != previous.lights.offset
+        );
+    }
+
+    void Sumire::updateGlobalDescriptorSet(uint32_t frameIdx) {
+        auto globalBufferInfo = frameUploadRing->descriptorInfo(frameUploads[frameIdx].global);
+        auto cameraBufferInfo = frameUploadRing->descriptorInfo(frameUploads[frameIdx].camera);
+        auto lightSSBOinfo = frameUploadRing->descriptorInfo(frameUploads[frameIdx].lights);
+        SumiDescriptorWriter(*globalDescriptorSetLayout, *globalDescriptorPool)
+            .writeBuffer(0, &globalBufferInfo)
+            .writeBuffer(1, &cameraBufferInfo)
+            .writeBuffer(2, &lightSSBOinfo)
+            .overwrite(globalDescriptorSets[frameIdx]);
+    }
+
+    void Sumire::updateLightData() {
+        const uint64_t generation = lightTracker.getGeneration();
+        const size_t nLights = sortedLights.size();
+
+        lightData.resize(nLights);
+        lightDataGenerations.resize(nLights, generation);
+        lightDataSlots.resize(nLights, SumiLightStore::INVALID_SLOT);
+
+        lights.collectChangedSince(lightDataVersion, changedLightSlots);
+        lightDataVersion = lights.getVersion();
+
+        // Only entries now holding a different or edited light are repacked, and only those whose
+        //  contents differ need to be re-uploaded.
+        for (size_t i = 0; i < nLights; i++) {
+            const uint32_t slot = sortedLights[i].slot;
+            const bool slotChanged = (changedLightSlots[slot / 64u] >> (slot % 64u)) & 1u;
+            if (lightDataSlots[i] == slot && !slotChanged) continue;
+            lightDataSlots[i] = slot;
+
+            const SumiLight::LightShaderData data = lights.getShaderData(slot);
+            if (data == lightData[i]) continue;
+
+            lightData[i] = data;
+            lightDataGenerations[i] = generation;
+        }
+    }
+
+    void Sumire::stressMoveLights(float frameTime, float cumulativeFrameTime) {
+        // Orbit every light around its own position, so lights change every frame without drifting.
+        constexpr float radius = 0.5f;
+        const auto orbit = [](float t, uint32_t slot) {
+            const float phase = t + static_cast<float>(slot) * 2.39996f;
+            return radius * glm::vec3{ glm::cos(phase), 0.0f, glm::sin(phase) };
+        };
+
+        for (uint32_t slot = 0; slot < lights.size(); slot++) {
+            const glm::vec3 delta = orbit(cumulativeFrameTime, slot) - orbit(cumulativeFrameTime - frameTime, slot);
+            lights.setPosition(slot, lights.getPosition(slot) + delta);
+        }
+    }
+
+    void Sumire::writeLightSSBO(int frameIdx) {
+        const uint64_t generation = lightTracker.getGeneration();
+        uint64_t& ssboGeneration = lightSSBOGenerations[frameIdx];
+        if (ssboGeneration == generation) return;
+
+        constexpr VkDeviceSize stride = sizeof(SumiLight::LightShaderData);
+        const size_t nLights = lightData.size();
+        assert(nLights <= sumiConfig.runtimeData.graphics.internal.MAX_N_LIGHTS && "Too many lights for the light SSBO.");
+
+        // Write contiguous runs of slots that changed after this SSBO was last written straight into the
+        //  mapped ring, only those runs are flushed.
+        const SumiUploadRing::Allocation& lightSSBO = frameUploads[frameIdx].lights;
+        size_t begin = 0;
+        while (begin < nLights) {
+            if (lightDataGenerations[begin] <= ssboGeneration) {
+                begin++;
+                continue;
+            }
+
+            size_t end = begin + 1;
+            while (end < nLights && lightDataGenerations[end] > ssboGeneration) end++;
+
+            frameUploadRing->write(lightSSBO, &lightData[begin], (end - begin) * stride, begin * stride);
+            begin = end;
+        }
 
+        ssboGeneration = generation;
     }
 }
\ No newline at end of file
@@ -2,27 +2,36 @@
 
 #include <sumire/config/sumi_config.hpp>
 
+#include <sumire/core/animation/sumi_animation_system.hpp>
 #include <sumire/core/windowing/sumi_window.hpp>
 #include <sumire/core/graphics_pipeline/sumi_device.hpp>
 #include <sumire/core/graphics_pipeline/sumi_descriptors.hpp>
+#include <sumire/core/graphics_pipeline/sumi_upload_ring.hpp>
 #include <sumire/core/models/sumi_model.hpp>
 #include <sumire/core/rendering/general/sumi_object.hpp>
 #include <sumire/core/rendering/lighting/sumi_light.hpp>
+#include <sumire/core/rendering/lighting/sumi_light_tracker.hpp>
 #include <sumire/core/rendering/sumi_renderer.hpp>
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+#include <sumire/loaders/async_model_loader.hpp>
 
 // Render Systems
 #include <sumire/core/render_systems/forward/mesh_rendersys.hpp>
 #include <sumire/core/render_systems/deferred/deferred_mesh_rendersys.hpp>
 #include <sumire/core/render_systems/depth_buffers/hzb_generator.hpp>
 #include <sumire/core/render_systems/high_quality_shadow_mapping/high_quality_shadow_mapper.hpp>
+#include <sumire/core/render_systems/morphing/compute_morpher.hpp>
 #include <sumire/core/render_systems/post/post_processor.hpp>
+#include <sumire/core/render_systems/skinning/compute_skinner.hpp>
 #include <sumire/core/render_systems/world_ui/point_light_rendersys.hpp>
 #include <sumire/core/render_systems/world_ui/grid_rendersys.hpp>
 
 // Debug Render Systems
 #include <sumire/core/render_systems/high_quality_shadow_mapping/hqsm_debugger.hpp>
 
+#include <chrono>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace sumire {
@@ -49,6 +58,16 @@ namespace sumire {
         void loadObjects();
         void loadLights(); 
 
+        bool allocateFrameUploads(uint32_t frameIdx);
+        void updateGlobalDescriptorSet(uint32_t frameIdx);
+        void updateLightData();
+        void writeLightSSBO(int frameIdx);
+        // Debug: moves every light each frame (see SumiImgui::HQSMstressMoveLights).
+        void stressMoveLights(float frameTime, float cumulativeFrameTime);
+
+        // Declared first so it is taken before any other member is constructed.
+        const std::chrono::steady_clock::time_point startupTime{ std::chrono::steady_clock::now() };
+
         SumiConfig sumiConfig{};
         SumiWindow sumiWindow{ 
             static_cast<int>(sumiConfig.startupData.graphics.user.RESOLUTION.WIDTH),
@@ -57,6 +76,15 @@ namespace sumire {
         };
         SumiDevice sumiDevice{ sumiWindow, &sumiConfig };
         SumiRenderer sumiRenderer{ sumiWindow, sumiDevice, sumiConfig };
+
+        // Workers for CPU-side frame preparation
+        SumiThreadPool threadPool{};
+
+        // Animation jobs run on the thread pool while the main thread prepares the frame
+        SumiAnimationSystem animationSystem{ &threadPool };
+
+        // Models stream in on the loader's own workers, and are added to objects once uploaded
+        loaders::AsyncModelLoader modelLoader{ sumiDevice };
         
         // Render Systems
         std::unique_ptr<MeshRenderSys>           meshRenderSystem;
@@ -64,6 +92,8 @@ namespace sumire {
         std::unique_ptr<HzbGenerator>            hzbGenerator;
         std::unique_ptr<HighQualityShadowMapper> shadowMapper;
         std::unique_ptr<PostProcessor>           postProcessor;
+        std::unique_ptr<ComputeMorpher>          computeMorpher;
+        std::unique_ptr<ComputeSkinner>          computeSkinner;
         std::unique_ptr<PointLightRenderSys>     pointLightSystem;
         std::unique_ptr<GridRendersys>           gridRenderSystem;
 
@@ -75,11 +105,31 @@ namespace sumire {
         std::unique_ptr<SumiDescriptorSetLayout> globalDescriptorSetLayout;
         std::vector<VkDescriptorSet>             globalDescriptorSets{};
 
-        std::vector<std::unique_ptr<SumiBuffer>> globalUniformBuffers;
-        std::vector<std::unique_ptr<SumiBuffer>> cameraUniformBuffers;
-        std::vector<std::unique_ptr<SumiBuffer>> lightSSBOs;
+        // Global & camera UBOs and the light SSBO of each frame in flight, sub-allocated from one
+        //  persistently mapped ring.
+        struct FrameUploads {
+            SumiUploadRing::Allocation global{};
+            SumiUploadRing::Allocation camera{};
+            SumiUploadRing::Allocation lights{};
+        };
+        std::unique_ptr<SumiUploadRing>          frameUploadRing;
+        std::vector<FrameUploads>                frameUploads;
 
         SumiObject::Map objects;
-        SumiLight::Map lights;
+        SumiLightStore lights;
+
+        // Light preparation is only redone when lights or the camera change (see SumiLightTracker).
+        SumiLightTracker lightTracker{};
+        // Points into the shadow mapper's light sorter, valid until the next sort.
+        std::span<const structs::viewSpaceLight> sortedLights;
+        std::vector<SumiLight::LightShaderData> lightData;
+        // Store slot packed into each light data entry, and the store version it was last checked at.
+        std::vector<uint32_t> lightDataSlots;
+        uint64_t lightDataVersion = 0u;
+        std::vector<uint64_t> changedLightSlots;
+        // Tracker generation at which each (sorted) light data slot last changed.
+        std::vector<uint64_t> lightDataGenerations;
+        // Tracker generation of the light data held by each frame in flight's light SSBO.
+        std::vector<uint64_t> lightSSBOGenerations;
     };
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace sumire {
+
+    SumiThreadPool::SumiThreadPool(uint32_t numThreads) {
+        if (numThreads == 0u) {
+            const uint32_t hwThreads = std::thread::hardware_concurrency();
+            numThreads = hwThreads > 1u ? hwThreads - 1u : 1u;
+        }
+
+        workers.reserve(numThreads);
+        for (uint32_t i = 0; i < numThreads; i++) {
+            workers.emplace_back(&SumiThreadPool::workerLoop, this);
+        }
+    }
+
+    SumiThreadPool::~SumiThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock{ queueMutex };
+            stopping = true;
+        }
+        queueCondition.notify_all();
+
+        for (auto& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    void SumiThreadPool::submit(Job job) {
+        {
+            std::unique_lock<std::mutex> lock{ queueMutex };
+            assert(!stopping && "Cannot submit jobs to a stopping thread pool.");
+            jobs.push_back(std::move(job));
+        }
+        queueCondition.notify_one();
+    }
+
+    void SumiThreadPool::parallelFor(uint32_t count, const RangeJob& func, uint32_t minBatchSize) {
+        if (count == 0u) return;
+
+        minBatchSize = std::max(1u, minBatchSize);
+        const uint32_t maxBatches = getThreadCount() + 1u; // + calling thread
+        const uint32_t numBatches = std::max(1u, std::min(maxBatches, count / minBatchSize));
+
+        // Nothing to split, so avoid the queue entirely.
+        if (numBatches == 1u) {
+            func(0u, count);
+            return;
+        }
+
+        const uint32_t batchSize = count / numBatches;
+        const uint32_t remainder = count % numBatches;
+
+        // Batch i covers [begin(i), begin(i + 1)), spreading the remainder over the first batches.
+        auto batchBegin = [batchSize, remainder](uint32_t i) {
+            return i * batchSize + std::min(i, remainder);
+        };
+
+        std::atomic<uint32_t> remainingBatches{ numBatches - 1u };
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+
+        for (uint32_t i = 1; i < numBatches; i++) {
+            submit([&, i]() {
+                func(batchBegin(i), batchBegin(i + 1u));
+
+                // Decrement under the lock so the waiting thread cannot destroy the sync
+                //  primitives on its stack while we are still signalling.
+                std::unique_lock<std::mutex> lock{ doneMutex };
+                if (remainingBatches.fetch_sub(1u) == 1u) doneCondition.notify_one();
+            });
+        }
+
+        // Calling thread takes the first batch
+        func(batchBegin(0u), batchBegin(1u));
+
+        // Help drain the queue rather than sleeping while our batches are pending.
+        while (remainingBatches.load() > 0u && tryRunPendingJob()) {}
+
+        std::unique_lock<std::mutex> lock{ doneMutex };
+        doneCondition.wait(lock, [&]() { return remainingBatches.load() == 0u; });
+    }
+
+    void SumiThreadPool::waitIdle() {
+        std::unique_lock<std::mutex> lock{ queueMutex };
+        idleCondition.wait(lock, [this]() { return jobs.empty() && activeJobs == 0u; });
+    }
+
+    void SumiThreadPool::workerLoop() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock{ queueMutex };
+                queueCondition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+                if (stopping && jobs.empty()) return;
+
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                activeJobs++;
+            }
+
+            job();
+
+            {
+                std::unique_lock<std::mutex> lock{ queueMutex };
+                activeJobs--;
+                if (jobs.empty() && activeJobs == 0u) idleCondition.notify_all();
+            }
+        }
+    }
+
+    bool SumiThreadPool::tryRunPendingJob() {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock{ queueMutex };
+            if (jobs.empty()) return false;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            activeJobs++;
+        }
+
+        job();
+
+        {
+            std::unique_lock<std::mutex> lock{ queueMutex };
+            activeJobs--;
+            if (jobs.empty() && activeJobs == 0u) idleCondition.notify_all();
+        }
+
+        return true;
+    }
+
+}
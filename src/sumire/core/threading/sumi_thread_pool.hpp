@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sumire {
+
+    // A fixed-size pool of worker threads for splitting CPU-side frame work (e.g. HQSM prepare).
+    //  Jobs are executed in FIFO order. Threads waiting on work (see parallelFor()) help execute
+    //  pending jobs so that nested / re-entrant use cannot dead-lock the pool.
+    class SumiThreadPool {
+    public:
+        using Job = std::function<void()>;
+        using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+        // 0 threads -> (hardware concurrency - 1), leaving a core for the calling thread.
+        explicit SumiThreadPool(uint32_t numThreads = 0u);
+        ~SumiThreadPool();
+
+        SumiThreadPool(const SumiThreadPool&) = delete;
+        SumiThreadPool& operator=(const SumiThreadPool&) = delete;
+
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+        // Queue a fire-and-forget job.
+        void submit(Job job);
+
+        // Split [0, count) into contiguous batches of at least minBatchSize and block until
+        //  every batch has been executed. The calling thread executes batches too.
+        void parallelFor(uint32_t count, const RangeJob& func, uint32_t minBatchSize = 1u);
+
+        // Block until the job queue is empty and all workers are idle.
+        void waitIdle();
+
+        // Execute the next queued job on the calling thread. Returns false if the queue was empty.
+        //  Lets a thread waiting on submitted jobs help with them instead of sleeping.
+        bool tryRunPendingJob();
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> workers;
+        std::deque<Job> jobs;
+
+        std::mutex queueMutex;
+        std::condition_variable queueCondition;
+        std::condition_variable idleCondition;
+
+        uint32_t activeJobs = 0u;
+        bool stopping = false;
+    };
+
+}
@@ -10,6 +10,8 @@
 #include <stdexcept>
 #include <string>
 #include <format>
+#include <utility>
+#include <vector>
 
 #include <iostream>
 
@@ -130,6 +132,8 @@ namespace sumire {
         SumiKBMcontroller &cameraController,
         const structs::zBin& zBin,
         structs::lightMask* lightMask,
+        const structs::prepareValidationStats* prepareValidationStats,
+        const structs::prepareFrameStats& prepareFrameStats,
         HQSMdebugger* hqsmDebugger,
         GpuProfiler* gpuProfiler,
         CpuProfiler* cpuProfiler
@@ -149,7 +153,7 @@ namespace sumire {
         drawProfilingSection(frameInfo, gpuProfiler, cpuProfiler);
 
         ImGui::Spacing();
-        drawDebugSection(zBin, lightMask, hqsmDebugger);
+        drawDebugSection(zBin, lightMask, prepareValidationStats, prepareFrameStats, hqsmDebugger);
 
         ImGui::Spacing();
         drawSceneSection(frameInfo);
@@ -217,6 +221,32 @@ namespace sumire {
                 }
             }
 
+            // --------- HQSM Prepare ----------------------------------------------------------------
+            auto& internalGraphics = sumiConfig.runtimeData.graphics.internal;
+            static int hqsmPrepareIdx = internalGraphics.GPU_HQSM_PREPARE ? 
+                (internalGraphics.VALIDATE_GPU_HQSM_PREPARE ? 2 : 1) : 0;
+            ImGui::Combo("HQSM Prepare", &hqsmPrepareIdx, "CPU\0GPU\0GPU (Validated)\0\0");
+            const bool gpuPrepare      = hqsmPrepareIdx != 0;
+            const bool validatePrepare = hqsmPrepareIdx == 2;
+            if (
+                gpuPrepare      != internalGraphics.GPU_HQSM_PREPARE || 
+                validatePrepare != internalGraphics.VALIDATE_GPU_HQSM_PREPARE
+            ) {
+                internalGraphics.GPU_HQSM_PREPARE          = gpuPrepare;
+                internalGraphics.VALIDATE_GPU_HQSM_PREPARE = validatePrepare;
+                sumiConfig.writeConfig();
+            }
+
+            const auto& startupGraphics = sumiConfig.startupData.graphics.internal;
+            if (
+                gpuPrepare      != startupGraphics.GPU_HQSM_PREPARE || 
+                validatePrepare != startupGraphics.VALIDATE_GPU_HQSM_PREPARE
+            ) {
+                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.0f, 0.0f, 1.0f));
+                ImGui::Text("A restart is required to change the HQSM prepare mode.");
+                ImGui::PopStyleColor();
+            }
+
             ImGui::Spacing();
             ImGui::TreePop();
         }
@@ -435,6 +465,77 @@ namespace sumire {
                         // Transform
                         drawTransformUI(obj.transform);
 
+                        const char* vertexFormats[] = {"Full", "Compact", "Quantized"};
+                        ImGui::Text("Vertex format: %s (%.1f KiB)",
+                            vertexFormats[obj.model->getVertexFormat()],
+                            static_cast<float>(obj.model->getVertexMemoryBytes()) / 1024.0f
+                        );
+
+                        // Falls back to vertex shader skinning when disabled, except for compact vertex models
+                        if (obj.model->hasSkin()) {
+                            bool computeSkinning = obj.model->usesComputeSkinning();
+                            if (ImGui::Checkbox("Compute Skinning", &computeSkinning)) {
+                                obj.model->setComputeSkinning(computeSkinning);
+                            }
+
+                            bool compactJoints = obj.model->getJointFormat() == Mesh::JOINT_FORMAT_COMPACT;
+                            if (ImGui::Checkbox("Compact Joints", &compactJoints)) {
+                                obj.model->setJointFormat(
+                                    compactJoints ? Mesh::JOINT_FORMAT_COMPACT : Mesh::JOINT_FORMAT_MATRIX
+                                );
+                            }
+                        }
+
+                        // Layered playback, in place of playing every animation while any layers are set
+                        if (obj.model->isAnimated() && ImGui::TreeNode("Animation Layers")) {
+                            const NodeHierarchy &hierarchy = obj.model->getNodeHierarchy();
+                            auto nodeLabel = [&hierarchy](int32_t idx) {
+                                if (idx == NodeHierarchy::NO_PARENT) return std::string{"None"};
+                                const std::string &name = hierarchy.getNode(idx)->name;
+                                return name.empty() ? "Node " + std::to_string(idx) : name;
+                            };
+
+                            int removeLayerIdx = -1;
+                            for (uint32_t i = 0; i < obj.model->getAnimationLayerCount(); i++) {
+                                AnimationLayer &layer = obj.model->getAnimationLayer(i);
+                                ImGui::PushID(static_cast<int>(i));
+                                ImGui::SeparatorText(("Layer " + std::to_string(i)).c_str());
+
+                                if (ImGui::BeginCombo("Animation", obj.model->getAnimationName(layer.animationIdx).c_str())) {
+                                    for (uint32_t a = 0; a < obj.model->getAnimationCount(); a++) {
+                                        if (ImGui::Selectable(obj.model->getAnimationName(a).c_str(), a == layer.animationIdx)) {
+                                            layer.animationIdx = a;
+                                        }
+                                    }
+                                    ImGui::EndCombo();
+                                }
+                                ImGui::SliderFloat("Weight", &layer.weight, 0.0f, 1.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+
+                                bool additive = layer.blendMode == AnimationLayer::BLEND_ADDITIVE;
+                                if (ImGui::Checkbox("Additive", &additive)) {
+                                    layer.blendMode = additive ? AnimationLayer::BLEND_ADDITIVE : AnimationLayer::BLEND_LERP;
+                                }
+
+                                const int32_t maskRoot = obj.model->getAnimationLayerMaskRoot(i);
+                                if (ImGui::BeginCombo("Mask", nodeLabel(maskRoot).c_str())) {
+                                    for (int32_t n = NodeHierarchy::NO_PARENT; n < static_cast<int32_t>(hierarchy.size()); n++) {
+                                        if (ImGui::Selectable(nodeLabel(n).c_str(), n == maskRoot)) {
+                                            obj.model->setAnimationLayerMask(i, n);
+                                        }
+                                    }
+                                    ImGui::EndCombo();
+                                }
+
+                                if (ImGui::Button("Remove")) removeLayerIdx = static_cast<int>(i);
+                                ImGui::PopID();
+                            }
+                            if (removeLayerIdx >= 0) obj.model->removeAnimationLayer(static_cast<uint32_t>(removeLayerIdx));
+
+                            if (ImGui::Button("Add Layer")) obj.model->addAnimationLayer(AnimationLayer{});
+
+                            ImGui::TreePop();
+                        }
+
                         ImGui::TreePop();
                     }
                 }
@@ -445,54 +546,75 @@ namespace sumire {
 
             if (ImGui::TreeNode("Lights")) {
                 ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.50f);
-                for (auto& kv : frameInfo.lights) {
-                    auto& light = kv.second;
-                    const std::string nodeStrId = std::to_string(kv.first);
+                SumiLightStore& lights = frameInfo.lights;
+                for (uint32_t slot = 0; slot < lights.size(); slot++) {
+                    const std::string nodeStrId = std::to_string(lights.idAt(slot));
                     const char* nodeCharId = nodeStrId.c_str();
-                    if (ImGui::TreeNode(nodeCharId, light.name.c_str())) {
+                    if (ImGui::TreeNode(nodeCharId, lights.getName(slot).c_str())) {
                         const char* lightTypes[] = {"Point", "Spot", "Directional"};
-                        static int lightTypeIdx = frameInfo.camera.getCameraType();
+                        int lightTypeIdx = static_cast<int>(lights.getType(slot));
                         ImGui::Combo("Type", &lightTypeIdx, lightTypes, IM_ARRAYSIZE(lightTypes));
-                        SumiLight::Type lightType = static_cast<SumiLight::Type>(lightTypeIdx);
-                        light.type = lightType;
-
-                        drawTransformUI(light.transform, false);
+                        lights.setType(slot, static_cast<SumiLight::Type>(lightTypeIdx));
+
+                        // Store setters skip unchanged values, so writing back every frame is free.
+                        ImGui::SeparatorText("Transform");
+                        glm::vec3 translation = lights.getPosition(slot);
+                        float pos[3] = { translation.x, translation.y, translation.z };
+                        ImGui::InputFloat3("translation", pos);
+                        lights.setPosition(slot, glm::vec3{ pos[0], pos[1], pos[2] });
+
+                        glm::vec3 rotation = lights.getRotation(slot);
+                        float rot[3] = {
+                            glm::degrees(rotation.x),
+                            glm::degrees(rotation.y),
+                            glm::degrees(rotation.z)
+                        };
+                        // Only write back on edit, as the degree round trip is lossy.
+                        if (ImGui::InputFloat3("rotation (deg)", rot, "%.1f")) {
+                            lights.setRotation(slot, glm::vec3{
+                                glm::radians(rot[0]),
+                                glm::radians(rot[1]),
+                                glm::radians(rot[2])
+                                });
+                        }
+                        ImGui::Spacing();
 
                         ImGui::SeparatorText("Illumination");
                         const ImGuiColorEditFlags colorPickerFlags = ImGuiColorEditFlags_AlphaPreview;
-                        float lightCol[3] = { light.color.r, light.color.g, light.color.b };
+                        glm::vec4 color = lights.getColor(slot);
+                        float lightCol[3] = { color.r, color.g, color.b };
                         ImGui::ColorEdit3("Color", lightCol, colorPickerFlags);
-                        light.color.r = lightCol[0];
-                        light.color.g = lightCol[1];
-                        light.color.b = lightCol[2];
+                        color.r = lightCol[0];
+                        color.g = lightCol[1];
+                        color.b = lightCol[2];
 
-                        float intensity = light.color.a;
+                        float intensity = color.a;
                         ImGui::DragFloat("Intensity", &intensity, 0.01f, 0.00f, 1.0f, "%.2f");
-                        light.color.a = intensity;
+                        color.a = intensity;
+                        lights.setColor(slot, color);
 
                         ImGui::Spacing();
-                        switch (light.type) {
+                        switch (lights.getType(slot)) {
                             case SumiLight::PUNCTUAL_POINT: {
                                 ImGui::SeparatorText("Attenuation");
-                                float range = light.range;
+                                float range = lights.getRange(slot);
                                 ImGui::DragFloat("Range", &range, 0.01f, 0.00f, 100.0f, "%.2f");
-                                light.range = range;
+                                lights.setRange(slot, range);
                             }
                             break;
                             case SumiLight::PUNCTUAL_SPOT: {
                                 ImGui::SeparatorText("Attenuation");
-                                float range = light.range;
+                                float range = lights.getRange(slot);
                                 ImGui::DragFloat("Range", &range, 0.01f, 0.00f, 100.0f, "%.2f");
-                                light.range =  range;
+                                lights.setRange(slot, range);
 
                                 ImGui::Spacing();
-                                float innerConeAngle = light.innerConeAngle;
+                                float innerConeAngle = lights.getInnerConeAngle(slot);
                                 ImGui::DragFloat("Inner Cone Angle", &innerConeAngle, 0.001f, 0.00f, glm::half_pi<float>(), "%.3f", ImGuiSliderFlags_AlwaysClamp);
-                                light.innerConeAngle = innerConeAngle;
 
-                                float outerConeAngle = light.outerConeAngle;
-                                ImGui::DragFloat("Outer Cone Angle", &outerConeAngle, 0.001f, light.innerConeAngle, glm::half_pi<float>(), "%.3f", ImGuiSliderFlags_AlwaysClamp);
-                                light.outerConeAngle = outerConeAngle;
+                                float outerConeAngle = lights.getOuterConeAngle(slot);
+                                ImGui::DragFloat("Outer Cone Angle", &outerConeAngle, 0.001f, innerConeAngle, glm::half_pi<float>(), "%.3f", ImGuiSliderFlags_AlwaysClamp);
+                                lights.setConeAngles(slot, innerConeAngle, outerConeAngle);
                             }
                             break;
                             case SumiLight::PUNCTUAL_DIRECTIONAL: {
@@ -533,12 +655,14 @@ namespace sumire {
             glm::degrees(rotation.y),
             glm::degrees(rotation.z)
         };
-        ImGui::InputFloat3("rotation (deg)", rot, "%.1f");
-        transform.setRotation(glm::vec3{
-            glm::radians(rot[0]),
-            glm::radians(rot[1]),
-            glm::radians(rot[2])
-            });
+        // Only write back on edit, as the degree round trip is lossy and would dirty the transform every frame.
+        if (ImGui::InputFloat3("rotation (deg)", rot, "%.1f")) {
+            transform.setRotation(glm::vec3{
+                glm::radians(rot[0]),
+                glm::radians(rot[1]),
+                glm::radians(rot[2])
+                });
+        }
 
         if (includeScale) {
             ImGui::Spacing();
@@ -609,6 +733,9 @@ namespace sumire {
                 for (auto& kv : cpuProfiler->getNamedBlocks()) {
                     ImGui::Text("%.5f ms - %s", kv.second.ms, kv.first.c_str());
                 }
+                for (auto& kv : cpuProfiler->getNamedCounters()) {
+                    ImGui::Text("%llu - %s", static_cast<unsigned long long>(kv.second), kv.first.c_str());
+                }
                 ImGui::Spacing();
             }
 
@@ -656,6 +783,8 @@ namespace sumire {
     void SumiImgui::drawDebugSection(
         const structs::zBin& zBin,
         structs::lightMask* lightMask,
+        const structs::prepareValidationStats* prepareValidationStats,
+        const structs::prepareFrameStats& prepareFrameStats,
         HQSMdebugger* hqsmDebugger
     ) {
         if (ImGui::CollapsingHeader("Debug")) {
@@ -675,7 +804,8 @@ namespace sumire {
             }
 
             ImGui::SeparatorText("Systems");
-            drawHighQualityShadowMappingSection(zBin, lightMask, hqsmDebugger);
+            drawHighQualityShadowMappingSection(
+                zBin, lightMask, prepareValidationStats, prepareFrameStats, hqsmDebugger);
 
             ImGui::Spacing();
         }
@@ -685,11 +815,15 @@ namespace sumire {
     void SumiImgui::drawHighQualityShadowMappingSection(
         const structs::zBin& zBin,
         structs::lightMask* lightMask,
+        const structs::prepareValidationStats* prepareValidationStats,
+        const structs::prepareFrameStats& prepareFrameStats,
         HQSMdebugger* hqsmDebugger
     ) {
         if (ImGui::TreeNode("High Quality Shadow Mapping")) {
             drawZbinSubsection(zBin);
             drawLightMaskSubsection(lightMask);
+            drawPrepareValidationSubsection(prepareValidationStats);
+            drawPrepareFramesSubsection(prepareFrameStats);
             drawHqsmDebugViewSubsection(hqsmDebugger);
 
             ImGui::TreePop();
@@ -784,9 +918,21 @@ namespace sumire {
                 ImGuiTableFlags_BordersV |
                 ImGuiTableFlags_NoHostExtendX;
 
-            constexpr int tileRows = 33;
             constexpr int tileCols = 32;
 
+            // Sparse tiles only store non-empty groups, so show the super group mask then one row per group.
+            const uint32_t tile = lightMask->tileIdx(
+                static_cast<uint32_t>(tileIdx[0]), static_cast<uint32_t>(tileIdx[1]));
+            const uint32_t superGroupMask = lightMask->words[lightMask->tileOffset(tile)];
+
+            std::vector<std::pair<uint32_t, uint32_t>> groups;
+            lightMask->forEachGroup(tile, [&groups](uint32_t groupIdx, uint32_t bits) {
+                groups.emplace_back(groupIdx, bits);
+            });
+            ImGui::Text("Non-empty groups: %u", static_cast<uint32_t>(groups.size()));
+
+            const int tileRows = static_cast<int>(groups.size()) + 1;
+
             const ImVec2 outer_size = ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 10);
             const ImU32 bitSetColor = ImGui::GetColorU32(ImVec4(0.1f, 0.9f, 0.1f, 0.6f));
             const ImU32 bitNotSetColor = ImGui::GetColorU32(ImVec4(0.9f, 0.1f, 0.1f, 0.6f));
@@ -816,18 +962,17 @@ namespace sumire {
                         if (col == 0) {
                             switch (row) {
                             case 0:
-                                ImGui::Text("[Groups]");
+                                ImGui::Text("[Super Groups]");
                                 break;
                             default:
-                                uint32_t groupIdx = static_cast<uint32_t>(row) - 1u;
+                                uint32_t groupIdx = groups[row - 1].first;
                                 ImGui::Text("[%u, %u]",
                                     groupIdx * 32, groupIdx * 32 + 31);
                             }
                         }
                         else {
-                            uint32_t tileX = static_cast<uint32_t>(tileIdx[0]);
-                            uint32_t tileY = static_cast<uint32_t>(tileIdx[1]);
-                            if (lightMask->readTileAtIdx(tileX, tileY).isBitSet(col - 1, row)) {
+                            const uint32_t bits = row == 0 ? superGroupMask : groups[row - 1].second;
+                            if (bits & (1u << (col - 1))) {
                                 ImGui::PushStyleColor(ImGuiCol_Text, bitSetColor);
                                 ImGui::Text("1");
                                 ImGui::PopStyleColor();
@@ -846,6 +991,53 @@ namespace sumire {
         }
     }
 
+    void SumiImgui::drawPrepareValidationSubsection(
+        const structs::prepareValidationStats* prepareValidationStats
+    ) {
+        if (ImGui::TreeNode("GPU Prepare Validation")) {
+            if (prepareValidationStats) {
+                const structs::prepareValidationStats& stats = *prepareValidationStats;
+                ImGui::Text("Validated frames: %u (%u failed)", stats.validatedFrames, stats.failedFrames);
+
+                if (stats.zBinMismatches > 0u || stats.lightMaskMismatches > 0u || stats.zBinReferenceMismatches > 0u) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.0f, 0.0f, 1.0f));
+                }
+                else {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
+                }
+                ImGui::Text("zBin mismatches: %u (first slice: %d)", 
+                    stats.zBinMismatches, stats.firstZbinMismatch);
+                ImGui::Text("Light mask mismatches: %u (first tile: %d)", 
+                    stats.lightMaskMismatches, stats.firstLightMaskMismatch);
+                ImGui::Text("CPU zBin reference mismatches: %u (first slice: %d)",
+                    stats.zBinReferenceMismatches, stats.firstZbinReferenceMismatch);
+                ImGui::PopStyleColor();
+            }
+            else {
+                ImGui::Text("GPU prepare validation is disabled.");
+            }
+
+            ImGui::TreePop();
+        }
+    }
+
+    void SumiImgui::drawPrepareFramesSubsection(const structs::prepareFrameStats& prepareFrameStats) {
+        if (ImGui::TreeNode("Prepare Frames In Flight")) {
+            ImGui::Checkbox("Move lights every frame", &HQSMstressMoveLights);
+            ImGui::Spacing();
+
+            // With lights moving every frame, each frame should upload once per prepare and
+            //  reallocations should stay flat once the light mask has grown to fit.
+            ImGui::Text("Prepares: %u", prepareFrameStats.preparedFrames);
+            ImGui::Text("Frame uploads: %u (%u skipped)", 
+                prepareFrameStats.frameUploads, prepareFrameStats.skippedFrames);
+            ImGui::Text("Light mask reallocations: %u (%u GPU overflows)",
+                prepareFrameStats.lightMaskGrowths, prepareFrameStats.lightMaskOverflows);
+
+            ImGui::TreePop();
+        }
+    }
+
     void SumiImgui::drawHqsmDebugViewSubsection(HQSMdebugger* hqsmDebugger) {
         if (ImGui::TreeNode("Debug Views")) {
 
@@ -16,6 +16,8 @@
 
 #include <sumire/core/render_systems/high_quality_shadow_mapping/zbin.hpp>
 #include <sumire/core/render_systems/high_quality_shadow_mapping/light_mask.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/prepare_validation.hpp>
+#include <sumire/core/render_systems/high_quality_shadow_mapping/prepare_frame_stats.hpp>
 #include <sumire/core/render_systems/high_quality_shadow_mapping/hqsm_debugger.hpp>
 
 #include <sumire/input/sumi_kbm_controller.hpp>
@@ -55,6 +57,8 @@ namespace sumire {
                 SumiKBMcontroller &cameraController,
                 const structs::zBin& zBin,
                 structs::lightMask* lightMask,
+                const structs::prepareValidationStats* prepareValidationStats,
+                const structs::prepareFrameStats& prepareFrameStats,
                 HQSMdebugger* hqsmDebugger,
                 GpuProfiler* gpuProfiler,
                 CpuProfiler* cpuProfiler
@@ -77,6 +81,8 @@ namespace sumire {
 
             // Debug Views
             HQSMdebuggerView HQSMdebugView = HQSMdebuggerView::HQSM_DEBUG_NONE;
+            // Moves every light each frame, to check HQSM prepare buffers under constant light changes.
+            bool HQSMstressMoveLights{false};
 
         private:
             void initImgui(VkRenderPass renderPass, uint32_t subpassIdx, VkQueue workQueue);
@@ -97,16 +103,22 @@ namespace sumire {
             void drawDebugSection(
                 const structs::zBin& zBin,
                 structs::lightMask* lightMask,
+                const structs::prepareValidationStats* prepareValidationStats,
+                const structs::prepareFrameStats& prepareFrameStats,
                 HQSMdebugger* hqsmDebugger
             );
 
             void drawHighQualityShadowMappingSection(
                 const structs::zBin& zBin, 
                 structs::lightMask* lightMask,
+                const structs::prepareValidationStats* prepareValidationStats,
+                const structs::prepareFrameStats& prepareFrameStats,
                 HQSMdebugger* hqsmDebugger
             );
             void drawZbinSubsection(const structs::zBin& zbin);
             void drawLightMaskSubsection(structs::lightMask* lightMask);
+            void drawPrepareValidationSubsection(const structs::prepareValidationStats* prepareValidationStats);
+            void drawPrepareFramesSubsection(const structs::prepareFrameStats& prepareFrameStats);
             void drawHqsmDebugViewSubsection(HQSMdebugger* hqsmDebugger);
 
             SumiConfig& sumiConfig;
@@ -0,0 +1,193 @@
+#include <sumire/loaders/async_model_loader.hpp>
+#include <sumire/loaders/gltf_loader.hpp>
+
+#include <sumire/util/vk_check_success.hpp>
+
+#include <cassert>
+#include <exception>
+#include <iostream>
+
+namespace sumire::loaders {
+
+    AsyncModelLoader::AsyncModelLoader(SumiDevice &device, uint32_t numThreads)
+        : sumiDevice{ device }, threadPool{ numThreads } {}
+
+    AsyncModelLoader::~AsyncModelLoader() {
+        // Jobs reference this loader, so they must not outlive it.
+        stopping.store(true);
+        {
+            std::unique_lock<std::mutex> lock{ doneMutex };
+            doneCondition.wait(lock, [this]() { return pendingJobs.load() == 0u; });
+        }
+
+        // Uploads still in flight write to the models they belong to, which are destroyed with their jobs.
+        for (Submission &submission : inFlight) {
+            vkWaitForFences(sumiDevice.device(), 1, &submission.fence, VK_TRUE, UINT64_MAX);
+            vkDestroyFence(sumiDevice.device(), submission.fence, nullptr);
+        }
+        inFlight.clear();
+
+        for (VkFence fence : freeFences) {
+            vkDestroyFence(sumiDevice.device(), fence, nullptr);
+        }
+    }
+
+    void AsyncModelLoader::loadGLTF(
+        const std::string &filepath,
+        PrepareFunc prepare,
+        LoadedFunc onLoaded,
+        bool genTangents,
+        bool useCache,
+        bool compactVertices,
+        bool optimizeMeshes,
+        uint32_t instanceCount
+    ) {
+        assert(onLoaded && "Async model load requested without a loaded callback");
+
+        auto job = std::make_unique<LoadJob>();
+        job->filepath = filepath;
+        job->prepare = std::move(prepare);
+        job->onLoaded = std::move(onLoaded);
+        job->genTangents = genTangents;
+        job->useCache = useCache;
+        job->compactVertices = compactVertices;
+        job->optimizeMeshes = optimizeMeshes;
+        job->instanceCount = instanceCount;
+        job->requestTime = std::chrono::high_resolution_clock::now();
+
+        pendingLoads.fetch_add(1u);
+        pendingJobs.fetch_add(1u);
+
+        // Pool jobs must be copyable, so the job is passed as a raw pointer and re-owned by runJob().
+        LoadJob *rawJob = job.release();
+        threadPool.submit([this, rawJob]() { runJob(rawJob); });
+    }
+
+    void AsyncModelLoader::runJob(LoadJob *rawJob) {
+        std::unique_ptr<LoadJob> job{ rawJob };
+
+        if (!stopping.load()) {
+            try {
+                job->batch = std::make_unique<SumiUploadBatch>(sumiDevice);
+                {
+                    SumiUploadBatch::Scope scope{ *job->batch };
+
+                    // Primitives are decoded on the loader's own pool. The waiting worker helps, so this
+                    //  cannot dead-lock even with every worker loading a model.
+                    job->model = GLTFloader::createModelFromFile(
+                        sumiDevice, job->filepath, job->genTangents, &threadPool, job->useCache, job->compactVertices,
+                        job->optimizeMeshes
+                    );
+                    if (job->prepare) job->prepare(*job->model);
+
+                    // Instance vertex copies read the model's vertex buffer, which the batch's barriers
+                    //  order after its upload.
+                    job->instances.reserve(job->instanceCount);
+                    for (uint32_t i = 0; i < job->instanceCount; i++) {
+                        job->instances.push_back(job->model->createInstance());
+                    }
+                }
+                job->batch->end();
+            }
+            catch (const std::exception &e) {
+                // The batch is never submitted, so commands recorded for the failed model are dropped with it.
+                job->model = nullptr;
+                job->instances.clear();
+                job->error = e.what();
+            }
+
+            std::lock_guard<std::mutex> lock{ recordedMutex };
+            recordedJobs.push_back(std::move(job));
+        }
+
+        // Decrement under the lock so that the destructor cannot return while we are still signalling.
+        std::unique_lock<std::mutex> lock{ doneMutex };
+        if (pendingJobs.fetch_sub(1u) == 1u) doneCondition.notify_all();
+    }
+
+    void AsyncModelLoader::update() {
+        // Retire completed submissions first, so their models are drawn from this frame on.
+        for (auto it = inFlight.begin(); it != inFlight.end();) {
+            VkResult status = vkGetFenceStatus(sumiDevice.device(), it->fence);
+            if (status == VK_NOT_READY) {
+                ++it;
+                continue;
+            }
+            VK_CHECK_SUCCESS(status, "[Sumire::AsyncModelLoader] Failed to get upload fence status.");
+
+            retireSubmission(*it);
+            it = inFlight.erase(it);
+        }
+
+        std::vector<std::unique_ptr<LoadJob>> jobs;
+        {
+            std::lock_guard<std::mutex> lock{ recordedMutex };
+            jobs.swap(recordedJobs);
+        }
+        if (jobs.empty()) return;
+
+        // Everything recorded since the last update goes in one submission, with one fence.
+        Submission submission{};
+        std::vector<VkCommandBuffer> commandBuffers;
+        for (auto &job : jobs) {
+            if (!job->model) {
+                std::cerr << "WARN: Failed to load model <" << job->filepath << "> - " << job->error << std::endl;
+                pendingLoads.fetch_sub(1u);
+                continue;
+            }
+            commandBuffers.push_back(job->batch->getCommandBuffer());
+            submission.jobs.push_back(std::move(job));
+        }
+        if (commandBuffers.empty()) return;
+
+        if (freeFences.empty()) {
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+            VK_CHECK_SUCCESS(
+                vkCreateFence(sumiDevice.device(), &fenceInfo, nullptr, &submission.fence),
+                "[Sumire::AsyncModelLoader] Failed to create upload fence."
+            );
+        } else {
+            submission.fence = freeFences.back();
+            freeFences.pop_back();
+        }
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+        submitInfo.pCommandBuffers = commandBuffers.data();
+
+        VK_CHECK_SUCCESS(
+            vkQueueSubmit(sumiDevice.graphicsQueue(), 1, &submitInfo, submission.fence),
+            "[Sumire::AsyncModelLoader] Failed to submit model uploads."
+        );
+
+        inFlight.push_back(std::move(submission));
+    }
+
+    void AsyncModelLoader::retireSubmission(Submission &submission) {
+        const auto now = std::chrono::high_resolution_clock::now();
+
+        for (auto &job : submission.jobs) {
+            const float readyMs = std::chrono::duration<float, std::milli>(now - job->requestTime).count();
+            std::cout << "[Sumire::AsyncModelLoader] Model <" << job->filepath << "> ready after " << readyMs
+                << "ms (upload commands: " << job->batch->getCommandCount()
+                << ", staged: " << job->batch->getStagingBytes() / 1024u << "KiB)" << std::endl;
+
+            // Uploads are complete, so their staging buffers and command buffer can go.
+            job->batch = nullptr;
+            job->onLoaded(std::move(job->model), std::move(job->instances));
+            pendingLoads.fetch_sub(1u);
+        }
+        submission.jobs.clear();
+
+        VK_CHECK_SUCCESS(
+            vkResetFences(sumiDevice.device(), 1, &submission.fence),
+            "[Sumire::AsyncModelLoader] Failed to reset upload fence."
+        );
+        freeFences.push_back(submission.fence);
+        submission.fence = VK_NULL_HANDLE;
+    }
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <sumire/core/graphics_pipeline/sumi_device.hpp>
+#include <sumire/core/graphics_pipeline/sumi_upload_batch.hpp>
+#include <sumire/core/models/sumi_model.hpp>
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sumire::loaders {
+
+    // Streams models in while frames are rendered. File I/O, decoding and resource creation run on the
+    //  loader's own workers, each model recording its uploads into a SumiUploadBatch rather than idling
+    //  the graphics queue. Once per frame, update() submits every batch recorded since the last update
+    //  in a single submission, and hands models to their callback once their submission's fence signals.
+    //
+    //  Usage:
+    //    loadGLTF(...) -> (each frame, main thread) update() -> onLoaded(model) some frames later.
+    class AsyncModelLoader {
+        public:
+            // Runs on the worker, after the model is created and before its uploads are submitted, so any
+            //  resources it creates are uploaded in the same batch (e.g. SumiModel::bakeAnimations()).
+            using PrepareFunc = std::function<void(SumiModel &model)>;
+            // Runs on the main thread during update(), once the model's uploads, and those of its instances
+            //  (see loadGLTF()), have completed.
+            using LoadedFunc = std::function<void(
+                std::shared_ptr<SumiModel> model, std::vector<std::shared_ptr<SumiModel>> instances)>;
+
+            // Loads get their own workers, so long loads never hold up frame jobs on the main pool.
+            explicit AsyncModelLoader(SumiDevice &device, uint32_t numThreads = 2u);
+            ~AsyncModelLoader();
+
+            AsyncModelLoader(const AsyncModelLoader&) = delete;
+            AsyncModelLoader& operator=(const AsyncModelLoader&) = delete;
+
+            // Queue a glTF model load (see GLTFloader::createModelFromFile). prepare may be null.
+            //  instanceCount instances of the model (see SumiModel::createInstance()) are created on the
+            //  worker after prepare, so their vertex copies upload in the model's batch.
+            void loadGLTF(
+                const std::string &filepath,
+                PrepareFunc prepare,
+                LoadedFunc onLoaded,
+                bool genTangents = true,
+                bool useCache = false,
+                bool compactVertices = false,
+                bool optimizeMeshes = false,
+                uint32_t instanceCount = 0u
+            );
+
+            // Hands completed models to their callbacks, then submits newly recorded uploads.
+            //  Must be called from the thread that submits frames, as it uses the graphics queue.
+            void update();
+
+            // Loads queued or awaiting upload.
+            uint32_t getPendingCount() const { return pendingLoads.load(); }
+
+        private:
+            struct LoadJob {
+                std::string filepath;
+                PrepareFunc prepare;
+                LoadedFunc onLoaded;
+                bool genTangents;
+                bool useCache;
+                bool compactVertices;
+                bool optimizeMeshes;
+                uint32_t instanceCount;
+                std::chrono::high_resolution_clock::time_point requestTime;
+
+                std::shared_ptr<SumiModel> model;
+                std::vector<std::shared_ptr<SumiModel>> instances;
+                std::unique_ptr<SumiUploadBatch> batch;
+                // Set instead of model if the load failed.
+                std::string error;
+            };
+
+            // Jobs submitted together, complete when fence signals.
+            struct Submission {
+                VkFence fence = VK_NULL_HANDLE;
+                std::vector<std::unique_ptr<LoadJob>> jobs;
+            };
+
+            // Takes ownership of job.
+            void runJob(LoadJob *job);
+            void retireSubmission(Submission &submission);
+
+            SumiDevice &sumiDevice;
+            SumiThreadPool threadPool;
+
+            // Jobs whose uploads are recorded, awaiting submission by update().
+            std::mutex recordedMutex;
+            std::vector<std::unique_ptr<LoadJob>> recordedJobs;
+
+            // Only touched by update() and the destructor.
+            std::vector<Submission> inFlight;
+            std::vector<VkFence> freeFences;
+
+            // Jobs queued on the workers, waited on before destruction. Jobs not yet started when the
+            //  loader is destroyed are dropped.
+            std::atomic<bool> stopping{ false };
+            std::atomic<uint32_t> pendingJobs{ 0u };
+            std::mutex doneMutex;
+            std::condition_variable doneCondition;
+
+            std::atomic<uint32_t> pendingLoads{ 0u };
+    };
+
+}
@@ -2,6 +2,7 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 
 #include <sumire/loaders/gltf_loader.hpp>
+#include <sumire/loaders/gltf_primitive_decoder.hpp>
 
 #include <sumire/util/gltf_vulkan_flag_converters.hpp>
 #include <sumire/util/gltf_interpolators.hpp>
@@ -9,7 +10,13 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <numeric>
 #include <unordered_set>
 #include <filesystem>
 
@@ -18,39 +25,69 @@ namespace sumire::loaders {
     std::unique_ptr<SumiModel> GLTFloader::createModelFromFile(
         SumiDevice &device, 
         const std::string &filepath, 
-        bool genTangents
+        bool genTangents,
+        SumiThreadPool *threadPool,
+        bool useCache,
+        bool compactVertices,
+        bool optimizeMeshes
     ) {
         std::filesystem::path fp = filepath;
+        // Cached vertices & indices are uploaded straight from the mapped cache, so it outlives data.
+        util::MappedFile cacheFile;
         SumiModel::Data data{};
-        loadModel(device, filepath, data, genTangents);
+        const auto loadStart = std::chrono::steady_clock::now();
+
+        SumimeshCache::Key cacheKey{};
+        const bool hasCacheKey = useCache && SumimeshCache::makeKey(
+            filepath,
+            (genTangents ? SumimeshCache::FLAG_GEN_TANGENTS : 0u)
+                | (optimizeMeshes ? SumimeshCache::FLAG_OPTIMIZE_MESHES : 0u),
+            cacheKey
+        );
+        const bool cached = hasCacheKey && SumimeshCache::read(
+            device, SumimeshCache::getCachePath(filepath), cacheKey, cacheFile, data);
+        if (!cached) {
+            loadModel(device, filepath, data, genTangents, optimizeMeshes, threadPool, hasCacheKey ? &cacheKey : nullptr);
+        }
 
+        data.compactVertices = compactVertices;
         auto modelPtr = std::make_unique<SumiModel>(device, data);
         modelPtr->displayName = fp.filename().string();
+        const auto loadDuration = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(
+            std::chrono::steady_clock::now() - loadStart);
 
-        std::cout << "[Sumire:GLTFloader] Loaded Model <" << filepath << "> (verts: " << data.vertices.size() 
-                    << ", triangles: " << (modelPtr->hasIndices() ? data.indices.size() / 3.0f : data.vertices.size())
+        const size_t vertexCount = cached ? data.vertexView.size() : data.vertices.size();
+        const size_t indexCount = cached ? data.indexView.size() : data.indices.size();
+        std::cout << "[Sumire:GLTFloader] Loaded Model <" << filepath << "> (verts: " << vertexCount 
+                    << ", triangles: " << (modelPtr->hasIndices() ? indexCount / 3.0f : vertexCount)
                     << ", nodes: " << data.flatNodes.size()
                     << ", mat: " << data.materials.size()
                     << ", tex: " << data.textures.size()
+                    << ", vertex memory: " << modelPtr->getVertexMemoryBytes() / 1024u << "KiB"
+                    << ", load: " << loadDuration.count() << "ms " << (cached ? "(cached)" : "(parsed)")
                     << ")" << std::endl;
         return modelPtr;
     }
 
-    void GLTFloader::loadModel(SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents) {
+    void GLTFloader::loadModel(
+        SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents, bool optimizeMeshes,
+        SumiThreadPool *threadPool, const SumimeshCache::Key *cacheKey
+    ) {
         std::filesystem::path fp = filepath;
         std::filesystem::path ext = fp.extension();
 
         if (ext == ".gltf") 
-            loadGLTF(device, filepath, data, false, genTangents);
+            loadGLTF(device, filepath, data, false, genTangents, optimizeMeshes, threadPool, cacheKey);
         else if (ext == ".glb")
-            loadGLTF(device, filepath, data, true, genTangents);
+            loadGLTF(device, filepath, data, true, genTangents, optimizeMeshes, threadPool, cacheKey);
         else
             throw std::runtime_error("[Sumire::GLTFloader] Attempted to load unsupported GLTF type: <" + ext.string() + ">");
 
     }
 
     void GLTFloader::loadGLTF(
-        SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool isBinaryFile, bool genTangents
+        SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool isBinaryFile, bool genTangents,
+        bool optimizeMeshes, SumiThreadPool *threadPool, const SumimeshCache::Key *cacheKey
     ) {
         tinygltf::Model gltfModel;
         tinygltf::TinyGLTF loader;
@@ -97,17 +134,84 @@ namespace sumire::loaders {
         loadGLTFtextures(device, gltfModel, data);
         loadGLTFmaterials(device, gltfModel, data);
 
-        // Mesh information
+        // Mesh information, so that vertices and indices are allocated once at their exact totals
         uint32_t vertexCount = 0;
         uint32_t indexCount = 0;
         for (uint32_t i = 0; i < scene.nodes.size(); i++) {
             getGLTFnodeProperties(gltfModel.nodes[scene.nodes[i]], gltfModel, vertexCount, indexCount, data);
         }
+        data.vertices.resize(vertexCount);
+        data.indices.resize(indexCount);
 
-        // Load nodes
+        // Load nodes, gathering the slice each primitive decodes into
+        std::vector<PrimitiveDecode> decodes;
         for (uint32_t i = 0; i < scene.nodes.size(); i++) {
             const tinygltf::Node& node = gltfModel.nodes[scene.nodes[i]];
-            loadGLTFnode(device, nullptr, node, scene.nodes[i], gltfModel, data, genTangents);
+            loadGLTFnode(device, nullptr, node, scene.nodes[i], gltfModel, data, decodes);
+        }
+        assert((decodes.empty() || (decodes.back().vertexStart + decodes.back().vertexCount == vertexCount
+            && decodes.back().indexStart + decodes.back().indexCount == indexCount))
+            && "Primitive slices do not match the sized vertex and index totals");
+
+        // Optimization moves vertices, so morph targets are pointed at where theirs moved to afterwards.
+        const uint32_t nDecodes = static_cast<uint32_t>(decodes.size());
+        std::vector<util::VertexCacheStats> statsBefore;
+        std::vector<util::VertexCacheStats> statsAfter;
+        std::vector<uint32_t> vertexRemap;
+        if (optimizeMeshes) {
+            statsBefore.resize(nDecodes);
+            statsAfter.resize(nDecodes);
+            if (!data.morphDeltas.empty()) {
+                vertexRemap.resize(vertexCount);
+                std::iota(vertexRemap.begin(), vertexRemap.end(), 0u);
+            }
+        }
+
+        // Slices never overlap, so primitives are decoded in parallel. Exceptions cannot leave a worker,
+        //  so the first is kept and rethrown here.
+        std::mutex decodeErrorMutex;
+        std::exception_ptr decodeError;
+        auto decodeRange = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                try {
+                    decodeGLTFprimitive(gltfModel, decodes[i], data, genTangents);
+                    if (optimizeMeshes) {
+                        optimizeGLTFprimitive(decodes[i], data, vertexRemap, statsBefore[i], statsAfter[i]);
+                    }
+                } catch (...) {
+                    std::unique_lock<std::mutex> lock{ decodeErrorMutex };
+                    if (!decodeError) decodeError = std::current_exception();
+                }
+            }
+        };
+        if (threadPool) {
+            threadPool->parallelFor(nDecodes, decodeRange);
+        } else {
+            decodeRange(0u, nDecodes);
+        }
+        if (decodeError) std::rethrow_exception(decodeError);
+
+        if (optimizeMeshes) {
+            if (!vertexRemap.empty()) {
+                for (MorphDelta &delta : data.morphDeltas) delta.vertex = vertexRemap[delta.vertex];
+                for (auto& node : data.flatNodes) {
+                    if (!node->mesh || node->mesh->morphVertexCount == 0u) continue;
+                    auto first = data.morphVertices.begin() + node->mesh->firstMorphVertex;
+                    auto last = first + node->mesh->morphVertexCount;
+                    for (auto it = first; it != last; ++it) *it = vertexRemap[*it];
+                    std::sort(first, last);
+                }
+            }
+
+            util::VertexCacheStats totalBefore{};
+            util::VertexCacheStats totalAfter{};
+            for (uint32_t i = 0; i < nDecodes; i++) {
+                totalBefore += statsBefore[i];
+                totalAfter += statsAfter[i];
+            }
+            std::cout << "[Sumire::GLTFloader] Optimized meshes of <" << filepath << "> ("
+                << util::VERTEX_CACHE_SIZE << " entry FIFO, ACMR: " << totalBefore.acmr() << " -> " << totalAfter.acmr()
+                << ", ATVR: " << totalBefore.atvr() << " -> " << totalAfter.atvr() << ")" << std::endl;
         }
         
         // Animations
@@ -128,10 +232,11 @@ namespace sumire::loaders {
             }
         }
 
-        // Initial pose
-        for (auto& node : data.nodes) {
-            node->applyTransformHierarchy();
-            node->updateRecursive();
+        // The initial pose is written by SumiModel once its node hierarchy is built.
+
+        // Failing to cache is not an error, the next load will parse the source again.
+        if (cacheKey) {
+            SumimeshCache::write(SumimeshCache::getCachePath(filepath), *cacheKey, gltfModel, data);
         }
     }
 
@@ -371,13 +476,27 @@ namespace sumire::loaders {
                         }
                     }
                     break;
+                    // Morph target weights, one per target for each keyframe
+                    case TINYGLTF_TYPE_SCALAR: {
+                        const float *scalarData = static_cast<const float*>(outputDataPtr);
+                        createSampler.weightOutputs.assign(scalarData, scalarData + outputAccessor.count);
+
+                        const size_t valuesPerKeyframe = createSampler.inputs.size() *
+                            (createSampler.interpolation == util::GLTFinterpolationType::INTERP_CUBIC_SPLINE ? 3u : 1u);
+                        if (valuesPerKeyframe == 0 || outputAccessor.count % valuesPerKeyframe != 0) {
+                            throw std::runtime_error("Morph target weight animation has a weight count that does not match its keyframes");
+                        }
+                        createSampler.weightCount = static_cast<uint32_t>(outputAccessor.count / valuesPerKeyframe);
+                    }
+                    break;
                     default: {
-                        throw std::runtime_error("Tried to Cast Unsupported Sampler Output Value Data Type (Supported: Vec3, Vec4)");
+                        throw std::runtime_error("Tried to Cast Unsupported Sampler Output Value Data Type (Supported: Scalar, Vec3, Vec4)");
                     }
                 }
 
                 // Check inputs and outputs directly map to one another for interpolation types other than cubic spline.
                 if (createSampler.interpolation != util::GLTFinterpolationType::INTERP_CUBIC_SPLINE && 
+                    createSampler.weightOutputs.empty() &&
                     createSampler.inputs.size() != createSampler.outputs.size()
                 ) {
                     throw std::runtime_error("Non cubic spline animation channel has non 1-to-1 mapping of animation inputs (time values) to outputs (morphing values)");
@@ -400,7 +519,6 @@ namespace sumire::loaders {
                     createChannel.path = AnimationChannel::PathType::SCALE;
                 }
                 if (channel.target_path == "weights") {
-                    throw std::runtime_error("TODO: Animation via weights & morph targets");
                     createChannel.path = AnimationChannel::PathType::WEIGHTS;
                 }
 
@@ -446,7 +564,7 @@ namespace sumire::loaders {
         Node *parent, const tinygltf::Node &node, uint32_t nodeIdx, 
         const tinygltf::Model &model, 
         SumiModel::Data &data,
-        bool genTangents
+        std::vector<PrimitiveDecode> &decodes
     ) {
         std::unique_ptr<Node> createNode = std::make_unique<Node>();
         createNode->idx = nodeIdx;
@@ -473,7 +591,7 @@ namespace sumire::loaders {
         if (node.children.size() > 0) {
             for (size_t i = 0; i < node.children.size(); i++) {
                 loadGLTFnode(
-                    device, createNode.get(), model.nodes[node.children[i]], node.children[i], model, data, genTangents);
+                    device, createNode.get(), model.nodes[node.children[i]], node.children[i], model, data, decodes);
             }
         }
 
@@ -481,253 +599,76 @@ namespace sumire::loaders {
         if (node.mesh > -1) {
             const tinygltf::Mesh& mesh = model.meshes[node.mesh];
             std::unique_ptr<Mesh> createMesh = std::make_unique<Mesh>(device, createNode->matrix);
+
+            // Per morph target deltas, gathered over all primitives of the mesh
+            std::vector<std::vector<MorphDelta>> targetDeltas;
             
             for (size_t i = 0; i < mesh.primitives.size(); i++) {
 
-                uint32_t vertexCount = 0;
-                uint32_t indexCount = 0;
-                uint32_t vertexStart = static_cast<uint32_t>(data.vertices.size());
-                uint32_t indexStart = static_cast<uint32_t>(data.indices.size());
-
                 const tinygltf::Primitive &primitive = mesh.primitives[i];
-                bool hasIndices = primitive.indices > -1;
-                bool hasSkin;
-
-                // Vertices
-                // Buffer pointers & data strides
-                const float *bufferPos = nullptr;
-                const float *bufferNorm = nullptr;
-                const float *bufferTangent = nullptr;
-                const float *bufferTexCoord0 = nullptr;
-                const float *bufferTexCoord1 = nullptr;
-                const float *bufferColor0 = nullptr;
-                const void  *rawBufferJoints0 = nullptr;
-                const float *bufferWeights0 = nullptr;
-                int stridePos;
-                int strideNorm;
-                int strideTangent;
-                int strideTexCoord0;
-                int strideTexCoord1;
-                int strideColor0;
-                int strideJoints0;
-                int strideWeights0;
-
-                int jointsComponentType;
-
-                // Pos
+
                 auto positionEntry = primitive.attributes.find("POSITION");
                 assert(positionEntry != primitive.attributes.end()); // Must have position
 
-                const tinygltf::Accessor& posAccessor = model.accessors[positionEntry->second];
-                vertexCount = static_cast<uint32_t>(posAccessor.count);
-
-                const tinygltf::BufferView& posBufferView = model.bufferViews[posAccessor.bufferView];
-                const tinygltf::Buffer& posBuffer = model.buffers[posBufferView.buffer];
-                bufferPos = reinterpret_cast<const float *>(&(posBuffer.data[posAccessor.byteOffset + posBufferView.byteOffset]));
-                stridePos = posAccessor.ByteStride(posBufferView) ? (posAccessor.ByteStride(posBufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
-
-                // Normals
-                auto normEntry = primitive.attributes.find("NORMAL");
-                if (normEntry != primitive.attributes.end()) {
-                    const tinygltf::Accessor& normAccessor = model.accessors[normEntry->second];
-                    const tinygltf::BufferView& normBufferView = model.bufferViews[normAccessor.bufferView];
-                    const tinygltf::Buffer& normBuffer = model.buffers[normBufferView.buffer];
-                    bufferNorm = reinterpret_cast<const float *>(&(normBuffer.data[normAccessor.byteOffset + normBufferView.byteOffset]));
-                    strideNorm = normAccessor.ByteStride(normBufferView) ? (normAccessor.ByteStride(normBufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3); 
-                }
-
-                auto tangentEntry = primitive.attributes.find("TANGENT");
-                if (tangentEntry != primitive.attributes.end()) {
-                    const tinygltf::Accessor& tangentAccessor = model.accessors[tangentEntry->second];
-                    const tinygltf::BufferView& tangentBufferView = model.bufferViews[tangentAccessor.bufferView];
-                    const tinygltf::Buffer& tangentBuffer = model.buffers[tangentBufferView.buffer];
-                    bufferTangent = reinterpret_cast<const float *>(&(tangentBuffer.data[tangentAccessor.byteOffset + tangentBufferView.byteOffset]));
-                    strideTangent = tangentAccessor.ByteStride(tangentBufferView) ? (tangentAccessor.ByteStride(tangentBufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-                }
-
-                // UVs
-                auto texCoordEntry0 = primitive.attributes.find("TEXCOORD_0");
-                if (texCoordEntry0 != primitive.attributes.end()) {
-                    const tinygltf::Accessor& texCoordAccessor = model.accessors[texCoordEntry0->second];
-                    const tinygltf::BufferView& texCoordBufferView = model.bufferViews[texCoordAccessor.bufferView];
-                    const tinygltf::Buffer& texCoordBuffer = model.buffers[texCoordBufferView.buffer];
-                    bufferTexCoord0 = reinterpret_cast<const float *>(&(texCoordBuffer.data[texCoordAccessor.byteOffset + texCoordBufferView.byteOffset]));
-                    strideTexCoord0 = texCoordAccessor.ByteStride(texCoordBufferView) ? (texCoordAccessor.ByteStride(texCoordBufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC2); 
-                }
-                auto texCoordEntry1 = primitive.attributes.find("TEXCOORD_1");
-                if (texCoordEntry1 != primitive.attributes.end()) {
-                    const tinygltf::Accessor& texCoordAccessor = model.accessors[texCoordEntry1->second];
-                    const tinygltf::BufferView& texCoordBufferView = model.bufferViews[texCoordAccessor.bufferView];
-                    const tinygltf::Buffer& texCoordBuffer = model.buffers[texCoordBufferView.buffer];
-                    bufferTexCoord1 = reinterpret_cast<const float *>(&(texCoordBuffer.data[texCoordAccessor.byteOffset + texCoordBufferView.byteOffset]));
-                    strideTexCoord1 = texCoordAccessor.ByteStride(texCoordBufferView) ? (texCoordAccessor.ByteStride(texCoordBufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC2); 
-                }
-
-                // Vertex Colours
-                auto colorEntry = primitive.attributes.find("COLOR_0");
-                if (colorEntry != primitive.attributes.end()) {
-                    const tinygltf::Accessor& colorAccessor = model.accessors[colorEntry->second];
-                    const tinygltf::BufferView& colorBufferView = model.bufferViews[colorAccessor.bufferView];
-                    const tinygltf::Buffer& colorBuffer = model.buffers[colorBufferView.buffer];
-                    bufferColor0 = reinterpret_cast<const float *>(&(colorBuffer.data[colorAccessor.byteOffset + colorBufferView.byteOffset]));
-                    strideColor0 = colorAccessor.ByteStride(colorBufferView) ? (colorAccessor.ByteStride(colorBufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3); 
-                }
-
-                // Skinning
-                if (createNode->skinIdx > -1) {
-                    auto jointsEntry = primitive.attributes.find("JOINTS_0");
-                    if (jointsEntry != primitive.attributes.end()) {
-                        const tinygltf::Accessor& jointsAccessor = model.accessors[jointsEntry->second];
-                        const tinygltf::BufferView& jointsBufferView = model.bufferViews[jointsAccessor.bufferView];
-                        const tinygltf::Buffer& jointsBuffer = model.buffers[jointsBufferView.buffer];
-                        jointsComponentType = jointsAccessor.componentType;
-                        rawBufferJoints0 = &(model.buffers[jointsBufferView.buffer].data[jointsAccessor.byteOffset + jointsBufferView.byteOffset]);
-                        strideJoints0 = jointsAccessor.ByteStride(jointsBufferView) ? (jointsAccessor.ByteStride(jointsBufferView) / tinygltf::GetComponentSizeInBytes(jointsComponentType)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-                    }
-
-                    auto weightsEntry = primitive.attributes.find("WEIGHTS_0");
-                    if (weightsEntry != primitive.attributes.end()) {
-                        const tinygltf::Accessor& weightsAccessor = model.accessors[weightsEntry->second];
-                        const tinygltf::BufferView& weightsBufferView = model.bufferViews[weightsAccessor.bufferView];
-                        const tinygltf::Buffer& weightsBuffer = model.buffers[weightsBufferView.buffer];
-                        bufferWeights0 = reinterpret_cast<const float *>(&(model.buffers[weightsBufferView.buffer].data[weightsAccessor.byteOffset + weightsBufferView.byteOffset]));
-                        strideWeights0 = weightsAccessor.ByteStride(weightsBufferView) ? (weightsAccessor.ByteStride(weightsBufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-
-                    }
-                }
-
-                hasSkin = rawBufferJoints0 && bufferWeights0;
-
-                // Cast skinning buffer to correct type before writing vertices
-                const uint16_t *castShortBufferJoints0;
-                const uint8_t *castByteBufferJoints0;
-                if (hasSkin) {
-                    switch (jointsComponentType) {
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-                            castShortBufferJoints0 = static_cast<const uint16_t*>(rawBufferJoints0);
-                            break;
-                        }
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-                            castByteBufferJoints0 = static_cast<const uint8_t*>(rawBufferJoints0);
-                            break;
-                        }
-                        default:
-                            throw std::runtime_error("[Sumire::GLTFloader] Attempted to load skin with an unsupported data type. Supported: uint16, uint8");
-                    }
-                }
-
-                // Populate Vertex structs
-                for (uint32_t vIdx = 0; vIdx < vertexCount; vIdx++) {
-                    Vertex v{};
-                    v.position = glm::make_vec3(&bufferPos[vIdx * stridePos]);
-                    v.normal = glm::normalize(bufferNorm ? glm::make_vec3(&bufferNorm[vIdx * strideNorm]) : glm::vec3{0.0f});
-                    v.tangent = glm::normalize(bufferTangent ? glm::make_vec4(&bufferTangent[vIdx * strideTangent]) : glm::vec4{0.0f});
-                    v.uv0 = bufferTexCoord0 ? glm::make_vec2(&bufferTexCoord0[vIdx * strideTexCoord0]) : glm::vec3{0.0f};
-                    v.uv1 = bufferTexCoord1 ? glm::make_vec2(&bufferTexCoord1[vIdx * strideTexCoord0]) : glm::vec3{0.0f};
-                    v.color = bufferColor0 ? glm::make_vec3(&bufferColor0[vIdx * strideColor0]) : glm::vec3{1.0f};
-
-                    // Skinning information
-                    if (hasSkin) {
-                        // Joints
-                        switch (jointsComponentType) {
-                            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-                                v.joint = glm::make_vec4(&castShortBufferJoints0[vIdx * strideJoints0]);
-                                break;
-                            }
-                            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-                                v.joint = glm::make_vec4(&castByteBufferJoints0[vIdx * strideJoints0]);
-                                break;
-                            }
-                        }
-
-                        // Weights
-                        v.weight = glm::make_vec4(&bufferWeights0[vIdx * strideWeights0]);
-                        if (glm::length(v.weight) == 0.0f) // disallow zeroed weights
-                            v.weight = glm::vec4{1.0f, 0.0f, 0.0f, 0.0f};
-
-                    } else {
-                        // Default Joint
-                        v.joint = glm::vec4{0.0f};
-
-                        // Default Weight
-                        v.weight = glm::vec4{1.0f, 0.0f, 0.0f, 0.0f};
-                    }
-
-                    // TODO: Keeping track of current vertex no. and indexing straight to the array would again be faster than
-                    //       push_back.
-                    data.vertices.push_back(v);
-                }
-
-                // Indices
-                if (hasIndices) {
-                    const tinygltf::Accessor& idxAccessor = model.accessors[primitive.indices > -1 ? primitive.indices : 0];
-                    indexCount = static_cast<uint32_t>(idxAccessor.count);
-
-                    const tinygltf::BufferView& idxBufferView = model.bufferViews[idxAccessor.bufferView];
-                    const tinygltf::Buffer& idxBuffer = model.buffers[idxBufferView.buffer];
-                    
-                    // Raw idx data to cast
-                    const void *idxBufferData = &(idxBuffer.data[idxAccessor.byteOffset + idxBufferView.byteOffset]);
-
-                    // TODO: Raw indexing of the indices array would be considerably faster for index buffer
-                    //       here than push_back.
-                    switch (idxAccessor.componentType) {
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
-                            const uint32_t *castData = static_cast<const uint32_t *>(idxBufferData);
-                            for (uint32_t idx = 0; idx < indexCount; idx++) {
-                                data.indices.push_back(castData[idx] + vertexStart);
-                            }
-                        }
-                        break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-                            const uint16_t *castData = static_cast<const uint16_t *>(idxBufferData);
-                            for (uint32_t idx = 0; idx < indexCount; idx++) {
-                                data.indices.push_back(static_cast<uint32_t>(castData[idx]) + vertexStart);
-                            }
-                        }
-                        break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-                            const uint8_t *castData = static_cast<const uint8_t *>(idxBufferData);
-                            for (uint32_t idx = 0; idx < indexCount; idx++) {
-                                data.indices.push_back(static_cast<uint32_t>(castData[idx]) + vertexStart);
-                            }
-                        }
-                        break;
-                        default:
-                            throw std::runtime_error("[Sumire::GLTFloader] Attempted to load model indices with an unsupported data type. Supported: uint32, uint16, uint8");
-                    }
-
+                // Vertices and indices are decoded once all nodes are loaded, each primitive into its own
+                //  slice of the model's arrays (see decodeGLTFprimitive).
+                PrimitiveDecode decode{};
+                decode.primitive = &primitive;
+                decode.vertexStart = decodes.empty() ? 0u : decodes.back().vertexStart + decodes.back().vertexCount;
+                decode.vertexCount = static_cast<uint32_t>(model.accessors[positionEntry->second].count);
+                decode.indexStart = decodes.empty() ? 0u : decodes.back().indexStart + decodes.back().indexCount;
+                decode.indexCount = primitive.indices > -1 ? static_cast<uint32_t>(model.accessors[primitive.indices].count) : 0u;
+                decode.skinned = createNode->skinIdx > -1;
+                decodes.push_back(decode);
+
+                const uint32_t vertexStart = decode.vertexStart;
+                const uint32_t vertexCount = decode.vertexCount;
+                const uint32_t indexStart = decode.indexStart;
+                const uint32_t indexCount = decode.indexCount;
+
+                // Morph targets
+                if (!primitive.targets.empty()) {
+                    loadGLTFmorphTargets(primitive, model, vertexStart, vertexCount, targetDeltas);
                 }
 
-                // Generate and assign tangents using Mikktspace baking if tangents are not provided by the model
-                if (genTangents && !bufferTangent) {
-                    util::MikktspaceData mikktspaceData {
-                        data.vertices,
-                        data.indices,
-                        std::vector<glm::vec4>(vertexCount),
-                        vertexStart,
-                        vertexCount,
-                        indexStart,
-                        indexCount
-                    };
-
-                    util::generateMikktspaceTangents(&mikktspaceData);
-
-                    for (uint32_t vIdx = 0; vIdx < vertexCount; vIdx++) {
-                        data.vertices[vertexStart + vIdx].tangent = mikktspaceData.outTangents[vIdx];
-                    }
-                }
-                
                 // Assign primitive to mesh
                 std::unique_ptr<Primitive> createPrimitive = std::make_unique<Primitive>(
                     indexStart, 
                     indexCount, 
+                    vertexStart,
                     vertexCount, 
                     primitive.material > -1 ? data.materials[primitive.material].get() : data.materials.back().get(),
                     primitive.material > -1 ? primitive.material : data.materials.size() - 1
                 );
                 createMesh->primitives.push_back(std::move(createPrimitive));
             }
+
+            // Each target's deltas are stored contiguously, followed by the mesh's morphed vertices.
+            if (!targetDeltas.empty()) {
+                std::vector<uint32_t> morphVertices;
+                for (auto &deltas : targetDeltas) {
+                    createMesh->morphTargets.push_back(MorphTarget{
+                        static_cast<uint32_t>(data.morphDeltas.size()), static_cast<uint32_t>(deltas.size())
+                    });
+                    for (const MorphDelta &delta : deltas) morphVertices.push_back(delta.vertex);
+                    data.morphDeltas.insert(data.morphDeltas.end(), deltas.begin(), deltas.end());
+                }
+
+                std::sort(morphVertices.begin(), morphVertices.end());
+                morphVertices.erase(std::unique(morphVertices.begin(), morphVertices.end()), morphVertices.end());
+                createMesh->firstMorphVertex = static_cast<uint32_t>(data.morphVertices.size());
+                createMesh->morphVertexCount = static_cast<uint32_t>(morphVertices.size());
+                data.morphVertices.insert(data.morphVertices.end(), morphVertices.begin(), morphVertices.end());
+
+                // Default weights from the node, else the mesh, else zero.
+                const std::vector<double> &weights = !node.weights.empty() ? node.weights : mesh.weights;
+                createMesh->defaultMorphWeights = std::vector<float>(targetDeltas.size(), 0.0f);
+                for (size_t t = 0; t < std::min(weights.size(), targetDeltas.size()); t++) {
+                    createMesh->defaultMorphWeights[t] = static_cast<float>(weights[t]);
+                }
+                createMesh->morphWeights = createMesh->defaultMorphWeights;
+            }
+
             // Assign mesh to node
             createNode->mesh = std::move(createMesh);
         }
@@ -743,6 +684,158 @@ namespace sumire::loaders {
         
     }
 
+    void GLTFloader::decodeGLTFprimitive(
+        const tinygltf::Model &model, const PrimitiveDecode &decode, SumiModel::Data &data, bool genTangents
+    ) {
+        const tinygltf::Primitive &primitive = *decode.primitive;
+        Vertex *vertices = data.vertices.data() + decode.vertexStart;
+
+        GLTFprimitiveDecoder::decode(
+            model, primitive, decode.skinned,
+            vertices, decode.vertexStart, decode.vertexCount,
+            data.indices.data() + decode.indexStart, decode.indexCount
+        );
+
+        // Generate and assign tangents using Mikktspace baking if tangents are not provided by the model.
+        //  Only reads and writes this primitive's slices, so is safe alongside other primitives' decodes.
+        const bool hasTangents = primitive.attributes.count("TANGENT") > 0;
+        if (genTangents && !hasTangents) {
+            util::MikktspaceData mikktspaceData {
+                data.vertices,
+                data.indices,
+                std::vector<glm::vec4>(decode.vertexCount),
+                decode.vertexStart,
+                decode.vertexCount,
+                decode.indexStart,
+                decode.indexCount
+            };
+
+            util::generateMikktspaceTangents(&mikktspaceData);
+
+            for (uint32_t vIdx = 0; vIdx < decode.vertexCount; vIdx++) {
+                vertices[vIdx].tangent = mikktspaceData.outTangents[vIdx];
+            }
+        }
+    }
+
+    void GLTFloader::optimizeGLTFprimitive(
+        const PrimitiveDecode &decode, SumiModel::Data &data, std::vector<uint32_t> &vertexRemap,
+        util::VertexCacheStats &statsBefore, util::VertexCacheStats &statsAfter
+    ) {
+        // Strips, fans, lines & points are drawn as they are.
+        const int mode = decode.primitive->mode;
+        if (mode != TINYGLTF_MODE_TRIANGLES && mode != -1) return;
+
+        util::MeshOptimizeData optimizeData{
+            data.vertices,
+            data.indices,
+            decode.vertexStart,
+            decode.vertexCount,
+            decode.indexStart,
+            decode.indexCount
+        };
+        if (!util::optimizeMesh(&optimizeData)) return;
+
+        statsBefore = optimizeData.outStatsBefore;
+        statsAfter = optimizeData.outStatsAfter;
+        if (!vertexRemap.empty()) {
+            for (uint32_t vIdx = 0; vIdx < decode.vertexCount; vIdx++) {
+                vertexRemap[decode.vertexStart + vIdx] = decode.vertexStart + optimizeData.outRemap[vIdx];
+            }
+        }
+    }
+
+    void GLTFloader::loadGLTFmorphTargets(
+        const tinygltf::Primitive &primitive, const tinygltf::Model &model,
+        uint32_t vertexStart, uint32_t vertexCount,
+        std::vector<std::vector<MorphDelta>> &targetDeltas
+    ) {
+        // All primitives of a mesh have the same number of targets
+        if (targetDeltas.size() < primitive.targets.size()) targetDeltas.resize(primitive.targets.size());
+
+        for (size_t t = 0; t < primitive.targets.size(); t++) {
+            const std::map<std::string, int> &target = primitive.targets[t];
+
+            auto readAttribute = [&](const char *name) {
+                auto entry = target.find(name);
+                return entry != target.end() ? readGLTFvec3Accessor(model, entry->second) : std::vector<glm::vec3>{};
+            };
+            std::vector<glm::vec3> positions = readAttribute("POSITION");
+            std::vector<glm::vec3> normals = readAttribute("NORMAL");
+            std::vector<glm::vec3> tangents = readAttribute("TANGENT");
+
+            // Only vertices the target moves are kept
+            for (uint32_t vIdx = 0; vIdx < vertexCount; vIdx++) {
+                MorphDelta delta{};
+                delta.vertex = vertexStart + vIdx;
+                delta.position = vIdx < positions.size() ? positions[vIdx] : glm::vec3{ 0.0f };
+                delta.normal = vIdx < normals.size() ? normals[vIdx] : glm::vec3{ 0.0f };
+                delta.tangent = vIdx < tangents.size() ? tangents[vIdx] : glm::vec3{ 0.0f };
+
+                if (delta.position == glm::vec3{ 0.0f } && delta.normal == glm::vec3{ 0.0f }
+                    && delta.tangent == glm::vec3{ 0.0f }
+                ) continue;
+
+                targetDeltas[t].push_back(delta);
+            }
+        }
+    }
+
+    std::vector<glm::vec3> GLTFloader::readGLTFvec3Accessor(const tinygltf::Model &model, int accessorIdx) {
+        const tinygltf::Accessor &accessor = model.accessors[accessorIdx];
+        if (accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor.type != TINYGLTF_TYPE_VEC3) {
+            throw std::runtime_error("[Sumire::GLTFloader] Attempted to load a vec3 accessor with an unsupported data type. Supported: float vec3");
+        }
+
+        // Accessors without a buffer view are zero initialised
+        std::vector<glm::vec3> values(accessor.count, glm::vec3{ 0.0f });
+        if (accessor.bufferView > -1) {
+            const tinygltf::BufferView &bufferView = model.bufferViews[accessor.bufferView];
+            const tinygltf::Buffer &buffer = model.buffers[bufferView.buffer];
+            const float *data = reinterpret_cast<const float *>(&buffer.data[accessor.byteOffset + bufferView.byteOffset]);
+            const int stride = accessor.ByteStride(bufferView) ?
+                (accessor.ByteStride(bufferView) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
+
+            for (size_t i = 0; i < accessor.count; i++) {
+                values[i] = glm::make_vec3(&data[i * stride]);
+            }
+        }
+
+        // Sparse accessors substitute values at the given indices
+        if (accessor.sparse.isSparse) {
+            const tinygltf::BufferView &indicesView = model.bufferViews[accessor.sparse.indices.bufferView];
+            const tinygltf::BufferView &valuesView = model.bufferViews[accessor.sparse.values.bufferView];
+            const unsigned char *indicesData =
+                &model.buffers[indicesView.buffer].data[indicesView.byteOffset + accessor.sparse.indices.byteOffset];
+            const float *valuesData = reinterpret_cast<const float *>(
+                &model.buffers[valuesView.buffer].data[valuesView.byteOffset + accessor.sparse.values.byteOffset]);
+
+            for (int i = 0; i < accessor.sparse.count; i++) {
+                uint32_t idx;
+                switch (accessor.sparse.indices.componentType) {
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+                        idx = reinterpret_cast<const uint32_t *>(indicesData)[i];
+                    }
+                    break;
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                        idx = reinterpret_cast<const uint16_t *>(indicesData)[i];
+                    }
+                    break;
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                        idx = indicesData[i];
+                    }
+                    break;
+                    default:
+                        throw std::runtime_error("[Sumire::GLTFloader] Attempted to load sparse accessor indices with an unsupported data type. Supported: uint32, uint16, uint8");
+                }
+                assert(idx < values.size() && "Sparse accessor index out of range");
+                values[idx] = glm::make_vec3(&valuesData[3 * i]);
+            }
+        }
+
+        return values;
+    }
+
     Node* GLTFloader::getGLTFnode(uint32_t idx, SumiModel::Data &data) {
         // TODO: This linear (O(n)) search is pretty slow for objects with lots of nodes.
         //		 Would recommend making another field for data: nodeMap which has <idx, Node*> pairs
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <sumire/core/models/sumi_model.hpp>
+#include <sumire/core/threading/sumi_thread_pool.hpp>
+#include <sumire/loaders/sumimesh_cache.hpp>
+#include <sumire/util/mesh_optimizer.hpp>
 
 #include <tiny_gltf.h>
 
@@ -11,13 +14,32 @@ namespace sumire::loaders {
             static std::unique_ptr<SumiModel> createModelFromFile(
                 SumiDevice &device, 
                 const std::string &filepath,
-                bool genTangents = true
+                bool genTangents = true,
+                // Primitives are decoded on the pool if given, else on the calling thread.
+                SumiThreadPool *threadPool = nullptr,
+                // Load from the file's .sumimesh cache if it is up to date, else write it (see SumimeshCache).
+                bool useCache = false,
+                // Store vertices compactly where the model allows it (see SumiModel::Data::compactVertices).
+                bool compactVertices = false,
+                // Reorder each primitive's triangles & vertices for the GPU before upload (see util::optimizeMesh).
+                bool optimizeMeshes = false
             );
 
         private:
+            // A primitive's slice of the model's vertex and index arrays, decoded once every node is loaded.
+            struct PrimitiveDecode {
+                const tinygltf::Primitive *primitive;
+                uint32_t vertexStart;
+                uint32_t vertexCount;
+                uint32_t indexStart;
+                uint32_t indexCount;
+                bool skinned;
+            };
 
+            // Writes the model's cache if cacheKey is given.
             static void loadModel(
-                SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents);
+                SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents,
+                bool optimizeMeshes, SumiThreadPool *threadPool, const SumimeshCache::Key *cacheKey);
 
             // TODO: For full GLTF support (including extensions), the loader should really load an entire scene
             // 		 Not just directly to a model.
@@ -26,7 +48,10 @@ namespace sumire::loaders {
                 const std::string &filepath, 
                 SumiModel::Data &data,
                 bool isBinaryFile,
-                bool genTangents
+                bool genTangents,
+                bool optimizeMeshes,
+                SumiThreadPool *threadPool,
+                const SumimeshCache::Key *cacheKey
             );
             static void loadGLTFsamplers(SumiDevice &device, tinygltf::Model &model, SumiModel::Data &data);
             static void loadGLTFtextures(SumiDevice &device, tinygltf::Model &model, SumiModel::Data &data);
@@ -43,8 +68,26 @@ namespace sumire::loaders {
                 Node *parent, const tinygltf::Node &node, uint32_t nodeIdx, 
                 const tinygltf::Model &model, 
                 SumiModel::Data &data,
-                bool genTangents
+                std::vector<PrimitiveDecode> &decodes
             );
+            // Decodes a primitive's attributes and indices into its slices of data's vertices and indices,
+            //  which must already be sized. Touches no other primitive's slices.
+            static void decodeGLTFprimitive(
+                const tinygltf::Model &model, const PrimitiveDecode &decode, SumiModel::Data &data, bool genTangents
+            );
+            // Optimizes a decoded triangle list primitive in place (see util::optimizeMesh), recording where
+            //  its vertices moved in vertexRemap if that is not empty. Touches no other primitive's slices.
+            static void optimizeGLTFprimitive(
+                const PrimitiveDecode &decode, SumiModel::Data &data, std::vector<uint32_t> &vertexRemap,
+                util::VertexCacheStats &statsBefore, util::VertexCacheStats &statsAfter
+            );
+            static void loadGLTFmorphTargets(
+                const tinygltf::Primitive &primitive, const tinygltf::Model &model,
+                uint32_t vertexStart, uint32_t vertexCount,
+                std::vector<std::vector<MorphDelta>> &targetDeltas
+            );
+            // Reads a float vec3 accessor into a dense array, applying sparse substitutions if present.
+            static std::vector<glm::vec3> readGLTFvec3Accessor(const tinygltf::Model &model, int accessorIdx);
             static Node* getGLTFnode(uint32_t idx, SumiModel::Data &data);
             static uint32_t getLowestUnreservedGLTFNodeIdx(SumiModel::Data &data);
 
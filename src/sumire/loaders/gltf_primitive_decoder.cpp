@@ -0,0 +1,185 @@
+#include <sumire/loaders/gltf_primitive_decoder.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sumire::loaders {
+
+    namespace {
+
+        // Accessor component as a float, with normalized integers mapped to [0, 1] ([-1, 1] if signed).
+        template <typename T, bool Normalized>
+        inline float gltfComponentToFloat(T component) {
+            if constexpr (!Normalized || std::is_floating_point_v<T>) {
+                return static_cast<float>(component);
+            } else if constexpr (std::is_signed_v<T>) {
+                return std::max(static_cast<float>(component) / static_cast<float>(std::numeric_limits<T>::max()), -1.0f);
+            } else {
+                return static_cast<float>(component) / static_cast<float>(std::numeric_limits<T>::max());
+            }
+        }
+
+        // Writes nComponents of each accessor element to consecutive floats at memberOffset in each vertex.
+        //  Instantiated per component type, so that the per vertex loop has no format branches.
+        template <typename T, bool Normalized>
+        void decodeGLTFelements(
+            const unsigned char *src, size_t srcStride, size_t count, uint32_t nComponents,
+            Vertex *vertices, size_t memberOffset
+        ) {
+            for (size_t i = 0; i < count; i++) {
+                const T *element = reinterpret_cast<const T *>(src + i * srcStride);
+                float *dst = reinterpret_cast<float *>(reinterpret_cast<unsigned char *>(&vertices[i]) + memberOffset);
+                for (uint32_t c = 0; c < nComponents; c++) {
+                    dst[c] = gltfComponentToFloat<T, Normalized>(element[c]);
+                }
+            }
+        }
+
+        // Decodes a vertex attribute accessor into the float vector member at memberOffset of up to count vertices.
+        //  At most nComponents are written, e.g. the RGB of an RGBA colour.
+        void decodeGLTFattribute(
+            const tinygltf::Model &model, const tinygltf::Accessor &accessor, uint32_t nComponents,
+            Vertex *vertices, size_t memberOffset, size_t count
+        ) {
+            // Accessors without a buffer view are zero initialised, and only sparse morph targets use them.
+            if (accessor.bufferView < 0) return;
+
+            const tinygltf::BufferView &bufferView = model.bufferViews[accessor.bufferView];
+            const unsigned char *src = &model.buffers[bufferView.buffer].data[accessor.byteOffset + bufferView.byteOffset];
+            const int srcStride = accessor.ByteStride(bufferView);
+            if (srcStride <= 0) {
+                throw std::runtime_error("[Sumire::GLTFloader] Attempted to load a vertex attribute with an invalid byte stride.");
+            }
+
+            nComponents = std::min(nComponents, static_cast<uint32_t>(tinygltf::GetNumComponentsInType(accessor.type)));
+            count = std::min(count, accessor.count);
+
+            switch (accessor.componentType) {
+                case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+                    decodeGLTFelements<float, false>(src, srcStride, count, nComponents, vertices, memberOffset);
+                }
+                break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                    if (accessor.normalized) decodeGLTFelements<uint8_t, true>(src, srcStride, count, nComponents, vertices, memberOffset);
+                    else decodeGLTFelements<uint8_t, false>(src, srcStride, count, nComponents, vertices, memberOffset);
+                }
+                break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                    if (accessor.normalized) decodeGLTFelements<uint16_t, true>(src, srcStride, count, nComponents, vertices, memberOffset);
+                    else decodeGLTFelements<uint16_t, false>(src, srcStride, count, nComponents, vertices, memberOffset);
+                }
+                break;
+                case TINYGLTF_COMPONENT_TYPE_BYTE: {
+                    if (accessor.normalized) decodeGLTFelements<int8_t, true>(src, srcStride, count, nComponents, vertices, memberOffset);
+                    else decodeGLTFelements<int8_t, false>(src, srcStride, count, nComponents, vertices, memberOffset);
+                }
+                break;
+                case TINYGLTF_COMPONENT_TYPE_SHORT: {
+                    if (accessor.normalized) decodeGLTFelements<int16_t, true>(src, srcStride, count, nComponents, vertices, memberOffset);
+                    else decodeGLTFelements<int16_t, false>(src, srcStride, count, nComponents, vertices, memberOffset);
+                }
+                break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+                    decodeGLTFelements<uint32_t, false>(src, srcStride, count, nComponents, vertices, memberOffset);
+                }
+                break;
+                default:
+                    throw std::runtime_error("[Sumire::GLTFloader] Attempted to load a vertex attribute with an unsupported data type. Supported: float, (u)int8, (u)int16, uint32");
+            }
+        }
+
+        template <typename T>
+        void decodeGLTFindices(const unsigned char *src, size_t count, uint32_t vertexStart, uint32_t *indices) {
+            const T *castData = reinterpret_cast<const T *>(src);
+            for (size_t i = 0; i < count; i++) {
+                indices[i] = static_cast<uint32_t>(castData[i]) + vertexStart;
+            }
+        }
+
+    }
+
+    void GLTFprimitiveDecoder::decode(
+        const tinygltf::Model &model, const tinygltf::Primitive &primitive, bool skinned,
+        Vertex *vertices, uint32_t vertexStart, uint32_t vertexCount,
+        uint32_t *indices, uint32_t indexCount
+    ) {
+        // Defaults for attributes the primitive does not have
+        Vertex defaultVertex{};
+        defaultVertex.color = glm::vec3{ 1.0f };
+        defaultVertex.weight = glm::vec4{ 1.0f, 0.0f, 0.0f, 0.0f };
+        std::fill(vertices, vertices + vertexCount, defaultVertex);
+
+        // One pass per attribute, so that each pass is a single type-specialised loop.
+        auto decodeAttribute = [&](const char *name, uint32_t nComponents, size_t memberOffset) {
+            auto entry = primitive.attributes.find(name);
+            if (entry == primitive.attributes.end()) return false;
+            decodeGLTFattribute(
+                model, model.accessors[entry->second], nComponents, vertices, memberOffset, vertexCount);
+            return true;
+        };
+
+        decodeAttribute("POSITION", 3, offsetof(Vertex, position));
+        const bool hasNormals = decodeAttribute("NORMAL", 3, offsetof(Vertex, normal));
+        const bool hasTangents = decodeAttribute("TANGENT", 4, offsetof(Vertex, tangent));
+        decodeAttribute("TEXCOORD_0", 2, offsetof(Vertex, uv0));
+        decodeAttribute("TEXCOORD_1", 2, offsetof(Vertex, uv1));
+        decodeAttribute("COLOR_0", 3, offsetof(Vertex, color));
+
+        // Skinning, only if the node has a skin and the primitive has both joints and weights.
+        const bool hasSkin = skinned
+            && primitive.attributes.count("JOINTS_0") > 0 && primitive.attributes.count("WEIGHTS_0") > 0;
+        if (hasSkin) {
+            decodeAttribute("JOINTS_0", 4, offsetof(Vertex, joint));
+            decodeAttribute("WEIGHTS_0", 4, offsetof(Vertex, weight));
+            for (uint32_t vIdx = 0; vIdx < vertexCount; vIdx++) {
+                const glm::vec4 &weight = vertices[vIdx].weight;
+                // disallow zeroed weights
+                if (weight.x + weight.y + weight.z + weight.w == 0.0f) {
+                    vertices[vIdx].weight = glm::vec4{ 1.0f, 0.0f, 0.0f, 0.0f };
+                }
+            }
+        }
+
+        // Tangent handedness (w) is kept as is.
+        if (hasNormals) {
+            for (uint32_t vIdx = 0; vIdx < vertexCount; vIdx++) {
+                vertices[vIdx].normal = glm::normalize(vertices[vIdx].normal);
+            }
+        }
+        if (hasTangents) {
+            for (uint32_t vIdx = 0; vIdx < vertexCount; vIdx++) {
+                glm::vec4 &tangent = vertices[vIdx].tangent;
+                tangent = glm::vec4{ glm::normalize(glm::vec3{ tangent }), tangent.w };
+            }
+        }
+
+        // Indices
+        if (indexCount > 0) {
+            const tinygltf::Accessor &idxAccessor = model.accessors[primitive.indices];
+            const tinygltf::BufferView &idxBufferView = model.bufferViews[idxAccessor.bufferView];
+            const unsigned char *idxBufferData =
+                &model.buffers[idxBufferView.buffer].data[idxAccessor.byteOffset + idxBufferView.byteOffset];
+
+            switch (idxAccessor.componentType) {
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+                    decodeGLTFindices<uint32_t>(idxBufferData, indexCount, vertexStart, indices);
+                }
+                break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                    decodeGLTFindices<uint16_t>(idxBufferData, indexCount, vertexStart, indices);
+                }
+                break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                    decodeGLTFindices<uint8_t>(idxBufferData, indexCount, vertexStart, indices);
+                }
+                break;
+                default:
+                    throw std::runtime_error("[Sumire::GLTFloader] Attempted to load model indices with an unsupported data type. Supported: uint32, uint16, uint8");
+            }
+        }
+    }
+
+}
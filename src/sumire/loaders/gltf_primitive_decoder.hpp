@@ -0,0 +1,25 @@
+#pragma once
+
+#include <sumire/core/models/vertex.hpp>
+
+#include <tiny_gltf.h>
+
+#include <cstdint>
+
+namespace sumire::loaders {
+
+    // Decodes glTF primitives into slices of a model's preallocated vertex and index arrays, for
+    //  GLTFloader's second load phase. Needs no device, so primitives can be decoded on any thread.
+    class GLTFprimitiveDecoder {
+        public:
+            // Decodes primitive's attributes into vertices[0, vertexCount) and its indices into
+            //  indices[0, indexCount), offset by vertexStart. Joints & weights are only decoded if skinned.
+            //  Touches nothing outside the two slices, so primitives may be decoded in parallel.
+            static void decode(
+                const tinygltf::Model &model, const tinygltf::Primitive &primitive, bool skinned,
+                Vertex *vertices, uint32_t vertexStart, uint32_t vertexCount,
+                uint32_t *indices, uint32_t indexCount
+            );
+    };
+
+}
@@ -4,6 +4,7 @@
 
 #include <sumire/math/math_utils.hpp>
 #include <sumire/util/generate_mikktspace_tangents.hpp>
+#include <sumire/util/mesh_optimizer.hpp>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
@@ -38,11 +39,14 @@ namespace sumire::loaders {
     std::unique_ptr<SumiModel> OBJloader::createModelFromFile(
         SumiDevice &device, 
         const std::string &filepath,
-        bool genTangents
+        bool genTangents,
+        bool compactVertices,
+        bool optimizeMeshes
     ) {
         std::filesystem::path fp = filepath;
         SumiModel::Data data{};
-        loadModel(device, filepath, data, genTangents);
+        loadModel(device, filepath, data, genTangents, optimizeMeshes);
+        data.compactVertices = compactVertices;
 
         auto modelPtr = std::make_unique<SumiModel>(device, data);
         modelPtr->displayName = fp.filename().string();
@@ -52,22 +56,27 @@ namespace sumire::loaders {
                     << ", nodes: " << data.flatNodes.size()
                     << ", mat: " << data.materials.size()
                     << ", tex: " << data.textures.size()
+                    << ", vertex memory: " << modelPtr->getVertexMemoryBytes() / 1024u << "KiB"
                     << ")" << std::endl;
         return modelPtr;
     }
 
-    void OBJloader::loadModel(SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents) {
+    void OBJloader::loadModel(
+        SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents, bool optimizeMeshes
+    ) {
         std::filesystem::path fp = filepath;
         std::filesystem::path ext = fp.extension();
 
         if (ext == ".obj") 
-            loadOBJ(device, filepath, data, genTangents);
+            loadOBJ(device, filepath, data, genTangents, optimizeMeshes);
         else
             throw std::runtime_error("[Sumire::OBJloader] Attempted to load unsupported OBJ type: <" + ext.string() + ">");
 
     }
 
-    void OBJloader::loadOBJ(SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents) {
+    void OBJloader::loadOBJ(
+        SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents, bool optimizeMeshes
+    ) {
         // .Obj loading
         tinyobj::attrib_t attrib;
         std::vector<tinyobj::shape_t> shapes;
@@ -156,12 +165,33 @@ namespace sumire::loaders {
             }
         }
 
+        // Vertices are in first seen order and faces in file order, neither of which suit the GPU.
+        if (optimizeMeshes) {
+            util::MeshOptimizeData optimizeData{
+                data.vertices,
+                data.indices,
+                0,
+                vertexCount,
+                0,
+                indexCount
+            };
+
+            if (util::optimizeMesh(&optimizeData)) {
+                std::cout << "[Sumire::OBJloader] Optimized mesh of <" << filepath << "> ("
+                    << util::VERTEX_CACHE_SIZE << " entry FIFO, ACMR: " << optimizeData.outStatsBefore.acmr()
+                    << " -> " << optimizeData.outStatsAfter.acmr()
+                    << ", ATVR: " << optimizeData.outStatsBefore.atvr()
+                    << " -> " << optimizeData.outStatsAfter.atvr() << ")" << std::endl;
+            }
+        }
+
         // Push default material
         data.materials.push_back(OBJloader::createDefaultMaterial(device));
 
         std::unique_ptr<Primitive> mainPrimitive = std::make_unique<Primitive>(
             0, 
             indexCount, 
+            0,
             vertexCount, 
             data.materials.back().get(), 
             0 // Use default material only
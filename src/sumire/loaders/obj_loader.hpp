@@ -9,14 +9,20 @@ namespace sumire::loaders {
             static std::unique_ptr<SumiModel> createModelFromFile(
                 SumiDevice &device, 
                 const std::string &filepath, 
-                bool genTangents = true
+                bool genTangents = true,
+                // Store vertices compactly where the model allows it (see SumiModel::Data::compactVertices).
+                bool compactVertices = false,
+                // Reorder the model's triangles & vertices for the GPU before upload (see util::optimizeMesh).
+                bool optimizeMeshes = false
             );
         
         private:
             static void loadModel(
-                SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents);
+                SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents,
+                bool optimizeMeshes);
             static void loadOBJ(
-                SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents);
+                SumiDevice &device, const std::string &filepath, SumiModel::Data &data, bool genTangents,
+                bool optimizeMeshes);
             
             // TODO: Move this to a material manager
             static std::unique_ptr<SumiMaterial> createDefaultMaterial(SumiDevice &device);
@@ -0,0 +1,628 @@
+#include <sumire/loaders/sumimesh_cache.hpp>
+
+#include <sumire/util/rw_file_binary.hpp>
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace sumire::loaders {
+
+    namespace {
+
+        using sumimesh::CacheReader;
+        using sumimesh::CacheWriter;
+
+        constexpr int32_t NO_INDEX = -1;
+
+        // Section layouts (see sumimesh::CacheHeader for their order). Nodes, textures and materials are
+        //  referred to by their index in Data's arrays.
+
+        // Followed by the texture's RGBA pixels
+        struct CachedTexture {
+            uint32_t width;
+            uint32_t height;
+            // Without a sampler, the default sampler is used (see SumiTexture::defaultSamplerCreateInfo).
+            uint32_t hasSampler;
+            uint32_t minFilter;
+            uint32_t magFilter;
+            uint32_t addressModeU;
+            uint32_t addressModeV;
+            uint32_t addressModeW;
+        };
+
+        // Followed by the material's name
+        struct CachedMaterial {
+            // In the order of materialTextures() & materialTexCoords()
+            int32_t textures[SumiMaterial::MAT_TEX_COUNT];
+            int32_t texCoords[SumiMaterial::MAT_TEX_COUNT];
+            glm::vec4 baseColorFactors;
+            glm::vec2 metallicRoughnessFactors;
+            glm::vec3 emissiveFactors;
+            float normalScale;
+            float occlusionStrength;
+            float alphaCutoff;
+            uint32_t alphaMode;
+            uint32_t doubleSided;
+            uint32_t unlit;
+        };
+
+        // Followed by the node's name and children, then its primitives & morph targets if it has a mesh.
+        struct CachedNode {
+            uint32_t idx;
+            int32_t parent;
+            int32_t skinIdx;
+            uint32_t hasMesh;
+            glm::mat4 matrix;
+            glm::vec3 translation;
+            glm::quat rotation;
+            glm::vec3 scale;
+        };
+
+        struct CachedPrimitive {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            uint32_t firstVertex;
+            uint32_t vertexCount;
+            uint32_t materialIdx;
+        };
+
+        struct CachedChannel {
+            uint32_t path;
+            int32_t node;
+            uint32_t samplerIdx;
+        };
+
+        template <typename MaterialData>
+        auto materialTextures(MaterialData &mat) {
+            return std::array{
+                &mat.baseColorTexture, &mat.metallicRoughnessTexture, &mat.normalTexture,
+                &mat.occlusionTexture, &mat.emissiveTexture
+            };
+        }
+
+        template <typename MaterialData>
+        auto materialTexCoords(MaterialData &mat) {
+            return std::array{
+                &mat.baseColorTexCoord, &mat.metallicRoughnessTexCoord, &mat.normalTexCoord,
+                &mat.occlusionTexCoord, &mat.emissiveTexCoord
+            };
+        }
+
+        bool validIndex(int32_t idx, size_t count) {
+            return idx >= 0 && static_cast<size_t>(idx) < count;
+        }
+
+        bool validOptionalIndex(int32_t idx, size_t count) {
+            return idx == NO_INDEX || validIndex(idx, count);
+        }
+
+        void clearModelData(SumiModel::Data &data) {
+            data.nodes.clear();
+            data.flatNodes.clear();
+            data.vertices.clear();
+            data.indices.clear();
+            data.vertexView = {};
+            data.indexView = {};
+            data.meshCount = 0u;
+            data.skins.clear();
+            data.morphDeltas.clear();
+            data.morphVertices.clear();
+            data.animations.clear();
+            data.samplers.clear();
+            data.materials.clear();
+            data.textures.clear();
+        }
+
+        bool readTextures(SumiDevice &device, CacheReader &reader, SumiModel::Data &data) {
+            VkImageCreateInfo imageInfo{};
+            SumiTexture::defaultImageCreateInfo(imageInfo);
+            VkSamplerCreateInfo defaultSamplerInfo{};
+            SumiTexture::defaultSamplerCreateInfo(device, defaultSamplerInfo);
+
+            const uint32_t textureCount = reader.value<uint32_t>();
+            if (!reader.fits(textureCount, sizeof(CachedTexture))) return false;
+
+            for (uint32_t i = 0; i < textureCount; i++) {
+                const CachedTexture texture = reader.value<CachedTexture>();
+                std::span<const unsigned char> pixels = reader.array<unsigned char>();
+                if (!reader.ok || texture.width == 0u || texture.height == 0u
+                    || pixels.size() != static_cast<size_t>(texture.width) * texture.height * 4u
+                ) {
+                    return false;
+                }
+
+                VkSamplerCreateInfo samplerInfo = defaultSamplerInfo;
+                if (texture.hasSampler) {
+                    samplerInfo.minFilter = static_cast<VkFilter>(texture.minFilter);
+                    samplerInfo.magFilter = static_cast<VkFilter>(texture.magFilter);
+                    samplerInfo.addressModeU = static_cast<VkSamplerAddressMode>(texture.addressModeU);
+                    samplerInfo.addressModeV = static_cast<VkSamplerAddressMode>(texture.addressModeV);
+                    samplerInfo.addressModeW = static_cast<VkSamplerAddressMode>(texture.addressModeW);
+                }
+
+                // Uploaded straight from the mapping. Mips are generated on the GPU as for glTF textures.
+                data.textures.push_back(SumiTexture::createFromRGBA(
+                    device,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                    imageInfo,
+                    samplerInfo,
+                    texture.width, texture.height,
+                    const_cast<unsigned char*>(pixels.data())
+                ));
+            }
+
+            return true;
+        }
+
+        bool readMaterials(SumiDevice &device, CacheReader &reader, SumiModel::Data &data) {
+            const uint32_t materialCount = reader.value<uint32_t>();
+            if (!reader.fits(materialCount, sizeof(CachedMaterial))) return false;
+
+            for (uint32_t i = 0; i < materialCount; i++) {
+                const CachedMaterial cached = reader.value<CachedMaterial>();
+                std::string name = reader.string();
+                if (!reader.ok) return false;
+
+                SumiMaterial::MaterialTextureData mat{};
+                auto textures = materialTextures(mat);
+                auto texCoords = materialTexCoords(mat);
+                for (int t = 0; t < SumiMaterial::MAT_TEX_COUNT; t++) {
+                    if (!validOptionalIndex(cached.textures[t], data.textures.size())) return false;
+                    if (cached.textures[t] != NO_INDEX) *textures[t] = data.textures[cached.textures[t]];
+                    *texCoords[t] = cached.texCoords[t];
+                }
+
+                mat.baseColorFactors = cached.baseColorFactors;
+                mat.metallicRoughnessFactors = cached.metallicRoughnessFactors;
+                mat.emissiveFactors = cached.emissiveFactors;
+                mat.normalScale = cached.normalScale;
+                mat.occlusionStrength = cached.occlusionStrength;
+                mat.doubleSided = cached.doubleSided != 0u;
+                mat.alphaMode = static_cast<SumiMaterial::AlphaMode>(cached.alphaMode);
+                mat.alphaCutoff = cached.alphaCutoff;
+                mat.unlit = cached.unlit != 0u;
+                mat.name = std::move(name);
+
+                data.materials.push_back(SumiMaterial::createMaterial(device, mat));
+            }
+
+            return true;
+        }
+
+        bool readNodes(SumiDevice &device, CacheReader &reader, SumiModel::Data &data) {
+            const uint32_t nodeCount = reader.value<uint32_t>();
+            if (!reader.fits(nodeCount, sizeof(CachedNode))) return false;
+
+            // Created up front, as parents and children refer to each other.
+            for (uint32_t i = 0; i < nodeCount; i++) {
+                data.flatNodes.push_back(std::make_unique<Node>());
+            }
+
+            for (uint32_t i = 0; i < nodeCount; i++) {
+                const CachedNode cached = reader.value<CachedNode>();
+                std::string name = reader.string();
+                std::span<const int32_t> children = reader.array<int32_t>();
+                if (!reader.ok || !validOptionalIndex(cached.parent, nodeCount)) return false;
+
+                Node *node = data.flatNodes[i].get();
+                node->idx = cached.idx;
+                node->parent = cached.parent != NO_INDEX ? data.flatNodes[cached.parent].get() : nullptr;
+                node->name = std::move(name);
+                node->skinIdx = cached.skinIdx;
+                node->matrix = cached.matrix;
+                node->translation = cached.translation;
+                node->rotation = cached.rotation;
+                node->scale = cached.scale;
+
+                for (int32_t child : children) {
+                    if (!validIndex(child, nodeCount)) return false;
+                    node->children.push_back(data.flatNodes[child].get());
+                }
+
+                if (!cached.hasMesh) continue;
+
+                std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>(device, node->matrix);
+                for (const CachedPrimitive &primitive : reader.array<CachedPrimitive>()) {
+                    if (primitive.materialIdx >= data.materials.size()) return false;
+                    mesh->primitives.push_back(std::make_unique<Primitive>(
+                        primitive.firstIndex,
+                        primitive.indexCount,
+                        primitive.firstVertex,
+                        primitive.vertexCount,
+                        data.materials[primitive.materialIdx].get(),
+                        primitive.materialIdx
+                    ));
+                }
+                mesh->morphTargets = reader.vector<MorphTarget>();
+                mesh->defaultMorphWeights = reader.vector<float>();
+                mesh->morphWeights = mesh->defaultMorphWeights;
+                mesh->firstMorphVertex = reader.value<uint32_t>();
+                mesh->morphVertexCount = reader.value<uint32_t>();
+                if (!reader.ok) return false;
+
+                node->mesh = std::move(mesh);
+            }
+
+            for (int32_t root : reader.array<int32_t>()) {
+                if (!validIndex(root, nodeCount)) return false;
+                data.nodes.push_back(data.flatNodes[root].get());
+            }
+            data.meshCount = reader.value<uint32_t>();
+
+            return reader.ok;
+        }
+
+        bool readSkins(CacheReader &reader, SumiModel::Data &data) {
+            const size_t nodeCount = data.flatNodes.size();
+            const uint32_t skinCount = reader.value<uint32_t>();
+            if (!reader.fits(skinCount, sizeof(uint32_t))) return false;
+
+            for (uint32_t i = 0; i < skinCount; i++) {
+                std::unique_ptr<Skin> skin = std::make_unique<Skin>();
+                skin->name = reader.string();
+                const int32_t skeletonRoot = reader.value<int32_t>();
+                std::span<const int32_t> joints = reader.array<int32_t>();
+                skin->inverseBindMatrices = reader.vector<glm::mat4>();
+                if (!reader.ok || !validOptionalIndex(skeletonRoot, nodeCount)) return false;
+
+                skin->skeletonRoot = skeletonRoot != NO_INDEX ? data.flatNodes[skeletonRoot].get() : nullptr;
+                for (int32_t joint : joints) {
+                    if (!validIndex(joint, nodeCount)) return false;
+                    skin->joints.push_back(data.flatNodes[joint].get());
+                }
+
+                data.skins.push_back(std::move(skin));
+            }
+
+            return true;
+        }
+
+        bool readAnimations(CacheReader &reader, SumiModel::Data &data) {
+            const size_t nodeCount = data.flatNodes.size();
+            const uint32_t animationCount = reader.value<uint32_t>();
+            if (!reader.fits(animationCount, sizeof(uint32_t))) return false;
+
+            for (uint32_t i = 0; i < animationCount; i++) {
+                std::unique_ptr<Animation> animation = std::make_unique<Animation>();
+                animation->name = reader.string();
+                animation->start = reader.value<float>();
+                animation->end = reader.value<float>();
+
+                const uint32_t samplerCount = reader.value<uint32_t>();
+                if (!reader.fits(samplerCount, 2u * sizeof(uint32_t))) return false;
+                for (uint32_t s = 0; s < samplerCount; s++) {
+                    AnimationSampler sampler{};
+                    sampler.interpolation = static_cast<util::GLTFinterpolationType>(reader.value<uint32_t>());
+                    sampler.weightCount = reader.value<uint32_t>();
+                    sampler.inputs = reader.vector<float>();
+                    sampler.outputs = reader.vector<glm::vec4>();
+                    sampler.weightOutputs = reader.vector<float>();
+                    if (!reader.ok) return false;
+                    animation->samplers.push_back(std::move(sampler));
+                }
+
+                for (const CachedChannel &cached : reader.array<CachedChannel>()) {
+                    if (!validIndex(cached.node, nodeCount) || cached.samplerIdx >= animation->samplers.size()) return false;
+                    AnimationChannel channel{};
+                    channel.path = static_cast<AnimationChannel::PathType>(cached.path);
+                    channel.node = data.flatNodes[cached.node].get();
+                    channel.samplerIdx = cached.samplerIdx;
+                    animation->channels.push_back(channel);
+                }
+                if (!reader.ok) return false;
+
+                data.animations.push_back(std::move(animation));
+            }
+
+            return true;
+        }
+
+        // Ranges into the model's arrays, which are read after the nodes.
+        bool validateMeshRanges(const SumiModel::Data &data) {
+            for (const auto &node : data.flatNodes) {
+                if (!node->mesh) continue;
+                for (const auto &primitive : node->mesh->primitives) {
+                    if (static_cast<uint64_t>(primitive->firstVertex) + primitive->vertexCount > data.vertexView.size()) return false;
+                    if (static_cast<uint64_t>(primitive->firstIndex) + primitive->indexCount > data.indexView.size()) return false;
+                }
+                for (const MorphTarget &target : node->mesh->morphTargets) {
+                    if (static_cast<uint64_t>(target.firstDelta) + target.deltaCount > data.morphDeltas.size()) return false;
+                }
+                const Mesh &mesh = *node->mesh;
+                if (static_cast<uint64_t>(mesh.firstMorphVertex) + mesh.morphVertexCount > data.morphVertices.size()) return false;
+            }
+            return true;
+        }
+
+        bool readModelData(
+            SumiDevice &device, const util::MappedFile &cacheFile, CacheReader &reader, SumiModel::Data &data
+        ) {
+            if (!readTextures(device, reader, data)) return false;
+            if (!readMaterials(device, reader, data)) return false;
+            if (!readNodes(device, reader, data)) return false;
+            if (!readSkins(reader, data)) return false;
+            if (!readAnimations(reader, data)) return false;
+
+            SumimeshFile::Geometry geometry{};
+            if (!reader.ok || !SumimeshFile::readGeometry(cacheFile, geometry)) return false;
+            data.morphDeltas.assign(geometry.morphDeltas.begin(), geometry.morphDeltas.end());
+            data.morphVertices.assign(geometry.morphVertices.begin(), geometry.morphVertices.end());
+            data.vertexView = geometry.vertices;
+            data.indexView = geometry.indices;
+            if (!validateMeshRanges(data)) return false;
+
+            // Assign skins to nodes, as after a glTF load
+            for (auto &node : data.flatNodes) {
+                if (node->skinIdx > -1) {
+                    if (!validIndex(node->skinIdx, data.skins.size()) || !node->mesh) return false;
+                    node->skin = data.skins[node->skinIdx].get();
+                    node->mesh->initJointBuffer(device, node->skin->joints.size());
+                }
+            }
+
+            return true;
+        }
+
+        bool writeTextures(CacheWriter &writer, const tinygltf::Model &gltfModel, const SumiModel::Data &data) {
+            assert(data.textures.size() == gltfModel.textures.size() && "Model textures do not match the glTF textures");
+
+            writer.value<uint32_t>(static_cast<uint32_t>(gltfModel.textures.size()));
+            for (const tinygltf::Texture &texture : gltfModel.textures) {
+                const tinygltf::Image &image = gltfModel.images[texture.source];
+                const size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+                if ((image.component != 3 && image.component != 4)
+                    || image.image.size() < pixelCount * image.component
+                ) {
+                    return false;
+                }
+
+                CachedTexture cached{};
+                cached.width = static_cast<uint32_t>(image.width);
+                cached.height = static_cast<uint32_t>(image.height);
+                if (texture.sampler > -1) {
+                    const VkSamplerCreateInfo &samplerInfo = data.samplers[texture.sampler];
+                    cached.hasSampler = 1u;
+                    cached.minFilter = static_cast<uint32_t>(samplerInfo.minFilter);
+                    cached.magFilter = static_cast<uint32_t>(samplerInfo.magFilter);
+                    cached.addressModeU = static_cast<uint32_t>(samplerInfo.addressModeU);
+                    cached.addressModeV = static_cast<uint32_t>(samplerInfo.addressModeV);
+                    cached.addressModeW = static_cast<uint32_t>(samplerInfo.addressModeW);
+                }
+                writer.value(cached);
+
+                // Stored as RGBA, as uploaded (see SumiTexture::createFromRGB), so warm loads need no conversion.
+                unsigned char *pixels = writer.allocateArray<unsigned char>(pixelCount * 4u);
+                if (image.component == 3) {
+                    const unsigned char *rgb = image.image.data();
+                    for (size_t p = 0; p < pixelCount; p++) {
+                        pixels[4 * p + 0] = rgb[3 * p + 0];
+                        pixels[4 * p + 1] = rgb[3 * p + 1];
+                        pixels[4 * p + 2] = rgb[3 * p + 2];
+                        pixels[4 * p + 3] = 255u;
+                    }
+                } else {
+                    std::memcpy(pixels, image.image.data(), pixelCount * 4u);
+                }
+            }
+
+            return true;
+        }
+
+        bool writeMaterials(CacheWriter &writer, const SumiModel::Data &data) {
+            std::unordered_map<const SumiTexture*, int32_t> textureIndices;
+            for (size_t i = 0; i < data.textures.size(); i++) {
+                textureIndices[data.textures[i].get()] = static_cast<int32_t>(i);
+            }
+
+            // Including the default material at the back
+            writer.value<uint32_t>(static_cast<uint32_t>(data.materials.size()));
+            for (const auto &material : data.materials) {
+                const SumiMaterial::MaterialTextureData &mat = material->getTextureData();
+
+                CachedMaterial cached{};
+                auto textures = materialTextures(mat);
+                auto texCoords = materialTexCoords(mat);
+                for (int t = 0; t < SumiMaterial::MAT_TEX_COUNT; t++) {
+                    cached.textures[t] = NO_INDEX;
+                    if (*textures[t]) {
+                        auto textureIdx = textureIndices.find(textures[t]->get());
+                        if (textureIdx == textureIndices.end()) return false;
+                        cached.textures[t] = textureIdx->second;
+                    }
+                    cached.texCoords[t] = *texCoords[t];
+                }
+
+                cached.baseColorFactors = mat.baseColorFactors;
+                cached.metallicRoughnessFactors = mat.metallicRoughnessFactors;
+                cached.emissiveFactors = mat.emissiveFactors;
+                cached.normalScale = mat.normalScale;
+                cached.occlusionStrength = mat.occlusionStrength;
+                cached.alphaCutoff = mat.alphaCutoff;
+                cached.alphaMode = static_cast<uint32_t>(mat.alphaMode);
+                cached.doubleSided = mat.doubleSided ? 1u : 0u;
+                cached.unlit = mat.unlit ? 1u : 0u;
+
+                writer.value(cached);
+                writer.string(mat.name);
+            }
+
+            return true;
+        }
+
+        void writeNodes(
+            CacheWriter &writer, const SumiModel::Data &data,
+            const std::unordered_map<const Node*, int32_t> &nodeIndices
+        ) {
+            auto nodeIndex = [&](const Node *node) {
+                return node ? nodeIndices.at(node) : NO_INDEX;
+            };
+
+            writer.value<uint32_t>(static_cast<uint32_t>(data.flatNodes.size()));
+            for (const auto &node : data.flatNodes) {
+                CachedNode cached{};
+                cached.idx = node->idx;
+                cached.parent = nodeIndex(node->parent);
+                cached.skinIdx = node->skinIdx;
+                cached.hasMesh = node->mesh ? 1u : 0u;
+                cached.matrix = node->matrix;
+                cached.translation = node->translation;
+                cached.rotation = node->rotation;
+                cached.scale = node->scale;
+                writer.value(cached);
+                writer.string(node->name);
+
+                std::vector<int32_t> children;
+                for (const Node *child : node->children) children.push_back(nodeIndex(child));
+                writer.array(children);
+
+                if (!node->mesh) continue;
+
+                std::vector<CachedPrimitive> primitives;
+                for (const auto &primitive : node->mesh->primitives) {
+                    primitives.push_back(CachedPrimitive{
+                        primitive->firstIndex, primitive->indexCount,
+                        primitive->firstVertex, primitive->vertexCount,
+                        primitive->materialIdx
+                    });
+                }
+                writer.array(primitives);
+                writer.array(node->mesh->morphTargets);
+                writer.array(node->mesh->defaultMorphWeights);
+                writer.value<uint32_t>(node->mesh->firstMorphVertex);
+                writer.value<uint32_t>(node->mesh->morphVertexCount);
+            }
+
+            std::vector<int32_t> roots;
+            for (const Node *root : data.nodes) roots.push_back(nodeIndex(root));
+            writer.array(roots);
+            writer.value<uint32_t>(data.meshCount);
+        }
+
+        void writeSkins(
+            CacheWriter &writer, const SumiModel::Data &data,
+            const std::unordered_map<const Node*, int32_t> &nodeIndices
+        ) {
+            writer.value<uint32_t>(static_cast<uint32_t>(data.skins.size()));
+            for (const auto &skin : data.skins) {
+                writer.string(skin->name);
+                writer.value<int32_t>(skin->skeletonRoot ? nodeIndices.at(skin->skeletonRoot) : NO_INDEX);
+
+                std::vector<int32_t> joints;
+                for (const Node *joint : skin->joints) joints.push_back(nodeIndices.at(joint));
+                writer.array(joints);
+                writer.array(skin->inverseBindMatrices);
+            }
+        }
+
+        void writeAnimations(
+            CacheWriter &writer, const SumiModel::Data &data,
+            const std::unordered_map<const Node*, int32_t> &nodeIndices
+        ) {
+            writer.value<uint32_t>(static_cast<uint32_t>(data.animations.size()));
+            for (const auto &animation : data.animations) {
+                writer.string(animation->name);
+                writer.value<float>(animation->start);
+                writer.value<float>(animation->end);
+
+                writer.value<uint32_t>(static_cast<uint32_t>(animation->samplers.size()));
+                for (const AnimationSampler &sampler : animation->samplers) {
+                    writer.value<uint32_t>(static_cast<uint32_t>(sampler.interpolation));
+                    writer.value<uint32_t>(sampler.weightCount);
+                    writer.array(sampler.inputs);
+                    writer.array(sampler.outputs);
+                    writer.array(sampler.weightOutputs);
+                }
+
+                // Channels still target nodes by pointer until the model resolves them (see Animation::resolveNodes).
+                std::vector<CachedChannel> channels;
+                for (const AnimationChannel &channel : animation->channels) {
+                    channels.push_back(CachedChannel{
+                        static_cast<uint32_t>(channel.path), nodeIndices.at(channel.node), channel.samplerIdx
+                    });
+                }
+                writer.array(channels);
+            }
+        }
+
+    }
+
+    bool SumimeshCache::read(
+        SumiDevice &device, const std::string &cachePath, const Key &key,
+        util::MappedFile &cacheFile, SumiModel::Data &data
+    ) {
+        if (!open(cachePath, key, cacheFile)) return false;
+
+        // Sections follow the header, which open() has validated.
+        CacheReader reader{ cacheFile.data(), cacheFile.size() };
+        reader.value<sumimesh::CacheHeader>();
+
+        clearModelData(data);
+        if (!readModelData(device, cacheFile, reader, data)) {
+            std::cerr << "WARN: Mesh cache <" << cachePath << "> is corrupt, loading from source instead" << std::endl;
+            clearModelData(data);
+            cacheFile.close();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SumimeshCache::write(
+        const std::string &cachePath, const Key &key,
+        const tinygltf::Model &gltfModel, const SumiModel::Data &data
+    ) {
+        const auto writeStart = std::chrono::steady_clock::now();
+
+        CacheWriter writer;
+        size_t sizeEstimate = sizeof(sumimesh::CacheHeader) + data.vertices.size() * sizeof(Vertex)
+            + data.indices.size() * sizeof(uint32_t) + data.morphDeltas.size() * sizeof(MorphDelta);
+        for (const tinygltf::Image &image : gltfModel.images) {
+            sizeEstimate += static_cast<size_t>(image.width) * image.height * 4u;
+        }
+        writer.buffer.reserve(sizeEstimate);
+
+        writeHeader(writer, key);
+
+        std::unordered_map<const Node*, int32_t> nodeIndices;
+        for (size_t i = 0; i < data.flatNodes.size(); i++) {
+            nodeIndices[data.flatNodes[i].get()] = static_cast<int32_t>(i);
+        }
+
+        if (!writeTextures(writer, gltfModel, data) || !writeMaterials(writer, data)) {
+            std::cerr << "WARN: Model <" << cachePath << "> has textures that cannot be cached, skipping its mesh cache" << std::endl;
+            return false;
+        }
+        writeNodes(writer, data, nodeIndices);
+        writeSkins(writer, data, nodeIndices);
+        writeAnimations(writer, data, nodeIndices);
+        writeGeometry(writer, Geometry{ data.morphDeltas, data.morphVertices, data.vertices, data.indices });
+
+        // Written aside and renamed into place, so that an interrupted write never leaves a truncated cache.
+        const std::string tempPath = cachePath + ".tmp";
+        std::error_code err;
+        if (!util::writeFileBinary(tempPath, writer.buffer)) {
+            std::filesystem::remove(tempPath, err);
+            return false;
+        }
+        std::filesystem::rename(tempPath, cachePath, err);
+        if (err) {
+            std::filesystem::remove(tempPath, err);
+            return false;
+        }
+
+        const auto writeDuration = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(
+            std::chrono::steady_clock::now() - writeStart);
+        std::cout << "[Sumire::SumimeshCache] Wrote <" << cachePath << "> ("
+                    << writer.buffer.size() / (1024.0f * 1024.0f) << "MB, "
+                    << writeDuration.count() << "ms)" << std::endl;
+        return true;
+    }
+
+}
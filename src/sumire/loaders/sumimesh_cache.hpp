@@ -0,0 +1,42 @@
+#pragma once
+
+#include <sumire/core/models/sumi_model.hpp>
+#include <sumire/loaders/sumimesh_file.hpp>
+#include <sumire/util/mapped_file.hpp>
+
+#include <tiny_gltf.h>
+
+#include <string>
+
+namespace sumire::loaders {
+
+    // Native binary cache of a loaded glTF model (.sumimesh), written next to the source file after
+    //  its first load. The cache holds the model exactly as the loader leaves it in SumiModel::Data:
+    //  decoded vertices & indices, the node tree, skins, animations, morph targets, materials, and
+    //  textures as RGBA pixels. Warm loads map the cache and build the model from it with no parsing
+    //  or decoding, uploading vertices, indices and pixels from the mapping.
+    //
+    //  Caches are only used if written by the same cache VERSION for the same Key, so edits to the
+    //  source file, or to the loader's options, invalidate them (see SumimeshFile).
+    class SumimeshCache : public SumimeshFile {
+        public:
+            // Fills data from the cache at cachePath if it exists and was written for key, creating its
+            //  textures and materials on device. Vertices and indices are not copied out of the cache, but
+            //  referenced through SumiModel::Data::vertexView & indexView, so cacheFile must stay open until
+            //  the model has been created from data.
+            //  Returns false, with data cleared, if there is no valid cache.
+            static bool read(
+                SumiDevice &device, const std::string &cachePath, const Key &key,
+                util::MappedFile &cacheFile, SumiModel::Data &data
+            );
+
+            // Writes the cache of a model loaded from gltfModel into data, which must not have been
+            //  moved into a SumiModel yet. Texture pixels are taken from gltfModel's images.
+            //  Returns false if the cache could not be written, which leaves no partial cache behind.
+            static bool write(
+                const std::string &cachePath, const Key &key,
+                const tinygltf::Model &gltfModel, const SumiModel::Data &data
+            );
+    };
+
+}
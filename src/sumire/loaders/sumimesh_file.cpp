@@ -0,0 +1,102 @@
+#include <sumire/loaders/sumimesh_file.hpp>
+
+#include <cassert>
+
+namespace sumire::loaders {
+
+    std::string SumimeshFile::getCachePath(const std::string &sourcePath) {
+        return sourcePath + ".sumimesh";
+    }
+
+    bool SumimeshFile::makeKey(const std::string &sourcePath, uint32_t flags, Key &key) {
+        util::MappedFile source;
+        if (!source.open(sourcePath)) return false;
+
+        // FNV-1a over 8 byte words rather than single bytes, as large models are hashed on every load.
+        constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr uint64_t FNV_PRIME = 1099511628211ull;
+        const unsigned char *bytes = source.data();
+        const size_t size = source.size();
+
+        uint64_t hash = FNV_OFFSET_BASIS;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(uint64_t));
+            hash = (hash ^ word) * FNV_PRIME;
+        }
+        for (; i < size; i++) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+
+        key.sourceHash = hash;
+        key.sourceSize = static_cast<uint64_t>(size);
+        key.flags = flags;
+        return true;
+    }
+
+    bool SumimeshFile::open(const std::string &cachePath, const Key &key, util::MappedFile &cacheFile) {
+        if (!cacheFile.open(cachePath)) return false;
+
+        sumimesh::CacheReader reader{ cacheFile.data(), cacheFile.size() };
+        const sumimesh::CacheHeader header = reader.value<sumimesh::CacheHeader>();
+        const bool validHeader = reader.ok
+            && std::memcmp(header.magic, sumimesh::CACHE_MAGIC, sizeof(sumimesh::CACHE_MAGIC)) == 0
+            && header.version == VERSION
+            && header.vertexSize == sizeof(Vertex);
+        const bool matchesSource = header.sourceHash == key.sourceHash
+            && header.sourceSize == key.sourceSize
+            && header.flags == key.flags;
+        if (!validHeader || !matchesSource) {
+            cacheFile.close();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SumimeshFile::readGeometry(const util::MappedFile &cacheFile, Geometry &geometry) {
+        assert(cacheFile.isOpen() && "Cache geometry read from a cache that is not open");
+
+        sumimesh::CacheReader reader{ cacheFile.data(), cacheFile.size() };
+        const sumimesh::CacheHeader header = reader.value<sumimesh::CacheHeader>();
+        if (!reader.ok || !reader.seek(header.geometryOffset)) return false;
+
+        geometry.morphDeltas = reader.array<MorphDelta>();
+        geometry.morphVertices = reader.array<uint32_t>();
+        geometry.vertices = reader.array<Vertex>();
+        geometry.indices = reader.array<uint32_t>();
+        return reader.ok;
+    }
+
+    void SumimeshFile::writeHeader(sumimesh::CacheWriter &writer, const Key &key) {
+        assert(writer.buffer.empty() && "Cache header must be written first");
+
+        sumimesh::CacheHeader header{};
+        std::memcpy(header.magic, sumimesh::CACHE_MAGIC, sizeof(sumimesh::CACHE_MAGIC));
+        header.version = VERSION;
+        header.flags = key.flags;
+        header.sourceHash = key.sourceHash;
+        header.sourceSize = key.sourceSize;
+        header.vertexSize = sizeof(Vertex);
+        // Set by writeGeometry()
+        header.geometryOffset = 0u;
+        writer.value(header);
+    }
+
+    void SumimeshFile::writeGeometry(sumimesh::CacheWriter &writer, const Geometry &geometry) {
+        assert(writer.buffer.size() >= sizeof(sumimesh::CacheHeader) && "Cache geometry written before its header");
+
+        const uint64_t geometryOffset = writer.buffer.size();
+        std::memcpy(
+            writer.buffer.data() + offsetof(sumimesh::CacheHeader, geometryOffset),
+            &geometryOffset, sizeof(uint64_t)
+        );
+
+        writer.array(geometry.morphDeltas.data(), geometry.morphDeltas.size());
+        writer.array(geometry.morphVertices.data(), geometry.morphVertices.size());
+        writer.array(geometry.vertices.data(), geometry.vertices.size());
+        writer.array(geometry.indices.data(), geometry.indices.size());
+    }
+
+}
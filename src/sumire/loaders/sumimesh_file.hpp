@@ -0,0 +1,208 @@
+#pragma once
+
+#include <sumire/core/models/morph_target.hpp>
+#include <sumire/core/models/vertex.hpp>
+#include <sumire/util/mapped_file.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sumire::loaders {
+
+    namespace sumimesh {
+
+        constexpr char CACHE_MAGIC[8] = { 'S', 'U', 'M', 'I', 'M', 'E', 'S', 'H' };
+        // Arrays start on this alignment, so that they can be used in place from the mapped file.
+        constexpr size_t CACHE_ARRAY_ALIGNMENT = 16u;
+
+        // Sections follow the header in order:
+        //  textures, materials, nodes, skins, animations, then the geometry (see SumimeshFile::Geometry).
+        struct CacheHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t flags;
+            uint64_t sourceHash;
+            uint64_t sourceSize;
+            uint32_t vertexSize;
+            uint32_t reserved;
+            // Where the geometry starts, so it can be read without reading the sections before it.
+            uint64_t geometryOffset;
+        };
+
+        class CacheWriter {
+        public:
+            template <typename T>
+            void value(const T &v) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                bytes(&v, sizeof(T));
+            }
+
+            template <typename T>
+            void array(const T *values, size_t count) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                value<uint64_t>(count);
+                align();
+                bytes(values, count * sizeof(T));
+            }
+
+            template <typename T>
+            void array(const std::vector<T> &values) { array(values.data(), values.size()); }
+
+            // Appends an uninitialised array of count values to be filled by the caller.
+            //  Only valid until the next write.
+            template <typename T>
+            T* allocateArray(size_t count) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                value<uint64_t>(count);
+                align();
+                const size_t offset = buffer.size();
+                buffer.resize(offset + count * sizeof(T));
+                return reinterpret_cast<T*>(buffer.data() + offset);
+            }
+
+            void string(const std::string &s) {
+                value<uint32_t>(static_cast<uint32_t>(s.size()));
+                bytes(s.data(), s.size());
+            }
+
+            std::vector<char> buffer;
+
+        private:
+            void bytes(const void *src, size_t size) {
+                const char *srcBytes = static_cast<const char*>(src);
+                buffer.insert(buffer.end(), srcBytes, srcBytes + size);
+            }
+
+            void align() {
+                buffer.resize((buffer.size() + CACHE_ARRAY_ALIGNMENT - 1u) & ~(CACHE_ARRAY_ALIGNMENT - 1u), 0);
+            }
+        };
+
+        // Reads values in the order they were written. Reading past the end of the cache clears ok and
+        //  returns empty values, so that a truncated or corrupt cache is rejected rather than read out of bounds.
+        class CacheReader {
+        public:
+            CacheReader(const unsigned char *data, size_t size) : data{ data }, size{ size } {}
+
+            template <typename T>
+            T value() {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T v{};
+                if (!ok || size - offset < sizeof(T)) {
+                    ok = false;
+                    return v;
+                }
+                std::memcpy(&v, data + offset, sizeof(T));
+                offset += sizeof(T);
+                return v;
+            }
+
+            // The array in place in the mapped cache.
+            template <typename T>
+            std::span<const T> array() {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const uint64_t count = value<uint64_t>();
+                align();
+                if (!ok || !fits(count, sizeof(T))) {
+                    ok = false;
+                    return {};
+                }
+                const T *values = reinterpret_cast<const T*>(data + offset);
+                offset += static_cast<size_t>(count) * sizeof(T);
+                return { values, static_cast<size_t>(count) };
+            }
+
+            template <typename T>
+            std::vector<T> vector() {
+                std::span<const T> values = array<T>();
+                return std::vector<T>(values.begin(), values.end());
+            }
+
+            std::string string() {
+                const uint32_t length = value<uint32_t>();
+                if (!ok || !fits(length, 1u)) {
+                    ok = false;
+                    return {};
+                }
+                std::string s(reinterpret_cast<const char*>(data + offset), length);
+                offset += length;
+                return s;
+            }
+
+            // Continues reading from position, which must be within the cache.
+            bool seek(uint64_t position) {
+                if (position > size) ok = false;
+                else offset = static_cast<size_t>(position);
+                return ok;
+            }
+
+            // Whether count values of at least elementSize bytes could remain, to reject corrupt counts
+            //  before allocating for them.
+            bool fits(uint64_t count, size_t elementSize) const {
+                return count <= (size - offset) / elementSize;
+            }
+
+            bool ok = true;
+
+        private:
+            void align() {
+                const size_t aligned = (offset + CACHE_ARRAY_ALIGNMENT - 1u) & ~(CACHE_ARRAY_ALIGNMENT - 1u);
+                if (aligned > size) ok = false;
+                else offset = aligned;
+            }
+
+            const unsigned char *data;
+            size_t size;
+            size_t offset = 0u;
+        };
+
+    }
+
+    // The parts of the .sumimesh cache (see SumimeshCache) that need no device: keying, the header, and
+    //  the geometry arrays, which warm loads use in place from the mapped file.
+    class SumimeshFile {
+        public:
+            // Bump whenever the layout of the cache, or of any type it stores raw (e.g. Vertex), changes.
+            static constexpr uint32_t VERSION = 2u;
+
+            static constexpr uint32_t FLAG_GEN_TANGENTS = 1u << 0;
+            static constexpr uint32_t FLAG_OPTIMIZE_MESHES = 1u << 1;
+
+            struct Key {
+                uint64_t sourceHash = 0u;
+                uint64_t sourceSize = 0u;
+                // Loader options the cached data depends on (FLAG_*).
+                uint32_t flags = 0u;
+            };
+
+            // The model's morph deltas & vertices (see SumiModel::Data), vertices and indices.
+            struct Geometry {
+                std::span<const MorphDelta> morphDeltas;
+                std::span<const uint32_t> morphVertices;
+                std::span<const Vertex> vertices;
+                std::span<const uint32_t> indices;
+            };
+
+            static std::string getCachePath(const std::string &sourcePath);
+            // Hashes the contents of the source file. Returns false if it cannot be read.
+            static bool makeKey(const std::string &sourcePath, uint32_t flags, Key &key);
+
+            // Maps the cache at cachePath if it exists and was written by this VERSION for key.
+            //  Returns false, with cacheFile closed, if there is no valid cache.
+            static bool open(const std::string &cachePath, const Key &key, util::MappedFile &cacheFile);
+            // The geometry of a cache opened by open(), in place in its mapping.
+            //  Returns false if the cache is truncated or corrupt.
+            static bool readGeometry(const util::MappedFile &cacheFile, Geometry &geometry);
+
+            // Starts a cache written by this VERSION for key.
+            static void writeHeader(sumimesh::CacheWriter &writer, const Key &key);
+            // Appends the geometry, and records where it starts in the header.
+            static void writeGeometry(sumimesh::CacheWriter &writer, const Geometry &geometry);
+    };
+
+}
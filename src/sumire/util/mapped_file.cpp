@@ -0,0 +1,100 @@
+#include <sumire/util/mapped_file.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sumire::util {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+#ifdef _WIN32
+
+    bool MappedFile::open(const std::string &filepath) {
+        close();
+
+        HANDLE file = CreateFileA(
+            filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            return false;
+        }
+
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle = file;
+        mappingHandle = mapping;
+        mappedData = static_cast<const unsigned char*>(view);
+        mappedSize = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (mappedData) UnmapViewOfFile(mappedData);
+        if (mappingHandle) CloseHandle(mappingHandle);
+        if (fileHandle) CloseHandle(fileHandle);
+
+        mappedData = nullptr;
+        mappedSize = 0u;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+    }
+
+#else
+
+    bool MappedFile::open(const std::string &filepath) {
+        close();
+
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        const size_t fileSize = static_cast<size_t>(fileStat.st_size);
+        void *view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping holds its own reference to the file.
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+
+        mappedData = static_cast<const unsigned char*>(view);
+        mappedSize = fileSize;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (mappedData) munmap(const_cast<unsigned char*>(mappedData), mappedSize);
+
+        mappedData = nullptr;
+        mappedSize = 0u;
+    }
+
+#endif
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace sumire::util {
+
+    // A read-only memory mapping of a whole file. Pages are read in by the OS as they are first touched,
+    //  so mapped data can be handed straight to its consumer (e.g. a staging buffer) without first
+    //  reading it into an intermediate buffer.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Maps filepath, replacing any current mapping.
+        //  Returns false if the file cannot be opened or mapped, or is empty.
+        bool open(const std::string &filepath);
+        void close();
+
+        bool isOpen() const { return mappedData != nullptr; }
+        const unsigned char* data() const { return mappedData; }
+        size_t size() const { return mappedSize; }
+
+    private:
+        const unsigned char *mappedData = nullptr;
+        size_t mappedSize = 0u;
+
+#ifdef _WIN32
+        void *fileHandle = nullptr;
+        void *mappingHandle = nullptr;
+#endif
+    };
+
+}
@@ -0,0 +1,297 @@
+#include <sumire/util/mesh_optimizer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+namespace sumire::util {
+
+    namespace {
+        constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+        // Clusters may be split wherever the cache misses so far are within this factor of their hard
+        //  cluster's, trading a little vertex cache efficiency for finer overdraw ordering.
+        constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+        // Entries are timestamped as they enter the cache, so a vertex is cached while fewer than
+        //  cacheSize vertices entered after it. Timestamps start past cacheSize so nothing starts cached.
+        struct FifoCache {
+            std::vector<uint32_t> cachedAt;
+            uint32_t time;
+            uint32_t size;
+
+            FifoCache(uint32_t vertexCount, uint32_t cacheSize)
+                : cachedAt(vertexCount, 0u), time{ cacheSize + 1u }, size{ cacheSize } {}
+
+            bool contains(uint32_t v) const { return time - cachedAt[v] <= size; }
+            // Returns true on a miss
+            bool access(uint32_t v) {
+                if (contains(v)) return false;
+                cachedAt[v] = time++;
+                return true;
+            }
+            void flush() { time += size + 1u; }
+        };
+
+        // Tipsify: fans around vertices, choosing each next fanning vertex among those just used by how
+        //  long it will stay cached. Indices are relative to the vertex slice. hardBoundaries receives the
+        //  first triangle after each dead end, where the order jumps rather than fans on.
+        void optimizeVertexCache(
+            std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize,
+            std::vector<uint32_t> &hardBoundaries
+        ) {
+            const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+            // Triangles using each vertex, and how many of them are yet to be emitted.
+            std::vector<uint32_t> live(vertexCount, 0u);
+            for (uint32_t idx : indices) live[idx]++;
+            std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0u);
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                adjacencyOffsets[v + 1] = adjacencyOffsets[v] + live[v];
+            }
+            std::vector<uint32_t> adjacency(indices.size());
+            std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t t = 0; t < triangleCount; t++) {
+                for (uint32_t c = 0; c < 3; c++) {
+                    adjacency[adjacencyFill[indices[3 * t + c]]++] = t;
+                }
+            }
+
+            FifoCache cache{ vertexCount, cacheSize };
+            std::vector<bool> emitted(triangleCount, false);
+            std::vector<uint32_t> deadEnds;
+            deadEnds.reserve(indices.size());
+            std::vector<uint32_t> candidates;
+            std::vector<uint32_t> output;
+            output.reserve(indices.size());
+
+            uint32_t cursor = 0u;
+            uint32_t fanning = indices[0];
+            hardBoundaries.push_back(0u);
+
+            while (fanning != NO_VERTEX) {
+                candidates.clear();
+                for (uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++) {
+                    const uint32_t t = adjacency[a];
+                    if (emitted[t]) continue;
+                    emitted[t] = true;
+
+                    for (uint32_t c = 0; c < 3; c++) {
+                        const uint32_t v = indices[3 * t + c];
+                        output.push_back(v);
+                        deadEnds.push_back(v);
+                        candidates.push_back(v);
+                        live[v]--;
+                        cache.access(v);
+                    }
+                }
+
+                // Prefer the vertex cached longest that will still be cached once all its triangles are
+                //  emitted, else any vertex with triangles left.
+                uint32_t next = NO_VERTEX;
+                int64_t bestPriority = -1;
+                for (uint32_t v : candidates) {
+                    if (live[v] == 0u) continue;
+
+                    int64_t priority = 0;
+                    const uint32_t age = cache.time - cache.cachedAt[v];
+                    if (age + 2u * live[v] <= cacheSize) priority = age;
+                    if (priority > bestPriority) {
+                        bestPriority = priority;
+                        next = v;
+                    }
+                }
+
+                // Dead end: back track through recently used vertices, then scan for any left.
+                if (next == NO_VERTEX) {
+                    while (!deadEnds.empty()) {
+                        const uint32_t v = deadEnds.back();
+                        deadEnds.pop_back();
+                        if (live[v] > 0u) {
+                            next = v;
+                            break;
+                        }
+                    }
+                    while (next == NO_VERTEX && cursor < vertexCount) {
+                        if (live[cursor] > 0u) next = cursor;
+                        else cursor++;
+                    }
+                    if (next != NO_VERTEX) {
+                        hardBoundaries.push_back(static_cast<uint32_t>(output.size() / 3));
+                    }
+                }
+
+                fanning = next;
+            }
+
+            assert(output.size() == indices.size() && "Vertex cache optimization dropped triangles");
+            indices.swap(output);
+        }
+
+        // Splits the hard clusters further where the cache has warmed up, then sorts all clusters so those
+        //  facing away from the mesh centre, which are likely to occlude the rest, draw first.
+        void optimizeOverdraw(
+            std::vector<uint32_t> &indices, const Vertex *vertices, uint32_t vertexCount,
+            const std::vector<uint32_t> &hardBoundaries, uint32_t cacheSize
+        ) {
+            const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+            std::vector<uint32_t> boundaries;
+            FifoCache cache{ vertexCount, cacheSize };
+            for (size_t h = 0; h < hardBoundaries.size(); h++) {
+                const uint32_t begin = hardBoundaries[h];
+                const uint32_t end = h + 1 < hardBoundaries.size() ? hardBoundaries[h + 1] : triangleCount;
+
+                // Misses of the whole hard cluster, from a cold cache
+                cache.flush();
+                uint32_t hardMisses = 0u;
+                for (uint32_t i = 3 * begin; i < 3 * end; i++) {
+                    if (cache.access(indices[i])) hardMisses++;
+                }
+                const float hardAcmr = static_cast<float>(hardMisses) / (end - begin);
+
+                cache.flush();
+                boundaries.push_back(begin);
+                uint32_t clusterMisses = 0u;
+                uint32_t clusterTriangles = 0u;
+                for (uint32_t t = begin; t < end; t++) {
+                    for (uint32_t c = 0; c < 3; c++) {
+                        if (cache.access(indices[3 * t + c])) clusterMisses++;
+                    }
+                    clusterTriangles++;
+
+                    if (t + 1 < end && clusterMisses <= OVERDRAW_THRESHOLD * hardAcmr * clusterTriangles) {
+                        boundaries.push_back(t + 1);
+                        cache.flush();
+                        clusterMisses = 0u;
+                        clusterTriangles = 0u;
+                    }
+                }
+            }
+
+            const uint32_t clusterCount = static_cast<uint32_t>(boundaries.size());
+            if (clusterCount < 2u) return;
+
+            // Area weighted centroids & normals of each cluster, and of the whole mesh.
+            std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3{ 0.0f });
+            std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3{ 0.0f });
+            std::vector<float> clusterAreas(clusterCount, 0.0f);
+            glm::vec3 meshCentroid{ 0.0f };
+            float meshArea = 0.0f;
+            for (uint32_t k = 0; k < clusterCount; k++) {
+                const uint32_t end = k + 1 < clusterCount ? boundaries[k + 1] : triangleCount;
+                for (uint32_t t = boundaries[k]; t < end; t++) {
+                    const glm::vec3 &p0 = vertices[indices[3 * t + 0]].position;
+                    const glm::vec3 &p1 = vertices[indices[3 * t + 1]].position;
+                    const glm::vec3 &p2 = vertices[indices[3 * t + 2]].position;
+                    const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+                    const float area = 0.5f * glm::length(cross);
+                    const glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+                    clusterCentroids[k] += area * centroid;
+                    clusterNormals[k] += cross;
+                    clusterAreas[k] += area;
+                }
+                meshCentroid += clusterCentroids[k];
+                meshArea += clusterAreas[k];
+            }
+            if (meshArea <= 0.0f) return;
+            meshCentroid /= meshArea;
+
+            std::vector<float> sortKeys(clusterCount, 0.0f);
+            for (uint32_t k = 0; k < clusterCount; k++) {
+                const float normalLength = glm::length(clusterNormals[k]);
+                if (clusterAreas[k] <= 0.0f || normalLength <= 0.0f) continue;
+
+                const glm::vec3 centroid = clusterCentroids[k] / clusterAreas[k];
+                sortKeys[k] = glm::dot(centroid - meshCentroid, clusterNormals[k] / normalLength);
+            }
+
+            std::vector<uint32_t> order(clusterCount);
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return sortKeys[a] > sortKeys[b];
+            });
+
+            std::vector<uint32_t> sorted;
+            sorted.reserve(indices.size());
+            for (uint32_t k : order) {
+                const uint32_t end = k + 1 < clusterCount ? boundaries[k + 1] : triangleCount;
+                sorted.insert(sorted.end(), indices.begin() + 3 * boundaries[k], indices.begin() + 3 * end);
+            }
+            indices.swap(sorted);
+        }
+
+        // Renumbers vertices in the order indices first use them. Unused vertices keep their relative
+        //  order at the end of the slice.
+        void optimizeVertexFetch(std::vector<uint32_t> &indices, uint32_t vertexCount, std::vector<uint32_t> &remap) {
+            remap.assign(vertexCount, NO_VERTEX);
+            uint32_t nextVertex = 0u;
+            for (uint32_t &idx : indices) {
+                if (remap[idx] == NO_VERTEX) remap[idx] = nextVertex++;
+                idx = remap[idx];
+            }
+            for (uint32_t &newIdx : remap) {
+                if (newIdx == NO_VERTEX) newIdx = nextVertex++;
+            }
+        }
+    }
+
+    bool optimizeMesh(MeshOptimizeData *data) {
+        if (data->indexCount < 3u || data->indexCount % 3u != 0u) return false;
+        assert(data->vertexStart + data->vertexCount <= data->verts.size() && "Vertex slice out of range");
+        assert(data->indexStart + data->indexCount <= data->indices.size() && "Index slice out of range");
+
+        uint32_t *indices = data->indices.data() + data->indexStart;
+        Vertex *vertices = data->verts.data() + data->vertexStart;
+
+        std::vector<uint32_t> localIndices(data->indexCount);
+        for (uint32_t i = 0; i < data->indexCount; i++) {
+            if (indices[i] < data->vertexStart || indices[i] - data->vertexStart >= data->vertexCount) return false;
+            localIndices[i] = indices[i] - data->vertexStart;
+        }
+
+        data->outStatsBefore = simulateVertexCache(indices, data->indexCount, data->vertexStart, data->vertexCount);
+
+        std::vector<uint32_t> hardBoundaries;
+        optimizeVertexCache(localIndices, data->vertexCount, VERTEX_CACHE_SIZE, hardBoundaries);
+        optimizeOverdraw(localIndices, vertices, data->vertexCount, hardBoundaries, VERTEX_CACHE_SIZE);
+        optimizeVertexFetch(localIndices, data->vertexCount, data->outRemap);
+
+        const std::vector<Vertex> original(vertices, vertices + data->vertexCount);
+        for (uint32_t v = 0; v < data->vertexCount; v++) {
+            vertices[data->outRemap[v]] = original[v];
+        }
+        for (uint32_t i = 0; i < data->indexCount; i++) {
+            indices[i] = data->vertexStart + localIndices[i];
+        }
+
+        data->outStatsAfter = simulateVertexCache(indices, data->indexCount, data->vertexStart, data->vertexCount);
+        return true;
+    }
+
+    VertexCacheStats simulateVertexCache(
+        const uint32_t *indices, uint32_t indexCount,
+        uint32_t vertexStart, uint32_t vertexCount,
+        uint32_t cacheSize
+    ) {
+        VertexCacheStats stats{};
+        stats.triangles = indexCount / 3u;
+
+        FifoCache cache{ vertexCount, cacheSize };
+        std::vector<bool> referenced(vertexCount, false);
+        for (uint32_t i = 0; i < indexCount; i++) {
+            const uint32_t v = indices[i] - vertexStart;
+            assert(v < vertexCount && "Index outside of the simulated vertex slice");
+
+            if (cache.access(v)) stats.misses++;
+            if (!referenced[v]) {
+                referenced[v] = true;
+                stats.vertices++;
+            }
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <sumire/core/models/vertex.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sumire::util {
+
+    // Entries of the FIFO post-transform cache meshes are optimized for, and simulated with.
+    constexpr uint32_t VERTEX_CACHE_SIZE = 16u;
+
+    // Post-transform vertex cache efficiency of triangle lists (see simulateVertexCache).
+    struct VertexCacheStats {
+        uint64_t triangles = 0u;
+        // Distinct vertices referenced by the triangles
+        uint64_t vertices = 0u;
+        uint64_t misses = 0u;
+
+        // Average cache miss ratio: vertex shader invocations per triangle. 3 at worst, ~0.5 at best.
+        float acmr() const { return triangles > 0u ? static_cast<float>(misses) / triangles : 0.0f; }
+        // Average transform to vertex ratio: vertex shader invocations per vertex. 1 at best.
+        float atvr() const { return vertices > 0u ? static_cast<float>(misses) / vertices : 0.0f; }
+
+        VertexCacheStats &operator+=(const VertexCacheStats &other) {
+            triangles += other.triangles;
+            vertices += other.vertices;
+            misses += other.misses;
+            return *this;
+        }
+    };
+
+    struct MeshOptimizeData {
+        std::vector<Vertex> &verts;
+        std::vector<uint32_t> &indices;
+        uint32_t vertexStart;
+        uint32_t vertexCount;
+        uint32_t indexStart;
+        uint32_t indexCount;
+        // Where each of the slice's vertices moved to, relative to vertexStart.
+        std::vector<uint32_t> outRemap;
+        VertexCacheStats outStatsBefore;
+        VertexCacheStats outStatsAfter;
+    };
+
+    // Reorders an indexed triangle list primitive's slices in place, in three passes:
+    //  1. Triangles for the vertex cache (Tipsify, Sander et al. 2007).
+    //  2. Clusters of those triangles front to back for less overdraw, at a small cache cost.
+    //  3. Vertices into the order the triangles first use them, for vertex fetch locality.
+    //  Indices must lie within the vertex slice. Returns false, leaving the slices untouched, if the
+    //  primitive is not an indexed triangle list.
+    bool optimizeMesh(MeshOptimizeData *data);
+
+    // Simulates a FIFO cache of cacheSize entries over a triangle list whose indices lie in
+    //  [vertexStart, vertexStart + vertexCount).
+    VertexCacheStats simulateVertexCache(
+        const uint32_t *indices, uint32_t indexCount,
+        uint32_t vertexStart, uint32_t vertexCount,
+        uint32_t cacheSize = VERTEX_CACHE_SIZE
+    );
+
+}